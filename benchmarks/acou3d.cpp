@@ -2,7 +2,7 @@
 
 #include <blitz/array.h>
 #include <blitz/traversal.h>
-#include <blitz/timer.h>
+#include <blitz/benchext.h>
 
 #ifdef BZ_HAVE_STD
   #include <fstream>
@@ -42,76 +42,110 @@ float acoustic3D_BlitzCycled(int N, int niters);
 float acoustic3D_BlitzStencil(int N, int niters);
 
 
-void output_data(const char* type, const Timer& t, float check, double Gflops)
+#ifdef FORTRAN_90
+float acoustic3D_F90(int N, int niters)
+{
+    float check;
+    acoustic3d_f90(N, niters, check);
+    return check;
+}
+
+float acoustic3D_F90Tuned(int N, int niters)
+{
+    float check;
+    acoustic3d_f90tuned(N, niters, check);
+    return check;
+}
+#endif
+
+float acoustic3D_F77(int N, int niters)
+{
+    float check;
+    acoustic3d_f77(N, niters, check);
+    return check;
+}
+
+float acoustic3D_F77Tuned(int N, int niters)
+{
+    float check;
+    acoustic3d_f77tuned(N, niters, check);
+    return check;
+}
+
+// Time one version; the parameter is N and the iterations are time
+// steps, which each version does itself.
+void runVersion(BenchmarkExt<int>& bench, const char* description,
+    float (*version)(int, int))
 {
-  cout << type << ": " << t.elapsed() 
-	 << t.indep_var() << "  check = " 
-         << check << " Gflop/" << t.indep_var() << " = " 
-	 << (Gflops/t.elapsed())
-         << endl << endl;
+    bench.beginImplementation(description);
+
+    while (!bench.doneImplementationBenchmark())
+    {
+        int N = bench.getParameter();
+        int niters = bench.getIterations();
+        float check = 0;
+
+        while (bench.repeat())
+        {
+            bench.start();
+            check = version(N, niters);
+            bench.stop();
+        }
+
+        cout << description << ": check = " << check << endl << endl;
+    }
+
+    bench.endImplementation();
 }
 
 int main()
 {
-    Timer timer;
     int N = 112;
     int niters = 210;    // Must be divisible by 3 for tuned Fortran versions
-    float check;
+
+    int numBenchmarks = 6;
+#ifdef FORTRAN_90
+    numBenchmarks += 2;
+#endif
 
 		cout << "Acoustic 3D Benchmark" << endl << endl;
 
-		double Gflops = (N-2)*(N-2)*(N-2) * 11.0 * niters / 1.0e+9;
+    BenchmarkExt<int> bench("Acoustic 3D", numBenchmarks);
 
-    generateFastTraversalOrder(TinyVector<int,2>(N-2,N-2));
+    Array<int,1> parameters(1);
+    Array<long,1> iters(1);
+    Array<double,1> flops(1);
+    parameters = N;
+    iters = niters;
+    flops = (N-2)*(N-2)*(N-2) * 11.0;
 
-    timer.start();
-    check = acoustic3D_BlitzRaw(N, niters);
-    timer.stop();
-    output_data("Blitz++ (raw)", timer, check, Gflops);
+    bench.setNumParameters(1);
+    bench.setParameterVector(parameters);
+    bench.setIterations(iters);
+    bench.setOpsPerIteration(flops);
+    bench.setParameterDescription("N");
+    bench.setDependentVariable("flops");
+    bench.beginBenchmarking();
 
-    timer.start();
-    check = acoustic3D_BlitzStencil(N, niters);
-    timer.stop();
-    output_data("Blitz++ (stencil)", timer, check, Gflops);
+    generateFastTraversalOrder(TinyVector<int,2>(N-2,N-2));
 
+    runVersion(bench, "Blitz++ (raw)", acoustic3D_BlitzRaw);
+    runVersion(bench, "Blitz++ (stencil)", acoustic3D_BlitzStencil);
 #if 0
-    timer.start();
-    check = acoustic3D_BlitzInterlaced(N, niters, c);
-    timer.stop();
-    output_data("Blitz++ (interlaced)", timer, check, Gflops);
+    runVersion(bench, "Blitz++ (interlaced)", acoustic3D_BlitzInterlaced);
 #endif
-
-    timer.start();
-    check = acoustic3D_BlitzCycled(N, niters);
-    timer.stop();
-    output_data("Blitz++ (cycled)", timer, check, Gflops);
- 
-    timer.start();
-    check = acoustic3D_BlitzInterlacedCycled(N, niters);
-    timer.stop();
-    output_data("Blitz++ (interlaced & cycled)", timer, check, Gflops);
-
+    runVersion(bench, "Blitz++ (cycled)", acoustic3D_BlitzCycled);
+    runVersion(bench, "Blitz++ (interlaced & cycled)",
+        acoustic3D_BlitzInterlacedCycled);
 #ifdef FORTRAN_90
-    timer.start();
-    acoustic3d_f90(N, niters, check);
-    timer.stop();
-    output_data("Fortran 90", timer, check, Gflops);
-
-    timer.start();
-    acoustic3d_f90tuned(N, niters, check);
-    timer.stop();
-    output_data("Fortran 90 (tuned)", timer, check, Gflops);
+    runVersion(bench, "Fortran 90", acoustic3D_F90);
+    runVersion(bench, "Fortran 90 (tuned)", acoustic3D_F90Tuned);
 #endif
+    runVersion(bench, "Fortran 77", acoustic3D_F77);
+    runVersion(bench, "Fortran 77 (tuned)", acoustic3D_F77Tuned);
 
-    timer.start(); 
-    acoustic3d_f77(N, niters, check);
-    timer.stop(); 
-    output_data("Fortran 77", timer, check, Gflops);
-
-    timer.start();
-    acoustic3d_f77tuned(N, niters, check);
-    timer.stop();
-    output_data("Fortran 77 (tuned)", timer, check, Gflops);
+    bench.endBenchmarking();
+    bench.saveMatlabGraph("acou3d.m", "bar");
 
     return 0;
 }
@@ -1,5 +1,5 @@
 #include <blitz/array.h>
-#include <blitz/tinyvec-et.h>
+#include <blitz/benchext.h>
 
 BZ_USING_NAMESPACE(blitz)
 
@@ -44,7 +44,8 @@ typedef Array<double,3>   scalarField;
 BZ_DECLARE_STENCIL5(timestep, V, nextV, P, advect, force)
 
     nextV = *V + delta_t * ( recip_rho * (
-      eta * Laplacian3DVec4(V,geom) - grad3D4(P, geom) + *force) - *advect);
+      eta * Laplacian3DVec4_stencilop(V,geom)
+      - grad3D4n_stencilop(P) * geom.recipSpatialStep() + *force) - *advect);
 
 BZ_END_STENCIL
 /*
@@ -113,17 +114,48 @@ int main()
     vectorField advect;          // Advection field
     vectorField force;           // Forcing function
 
-    const int N = 50;            // Arrays are NxNxN
-
-    setup(N, V, nextV, P, P_rhs, advect, force);
-
-    const int nIters = 10;
-
-    for (int i=0; i < nIters; ++i)
+    BenchmarkExt<int> bench("CFD velocity time step", 1);
+
+    // Arrays are NxNxN; the rate is in updated grid points
+    const int numSizes = 6;
+    bench.setNumParameters(numSizes);
+    Array<int,1> parameters(numSizes);
+    Array<long,1> iters(numSizes);
+    Array<double,1> points(numSizes);
+    parameters = 20 + 10 * tensor::i;
+    points = pow3(parameters - 4.);
+    iters = 20000000L / points;
+    iters = where(iters < 2, 2, iters);
+    bench.setParameterVector(parameters);
+    bench.setIterations(iters);
+    bench.setOpsPerIteration(points);
+    bench.setParameterDescription("N");
+    bench.setDependentVariable("points");
+    bench.beginBenchmarking();
+
+    bench.beginImplementation("Blitz++ stencil");
+    while (!bench.doneImplementationBenchmark())
     {
-        iterate(V, nextV, P, P_rhs, advect, force);
+        const int N = bench.getParameter();
+        const long nIters = bench.getIterations();
+        cout << bench.currentImplementation() << ": N = " << N << endl;
+
+        setup(N, V, nextV, P, P_rhs, advect, force);
+
+        while (bench.repeat())
+        {
+            bench.start();
+            for (long i=0; i < nIters; ++i)
+            {
+                iterate(V, nextV, P, P_rhs, advect, force);
+            }
+            bench.stop();
+        }
     }
+    bench.endImplementation();
+
+    bench.endBenchmarking();
+    bench.saveMatlabGraph("cfd.m");
 
     return 0;
 }
-
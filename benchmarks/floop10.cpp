@@ -1,5 +1,5 @@
 
-// floop10 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// floop10 generated by makeloops.py Mon Oct 19 00:57:10 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 3 * parameters;
-    iters = 100000000L / flops;
+    bytes = 16 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -158,13 +161,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u+a+b+c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u+a+b+c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -199,13 +205,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u+a+b+c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u+a+b+c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -240,13 +249,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u+a(tensor::i)+b(tensor::i)+c(tensor::i);;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u+a(tensor::i)+b(tensor::i)+c(tensor::i);;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -288,13 +300,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
     initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u+a+b+c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u+a+b+c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -336,13 +351,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
     initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u+a+b+c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u+a+b+c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -377,13 +395,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u+a+b+c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u+a+b+c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -417,10 +438,13 @@ void F77Version(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop10_f77(N, x, a, b, c, u);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop10_f77(N, x, a, b, c, u);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -460,10 +484,13 @@ void F90Version(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop10_f90(N, x, a, b, c, u);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop10_f90(N, x, a, b, c, u);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
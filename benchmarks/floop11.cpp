@@ -1,5 +1,5 @@
 
-// floop11 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// floop11 generated by makeloops.py Mon Oct 19 00:57:10 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 3 * parameters;
-    iters = 100000000L / flops;
+    bytes = 20 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -159,13 +162,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(d.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -202,13 +208,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(d.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -245,13 +254,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(d.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a(tensor::i)+b(tensor::i)+c(tensor::i)+d(tensor::i);;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a(tensor::i)+b(tensor::i)+c(tensor::i)+d(tensor::i);;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -297,13 +309,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(d.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -349,13 +364,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(d.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -392,13 +410,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(d, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -434,10 +455,13 @@ void F77Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(d, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop11_f77(N, x, a, b, c, d);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop11_f77(N, x, a, b, c, d);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -480,10 +504,13 @@ void F90Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(d, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop11_f90(N, x, a, b, c, d);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop11_f90(N, x, a, b, c, d);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -1,5 +1,5 @@
 
-// floop12 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// floop12 generated by makeloops.py Mon Oct 19 00:57:10 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 4 * parameters;
-    iters = 100000000L / flops;
+    bytes = 24 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -162,13 +165,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(d.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = u+a; x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = u+a; x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -207,13 +213,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(d.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = u+a; x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = u+a; x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -252,13 +261,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(d.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = u+a(tensor::i); x = a(tensor::i)+b(tensor::i)+c(tensor::i)+d(tensor::i);;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = u+a(tensor::i); x = a(tensor::i)+b(tensor::i)+c(tensor::i)+d(tensor::i);;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -308,13 +320,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
     initializeRandomDouble(d.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = u+a; x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = u+a; x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -364,13 +379,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
     initializeRandomDouble(d.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = u+a; x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = u+a; x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -409,13 +427,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(d, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = u+a; x = a+b+c+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = u+a; x = a+b+c+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -453,10 +474,13 @@ void F77Version(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(d, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop12_f77(N, y, x, a, b, c, d, u);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop12_f77(N, y, x, a, b, c, d, u);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -502,10 +526,13 @@ void F90Version(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(d, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop12_f90(N, y, x, a, b, c, d, u);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop12_f90(N, y, x, a, b, c, d, u);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -1,5 +1,5 @@
 
-// floop16 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// floop16 generated by makeloops.py Mon Oct 19 00:57:10 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 4 * parameters;
-    iters = 100000000L / flops;
+    bytes = 20 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -160,13 +163,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c; y = x+c+u;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c; y = x+c+u;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -203,13 +209,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c; y = x+c+u;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c; y = x+c+u;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -246,13 +255,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a(tensor::i)+b(tensor::i)+c(tensor::i); y = x(tensor::i)+c(tensor::i)+u;;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a(tensor::i)+b(tensor::i)+c(tensor::i); y = x(tensor::i)+c(tensor::i)+u;;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -298,13 +310,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
     initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c; y = x+c+u;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c; y = x+c+u;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -350,13 +365,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float u)
     initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c; y = x+c+u;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c; y = x+c+u;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -393,13 +411,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a+b+c; y = x+c+u;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a+b+c; y = x+c+u;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -435,10 +456,13 @@ void F77Version(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop16_f77(N, y, x, a, b, c, u);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop16_f77(N, y, x, a, b, c, u);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -481,10 +505,13 @@ void F90Version(BenchmarkExt<int>& bench, float u)
         initializeRandomDouble(c, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop16_f90(N, y, x, a, b, c, u);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop16_f90(N, y, x, a, b, c, u);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
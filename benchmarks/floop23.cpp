@@ -1,5 +1,5 @@
 
-// floop23 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// floop23 generated by makeloops.py Mon Oct 19 00:57:10 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 4 * parameters;
-    iters = 100000000L / flops;
+    bytes = 24 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -161,13 +164,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(y.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b + c*d; y = b+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b + c*d; y = b+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -206,13 +212,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b + c*d; y = b+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b + c*d; y = b+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -251,13 +260,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a(tensor::i)*b(tensor::i) + c(tensor::i)*d(tensor::i); y = b(tensor::i)+d(tensor::i);;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a(tensor::i)*b(tensor::i) + c(tensor::i)*d(tensor::i); y = b(tensor::i)+d(tensor::i);;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -307,13 +319,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b + c*d; y = b+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b + c*d; y = b+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -363,13 +378,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b + c*d; y = b+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b + c*d; y = b+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -408,13 +426,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(y, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b + c*d; y = b+d;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b + c*d; y = b+d;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -452,10 +473,13 @@ void F77Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(y, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop23_f77(N, x, a, b, c, d, y);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop23_f77(N, x, a, b, c, d, y);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -501,10 +525,13 @@ void F90Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(y, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop23_f90(N, x, a, b, c, d, y);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop23_f90(N, x, a, b, c, d, y);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -1,5 +1,5 @@
 
-// floop3 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// floop3 generated by makeloops.py Mon Oct 19 00:57:09 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 2 * parameters;
-    iters = 100000000L / flops;
+    bytes = 12 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -154,13 +157,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float a)
         initializeRandomDouble(y.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = y + a*x;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = y + a*x;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -191,13 +197,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float a)
         initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = y + a*x;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = y + a*x;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -228,13 +237,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float a)
         initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = y(tensor::i) + a*x(tensor::i);;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = y(tensor::i) + a*x(tensor::i);;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -268,13 +280,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float a)
     initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = y + a*x;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = y + a*x;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -308,13 +323,16 @@ void VectorVersion(BenchmarkExt<int>& bench, float a)
     initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = y + a*x;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = y + a*x;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -345,13 +363,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench, float a)
         initializeRandomDouble(y, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            y = y + a*x;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                y = y + a*x;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -381,10 +402,13 @@ void F77Version(BenchmarkExt<int>& bench, float a)
         initializeRandomDouble(y, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop3_f77(N, x, y, a);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop3_f77(N, x, y, a);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -418,10 +442,13 @@ void F90Version(BenchmarkExt<int>& bench, float a)
         initializeRandomDouble(y, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop3_f90(N, x, y, a);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop3_f90(N, x, y, a);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
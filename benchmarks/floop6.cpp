@@ -1,5 +1,5 @@
 
-// floop6 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// floop6 generated by makeloops.py Mon Oct 19 00:57:09 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 1 * parameters;
-    iters = 100000000L / flops;
+    bytes = 12 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -155,13 +158,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(b.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -194,13 +200,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -233,13 +242,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a(tensor::i)*b(tensor::i);;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a(tensor::i)*b(tensor::i);;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -277,13 +289,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -321,13 +336,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -360,13 +378,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(b, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -398,10 +419,13 @@ void F77Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(b, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop6_f77(N, x, a, b);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop6_f77(N, x, a, b);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -438,10 +462,13 @@ void F90Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(b, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            floop6_f90(N, x, a, b);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                floop6_f90(N, x, a, b);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
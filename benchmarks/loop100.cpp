@@ -1,5 +1,5 @@
 
-// loop100 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// loop100 generated by makeloops.py Mon Oct 19 00:57:09 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 18 * parameters;
-    iters = 100000000L / flops;
+    bytes = 40 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -163,13 +166,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w, doubl
         initializeRandomDouble(x.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -206,13 +212,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w, doubl
         initializeRandomDouble(x.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -249,13 +258,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w, doubl
         initializeRandomDouble(x.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x=(1.0-c(tensor::i)*c(tensor::i))/((4*w)*sin(1.0+c(tensor::i)*c(tensor::i)-2*v*c(tensor::i)))*a(tensor::i)*b(tensor::i)*u*exp(-z*d(tensor::i));;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x=(1.0-c(tensor::i)*c(tensor::i))/((4*w)*sin(1.0+c(tensor::i)*c(tensor::i)-2*v*c(tensor::i)))*a(tensor::i)*b(tensor::i)*u*exp(-z*d(tensor::i));;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -301,13 +313,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w, doubl
     initializeRandomDouble(x.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -353,13 +368,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w, doubl
     initializeRandomDouble(x.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -396,13 +414,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench, double u, double v, double w, dou
         initializeRandomDouble(x, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x=(1.0-c*c)/((4*w)*sin(1.0+c*c-2*v*c))*a*b*u*exp(-z*d);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -438,10 +459,13 @@ void F77Version(BenchmarkExt<int>& bench, double u, double v, double w, double z
         initializeRandomDouble(x, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop100_f77(N, a, b, c, d, x, u, v, w, z);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop100_f77(N, a, b, c, d, x, u, v, w, z);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -484,10 +508,13 @@ void F90Version(BenchmarkExt<int>& bench, double u, double v, double w, double z
         initializeRandomDouble(x, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop100_f90(N, a, b, c, d, x, u, v, w, z);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop100_f90(N, a, b, c, d, x, u, v, w, z);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
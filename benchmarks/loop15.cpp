@@ -1,5 +1,5 @@
 
-// loop15 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// loop15 generated by makeloops.py Mon Oct 19 00:57:09 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 3 * parameters;
-    iters = 100000000L / flops;
+    bytes = 32 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -157,13 +160,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(c.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = c + a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = c + a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -198,13 +204,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = c + a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = c + a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -239,13 +248,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = c(tensor::i) + a(tensor::i)*b(tensor::i);;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = c(tensor::i) + a(tensor::i)*b(tensor::i);;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -287,13 +299,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = c + a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = c + a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -335,13 +350,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(c.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = c + a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = c + a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -376,13 +394,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(c, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = c + a*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = c + a*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -416,10 +437,13 @@ void F77Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(c, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop15_f77(N, x, a, b, c);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop15_f77(N, x, a, b, c);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -459,10 +483,13 @@ void F90Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(c, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop15_f90(N, x, a, b, c);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop15_f90(N, x, a, b, c);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -1,5 +1,5 @@
 
-// loop18 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// loop18 generated by makeloops.py Mon Oct 19 00:57:09 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 3 * parameters;
-    iters = 100000000L / flops;
+    bytes = 24 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -157,13 +160,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = (u+a)*(v+b);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = (u+a)*(v+b);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -196,13 +202,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = (u+a)*(v+b);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = (u+a)*(v+b);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -235,13 +244,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = (u+a(tensor::i))*(v+b(tensor::i));;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = (u+a(tensor::i))*(v+b(tensor::i));;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -279,13 +291,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
     initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = (u+a)*(v+b);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = (u+a)*(v+b);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -323,13 +338,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
     initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = (u+a)*(v+b);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = (u+a)*(v+b);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -362,13 +380,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = (u+a)*(v+b);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = (u+a)*(v+b);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -400,10 +421,13 @@ void F77Version(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop18_f77(N, x, a, b, u, v);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop18_f77(N, x, a, b, u, v);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -440,10 +464,13 @@ void F90Version(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop18_f90(N, x, a, b, u, v);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop18_f90(N, x, a, b, u, v);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
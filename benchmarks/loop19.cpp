@@ -1,5 +1,5 @@
 
-// loop19 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// loop19 generated by makeloops.py Mon Oct 19 00:57:09 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 2 * parameters;
-    iters = 100000000L / flops;
+    bytes = 32 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -159,13 +162,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*a; y = v*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*a; y = v*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -200,13 +206,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*a; y = v*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*a; y = v*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -241,13 +250,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*a(tensor::i); y = v*b(tensor::i);;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*a(tensor::i); y = v*b(tensor::i);;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -289,13 +301,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
     initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*a; y = v*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*a; y = v*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -337,13 +352,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v)
     initializeRandomDouble(b.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*a; y = v*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*a; y = v*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -378,13 +396,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*a; y = v*b;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*a; y = v*b;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -418,10 +439,13 @@ void F77Version(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop19_f77(N, y, x, a, b, u, v);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop19_f77(N, y, x, a, b, u, v);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -461,10 +485,13 @@ void F90Version(BenchmarkExt<int>& bench, double u, double v)
         initializeRandomDouble(b, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop19_f90(N, y, x, a, b, u, v);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop19_f90(N, y, x, a, b, u, v);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
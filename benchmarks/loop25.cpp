@@ -1,5 +1,5 @@
 
-// loop25 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// loop25 generated by makeloops.py Mon Oct 19 00:57:09 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 6 * parameters;
-    iters = 100000000L / flops;
+    bytes = 40 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -162,13 +165,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w)
         initializeRandomDouble(y.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*b; y = v*b + w*a + u*c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*b; y = v*b + w*a + u*c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -205,13 +211,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w)
         initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*b; y = v*b + w*a + u*c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*b; y = v*b + w*a + u*c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -248,13 +257,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w)
         initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*b(tensor::i); y = v*b(tensor::i) + w*a(tensor::i) + u*c(tensor::i);;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*b(tensor::i); y = v*b(tensor::i) + w*a(tensor::i) + u*c(tensor::i);;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -300,13 +312,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w)
     initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*b; y = v*b + w*a + u*c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*b; y = v*b + w*a + u*c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -352,13 +367,16 @@ void VectorVersion(BenchmarkExt<int>& bench, double u, double v, double w)
     initializeRandomDouble(y.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*b; y = v*b + w*a + u*c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*b; y = v*b + w*a + u*c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -395,13 +413,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench, double u, double v, double w)
         initializeRandomDouble(y, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = u*b; y = v*b + w*a + u*c;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = u*b; y = v*b + w*a + u*c;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -437,10 +458,13 @@ void F77Version(BenchmarkExt<int>& bench, double u, double v, double w)
         initializeRandomDouble(y, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop25_f77(N, x, a, b, c, y, u, v, w);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop25_f77(N, x, a, b, c, y, u, v, w);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -483,10 +507,13 @@ void F90Version(BenchmarkExt<int>& bench, double u, double v, double w)
         initializeRandomDouble(y, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop25_f90(N, x, a, b, c, y, u, v, w);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop25_f90(N, x, a, b, c, y, u, v, w);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
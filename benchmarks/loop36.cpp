@@ -1,5 +1,5 @@
 
-// loop36 generated by makeloops.py Thu Jun 30 16:44:56 2011
+// loop36 generated by makeloops.py Mon Oct 19 00:57:09 2026
 
 #include <blitz/vector2.h>
 #include <blitz/array.h>
@@ -81,16 +81,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = 1 * parameters;
-    iters = 100000000L / flops;
+    bytes = 16 * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -153,13 +156,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(e.data(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = exp(e);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = exp(e);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -190,13 +196,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(e.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = exp(e);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = exp(e);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -227,13 +236,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(e.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = exp(e(tensor::i));;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = exp(e(tensor::i));;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -267,13 +279,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(e.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = exp(e);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = exp(e);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -307,13 +322,16 @@ void VectorVersion(BenchmarkExt<int>& bench)
     initializeRandomDouble(e.dataFirst(), N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = exp(e);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = exp(e);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -344,13 +362,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench)
         initializeRandomDouble(e, N);
 
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            x = exp(e);
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                x = exp(e);
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -380,10 +401,13 @@ void F77Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(e, N);
         
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop36_f77(N, x, e);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop36_f77(N, x, e);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -417,10 +441,13 @@ void F90Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(e, N);
 
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            loop36_f90(N, x, e);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                loop36_f90(N, x, e);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
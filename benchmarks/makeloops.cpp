@@ -57,6 +57,11 @@ public:
 		return flops_;
 	}
 
+	int bytes() const
+	{
+		return bytes_;
+	}
+
 	int isArray(char c) const
 	{
 		for (int i=0; i < numArrays_; ++i)
@@ -83,6 +88,7 @@ private:
 	char loopBuffer_[bufLen];
 	char loopName_[bufLen];
 	int flops_;
+	int bytes_;
 };
 
 void loop::reset()
@@ -92,6 +98,7 @@ void loop::reset()
 	loopBuffer_[0] = '\0';
 	loopName_[0] = '\0';
 	flops_ = 0;
+	bytes_ = 0;
 }
 
 void loop::parseLoop(istream& is)
@@ -129,6 +136,10 @@ void loop::parseLoop(istream& is)
 			token = strtok(0, whitespace);
 			flops_ = atoi(token);
 			cout << "Flops: " << flops_ << endl;
+		} else if (!strcmp(token, "bytes")) {
+			token = strtok(0, whitespace);
+			bytes_ = atoi(token);
+			cout << "Bytes: " << bytes_ << endl;
 		} else if (!strcmp(token, "loop")) {
 			loopBuffer_[0] = '\0';
 			while (token = strtok(0, whitespace))
@@ -385,6 +396,7 @@ void cppVersion(loop& lp)
 	"    Vector<int> parameters(numSizes);\n"
 	"    Vector<long> iters(numSizes);\n"
 	"    Vector<double> flops(numSizes);\n"
+	"    Vector<double> bytes(numSizes);\n"
 	"\n"
 	"    for (int i=0; i < numSizes; ++i)\n"
 	"    {\n"
@@ -393,11 +405,13 @@ void cppVersion(loop& lp)
 	"        if (iters[i] < 2)\n"
 	"            iters[i] = 2;\n"
 	"        flops[i] = " << lp.flops() << " * parameters[i];\n"
+	"        bytes[i] = " << lp.bytes() << " * parameters[i];\n"
 	"    }\n"
 	"\n"
 	"    bench.setParameterVector(parameters);\n"
 	"    bench.setIterations(iters);\n"
 	"    bench.setOpsPerIteration(flops);\n"
+	"    bench.setBytesPerIteration(bytes);\n"
 	"\n"
 	"    bench.beginBenchmarking();" << endl << endl;
 
@@ -1,7 +1,7 @@
-#include <blitz/tinymat.h>
-#include <blitz/vector.h>
+#include <blitz/array.h>
+#include <blitz/tinymat2.h>
 #include <blitz/benchext.h>
-#include <blitz/rand-uniform.h>
+#include <random/uniform.h>
 
 #ifdef BZ_HAVE_COMPLEX
 
@@ -29,6 +29,18 @@ int QCDFortran77TunedVersion(BenchmarkExt<int>& bench);
 
 void initializeRandomDouble(double* data, int numElements);
 
+typedef TinyMatrix<complex<double>, 3, 2> spinor;
+typedef TinyMatrix<complex<double>, 3, 3> SU3Gauge;
+
+// Product of a gauge field element and a spinor, as in qcdf.f
+inline void product(spinor& res, const SU3Gauge& M, const spinor& src)
+{
+    for (int spin=0; spin < 2; ++spin)
+        for (int col=0; col < 3; ++col)
+            res(col,spin) = M(col,0) * src(0,spin) + M(col,1) * src(1,spin)
+                + M(col,2) * src(2,spin);
+}
+
 int main()
 {
     cout << "Blitz++ QCD Benchmark" << endl
@@ -37,7 +49,21 @@ int main()
 
     BenchmarkExt<int> bench("Lattice QCD Benchmark", 4);
 
-    bench.setRateDescription("Millions of operations/s");
+    // Lattice sizes from 4^4/16 to 16^4 sites, and 132 flops per site
+    const int numSizes = 9;
+    bench.setNumParameters(numSizes);
+    Array<int,1> parameters(numSizes);
+    Array<long,1> iters(numSizes);
+    Array<double,1> flops(numSizes);
+    parameters = pow(2, tensor::i + 4);
+    flops = 132. * parameters;
+    iters = 50000000L / flops;
+    iters = where(iters < 2, 2, iters);
+    bench.setParameterVector(parameters);
+    bench.setIterations(iters);
+    bench.setOpsPerIteration(flops);
+    bench.setParameterDescription("Lattice sites");
+    bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
     QCDBlitzVersion(bench);
@@ -56,9 +82,6 @@ int main()
 
 int QCDBlitzVersion(BenchmarkExt<int>& bench)
 {
-    typedef TinyMatrix<complex<double>, 3, 2> spinor;
-    typedef TinyMatrix<complex<double>, 3, 3> SU3Gauge;
-
     bench.beginImplementation("Blitz++");
 
     while (!bench.doneImplementationBenchmark())
@@ -66,23 +89,24 @@ int QCDBlitzVersion(BenchmarkExt<int>& bench)
         int length = bench.getParameter();
         int iters = (int)bench.getIterations();
 
-cout << "length = " << length << endl;
-
-        Vector<spinor> res(length), src(length);
-        Vector<SU3Gauge> M(length);
+        Array<spinor,1> res(length), src(length);
+        Array<SU3Gauge,1> M(length);
 
-        initializeRandomDouble((double*)src.data(), 
+        initializeRandomDouble((double*)src.dataFirst(), 
             length * sizeof(spinor) / sizeof(double));
-        initializeRandomDouble((double*)M.data(),
+        initializeRandomDouble((double*)M.dataFirst(),
             length * sizeof(SU3Gauge) / sizeof(double));
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            for (int i=0; i < length; ++i)
-                res[i] = product(M[i], src[i]);
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                for (int i=0; i < length; ++i)
+                    product(res(i), M(i), src(i));
+            }
+            bench.stop();
         }
-        bench.stop();
 
         // Time overhead
         bench.startOverhead();
@@ -97,12 +121,9 @@ cout << "length = " << length << endl;
     return 0;
 }
 
-    typedef TinyMatrix<complex<double>, 3, 2> spinor;
-    typedef TinyMatrix<complex<double>, 3, 3> gaugeFieldElement;
-
     struct latticeUnit {
         spinor one;
-        gaugeFieldElement gauge;
+        SU3Gauge gauge;
         spinor two;
     };
 
@@ -115,18 +136,21 @@ int QCDBlitzTunedVersion(BenchmarkExt<int>& bench)
         int length = bench.getParameter();
         int iters = (int)bench.getIterations();
 
-        Vector<latticeUnit> lattice(length);
+        Array<latticeUnit,1> lattice(length);
 
-        initializeRandomDouble((double*)lattice.data(),
+        initializeRandomDouble((double*)lattice.dataFirst(),
             length * sizeof(latticeUnit) / sizeof(double));
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            for (int i=0; i < length; ++i)
-                lattice[i].two = product(lattice[i].gauge, lattice[i].one);
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                for (int i=0; i < length; ++i)
+                    product(lattice(i).two, lattice(i).gauge, lattice(i).one);
+            }
+            bench.stop();
         }
-        bench.stop();
 
         // Time overhead
         bench.startOverhead();
@@ -145,8 +169,6 @@ int QCDFortran77Version(BenchmarkExt<int>& bench)
 {
     // Use Blitz++ library only to allocate space for the
     // arrays. 
-    typedef TinyMatrix<complex<double>, 3, 2> spinor;
-    typedef TinyMatrix<complex<double>, 3, 3> SU3Gauge;
 
     bench.beginImplementation("Fortran 77");
 
@@ -155,17 +177,20 @@ int QCDFortran77Version(BenchmarkExt<int>& bench)
         int length = bench.getParameter();
         int iters = (int)bench.getIterations();
 
-        Vector<spinor> res(length), src(length);
-        Vector<SU3Gauge> M(length);
+        Array<spinor,1> res(length), src(length);
+        Array<SU3Gauge,1> M(length);
 
-        initializeRandomDouble((double*)src.data(),
+        initializeRandomDouble((double*)src.dataFirst(),
             length * sizeof(spinor) / sizeof(double));
-        initializeRandomDouble((double*)M.data(),
+        initializeRandomDouble((double*)M.dataFirst(),
             length * sizeof(SU3Gauge) / sizeof(double));
 
-        bench.start();
-        qcdf(M.data(), res.data(), src.data(), length, iters);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            qcdf(M.dataFirst(), res.dataFirst(), src.dataFirst(), length, iters);
+            bench.stop();
+        }
 
         // Time overhead
         bench.startOverhead();
@@ -184,8 +209,6 @@ int QCDFortran77TunedVersion(BenchmarkExt<int>& bench)
 {
     // Use Blitz++ library only to allocate space for the
     // arrays.
-    typedef TinyMatrix<complex<double>, 3, 2> spinor;
-    typedef TinyMatrix<complex<double>, 3, 3> SU3Gauge;
 
     bench.beginImplementation("Fortran 77 Hand-tuned");
 
@@ -194,17 +217,20 @@ int QCDFortran77TunedVersion(BenchmarkExt<int>& bench)
         int length = bench.getParameter();
         int iters = (int)bench.getIterations();
 
-        Vector<spinor> res(length), src(length);
-        Vector<SU3Gauge> M(length);
+        Array<spinor,1> res(length), src(length);
+        Array<SU3Gauge,1> M(length);
 
-        initializeRandomDouble((double*)src.data(),
+        initializeRandomDouble((double*)src.dataFirst(),
             length * sizeof(spinor) / sizeof(double));
-        initializeRandomDouble((double*)M.data(),
+        initializeRandomDouble((double*)M.dataFirst(),
             length * sizeof(SU3Gauge) / sizeof(double));
 
-        bench.start();
-        qcdf2(M.data(), res.data(), src.data(), length, iters);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            qcdf2(M.dataFirst(), res.dataFirst(), src.dataFirst(), length, iters);
+            bench.stop();
+        }
 
         // Time overhead
         bench.startOverhead();
@@ -224,7 +250,7 @@ void initializeRandomDouble(double* data, int numElements)
     // This is a temporary kludge until I implement random complex
     // numbers.
 
-    static Random<Uniform> rnd;
+    static ranlib::Uniform<double> rnd;
 
     for (int i=0; i < numElements; ++i)
         data[i] = rnd.random();
@@ -232,7 +258,7 @@ void initializeRandomDouble(double* data, int numElements)
 
 #else // BZ_HAVE_COMPLEX
 
-#include <iostream.h>
+#include <iostream>
 
 int main()
 {
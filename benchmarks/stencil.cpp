@@ -3,8 +3,9 @@
 #include <blitz/array.h>
 #include <blitz/traversal.h>
 #include <blitz/benchext.h>
-#include <blitz/rand-uniform.h>
+#include <random/uniform.h>
 #include <blitz/array/stencil-et.h>
+#include <blitz/array/stencil-et-macros.h>
 
 BZ_USING_NAMESPACE(blitz)
 
@@ -49,25 +50,25 @@ int main()
     const int numSizes = 28;
 
     bench.setNumParameters(numSizes);
-    bench.setRateDescription("Mflops/s");
 
-    Vector<int> parameters(numSizes);
-    Vector<long> iters(numSizes);
-    Vector<double> flops(numSizes);
+    Array<int,1> parameters(numSizes);
+    Array<long,1> iters(numSizes);
+    Array<double,1> flops(numSizes);
 
     for (int i=0; i < numSizes; ++i)
     {
-        parameters[i] = (i+1) * 8;
-        iters[i] = 32*8*8*8/(i+1)/(i+1)/(i+1)/4;
-        if (iters[i] < 2)
-            iters[i] = 2;
-        int npoints = parameters[i] - 2;
-        flops[i] = npoints * npoints * npoints * 7 * 2;
+        parameters(i) = (i+1) * 8;
+        iters(i) = 32*8*8*8/(i+1)/(i+1)/(i+1)/4;
+        if (iters(i) < 2)
+            iters(i) = 2;
+        int npoints = parameters(i) - 2;
+        flops(i) = double(npoints) * npoints * npoints * 7 * 2;
     }
 
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setDependentVariable("flops");
 
     bench.beginBenchmarking();
 #ifdef FORTRAN_90
@@ -91,7 +92,7 @@ int main()
 
 void initializeRandomDouble(double* data, int numElements, int stride = 1)
 {
-    static Random<Uniform> rnd;
+    static ranlib::Uniform<double> rnd;
 
     for (int i=0; i < numElements; ++i)
         data[i*stride] = rnd.random();
@@ -117,18 +118,21 @@ void stencilBlitzVersion(BenchmarkExt<int>& bench)
         generateFastTraversalOrder(size);
         double c = 1/7.;
        
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            Range I(1,N-2), J(1,N-2), K(1,N-2);
-
-            A(I,J,K) = c * (B(I,J,K) + B(I+1,J,K) + B(I-1,J,K) + B(I,J+1,K)
-                + B(I,J-1,K) + B(I,J,K+1) + B(I,J,K-1));
-
-            B(I,J,K) = c * (A(I,J,K) + A(I+1,J,K) + A(I-1,J,K) + A(I,J+1,K)
-                + A(I,J-1,K) + A(I,J,K+1) + A(I,J,K-1));
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                Range I(1,N-2), J(1,N-2), K(1,N-2);
+
+                A(I,J,K) = c * (B(I,J,K) + B(I+1,J,K) + B(I-1,J,K) + B(I,J+1,K)
+                    + B(I,J-1,K) + B(I,J,K+1) + B(I,J,K-1));
+
+                B(I,J,K) = c * (A(I,J,K) + A(I+1,J,K) + A(I-1,J,K) + A(I,J+1,K)
+                    + A(I,J-1,K) + A(I,J,K+1) + A(I,J,K-1));
+            }
+            bench.stop();
         }
-        bench.stop();
     }
 
     bench.endImplementation();
@@ -142,7 +146,7 @@ BZ_END_STENCIL_OPERATOR
 BZ_ET_STENCIL(test1, double, double,shape(-1,-1,-1),shape(1,1,1))
 
 BZ_DECLARE_STENCIL2(test1stencil,A,B)
-  A=test1(B);
+  A=test1_stencilop(B);
 BZ_END_STENCIL_WITH_SHAPE(shape(-1,-1,-1),shape(1,1,1))
 
 void stencilBlitzExpressionVersion(BenchmarkExt<int>& bench)
@@ -165,15 +169,18 @@ void stencilBlitzExpressionVersion(BenchmarkExt<int>& bench)
         generateFastTraversalOrder(size);
         double c = 1/7.;
        
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            Range I(1,N-2), J(1,N-2), K(1,N-2);
-	    A(I,J,K) = test1(B);
-
-	    B(I,J,K) = test1(A);
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                Range I(1,N-2), J(1,N-2), K(1,N-2);
+                A(I,J,K) = test1(B);
+
+                B(I,J,K) = test1(A);
+            }
+            bench.stop();
         }
-        bench.stop();
     }
 
     bench.endImplementation();
@@ -199,16 +206,19 @@ void stencilBlitzProductVersion(BenchmarkExt<int>& bench)
         generateFastTraversalOrder(size);
         double c = 1/7.;
        
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            Range I(1,N-2), J(1,N-2), K(1,N-2);
-	    C=B*B;
-	    A(I,J,K) = test1(C);
-	    C=A*A;
-	    B(I,J,K) = test1(C);
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                Range I(1,N-2), J(1,N-2), K(1,N-2);
+                C=B*B;
+                A(I,J,K) = test1(C);
+                C=A*A;
+                B(I,J,K) = test1(C);
+            }
+            bench.stop();
         }
-        bench.stop();
     }
 
     bench.endImplementation();
@@ -234,20 +244,23 @@ void stencilBlitzProductVersion2(BenchmarkExt<int>& bench)
         generateFastTraversalOrder(size);
         double c = 1/7.;
        
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            Range I(1,N-2), J(1,N-2), K(1,N-2);
-	    {
-	      Array<double,3>C(B*B);
-	      A(I,J,K) = test1(C);
-	    }
-	    {
-	      Array<double,3>C(A*A);
-	      B(I,J,K) = test1(C);
-	    }
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                Range I(1,N-2), J(1,N-2), K(1,N-2);
+                {
+                  Array<double,3>C(B*B);
+                  A(I,J,K) = test1(C);
+                }
+                {
+                  Array<double,3>C(A*A);
+                  B(I,J,K) = test1(C);
+                }
+            }
+            bench.stop();
         }
-        bench.stop();
     }
 
     bench.endImplementation();
@@ -273,15 +286,18 @@ void stencilBlitzProductVersion3(BenchmarkExt<int>& bench)
         generateFastTraversalOrder(size);
         double c = 1/7.;
        
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            Range I(1,N-2), J(1,N-2), K(1,N-2);
-	    A(I,J,K) = test1(B*B);
-
-	    B(I,J,K) = test1(A*A);
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                Range I(1,N-2), J(1,N-2), K(1,N-2);
+                A(I,J,K) = test1(B*B);
+
+                B(I,J,K) = test1(A*A);
+            }
+            bench.stop();
         }
-        bench.stop();
     }
 
     bench.endImplementation();
@@ -307,15 +323,18 @@ void stencilBlitzIndexVersion(BenchmarkExt<int>& bench)
         generateFastTraversalOrder(size);
         double c = 1/7.;
        
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            Range I(1,N-2), J(1,N-2), K(1,N-2);
-	    A(I,J,K) = test1(B(tensor::i, tensor::j, tensor::k));
-
-	    B(I,J,K) = test1(A(tensor::i, tensor::j, tensor::k));
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                Range I(1,N-2), J(1,N-2), K(1,N-2);
+                A(I,J,K) = test1(B(tensor::i, tensor::j, tensor::k));
+
+                B(I,J,K) = test1(A(tensor::i, tensor::j, tensor::k));
+            }
+            bench.stop();
         }
-        bench.stop();
     }
 
     bench.endImplementation();
@@ -341,14 +360,17 @@ void stencilBlitzStencilVersion(BenchmarkExt<int>& bench)
         generateFastTraversalOrder(size);
         double c = 1/7.;
        
-	;        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            Range I(1,N-2), J(1,N-2), K(1,N-2);
-	    applyStencil(test1stencil(),A,B);
-	    applyStencil(test1stencil(),B,A);
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                Range I(1,N-2), J(1,N-2), K(1,N-2);
+                applyStencil(test1stencil(),A,B);
+                applyStencil(test1stencil(),B,A);
+            }
+            bench.stop();
         }
-        bench.stop();
     }
 
     bench.endImplementation();
@@ -375,9 +397,12 @@ void stencilFortran77Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(A, arraySize);
         initializeRandomDouble(B, arraySize);
 
-        bench.start();
-        stencilf(A, B, N, iters);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            stencilf(A, B, N, iters);
+            bench.stop();
+        }
 
         delete [] A;
         delete [] B;
@@ -407,9 +432,12 @@ void stencilFortran77VersionTiled(BenchmarkExt<int>& bench)
         initializeRandomDouble(A, arraySize);
         initializeRandomDouble(B, arraySize);
 
-        bench.start();
-        stencilftiled(A, B, N, iters);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            stencilftiled(A, B, N, iters);
+            bench.stop();
+        }
 
         delete [] A;
         delete [] B;
@@ -440,9 +468,12 @@ void stencilFortran90Version(BenchmarkExt<int>& bench)
         initializeRandomDouble(A, arraySize);
         initializeRandomDouble(B, arraySize);
 
-        bench.start();
-        stencilf90(A, B, N, iters);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            stencilf90(A, B, N, iters);
+            bench.stop();
+        }
 
         delete [] A;
         delete [] B;
@@ -22,6 +22,7 @@
 #include <blitz/array/zip.h>        // Zipping multicomponent types
 #include <blitz/array/where.h>      // where(X,Y,Z)
 #include <blitz/array/indirect.h>   // Indirection
+#include <blitz/array/scatter.h>    // Accumulating scatter updates
 #include <blitz/array/stencils.h>   // Stencil objects
 #include <blitz/tinymat2.cc>        // TinyMatrix implementations
 #endif
@@ -0,0 +1,1217 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/batched.h   Batched kernels for arrays of TinyVectors and
+ *                         TinyMatrices
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_BATCHED_H
+#define BZ_ARRAY_BATCHED_H
+
+#ifndef BZ_ARRAY_H
+ #error <blitz/array/batched.h> must be included after <blitz/array.h>
+#endif
+
+#ifdef _OPENMP
+ #include <omp.h>
+#endif
+
+/*
+ * The operations of TinyVector and TinyMatrix are unrolled code for
+ * one object, so a loop over an Array of them computes one object at a
+ * time and the compiler finds little to vectorize in it. The functions
+ * below apply an operation to every element of Arrays of tiny objects
+ * BZ_BATCH_WIDTH objects at a time, one object per lane: each
+ * operation is written as a loop over the lanes doing the operation on
+ * one object, which the compiler vectorizes across the objects,
+ * transposing their components into vector registers. The objects of
+ * strided operands are first copied to local arrays with one row per
+ * component and one column per object.
+ *
+ *   Array<TinyMatrix<double,3,3>,1> A(n), B(n), C(n);
+ *   Array<double,1> d(n);
+ *   batchProduct(C, A, B);        // C(i) = A(i) * B(i)
+ *   batchDeterminant(d, A);       // d(i) = det A(i)
+ *   batchInverse(B, A);           // B(i) = A(i)^-1
+ *
+ * The factorizations and solves of small dense systems, such as those
+ * of block-Jacobi iterations, keep the matrices of W objects in local
+ * arrays with one row of W lanes per element, and do the elimination
+ * with loops over the lanes innermost, BZ_BATCH_SOLVE_WIDTH lanes;
+ * pivots are chosen in each lane with comparisons and selections
+ * rather than branches. The lanes only pay off for small matrices: the
+ * solves and LU factorizations of matrices of more than
+ * BZ_BATCH_SOLVE_MAX_SIZE rows are done one object at a time, with the
+ * pivots chosen by branches, while the Cholesky factorizations, which do
+ * not pivot, always use the lanes:
+ *
+ *   Array<TinyMatrix<double,5,5>,3> A(n,n,n), LU(n,n,n);
+ *   Array<TinyVector<int,5>,3> pivot(n,n,n);
+ *   Array<TinyVector<double,5>,3> x(n,n,n), b(n,n,n);
+ *   batchSolve(x, A, b);          // A(i) x(i) = b(i)
+ *   batchLU(LU, pivot, A);        // P A(i) = L U, once
+ *   batchLUSolve(x, LU, pivot, b);
+ *
+ * The arrays have the same extents, and may have any bases, strides and
+ * storage orders; the objects are taken along the innermost rank of the
+ * first result, and the lines of the arrays are split between OpenMP
+ * threads when there are at least BZ_BATCH_THREADING_THRESHOLD objects.
+ * A result may be one of the operands, but must not overlap them
+ * otherwise.
+ */
+
+BZ_NAMESPACE(blitz)
+
+/** The kernels have the element type T_numtype, the numbers of
+    components of their operands a and b and of their results r and s,
+    and a method compute doing the operation on W objects: component k
+    of the object at lane w of the operand a is a[k*L::aC + w*L::aL],
+    and likewise for b, r and s. The lanes are independent, so that the
+    loops over them vectorize, the compiler transposing the components
+    of W objects into registers of W lanes when the objects are
+    contiguous (L::aC = 1). The kernels are applied to width objects at
+    a time, and those for which readsResult is true read r before
+    writing it. Those for which gathered is true always work on local
+    copies of the objects, even contiguous ones. */
+template<typename T, int N_arg1, int N_arg2, int N_result,
+         int N_result2 = 0, bool N_readsResult = false>
+struct _bz_BatchKernel {
+    typedef T T_numtype;
+    static const int width = BZ_BATCH_WIDTH;
+    static const int argComponents1 = N_arg1, argComponents2 = N_arg2,
+        resultComponents = N_result, result2Components = N_result2;
+    static const bool readsResult = N_readsResult;
+    static const bool gathered = false;
+};
+
+// The layout of operands copied to local arrays, one row of W lanes
+// per component,
+template<int W>
+struct _bz_BatchLocal {
+    static const int aC = W, aL = 1, bC = W, bL = 1, rC = W, rL = 1,
+        sC = W, sL = 1;
+};
+
+// and of operands left in place, made of objects of the given numbers
+// of components.
+template<int N_a, int N_b, int N_r, int N_s>
+struct _bz_BatchObjects {
+    static const int aC = 1, aL = N_a, bC = 1, bL = N_b, rC = 1, rL = N_r,
+        sC = 1, sL = N_s;
+};
+
+// component k of the lane w of the operand p
+#define BZ_BATCH_LANE(p, k) p[(k)*L::p##C + w*L::p##L]
+
+// cross product of TinyVectors of length 3. In place, the components
+// of the lanes are 3 apart, which the compiler transposes slowly into
+// wide vectors; the copies have one row per component.
+template<typename T>
+struct _bz_BatchCross : public _bz_BatchKernel<T, 3, 3, 3> {
+
+    static const bool gathered = true;
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b* restrict b,
+        T_r* restrict r, T_s*)
+    {
+        for (int w=0; w < W; ++w)
+        {
+            BZ_BATCH_LANE(r, 0) = BZ_BATCH_LANE(a, 1) * BZ_BATCH_LANE(b, 2)
+                - BZ_BATCH_LANE(a, 2) * BZ_BATCH_LANE(b, 1);
+            BZ_BATCH_LANE(r, 1) = BZ_BATCH_LANE(a, 2) * BZ_BATCH_LANE(b, 0)
+                - BZ_BATCH_LANE(a, 0) * BZ_BATCH_LANE(b, 2);
+            BZ_BATCH_LANE(r, 2) = BZ_BATCH_LANE(a, 0) * BZ_BATCH_LANE(b, 1)
+                - BZ_BATCH_LANE(a, 1) * BZ_BATCH_LANE(b, 0);
+        }
+    }
+};
+
+// dot product of TinyVectors of length N
+template<typename T, int N>
+struct _bz_BatchDot : public _bz_BatchKernel<T, N, N, 1> {
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b* restrict b,
+        T_r* restrict r, T_s*)
+    {
+        for (int w=0; w < W; ++w)
+        {
+            T x = BZ_BATCH_LANE(a, 0) * BZ_BATCH_LANE(b, 0);
+            for (int k=1; k < N; ++k)
+                x += BZ_BATCH_LANE(a, k) * BZ_BATCH_LANE(b, k);
+            BZ_BATCH_LANE(r, 0) = x;
+        }
+    }
+};
+
+// product of an N x K and a K x M TinyMatrix, or of an N x K
+// TinyMatrix and a TinyVector of length K when M is 1: the components
+// of a TinyMatrix are stored by rows, and those of a TinyVector are a
+// column.
+template<typename T, int N, int K, int M>
+struct _bz_BatchProduct : public _bz_BatchKernel<T, N*K, K*M, N*M> {
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b* restrict b,
+        T_r* restrict r, T_s*)
+    {
+        for (int i=0; i < N; ++i)
+            for (int j=0; j < M; ++j)
+                for (int w=0; w < W; ++w)
+                {
+                    T x = BZ_BATCH_LANE(a, i*K) * BZ_BATCH_LANE(b, j);
+                    for (int k=1; k < K; ++k)
+                        x += BZ_BATCH_LANE(a, i*K + k)
+                            * BZ_BATCH_LANE(b, k*M + j);
+                    BZ_BATCH_LANE(r, i*M + j) = x;
+                }
+    }
+};
+
+// determinant and inverse of an N x N TinyMatrix, for N = 2, 3 and 4,
+// by cofactors. The inverse of a singular matrix has infinite or NaN
+// components.
+template<typename T, int N>
+struct _bz_BatchDeterminant;
+
+template<typename T, int N>
+struct _bz_BatchInverse;
+
+template<typename T>
+struct _bz_BatchDeterminant<T,2> : public _bz_BatchKernel<T, 4, 0, 1> {
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s*)
+    {
+        for (int w=0; w < W; ++w)
+            BZ_BATCH_LANE(r, 0) = BZ_BATCH_LANE(a, 0) * BZ_BATCH_LANE(a, 3)
+                - BZ_BATCH_LANE(a, 1) * BZ_BATCH_LANE(a, 2);
+    }
+};
+
+template<typename T>
+struct _bz_BatchInverse<T,2> : public _bz_BatchKernel<T, 4, 0, 4> {
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s*)
+    {
+        for (int w=0; w < W; ++w)
+        {
+            const T a00 = BZ_BATCH_LANE(a, 0), a01 = BZ_BATCH_LANE(a, 1),
+                a10 = BZ_BATCH_LANE(a, 2), a11 = BZ_BATCH_LANE(a, 3);
+            const T s = T(1) / (a00 * a11 - a01 * a10);
+            BZ_BATCH_LANE(r, 0) = a11 * s;
+            BZ_BATCH_LANE(r, 1) = -a01 * s;
+            BZ_BATCH_LANE(r, 2) = -a10 * s;
+            BZ_BATCH_LANE(r, 3) = a00 * s;
+        }
+    }
+};
+
+template<typename T>
+struct _bz_BatchDeterminant<T,3> : public _bz_BatchKernel<T, 9, 0, 1> {
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s*)
+    {
+        for (int w=0; w < W; ++w)
+            BZ_BATCH_LANE(r, 0) = BZ_BATCH_LANE(a, 0) * (BZ_BATCH_LANE(a, 4)
+                    * BZ_BATCH_LANE(a, 8) - BZ_BATCH_LANE(a, 5)
+                    * BZ_BATCH_LANE(a, 7))
+                + BZ_BATCH_LANE(a, 1) * (BZ_BATCH_LANE(a, 5)
+                    * BZ_BATCH_LANE(a, 6) - BZ_BATCH_LANE(a, 3)
+                    * BZ_BATCH_LANE(a, 8))
+                + BZ_BATCH_LANE(a, 2) * (BZ_BATCH_LANE(a, 3)
+                    * BZ_BATCH_LANE(a, 7) - BZ_BATCH_LANE(a, 4)
+                    * BZ_BATCH_LANE(a, 6));
+    }
+};
+
+template<typename T>
+struct _bz_BatchInverse<T,3> : public _bz_BatchKernel<T, 9, 0, 9> {
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s*)
+    {
+        for (int w=0; w < W; ++w)
+        {
+            const T a00 = BZ_BATCH_LANE(a, 0), a01 = BZ_BATCH_LANE(a, 1),
+                a02 = BZ_BATCH_LANE(a, 2), a10 = BZ_BATCH_LANE(a, 3),
+                a11 = BZ_BATCH_LANE(a, 4), a12 = BZ_BATCH_LANE(a, 5),
+                a20 = BZ_BATCH_LANE(a, 6), a21 = BZ_BATCH_LANE(a, 7),
+                a22 = BZ_BATCH_LANE(a, 8);
+            // the cofactors of the first column
+            const T c00 = a11 * a22 - a12 * a21,
+                c10 = a12 * a20 - a10 * a22,
+                c20 = a10 * a21 - a11 * a20;
+            const T s = T(1) / (a00 * c00 + a01 * c10 + a02 * c20);
+            BZ_BATCH_LANE(r, 0) = c00 * s;
+            BZ_BATCH_LANE(r, 1) = (a02 * a21 - a01 * a22) * s;
+            BZ_BATCH_LANE(r, 2) = (a01 * a12 - a02 * a11) * s;
+            BZ_BATCH_LANE(r, 3) = c10 * s;
+            BZ_BATCH_LANE(r, 4) = (a00 * a22 - a02 * a20) * s;
+            BZ_BATCH_LANE(r, 5) = (a02 * a10 - a00 * a12) * s;
+            BZ_BATCH_LANE(r, 6) = c20 * s;
+            BZ_BATCH_LANE(r, 7) = (a01 * a20 - a00 * a21) * s;
+            BZ_BATCH_LANE(r, 8) = (a00 * a11 - a01 * a10) * s;
+        }
+    }
+};
+
+// The 4 x 4 determinant and inverse use the 2 x 2 minors of the first
+// two rows (s) and of the last two rows (c).
+template<typename T>
+struct _bz_BatchDeterminant<T,4> : public _bz_BatchKernel<T, 16, 0, 1> {
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s*)
+    {
+        for (int w=0; w < W; ++w)
+        {
+            const T s0 = BZ_BATCH_LANE(a, 0) * BZ_BATCH_LANE(a, 5)
+                - BZ_BATCH_LANE(a, 4) * BZ_BATCH_LANE(a, 1);
+            const T s1 = BZ_BATCH_LANE(a, 0) * BZ_BATCH_LANE(a, 6)
+                - BZ_BATCH_LANE(a, 4) * BZ_BATCH_LANE(a, 2);
+            const T s2 = BZ_BATCH_LANE(a, 0) * BZ_BATCH_LANE(a, 7)
+                - BZ_BATCH_LANE(a, 4) * BZ_BATCH_LANE(a, 3);
+            const T s3 = BZ_BATCH_LANE(a, 1) * BZ_BATCH_LANE(a, 6)
+                - BZ_BATCH_LANE(a, 5) * BZ_BATCH_LANE(a, 2);
+            const T s4 = BZ_BATCH_LANE(a, 1) * BZ_BATCH_LANE(a, 7)
+                - BZ_BATCH_LANE(a, 5) * BZ_BATCH_LANE(a, 3);
+            const T s5 = BZ_BATCH_LANE(a, 2) * BZ_BATCH_LANE(a, 7)
+                - BZ_BATCH_LANE(a, 6) * BZ_BATCH_LANE(a, 3);
+            const T c5 = BZ_BATCH_LANE(a, 10) * BZ_BATCH_LANE(a, 15)
+                - BZ_BATCH_LANE(a, 14) * BZ_BATCH_LANE(a, 11);
+            const T c4 = BZ_BATCH_LANE(a, 9) * BZ_BATCH_LANE(a, 15)
+                - BZ_BATCH_LANE(a, 13) * BZ_BATCH_LANE(a, 11);
+            const T c3 = BZ_BATCH_LANE(a, 9) * BZ_BATCH_LANE(a, 14)
+                - BZ_BATCH_LANE(a, 13) * BZ_BATCH_LANE(a, 10);
+            const T c2 = BZ_BATCH_LANE(a, 8) * BZ_BATCH_LANE(a, 15)
+                - BZ_BATCH_LANE(a, 12) * BZ_BATCH_LANE(a, 11);
+            const T c1 = BZ_BATCH_LANE(a, 8) * BZ_BATCH_LANE(a, 14)
+                - BZ_BATCH_LANE(a, 12) * BZ_BATCH_LANE(a, 10);
+            const T c0 = BZ_BATCH_LANE(a, 8) * BZ_BATCH_LANE(a, 13)
+                - BZ_BATCH_LANE(a, 12) * BZ_BATCH_LANE(a, 9);
+            BZ_BATCH_LANE(r, 0) = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1
+                + s5 * c0;
+        }
+    }
+};
+
+template<typename T>
+struct _bz_BatchInverse<T,4> : public _bz_BatchKernel<T, 16, 0, 16> {
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s*)
+    {
+        for (int w=0; w < W; ++w)
+        {
+            const T a00 = BZ_BATCH_LANE(a, 0), a01 = BZ_BATCH_LANE(a, 1),
+                a02 = BZ_BATCH_LANE(a, 2), a03 = BZ_BATCH_LANE(a, 3),
+                a10 = BZ_BATCH_LANE(a, 4), a11 = BZ_BATCH_LANE(a, 5),
+                a12 = BZ_BATCH_LANE(a, 6), a13 = BZ_BATCH_LANE(a, 7),
+                a20 = BZ_BATCH_LANE(a, 8), a21 = BZ_BATCH_LANE(a, 9),
+                a22 = BZ_BATCH_LANE(a, 10), a23 = BZ_BATCH_LANE(a, 11),
+                a30 = BZ_BATCH_LANE(a, 12), a31 = BZ_BATCH_LANE(a, 13),
+                a32 = BZ_BATCH_LANE(a, 14), a33 = BZ_BATCH_LANE(a, 15);
+            const T s0 = a00 * a11 - a10 * a01, s1 = a00 * a12 - a10 * a02,
+                s2 = a00 * a13 - a10 * a03, s3 = a01 * a12 - a11 * a02,
+                s4 = a01 * a13 - a11 * a03, s5 = a02 * a13 - a12 * a03;
+            const T c5 = a22 * a33 - a32 * a23, c4 = a21 * a33 - a31 * a23,
+                c3 = a21 * a32 - a31 * a22, c2 = a20 * a33 - a30 * a23,
+                c1 = a20 * a32 - a30 * a22, c0 = a20 * a31 - a30 * a21;
+            const T s = T(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2
+                - s4 * c1 + s5 * c0);
+            BZ_BATCH_LANE(r, 0) = (a11 * c5 - a12 * c4 + a13 * c3) * s;
+            BZ_BATCH_LANE(r, 1) = (-a01 * c5 + a02 * c4 - a03 * c3) * s;
+            BZ_BATCH_LANE(r, 2) = (a31 * s5 - a32 * s4 + a33 * s3) * s;
+            BZ_BATCH_LANE(r, 3) = (-a21 * s5 + a22 * s4 - a23 * s3) * s;
+            BZ_BATCH_LANE(r, 4) = (-a10 * c5 + a12 * c2 - a13 * c1) * s;
+            BZ_BATCH_LANE(r, 5) = (a00 * c5 - a02 * c2 + a03 * c1) * s;
+            BZ_BATCH_LANE(r, 6) = (-a30 * s5 + a32 * s2 - a33 * s1) * s;
+            BZ_BATCH_LANE(r, 7) = (a20 * s5 - a22 * s2 + a23 * s1) * s;
+            BZ_BATCH_LANE(r, 8) = (a10 * c4 - a11 * c2 + a13 * c0) * s;
+            BZ_BATCH_LANE(r, 9) = (-a00 * c4 + a01 * c2 - a03 * c0) * s;
+            BZ_BATCH_LANE(r, 10) = (a30 * s4 - a31 * s2 + a33 * s0) * s;
+            BZ_BATCH_LANE(r, 11) = (-a20 * s4 + a21 * s2 - a23 * s0) * s;
+            BZ_BATCH_LANE(r, 12) = (-a10 * c3 + a11 * c1 - a12 * c0) * s;
+            BZ_BATCH_LANE(r, 13) = (a00 * c3 - a01 * c1 + a02 * c0) * s;
+            BZ_BATCH_LANE(r, 14) = (-a30 * s3 + a31 * s1 - a32 * s0) * s;
+            BZ_BATCH_LANE(r, 15) = (a20 * s3 - a21 * s1 + a22 * s0) * s;
+        }
+    }
+};
+
+// element (i,j) of the lane w of a local N x N_columns matrix m of W
+// lanes
+#define BZ_BATCH_ELEMENT(m, i, j) m[((i)*N_columns + (j))*W + w]
+
+/* The modulus used to choose the pivots and the Jacobi rotations.
+   This is fabs, so the batched solvers, inverses and eigensolvers are
+   for real T only: complex T is not supported. */
+template<typename T>
+inline T _bz_batchAbs(T x)
+{
+    return BZ_MATHFN_SCOPE(fabs)(x);
+}
+
+/** The number of objects the kernels which pivot work on at a time:
+    BZ_BATCH_SOLVE_WIDTH lanes for matrices of up to
+    BZ_BATCH_SOLVE_MAX_SIZE rows, and one object for larger ones, for
+    which the lanes are slower. */
+template<int N>
+struct _bz_batchPivotedWidth {
+    static const int value = N <= BZ_BATCH_SOLVE_MAX_SIZE
+        ? BZ_BATCH_SOLVE_WIDTH : 1;
+};
+
+/** Brings the element of largest modulus of column k of the N x
+    N_columns matrix m of one object to row k, by exchanging the rows,
+    and the pivots p with them when p is not null. One object has no
+    lanes to keep together, so the pivot row is found with branches and
+    exchanged once. */
+template<typename T, int N, int N_columns>
+inline void _bz_batchPivot(T* restrict m, T* restrict p, int k)
+{
+    int row = k;
+    T largest = _bz_batchAbs(m[k*N_columns + k]);
+    for (int i=k+1; i < N; ++i)
+        if (_bz_batchAbs(m[i*N_columns + k]) > largest)
+        {
+            row = i;
+            largest = _bz_batchAbs(m[i*N_columns + k]);
+        }
+    if (row == k)
+        return;
+
+    for (int j=p ? 0 : k; j < N_columns; ++j)
+    {
+        const T x = m[k*N_columns + j];
+        m[k*N_columns + j] = m[row*N_columns + j];
+        m[row*N_columns + j] = x;
+    }
+    if (p)
+    {
+        const T x = p[k];
+        p[k] = p[row];
+        p[row] = x;
+    }
+}
+
+/** LU factorization with partial pivoting of the N x N_columns
+    matrices of W lanes m, the columns past N being right-hand sides
+    eliminated along. The element of largest modulus of column k is
+    brought to row k by exchanging row k with each row below it which
+    has a larger element, with selections rather than branches (by
+    _bz_batchPivot for one object). When p is not null, it follows the
+    exchanges from 0, 1, ... N-1 in each lane, and the multipliers left
+    below the diagonal are exchanged with the rows; otherwise they are
+    only the by-products of the elimination. */
+template<typename T, int N, int N_columns, int W>
+inline void _bz_batchEliminate(T* restrict m, T* restrict p)
+{
+    for (int k=0; k < N; ++k)
+    {
+        if (W == 1)
+            _bz_batchPivot<T,N,N_columns>(m, p, k);
+        else
+        {
+            for (int i=k+1; i < N; ++i)
+            {
+                // the comparison is repeated in the loops, where it
+                // vectorizes better than a stored mask
+                T x0[W], y0[W];
+                for (int w=0; w < W; ++w)
+                {
+                    x0[w] = _bz_batchAbs(BZ_BATCH_ELEMENT(m, k, k));
+                    y0[w] = _bz_batchAbs(BZ_BATCH_ELEMENT(m, i, k));
+                }
+                for (int j=p ? 0 : k; j < N_columns; ++j)
+                    for (int w=0; w < W; ++w)
+                    {
+                        const T x = BZ_BATCH_ELEMENT(m, k, j),
+                            y = BZ_BATCH_ELEMENT(m, i, j);
+                        BZ_BATCH_ELEMENT(m, k, j) = y0[w] > x0[w] ? y : x;
+                        BZ_BATCH_ELEMENT(m, i, j) = y0[w] > x0[w] ? x : y;
+                    }
+                if (p)
+                    for (int w=0; w < W; ++w)
+                    {
+                        const T x = p[k*W + w], y = p[i*W + w];
+                        p[k*W + w] = y0[w] > x0[w] ? y : x;
+                        p[i*W + w] = y0[w] > x0[w] ? x : y;
+                    }
+            }
+        }
+
+        T pivot[W];
+        for (int w=0; w < W; ++w)
+            pivot[w] = T(1) / BZ_BATCH_ELEMENT(m, k, k);
+        for (int i=k+1; i < N; ++i)
+        {
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_ELEMENT(m, i, k) *= pivot[w];
+            for (int j=k+1; j < N_columns; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(m, i, j) -= BZ_BATCH_ELEMENT(m, i, k)
+                        * BZ_BATCH_ELEMENT(m, k, j);
+        }
+    }
+}
+
+/** Replaces the columns past N of the N x N_columns matrices of W
+    lanes m by the solutions of U x = column, U being the upper
+    triangle of the first N columns. */
+template<typename T, int N, int N_columns, int W>
+inline void _bz_batchBackSubstitute(T* restrict m)
+{
+    T diagonal[N * W];
+    for (int i=0; i < N; ++i)
+        for (int w=0; w < W; ++w)
+            diagonal[i*W + w] = T(1) / BZ_BATCH_ELEMENT(m, i, i);
+
+    for (int c=N; c < N_columns; ++c)
+        for (int i=N-1; i >= 0; --i)
+        {
+            for (int j=i+1; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(m, i, c) -= BZ_BATCH_ELEMENT(m, i, j)
+                        * BZ_BATCH_ELEMENT(m, j, c);
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_ELEMENT(m, i, c) *= diagonal[i*W + w];
+        }
+}
+
+/** Solution of a x = b, by LU factorization with partial pivoting of
+    the matrix a extended with the column b. */
+template<typename T, int N>
+struct _bz_BatchSolve : public _bz_BatchKernel<T, N*N, N, N> {
+
+    static const int width = _bz_batchPivotedWidth<N>::value;
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b* restrict b,
+        T_r* restrict r, T_s*)
+    {
+        const int N_columns = N + 1;
+        T m[N * N_columns * W];
+        for (int i=0; i < N; ++i)
+        {
+            for (int j=0; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(m, i, j) = BZ_BATCH_LANE(a, i*N + j);
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_ELEMENT(m, i, N) = BZ_BATCH_LANE(b, i);
+        }
+
+        _bz_batchEliminate<T,N,N_columns,W>(m, static_cast<T*>(0));
+        _bz_batchBackSubstitute<T,N,N_columns,W>(m);
+
+        for (int i=0; i < N; ++i)
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_LANE(r, i) = BZ_BATCH_ELEMENT(m, i, N);
+    }
+};
+
+/** LU factorization with partial pivoting: r holds the multipliers of
+    the unit lower triangle L below the diagonal and the upper triangle
+    U, and s the pivots, row i of P a = L U being row s(i) of a. */
+template<typename T, int N>
+struct _bz_BatchLU : public _bz_BatchKernel<T, N*N, 0, N*N, N> {
+
+    static const int width = _bz_batchPivotedWidth<N>::value;
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s* restrict s)
+    {
+        const int N_columns = N;
+        T m[N * N * W], p[N * W];
+        for (int i=0; i < N; ++i)
+        {
+            for (int j=0; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(m, i, j) = BZ_BATCH_LANE(a, i*N + j);
+            for (int w=0; w < W; ++w)
+                p[i*W + w] = i;
+        }
+
+        _bz_batchEliminate<T,N,N_columns,W>(m, p);
+
+        for (int i=0; i < N; ++i)
+        {
+            for (int j=0; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_LANE(r, i*N + j) = BZ_BATCH_ELEMENT(m, i, j);
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_LANE(s, i) = T_s(p[i*W + w]);
+        }
+    }
+};
+
+/** Solution of a x = r in place, from the LU factorization a and the
+    pivots b of _bz_BatchLU. */
+template<typename T, int N>
+struct _bz_BatchLUSolve : public _bz_BatchKernel<T, N*N, N, N, 0, true> {
+
+    static const int width = _bz_batchPivotedWidth<N>::value;
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b* restrict b,
+        T_r* restrict r, T_s*)
+    {
+        const int N_columns = N + 1;
+        T m[N * N_columns * W];
+        for (int i=0; i < N; ++i)
+        {
+            for (int j=0; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(m, i, j) = BZ_BATCH_LANE(a, i*N + j);
+            // row i of P r, selected rather than indexed
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_ELEMENT(m, i, N) = 0;
+            for (int j=0; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                    if (BZ_BATCH_LANE(b, i) == j)
+                        BZ_BATCH_ELEMENT(m, i, N) = BZ_BATCH_LANE(r, j);
+        }
+
+        // L y = P r, then U x = y
+        for (int i=1; i < N; ++i)
+            for (int j=0; j < i; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(m, i, N) -= BZ_BATCH_ELEMENT(m, i, j)
+                        * BZ_BATCH_ELEMENT(m, j, N);
+        _bz_batchBackSubstitute<T,N,N_columns,W>(m);
+
+        for (int i=0; i < N; ++i)
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_LANE(r, i) = BZ_BATCH_ELEMENT(m, i, N);
+    }
+};
+
+// inverse of an N x N matrix for N other than 2, 3 and 4: the LU
+// factorization of a extended with the identity, and the solutions for
+// its columns
+template<typename T, int N>
+struct _bz_BatchInverse : public _bz_BatchKernel<T, N*N, 0, N*N> {
+
+    static const int width = _bz_batchPivotedWidth<N>::value;
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s*)
+    {
+        const int N_columns = 2 * N;
+        T m[N * N_columns * W];
+        for (int i=0; i < N; ++i)
+            for (int j=0; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                {
+                    BZ_BATCH_ELEMENT(m, i, j) = BZ_BATCH_LANE(a, i*N + j);
+                    BZ_BATCH_ELEMENT(m, i, N + j) = (i == j);
+                }
+
+        _bz_batchEliminate<T,N,N_columns,W>(m, static_cast<T*>(0));
+        _bz_batchBackSubstitute<T,N,N_columns,W>(m);
+
+        for (int i=0; i < N; ++i)
+            for (int j=0; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_LANE(r, i*N + j) = BZ_BATCH_ELEMENT(m, i, N + j);
+    }
+};
+
+/** Cholesky factorization a = r r^T of a symmetric positive definite
+    matrix, of which only the lower triangle is read. r is lower
+    triangular; a matrix which is not positive definite gives NaN
+    elements. */
+template<typename T, int N>
+struct _bz_BatchCholesky : public _bz_BatchKernel<T, N*N, 0, N*N> {
+
+    static const int width = BZ_BATCH_SOLVE_WIDTH;
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s*)
+    {
+        const int N_columns = N;
+        T l[N * N * W];
+        for (int j=0; j < N; ++j)
+        {
+            T diagonal[W];
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_ELEMENT(l, j, j) = BZ_BATCH_LANE(a, j*N + j);
+            for (int k=0; k < j; ++k)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(l, j, j) -= BZ_BATCH_ELEMENT(l, j, k)
+                        * BZ_BATCH_ELEMENT(l, j, k);
+            for (int w=0; w < W; ++w)
+            {
+                BZ_BATCH_ELEMENT(l, j, j) =
+                    BZ_MATHFN_SCOPE(sqrt)(BZ_BATCH_ELEMENT(l, j, j));
+                diagonal[w] = T(1) / BZ_BATCH_ELEMENT(l, j, j);
+            }
+
+            for (int i=j+1; i < N; ++i)
+            {
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(l, i, j) = BZ_BATCH_LANE(a, i*N + j);
+                for (int k=0; k < j; ++k)
+                    for (int w=0; w < W; ++w)
+                        BZ_BATCH_ELEMENT(l, i, j) -= BZ_BATCH_ELEMENT(l, i, k)
+                            * BZ_BATCH_ELEMENT(l, j, k);
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(l, i, j) *= diagonal[w];
+            }
+        }
+
+        for (int i=0; i < N; ++i)
+            for (int j=0; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_LANE(r, i*N + j) =
+                        j <= i ? BZ_BATCH_ELEMENT(l, i, j) : T(0);
+    }
+};
+
+/** Solution of a a^T x = b, a being the Cholesky factor of
+    _bz_BatchCholesky. */
+template<typename T, int N>
+struct _bz_BatchCholeskySolve : public _bz_BatchKernel<T, N*N, N, N> {
+
+    static const int width = BZ_BATCH_SOLVE_WIDTH;
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b* restrict b,
+        T_r* restrict r, T_s*)
+    {
+        const int N_columns = N;
+        T l[N * N * W], y[N * W], diagonal[N * W];
+        for (int i=0; i < N; ++i)
+        {
+            for (int j=0; j <= i; ++j)
+                for (int w=0; w < W; ++w)
+                    BZ_BATCH_ELEMENT(l, i, j) = BZ_BATCH_LANE(a, i*N + j);
+            for (int w=0; w < W; ++w)
+            {
+                y[i*W + w] = BZ_BATCH_LANE(b, i);
+                diagonal[i*W + w] = T(1) / BZ_BATCH_ELEMENT(l, i, i);
+            }
+        }
+
+        for (int i=0; i < N; ++i)
+        {
+            for (int j=0; j < i; ++j)
+                for (int w=0; w < W; ++w)
+                    y[i*W + w] -= BZ_BATCH_ELEMENT(l, i, j) * y[j*W + w];
+            for (int w=0; w < W; ++w)
+                y[i*W + w] *= diagonal[i*W + w];
+        }
+        for (int i=N-1; i >= 0; --i)
+        {
+            for (int j=i+1; j < N; ++j)
+                for (int w=0; w < W; ++w)
+                    y[i*W + w] -= BZ_BATCH_ELEMENT(l, j, i) * y[j*W + w];
+            for (int w=0; w < W; ++w)
+                y[i*W + w] *= diagonal[i*W + w];
+        }
+
+        for (int i=0; i < N; ++i)
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_LANE(r, i) = y[i*W + w];
+    }
+};
+
+/** Eigenvalues r, in increasing order, and eigenvectors s, as columns,
+    of a symmetric 3x3 matrix, by cyclic Jacobi rotations, all lanes
+    doing the same number of sweeps: until the off-diagonal elements of
+    every lane are negligible. */
+template<typename T>
+struct _bz_BatchSymmetricEigen : public _bz_BatchKernel<T, 9, 0, 3, 9> {
+
+    static const int width = BZ_BATCH_SOLVE_WIDTH;
+
+    static const int maxSweeps = 16;
+
+    // the rotation annihilating element (p,q) of m, applied to the
+    // columns of v
+    template<int W>
+    static void rotate(T* restrict m, T* restrict v, int p, int q)
+    {
+        const int N_columns = 3;
+        for (int w=0; w < W; ++w)
+        {
+            const T apq = BZ_BATCH_ELEMENT(m, p, q);
+            const bool zero = (apq == 0);
+            const T theta = (BZ_BATCH_ELEMENT(m, q, q)
+                - BZ_BATCH_ELEMENT(m, p, p)) / (zero ? T(1) : 2 * apq);
+            T t = (theta < 0 ? T(-1) : T(1)) / (_bz_batchAbs(theta)
+                + BZ_MATHFN_SCOPE(sqrt)(theta * theta + 1));
+            t = zero ? T(0) : t;
+            const T c = T(1) / BZ_MATHFN_SCOPE(sqrt)(t * t + 1), s = t * c;
+
+            for (int k=0; k < 3; ++k)
+            {
+                const T x = BZ_BATCH_ELEMENT(m, k, p),
+                    y = BZ_BATCH_ELEMENT(m, k, q);
+                BZ_BATCH_ELEMENT(m, k, p) = c * x - s * y;
+                BZ_BATCH_ELEMENT(m, k, q) = s * x + c * y;
+            }
+            for (int k=0; k < 3; ++k)
+            {
+                const T x = BZ_BATCH_ELEMENT(m, p, k),
+                    y = BZ_BATCH_ELEMENT(m, q, k);
+                BZ_BATCH_ELEMENT(m, p, k) = c * x - s * y;
+                BZ_BATCH_ELEMENT(m, q, k) = s * x + c * y;
+            }
+            BZ_BATCH_ELEMENT(m, p, q) = BZ_BATCH_ELEMENT(m, q, p) = 0;
+            for (int k=0; k < 3; ++k)
+            {
+                const T x = BZ_BATCH_ELEMENT(v, k, p),
+                    y = BZ_BATCH_ELEMENT(v, k, q);
+                BZ_BATCH_ELEMENT(v, k, p) = c * x - s * y;
+                BZ_BATCH_ELEMENT(v, k, q) = s * x + c * y;
+            }
+        }
+    }
+
+    // puts the eigenvalues p and q in increasing order
+    template<int W>
+    static void order(T* restrict m, T* restrict v, int p, int q)
+    {
+        const int N_columns = 3;
+        for (int w=0; w < W; ++w)
+        {
+            const bool swap = BZ_BATCH_ELEMENT(m, p, p)
+                > BZ_BATCH_ELEMENT(m, q, q);
+            const T x = BZ_BATCH_ELEMENT(m, p, p),
+                y = BZ_BATCH_ELEMENT(m, q, q);
+            BZ_BATCH_ELEMENT(m, p, p) = swap ? y : x;
+            BZ_BATCH_ELEMENT(m, q, q) = swap ? x : y;
+            for (int k=0; k < 3; ++k)
+            {
+                const T x = BZ_BATCH_ELEMENT(v, k, p),
+                    y = BZ_BATCH_ELEMENT(v, k, q);
+                BZ_BATCH_ELEMENT(v, k, p) = swap ? y : x;
+                BZ_BATCH_ELEMENT(v, k, q) = swap ? x : y;
+            }
+        }
+    }
+
+    template<int W, typename L, typename T_a, typename T_b, typename T_r,
+             typename T_s>
+    static void compute(const T_a* restrict a, const T_b*, T_r* restrict r,
+        T_s* restrict s)
+    {
+        const int N_columns = 3;
+        const T eps = std::numeric_limits<T>::epsilon();
+        T m[9 * W], v[9 * W];
+        for (int k=0; k < 9; ++k)
+            for (int w=0; w < W; ++w)
+            {
+                m[k*W + w] = BZ_BATCH_LANE(a, k);
+                v[k*W + w] = (k % 4 == 0);
+            }
+
+        for (int sweep=0; sweep < maxSweeps; ++sweep)
+        {
+            bool converged = true;
+            for (int w=0; w < W; ++w)
+            {
+                const T off = BZ_BATCH_ELEMENT(m, 0, 1)
+                    * BZ_BATCH_ELEMENT(m, 0, 1) + BZ_BATCH_ELEMENT(m, 0, 2)
+                    * BZ_BATCH_ELEMENT(m, 0, 2) + BZ_BATCH_ELEMENT(m, 1, 2)
+                    * BZ_BATCH_ELEMENT(m, 1, 2);
+                const T diagonal = BZ_BATCH_ELEMENT(m, 0, 0)
+                    * BZ_BATCH_ELEMENT(m, 0, 0) + BZ_BATCH_ELEMENT(m, 1, 1)
+                    * BZ_BATCH_ELEMENT(m, 1, 1) + BZ_BATCH_ELEMENT(m, 2, 2)
+                    * BZ_BATCH_ELEMENT(m, 2, 2);
+                converged &= !(off > eps * eps * diagonal);
+            }
+            if (converged)
+                break;
+            rotate<W>(m, v, 0, 1);
+            rotate<W>(m, v, 0, 2);
+            rotate<W>(m, v, 1, 2);
+        }
+
+        order<W>(m, v, 0, 1);
+        order<W>(m, v, 1, 2);
+        order<W>(m, v, 0, 1);
+
+        for (int k=0; k < 3; ++k)
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_LANE(r, k) = BZ_BATCH_ELEMENT(m, k, k);
+        for (int k=0; k < 9; ++k)
+            for (int w=0; w < W; ++w)
+                BZ_BATCH_LANE(s, k) = v[k*W + w];
+    }
+};
+
+#undef BZ_BATCH_ELEMENT
+#undef BZ_BATCH_LANE
+
+// the type of the components of T, T itself for a scalar
+template<typename T>
+struct _bz_batchElement {
+    typedef typename multicomponent_traits<T>::T_element T_element;
+    static const int size = sizeof(T) / sizeof(T_element);
+};
+
+/** Applies the kernel to W objects, the w-th of which is at a + w*sa,
+    b + w*sb, r + w*sr and s + w*ss: their components are copied to
+    local arrays, one row of W lanes per component, and those of the
+    results back. */
+template<typename T_kernel, int W, typename T_result, typename T_result2,
+         typename T_arg1, typename T_arg2>
+inline void _bz_batchGathered(T_result* r, diffType sr, T_result2* s,
+    diffType ss, const T_arg1* a, diffType sa, const T_arg2* b, diffType sb)
+{
+    typedef typename _bz_batchElement<T_arg1>::T_element T_a;
+    typedef typename _bz_batchElement<T_arg2>::T_element T_b;
+    typedef typename _bz_batchElement<T_result>::T_element T_r;
+    typedef typename _bz_batchElement<T_result2>::T_element T_s;
+    const int na = T_kernel::argComponents1, nb = T_kernel::argComponents2,
+        nr = T_kernel::resultComponents, ns = T_kernel::result2Components;
+    T_a x[(na ? na : 1) * W];
+    T_b y[(nb ? nb : 1) * W];
+    T_r z[(nr ? nr : 1) * W];
+    T_s u[(ns ? ns : 1) * W];
+
+    for (int w=0; w < W; ++w)
+    {
+        const T_a* restrict p = reinterpret_cast<const T_a*>(a + w*sa);
+        for (int k=0; k < na; ++k)
+            x[k*W + w] = p[k];
+    }
+    if (nb)
+        for (int w=0; w < W; ++w)
+        {
+            const T_b* restrict p = reinterpret_cast<const T_b*>(b + w*sb);
+            for (int k=0; k < nb; ++k)
+                y[k*W + w] = p[k];
+        }
+    if (T_kernel::readsResult)
+        for (int w=0; w < W; ++w)
+        {
+            const T_r* restrict p = reinterpret_cast<const T_r*>(r + w*sr);
+            for (int k=0; k < nr; ++k)
+                z[k*W + w] = p[k];
+        }
+
+    T_kernel::template compute<W, _bz_BatchLocal<W> >(x, y, z, u);
+
+    for (int w=0; w < W; ++w)
+    {
+        T_r* restrict p = reinterpret_cast<T_r*>(r + w*sr);
+        for (int k=0; k < nr; ++k)
+            p[k] = z[k*W + w];
+    }
+    if (ns)
+        for (int w=0; w < W; ++w)
+        {
+            T_s* restrict p = reinterpret_cast<T_s*>(s + w*ss);
+            for (int k=0; k < ns; ++k)
+                p[k] = u[k*W + w];
+        }
+}
+
+/** Applies the kernel to W contiguous objects at a, b, r and s, in
+    place: the lanes are the objects. */
+template<typename T_kernel, int W, typename T_result, typename T_result2,
+         typename T_arg1, typename T_arg2>
+inline void _bz_batchContiguous(T_result* r, T_result2* s,
+    const T_arg1* a, const T_arg2* b)
+{
+    typedef _bz_batchElement<T_arg1> T_a;
+    typedef _bz_batchElement<T_arg2> T_b;
+    typedef _bz_batchElement<T_result> T_r;
+    typedef _bz_batchElement<T_result2> T_s;
+    T_kernel::template compute<W,
+        _bz_BatchObjects<T_a::size, T_b::size, T_r::size, T_s::size> >(
+            reinterpret_cast<const typename T_a::T_element*>(a),
+            reinterpret_cast<const typename T_b::T_element*>(b),
+            reinterpret_cast<typename T_r::T_element*>(r),
+            reinterpret_cast<typename T_s::T_element*>(s));
+}
+
+/** Applies the kernel to the elements of a and b (a null b for the
+    kernels of one operand), writing the results to r and s (a null s
+    for the kernels of one result). The lines of the innermost rank of
+    r are cut into pieces of a few batches, which are split between
+    OpenMP threads; along each piece the objects are taken
+    T_kernel::width at a time, and one at a time at the end of the line.
+    The objects of strided lines are gathered into local arrays
+    first. */
+template<typename T_kernel, typename T_result, typename T_result2,
+         typename T_arg1, typename T_arg2, int N_rank>
+void _bz_batchEvaluate(Array<T_result,N_rank>& r,
+    Array<T_result2,N_rank>* s, const Array<T_arg1,N_rank>& a,
+    const Array<T_arg2,N_rank>* b)
+{
+    BZPRECHECK(all(a.extent() == r.extent())
+        && (!b || all(b->extent() == r.extent()))
+        && (!s || all(s->extent() == r.extent())),
+        "Batched operation on arrays of different shapes:" << endl
+        << r.extent() << endl << a.extent());
+
+    if (r.numElements() == 0)
+        return;
+
+    const int W = T_kernel::width;
+    const int inner = r.ordering(0);
+    const diffType n = r.extent(inner), sr = r.stride(inner),
+        ss = s ? s->stride(inner) : 0, sa = a.stride(inner),
+        sb = b ? b->stride(inner) : 0;
+
+    // pieces of 32 batches, and how many of them make a line
+    const diffType piece = 32 * W, pieces = (n + piece - 1) / piece,
+        work = diffType(r.numElements() / n) * pieces;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) \
+  if ((r.numElements() >= BZ_BATCH_THREADING_THRESHOLD) && !omp_in_parallel())
+#endif
+    for (diffType t=0; t < work; ++t)
+    {
+        // the start of the piece, relative to the lower bounds
+        TinyVector<int,N_rank> index(0);
+        index[inner] = int((t % pieces) * piece);
+        diffType line = t / pieces;
+        for (int j=1; j < N_rank; ++j)
+        {
+            const int rank = r.ordering(j);
+            index[rank] = int(line % r.extent(rank));
+            line /= r.extent(rank);
+        }
+
+        TinyVector<int,N_rank> ir, is, ia, ib;
+        for (int j=0; j < N_rank; ++j)
+        {
+            ir[j] = r.lbound(j) + index[j];
+            is[j] = s ? s->lbound(j) + index[j] : 0;
+            ia[j] = a.lbound(j) + index[j];
+            ib[j] = b ? b->lbound(j) + index[j] : 0;
+        }
+        T_result* pr = &r(ir);
+        T_result2* ps = s ? &(*s)(is) : 0;
+        const T_arg1* pa = &a(ia);
+        const T_arg2* pb = b ? &(*b)(ib) : 0;
+        const diffType m = n - index[inner] < piece ? n - index[inner]
+            : piece;
+
+        // the kernels work in place only on copies of the objects
+        const void* results[2] = { pr, ps };
+        bool inPlace = false;
+        for (int k=0; k < 2; ++k)
+            inPlace |= results[k] && (results[k] == static_cast<const void*>(pa)
+                || results[k] == static_cast<const void*>(pb));
+
+        diffType i = 0;
+        if (sr == 1 && (!s || ss == 1) && sa == 1 && (!b || sb == 1)
+            && !inPlace)
+        {
+            // unit strides as constants, so that the copies vectorize
+            if (T_kernel::gathered)
+                for (; i + W <= m; i += W)
+                    _bz_batchGathered<T_kernel,W>(pr + i, 1,
+                        ps ? ps + i : ps, 1, pa + i, 1, pb ? pb + i : pb, 1);
+            else
+                for (; i + W <= m; i += W)
+                    _bz_batchContiguous<T_kernel,W>(pr + i,
+                        ps ? ps + i : ps, pa + i, pb ? pb + i : pb);
+        }
+        else
+        {
+            for (; i + W <= m; i += W)
+                _bz_batchGathered<T_kernel,W>(pr + i*sr, sr,
+                    ps ? ps + i*ss : ps, ss, pa + i*sa, sa,
+                    pb ? pb + i*sb : pb, sb);
+        }
+        for (; i < m; ++i)
+            _bz_batchGathered<T_kernel,1>(pr + i*sr, sr,
+                ps ? ps + i*ss : ps, ss, pa + i*sa, sa,
+                pb ? pb + i*sb : pb, sb);
+    }
+}
+
+/** r(i) = cross(a(i), b(i)) */
+template<typename T, int N_rank>
+void batchCross(Array<TinyVector<T,3>,N_rank>& r,
+    const Array<TinyVector<T,3>,N_rank>& a,
+    const Array<TinyVector<T,3>,N_rank>& b)
+{
+    _bz_batchEvaluate<_bz_BatchCross<T> >(r,
+        static_cast<Array<T,N_rank>*>(0), a, &b);
+}
+
+/** r(i) = dot(a(i), b(i)) */
+template<typename T, int N, int N_rank>
+void batchDot(Array<T,N_rank>& r, const Array<TinyVector<T,N>,N_rank>& a,
+    const Array<TinyVector<T,N>,N_rank>& b)
+{
+    _bz_batchEvaluate<_bz_BatchDot<T,N> >(r,
+        static_cast<Array<T,N_rank>*>(0), a, &b);
+}
+
+/** r(i) = a(i) * b(i), the matrix product */
+template<typename T, int N, int K, int M, int N_rank>
+void batchProduct(Array<TinyMatrix<T,N,M>,N_rank>& r,
+    const Array<TinyMatrix<T,N,K>,N_rank>& a,
+    const Array<TinyMatrix<T,K,M>,N_rank>& b)
+{
+    _bz_batchEvaluate<_bz_BatchProduct<T,N,K,M> >(r,
+        static_cast<Array<T,N_rank>*>(0), a, &b);
+}
+
+/** r(i) = a(i) * b(i), the product of a matrix and a vector */
+template<typename T, int N, int K, int N_rank>
+void batchProduct(Array<TinyVector<T,N>,N_rank>& r,
+    const Array<TinyMatrix<T,N,K>,N_rank>& a,
+    const Array<TinyVector<T,K>,N_rank>& b)
+{
+    _bz_batchEvaluate<_bz_BatchProduct<T,N,K,1> >(r,
+        static_cast<Array<T,N_rank>*>(0), a, &b);
+}
+
+/** r(i) = det a(i), for 2x2, 3x3 and 4x4 matrices */
+template<typename T, int N, int N_rank>
+void batchDeterminant(Array<T,N_rank>& r,
+    const Array<TinyMatrix<T,N,N>,N_rank>& a)
+{
+    _bz_batchEvaluate<_bz_BatchDeterminant<T,N> >(r,
+        static_cast<Array<T,N_rank>*>(0), a,
+        static_cast<const Array<T,N_rank>*>(0));
+}
+
+/** r(i) = a(i)^-1: by cofactors for 2x2, 3x3 and 4x4 matrices, and by
+    LU factorization with partial pivoting for the others */
+template<typename T, int N, int N_rank>
+void batchInverse(Array<TinyMatrix<T,N,N>,N_rank>& r,
+    const Array<TinyMatrix<T,N,N>,N_rank>& a)
+{
+    _bz_batchEvaluate<_bz_BatchInverse<T,N> >(r,
+        static_cast<Array<T,N_rank>*>(0), a,
+        static_cast<const Array<T,N_rank>*>(0));
+}
+
+/** x(i) = a(i)^-1 b(i), by LU factorization with partial pivoting */
+template<typename T, int N, int N_rank>
+void batchSolve(Array<TinyVector<T,N>,N_rank>& x,
+    const Array<TinyMatrix<T,N,N>,N_rank>& a,
+    const Array<TinyVector<T,N>,N_rank>& b)
+{
+    _bz_batchEvaluate<_bz_BatchSolve<T,N> >(x,
+        static_cast<Array<T,N_rank>*>(0), a, &b);
+}
+
+/** LU factorization with partial pivoting, P a(i) = L U: lu(i) holds
+    the multipliers of the unit lower triangle L below the diagonal,
+    and the upper triangle U; row k of P a(i) is row pivot(i)(k) of
+    a(i). lu may be a. */
+template<typename T, int N, int N_rank>
+void batchLU(Array<TinyMatrix<T,N,N>,N_rank>& lu,
+    Array<TinyVector<int,N>,N_rank>& pivot,
+    const Array<TinyMatrix<T,N,N>,N_rank>& a)
+{
+    _bz_batchEvaluate<_bz_BatchLU<T,N> >(lu, &pivot, a,
+        static_cast<const Array<T,N_rank>*>(0));
+}
+
+/** x(i) = a(i)^-1 b(i), from the factorization lu, pivot of batchLU. x
+    may be b. */
+template<typename T, int N, int N_rank>
+void batchLUSolve(Array<TinyVector<T,N>,N_rank>& x,
+    const Array<TinyMatrix<T,N,N>,N_rank>& lu,
+    const Array<TinyVector<int,N>,N_rank>& pivot,
+    const Array<TinyVector<T,N>,N_rank>& b)
+{
+    if (&x(x.lbound()) != &b(b.lbound()))
+        x = b;
+    _bz_batchEvaluate<_bz_BatchLUSolve<T,N> >(x,
+        static_cast<Array<T,N_rank>*>(0), lu, &pivot);
+}
+
+/** Cholesky factorization a(i) = l(i) l(i)^T of symmetric positive
+    definite matrices, of which only the lower triangles are read; the
+    upper triangles of l are set to zero. l may be a. */
+template<typename T, int N, int N_rank>
+void batchCholesky(Array<TinyMatrix<T,N,N>,N_rank>& l,
+    const Array<TinyMatrix<T,N,N>,N_rank>& a)
+{
+    _bz_batchEvaluate<_bz_BatchCholesky<T,N> >(l,
+        static_cast<Array<T,N_rank>*>(0), a,
+        static_cast<const Array<T,N_rank>*>(0));
+}
+
+/** x(i) = (l(i) l(i)^T)^-1 b(i), from the factor l of batchCholesky */
+template<typename T, int N, int N_rank>
+void batchCholeskySolve(Array<TinyVector<T,N>,N_rank>& x,
+    const Array<TinyMatrix<T,N,N>,N_rank>& l,
+    const Array<TinyVector<T,N>,N_rank>& b)
+{
+    _bz_batchEvaluate<_bz_BatchCholeskySolve<T,N> >(x,
+        static_cast<Array<T,N_rank>*>(0), l, &b);
+}
+
+/** Eigenvalues, in increasing order, and eigenvectors of symmetric 3x3
+    matrices: column k of vectors(i) is a unit eigenvector for
+    values(i)(k). */
+template<typename T, int N_rank>
+void batchEigenSymmetric(Array<TinyVector<T,3>,N_rank>& values,
+    Array<TinyMatrix<T,3,3>,N_rank>& vectors,
+    const Array<TinyMatrix<T,3,3>,N_rank>& a)
+{
+    _bz_batchEvaluate<_bz_BatchSymmetricEigen<T> >(values, &vectors, a,
+        static_cast<const Array<T,N_rank>*>(0));
+}
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_BATCHED_H
@@ -31,6 +31,8 @@
 #ifndef BZ_CGSOLVE_H
 #define BZ_CGSOLVE_H
 
+#include <blitz/array/krylov.h>
+
 BZ_NAMESPACE(blitz)
 
 template<typename T_numtype>
@@ -54,101 +56,33 @@ void dump(const char* name, Array<T_numtype,3>& A)
     cout << "Average magnitude of " << name << " is " << normA << endl;
 }
 
+/*
+ * Solves stencil(x) = rhs over the interior of x with the conjugate
+ * gradient method (see <blitz/array/krylov.h>), after applying the
+ * boundary conditions to x. The updates are restricted to the
+ * interior, and the solver stops when sum(r*r) < haltrho, r being the
+ * residual, or after 1000 iterations. Returns the number of
+ * iterations.
+ */
 template<typename T_stencil, typename T_numtype, int N_rank, typename T_BCs>
 int conjugateGradientSolver(T_stencil stencil,
     Array<T_numtype,N_rank>& x,
     Array<T_numtype,N_rank>& rhs, double haltrho, 
     const T_BCs& boundaryConditions)
 {
-    // NEEDS_WORK: only apply CG updates over interior; need to handle
-    // BCs separately.
-
-    // x = unknowns being solved for (initial guess assumed)
-    // r = residual
-    // p = descent direction for x
-    // q = descent direction for r
-
-    RectDomain<N_rank> interior = interiorDomain(stencil, x, rhs);
-
-cout << "Interior: " << interior.lbound() << ", " << interior.ubound()
-     << endl;
-
-    // Calculate initial residual
-    Array<T_numtype,N_rank> r = rhs.copy();
-    r *= -1.0;
-
     boundaryConditions.applyBCs(x);
 
-    applyStencil(stencil, r, x);
-
- dump("r after stencil", r);
- cout << "Slice through r: " << endl << r(23,17,Range::all()) << endl;
- cout << "Slice through x: " << endl << x(23,17,Range::all()) << endl;
- cout << "Slice through rhs: " << endl << rhs(23,17,Range::all()) << endl;
-
-    r *= -1.0;
-
- dump("r", r);
-
-    // Allocate the descent direction arrays
-    Array<T_numtype,N_rank> p, q;
-    allocateArrays(x.shape(), p, q);
-
-    int iteration = 0;
-    int converged = 0;
-    T_numtype rho = 0.;
-    T_numtype oldrho = 0.;
-
-    const int maxIterations = 1000;
-
-    // Get views of interior of arrays (without boundaries)
-    Array<T_numtype,N_rank> rint = r(interior);
-    Array<T_numtype,N_rank> pint = p(interior);
-    Array<T_numtype,N_rank> qint = q(interior);
-    Array<T_numtype,N_rank> xint = x(interior);
-
-    while (iteration < maxIterations)
-    {
-        rho = sum(r * r);
-
-        if ((iteration % 20) == 0)
-            cout << "CG: Iter " << iteration << "\t rho = " << rho << endl;
-
-        // Check halting condition
-        if (rho < haltrho)
-        {
-            converged = 1;
-            break;
-        }
-
-        if (iteration == 0)
-        {
-            p = r;
-        }
-        else {
-            T_numtype beta = rho / oldrho;
-            p = beta * p + r;
-        }
-
-        q = 0.;
-//        boundaryConditions.applyBCs(p);
-        applyStencil(stencil, q, p);
-
-        T_numtype pq = sum(p*q);
-
-        T_numtype alpha = rho / pq;
-
-        x += alpha * p;
-        r -= alpha * q;
-
-        oldrho = rho;
-        ++iteration;
-    }
-
-    if (!converged)
-        cout << "Warning: CG solver did not converge" << endl;
-
-    return iteration;
+    // The residual, and so the corrections to x, are 0 outside the
+    // interior
+    RectDomain<N_rank> interior = interiorDomain(stencil, x, rhs);
+    Array<T_numtype,N_rank> b(x.lbound(), x.extent());
+    b = 0;
+    b(interior) = rhs(interior);
+
+    ConjugateGradient<T_numtype,N_rank> solver;
+    solver.setMaxIterations(1000);
+    solver.setTolerance(0, BZ_MATHFN_SCOPE(sqrt)(haltrho));
+    return solver.solve(StencilOperator<T_stencil>(stencil), x, b).iterations;
 }
 
 BZ_NAMESPACE_END
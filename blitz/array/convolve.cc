@@ -1,5 +1,5 @@
 /***************************************************************************
- * blitz/array/convolve.cc  One-dimensional convolution
+ * blitz/array/convolve.cc  Convolution and correlation
  *
  * $Id$
  *
@@ -7,7 +7,7 @@
  *
  * This file is a part of Blitz.
  *
- * Blitz is free software: you can redistribute it and/or modify 
+ * Blitz is free software: you can redistribute it and/or modify
  * it under the terms of the GNU Lesser General Public License
  * as published by the Free Software Foundation, either version 3
  * of the License, or (at your option) any later version.
@@ -17,55 +17,449 @@
  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  * GNU Lesser General Public License for more details.
  *
- * You should have received a copy of the GNU Lesser General Public 
+ * You should have received a copy of the GNU Lesser General Public
  * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
- * 
+ *
  * Suggestions:          blitz-devel@lists.sourceforge.net
- * Bugs:                 blitz-support@lists.sourceforge.net    
+ * Bugs:                 blitz-support@lists.sourceforge.net
  *
  * For more information, please see the Blitz++ Home Page:
  *    https://sourceforge.net/projects/blitz/
  *
  ****************************************************************************/
-
 #ifndef BZ_ARRAY_CONVOLVE_CC
 #define BZ_ARRAY_CONVOLVE_CC
 
+#ifndef BZ_ARRAY_CONVOLVE_H
+ #error <blitz/array/convolve.cc> must be included via <blitz/array/convolve.h>
+#endif
+
 BZ_NAMESPACE(blitz)
 
+/** Traits of the element types of convolutions: whether FFTs can be
+    used, the real type of the transforms and the conjugate. */
 template<typename T>
-Array<T,1> convolve(const Array<T,1>& B, const Array<T,1>& C)
+struct _bz_convolveTraits {
+    static const bool useFFT = false;
+    template<int N> static void conjugate(Array<T,N>&) { }
+};
+
+template<typename T>
+struct _bz_convolveRealTraits {
+    static const bool useFFT = true;
+    typedef T T_real;
+    static T fromComplex(const complex<T>& x) { return x.real(); }
+    template<int N> static void conjugate(Array<T,N>&) { }
+};
+
+template<> struct _bz_convolveTraits<float>
+    : public _bz_convolveRealTraits<float> { };
+template<> struct _bz_convolveTraits<double>
+    : public _bz_convolveRealTraits<double> { };
+template<> struct _bz_convolveTraits<long double>
+    : public _bz_convolveRealTraits<long double> { };
+
+template<typename T>
+struct _bz_convolveTraits<complex<T> > {
+    static const bool useFFT = true;
+    typedef T T_real;
+    static complex<T> fromComplex(const complex<T>& x) { return x; }
+    template<int N> static void conjugate(Array<complex<T>,N>& A)
+    { A = conj(A); }
+};
+
+// index of line l of a box (all but the last rank), relative to its
+// lower corner
+template<int N>
+inline void _bz_convolveLineIndex(sizeType l, const TinyVector<int,N>& extent,
+                                  TinyVector<int,N>& index)
+{
+    for (int d=N-2; d >= 0; --d)
+    {
+        index(d) = l % extent(d);
+        l /= extent(d);
+    }
+    index(N-1) = 0;
+}
+
+template<int N>
+inline diffType _bz_convolveOffset(const TinyVector<int,N>& index,
+                                   const TinyVector<diffType,N>& stride)
+{
+    diffType offset = 0;
+    for (int d=0; d < N; ++d)
+        offset += diffType(index(d)) * stride(d);
+    return offset;
+}
+
+// a[i] += c * b[i] for first <= i <= last
+template<typename T>
+inline void _bz_convolveAxpy(T* restrict a, const T* restrict b, const T c,
+                             int first, int last)
+{
+    for (int i=first; i <= last; ++i)
+        a[i] += c * b[i];
+}
+
+/*
+ * Direct convolution. A is split into segments of lines along the
+ * last rank, which are short enough to stay in cache while all taps
+ * of the kernel are added to them, and the segments are distributed
+ * between threads.
+ */
+template<typename T, int N>
+void _bz_convolveDirect(Array<T,N>& A, const Array<T,N>& B0,
+                        const Array<T,N>& C)
+{
+    // the inner loops need unit stride along the last rank
+    Array<T,N> B(B0);
+    if (B.stride(N-1) != 1)
+    {
+        Array<T,N> copy(B0.lbound(), B0.extent());
+        copy = B0;
+        B.reference(copy);
+    }
+
+    const int last = N-1;
+    const int segmentLength =
+        BZ_L1_CACHE_ESTIMATED_SIZE / (2 * int(sizeof(T))) > 0 ?
+        BZ_L1_CACHE_ESTIMATED_SIZE / (2 * int(sizeof(T))) : 1;
+    const int numSegments = (A.extent(last) + segmentLength - 1)
+        / segmentLength;
+    const sizeType numLines = A.numElements() / A.extent(last);
+    const sizeType kernelLines = C.numElements() / C.extent(last);
+    const diffType numItems = diffType(numLines) * numSegments;
+
+    T* const a0 = A.dataZero();
+    const T* const b0 = B.dataZero();
+    const T* const c0 = C.dataZero();
+    const TinyVector<diffType,N> as(A.stride()), bs(B.stride()),
+        cs(C.stride());
+
+#ifdef _OPENMP
+    const bool parallel = (numItems > 1) && !omp_in_parallel()
+        && (double(A.numElements()) * C.numElements()
+            >= BZ_CONVOLVE_THREADING_THRESHOLD);
+#pragma omp parallel for schedule(dynamic) if (parallel)
+#endif
+    for (diffType item=0; item < numItems; ++item)
+    {
+        const sizeType line = item / numSegments;
+        const int first = A.lbound(last) + int(item % numSegments)
+            * segmentLength;
+        const int end = first + segmentLength - 1 < A.ubound(last) ?
+            first + segmentLength - 1 : A.ubound(last);
+
+        // output line i and its offset
+        TinyVector<int,N> i, k, j;
+        _bz_convolveLineIndex(line, A.extent(), i);
+        i += A.lbound();
+        i(last) = 0;
+        T* const a = a0 + _bz_convolveOffset(i, as);
+
+        for (sizeType kl=0; kl < kernelLines; ++kl)
+        {
+            _bz_convolveLineIndex(kl, C.extent(), k);
+            k += C.lbound();
+            k(last) = 0;
+
+            // line j = i - k of B, if it exists
+            bool inside = true;
+            for (int d=0; d < last; ++d)
+            {
+                j(d) = i(d) - k(d);
+                inside = inside && (j(d) >= B.lbound(d))
+                    && (j(d) <= B.ubound(d));
+            }
+            if (!inside)
+                continue;
+            j(last) = 0;
+            const T* const b = b0 + _bz_convolveOffset(j, bs);
+            const T* const c = c0 + _bz_convolveOffset(k, cs);
+
+            for (int kk=C.lbound(last); kk <= C.ubound(last); ++kk)
+            {
+                const int lo = B.lbound(last) + kk > first ?
+                    B.lbound(last) + kk : first;
+                const int hi = B.ubound(last) + kk < end ?
+                    B.ubound(last) + kk : end;
+                if (lo <= hi)
+                    _bz_convolveAxpy(a, b - kk, c[kk * cs(last)], lo, hi);
+            }
+        }
+    }
+}
+
+/*
+ * Sizes of the FFT convolution. The transforms along all ranks but
+ * the first cover the full result. Along the first rank, B is split
+ * into numBlocks blocks of blockLength rows whose convolutions with C
+ * are added (overlap-add) when B is much longer than C, otherwise
+ * there is a single block.
+ */
+template<int N>
+void _bz_convolveFFTSizes(const TinyVector<int,N>& Bext,
+                          const TinyVector<int,N>& Cext,
+                          TinyVector<int,N>& fftLength,
+                          int& blockLength, int& numBlocks)
+{
+    for (int d=0; d < N; ++d)
+        fftLength(d) = FFTPlan<double>::nextFastLength(Bext(d)+Cext(d)-1);
+
+    const int blockFFTLength = FFTPlan<double>::nextFastLength(8 * Cext(0));
+    if (blockFFTLength < fftLength(0))
+    {
+        fftLength(0) = blockFFTLength;
+        blockLength = blockFFTLength - Cext(0) + 1;
+    }
+    else
+        blockLength = Bext(0);
+    numBlocks = (Bext(0) + blockLength - 1) / blockLength;
+}
+
+template<typename T, int N>
+double _bz_convolveFFTCost(const Array<T,N>& B, const Array<T,N>& C)
+{
+    TinyVector<int,N> fftLength;
+    int blockLength, numBlocks;
+    _bz_convolveFFTSizes(B.extent(), C.extent(), fftLength, blockLength,
+                         numBlocks);
+    const double n = product(fftLength);
+    // a forward and an inverse transform per block, and the kernel's
+    return (2 * numBlocks + 1) * n * (std::log(n) / std::log(2.) + 1);
+}
+
+template<typename R, int N>
+void _bz_convolveTransform(complex<R>* X, const TinyVector<int,N>& extent,
+                           const TinyVector<diffType,N>& stride,
+                           const FFTPlan<R>* const* plans, bool inverse,
+                           bool parallel)
+{
+    for (int d=0; d < N; ++d)
+        _bz_fftLines(X, extent, stride, d, *plans[d], inverse, parallel);
+}
+
+/** Adds the convolution of rows first..first+length-1 (along the first
+    rank) of B with C to A, using X as buffer and K the transform of C. */
+template<typename T, int N, typename R>
+void _bz_convolveBlock(Array<T,N>& A, const Array<T,N>& B,
+                       const Array<T,N>& C, int first, int length,
+                       complex<R>* restrict X, const complex<R>* restrict K,
+                       const TinyVector<int,N>& fftLength,
+                       const FFTPlan<R>* const* plans, bool parallel)
 {
-    int Bl = B.lbound(0), Bh = B.ubound(0);
-    int Cl = C.lbound(0), Ch = C.ubound(0);
+    const int last = N-1;
+    TinyVector<diffType,N> xs;
+    xs(last) = 1;
+    for (int d=last-1; d >= 0; --d)
+        xs(d) = xs(d+1) * fftLength(d+1);
+    const diffType size = xs(0) * fftLength(0);
+
+    for (diffType p=0; p < size; ++p)
+        X[p] = complex<R>(0);
+
+    // copy the block of B
+    TinyVector<int,N> bext(B.extent()), i, j;
+    bext(0) = length;
+    const sizeType numLines = product(bext) / bext(last);
+    for (sizeType l=0; l < numLines; ++l)
+    {
+        _bz_convolveLineIndex(l, bext, i);
+        j = i + B.lbound();
+        j(0) += first - B.lbound(0);
+        complex<R>* restrict x = X + _bz_convolveOffset(i, xs);
+        const T* b = &B(j);
+        const diffType stride = B.stride(last);
+        for (int n=0; n < bext(last); ++n)
+            x[n] = b[n*stride];
+    }
+
+    _bz_convolveTransform(X, fftLength, xs, plans, false, parallel);
+#ifdef _OPENMP
+#pragma omp parallel for if (parallel && !omp_in_parallel())
+#endif
+    for (diffType p=0; p < size; ++p)
+        X[p] = _bz_fftMul(X[p], K[p]);
+    _bz_convolveTransform(X, fftLength, xs, plans, true, parallel);
+
+    // Position p of X is the result at index p + origin. Add the part
+    // of the full result of the block which is inside A.
+    TinyVector<int,N> origin(B.lbound() + C.lbound()), lo, hi;
+    origin(0) = first + C.lbound(0);
+    for (int d=0; d < N; ++d)
+    {
+        const int full = (d == 0 ? length : B.extent(d)) + C.extent(d) - 1;
+        lo(d) = origin(d) > A.lbound(d) ? origin(d) : A.lbound(d);
+        hi(d) = origin(d) + full - 1 < A.ubound(d) ?
+            origin(d) + full - 1 : A.ubound(d);
+        if (hi(d) < lo(d))
+            return;
+    }
+    const TinyVector<int,N> ext(hi - lo + 1);
+    const sizeType outLines = product(ext) / ext(last);
+    for (sizeType l=0; l < outLines; ++l)
+    {
+        _bz_convolveLineIndex(l, ext, i);
+        i += lo;
+        T* restrict a = &A(i);
+        const complex<R>* restrict x = X +
+            _bz_convolveOffset(TinyVector<int,N>(i - origin), xs);
+        for (int n=0; n < ext(last); ++n)
+            a[n] += _bz_convolveTraits<T>::fromComplex(x[n]);
+    }
+}
+
+template<typename T, int N>
+void _bz_convolveFFT(Array<T,N>& A, const Array<T,N>& B, const Array<T,N>& C)
+{
+    typedef typename _bz_convolveTraits<T>::T_real R;
+    const int last = N-1;
+
+    TinyVector<int,N> fftLength;
+    int blockLength, numBlocks;
+    _bz_convolveFFTSizes(B.extent(), C.extent(), fftLength, blockLength,
+                         numBlocks);
+
+    const FFTPlan<R>* plans[N];
+    for (int d=0; d < N; ++d)
+        plans[d] = &FFTPlan<R>::get(fftLength(d));
+
+    TinyVector<diffType,N> xs;
+    xs(last) = 1;
+    for (int d=last-1; d >= 0; --d)
+        xs(d) = xs(d+1) * fftLength(d+1);
+    const sizeType size = xs(0) * fftLength(0);
 
-    int lbound = Bl + Cl;
-    int ubound = Bh + Ch;
-    
-    Array<T,1> A(Range(lbound,ubound));
+    // scaled transform of C
+    vector<complex<R> > K(size, complex<R>(0));
+    const R scale = R(1) / R(size);
+    TinyVector<int,N> i;
+    const sizeType kernelLines = C.numElements() / C.extent(last);
+    for (sizeType l=0; l < kernelLines; ++l)
+    {
+        _bz_convolveLineIndex(l, C.extent(), i);
+        complex<R>* k = &K[0] + _bz_convolveOffset(i, xs);
+        i += C.lbound();
+        const T* c = &C(i);
+        for (int n=0; n < C.extent(last); ++n)
+            k[n] = complex<R>(c[n*C.stride(last)]) * scale;
+    }
+    _bz_convolveTransform(&K[0], fftLength, xs, plans, false, true);
 
-    T result;
-    for (int i=lbound; i <= ubound; ++i)
+    if (numBlocks == 1)
+    {
+        vector<complex<R> > X(size);
+        _bz_convolveBlock(A, B, C, B.lbound(0), B.extent(0), &X[0], &K[0],
+                          fftLength, plans, true);
+    }
+    else
     {
-        int jl = i - Ch;
-        if (jl < Bl)
-            jl = Bl;
+        // Blocks two apart do not overlap in A, so the even and then
+        // the odd blocks are done in parallel.
+#ifdef _OPENMP
+#pragma omp parallel if (!omp_in_parallel())
+#endif
+        {
+            vector<complex<R> > X(size);
+            for (int phase=0; phase < 2; ++phase)
+            {
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+                for (int b=phase; b < numBlocks; b += 2)
+                {
+                    const int first = B.lbound(0) + b * blockLength;
+                    const int length = first + blockLength - 1 < B.ubound(0) ?
+                        blockLength : B.ubound(0) - first + 1;
+                    _bz_convolveBlock(A, B, C, first, length, &X[0], &K[0],
+                                      fftLength, plans, false);
+                }
+            }
+        }
+    }
+}
 
-        int jh = i - Cl;
-        if (jh > Bh)
-            jh = Bh;
+template<bool useFFT>
+struct _bz_convolveMethod {
+    template<typename T, int N>
+    static void apply(Array<T,N>& A, const Array<T,N>& B,
+                      const Array<T,N>& C, ConvolutionMethod)
+    {
+        _bz_convolveDirect(A, B, C);
+    }
+};
 
-        result = 0;
-        for (int j=jl; j <= jh; ++j)
-            result += B(j) * C(i-j);
+template<>
+struct _bz_convolveMethod<true> {
+    template<typename T, int N>
+    static void apply(Array<T,N>& A, const Array<T,N>& B,
+                      const Array<T,N>& C, ConvolutionMethod method)
+    {
+        if (method == convolveAuto)
+        {
+            const double direct = double(A.numElements()) * C.numElements();
+            method = direct > BZ_CONVOLVE_FFT_RATIO
+                * _bz_convolveFFTCost(B, C) ? convolveFFT : convolveDirect;
+        }
 
-        A(i) = result;
+        if (method == convolveFFT)
+            _bz_convolveFFT(A, B, C);
+        else
+            _bz_convolveDirect(A, B, C);
     }
+};
+
+template<typename T, int N>
+Array<T,N> convolve(const Array<T,N>& B, const Array<T,N>& C,
+                    ConvolutionMode mode, ConvolutionMethod method)
+{
+    const bool empty = (B.numElements() == 0) || (C.numElements() == 0);
+
+    TinyVector<int,N> lbound, extent;
+    for (int d=0; d < N; ++d)
+    {
+        int ubound;
+        switch (mode) {
+        case convolveSame:
+            lbound(d) = B.lbound(d);
+            ubound = B.ubound(d);
+            break;
+        case convolveValid:
+            lbound(d) = B.lbound(d) + C.ubound(d);
+            ubound = B.ubound(d) + C.lbound(d);
+            break;
+        default:
+            lbound(d) = B.lbound(d) + C.lbound(d);
+            ubound = B.ubound(d) + C.ubound(d);
+        }
+        extent(d) = (ubound < lbound(d)) || (empty && mode != convolveSame) ?
+            0 : ubound - lbound(d) + 1;
+    }
+
+    Array<T,N> A(lbound, extent);
+    A = 0;
+
+    if (!empty && A.numElements())
+        _bz_convolveMethod<_bz_convolveTraits<T>::useFFT>::
+            apply(A, B, C, method);
 
     return A;
 }
 
+template<typename T, int N>
+Array<T,N> correlate(const Array<T,N>& B, const Array<T,N>& C,
+                     ConvolutionMode mode, ConvolutionMethod method)
+{
+    // convolve with D(i) = conj(C(-i))
+    Array<T,N> D = C.copy();
+    for (int d=0; d < N; ++d)
+        D.reverseSelf(d);
+    D.reindexSelf(TinyVector<int,N>(-C.ubound()));
+    _bz_convolveTraits<T>::conjugate(D);
+
+    return convolve(B, D, mode, method);
+}
+
 BZ_NAMESPACE_END
 
 #endif // BZ_ARRAY_CONVOLVE_CC
-
@@ -1,6 +1,6 @@
 // -*- C++ -*-
 /***************************************************************************
- * blitz/array/convolve.h   One-dimensional convolution
+ * blitz/array/convolve.h   Convolution and correlation
  *
  * $Id$
  *
@@ -35,10 +35,50 @@
  #error <blitz/array/convolve.h> must be included after <blitz/array.h>
 #endif
 
+#include <blitz/array/fft.h>
+
+/*
+ * convolve(B, C) computes the N-dimensional convolution
+ *
+ *   A(i) = sum_j B(j) C(i-j)
+ *
+ * and correlate(B, C) the correlation
+ *
+ *   A(i) = sum_j B(i+j) conj(C(j))
+ *
+ * The domain of A depends on the mode:
+ *
+ *   convolveFull   all i where the sum has a term, from B.lbound() +
+ *                  C.lbound() to B.ubound() + C.ubound() for convolve,
+ *                  and from B.lbound() - C.ubound() to B.ubound() -
+ *                  C.lbound() for correlate;
+ *   convolveSame   the domain of B, so that a kernel whose domain is
+ *                  centred on 0 gives a centred result;
+ *   convolveValid  the i where all terms of the sum are in B (empty if
+ *                  C is larger than B).
+ *
+ * The sums are computed directly when the kernel is short, and with
+ * FFTs (overlap-add along the first rank when B is much longer than C)
+ * when this needs fewer operations; the method may also be forced.
+ * The FFTs are only used for floating-point and complex elements.
+ * With OpenMP both methods are split between threads.
+ */
+
 BZ_NAMESPACE(blitz)
 
-template<typename T>
-Array<T,1> convolve(const Array<T,1>& B, const Array<T,1>& C);
+enum ConvolutionMode { convolveFull, convolveSame, convolveValid };
+
+enum ConvolutionMethod { convolveAuto, convolveDirect, convolveFFT };
+
+template<typename T, int N>
+Array<T,N> convolve(const Array<T,N>& B, const Array<T,N>& C,
+                    ConvolutionMode mode = convolveFull,
+                    ConvolutionMethod method = convolveAuto);
+
+template<typename T, int N>
+Array<T,N> correlate(const Array<T,N>& B, const Array<T,N>& C,
+                     ConvolutionMode mode = convolveFull,
+                     ConvolutionMethod method = convolveAuto);
 
 BZ_NAMESPACE_END
 
@@ -186,6 +186,9 @@ public:
 
   T_result first_value() const { return iter_.first_value(); }
 
+  /// The wrapped expression.
+  const T_expr& iter() const { return iter_; }
+
 #ifdef BZ_ARRAY_EXPR_PASS_INDEX_BY_VALUE
     template<int N_rank>
     T_result operator()(const TinyVector<int, N_rank> i) const { return iter_(i); }
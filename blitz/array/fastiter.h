@@ -395,6 +395,12 @@ public:
   }
 
 protected:
+    /** Iterator over a container other than Array with the same
+        inquiry members, such as StaticArray. */
+    FastArrayIteratorBase(P_arraytype array, const P_numtype* data)
+        : data_(data), array_(array)
+    { }
+
   const P_numtype * restrict           data_;
   P_arraytype                          array_;
   ConstPointerStack<P_numtype,N_rank>  stack_;
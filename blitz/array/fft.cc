@@ -0,0 +1,786 @@
+/***************************************************************************
+ * blitz/array/fft.cc  Fast Fourier transforms
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_FFT_CC
+#define BZ_ARRAY_FFT_CC
+
+#ifndef BZ_ARRAY_FFT_H
+ #error <blitz/array/fft.cc> must be included via <blitz/array/fft.h>
+#endif
+
+BZ_NAMESPACE(blitz)
+
+/* Complex products written out, since the operators of complex<T>
+   check for infinities and NaNs and are not vectorized. */
+template<typename T>
+inline complex<T> _bz_fftMul(const complex<T>& a, const complex<T>& b)
+{
+    return complex<T>(a.real()*b.real() - a.imag()*b.imag(),
+                      a.real()*b.imag() + a.imag()*b.real());
+}
+
+// -i z
+template<typename T>
+inline complex<T> _bz_fftMulMinusI(const complex<T>& z)
+{
+    return complex<T>(z.imag(), -z.real());
+}
+
+// exp(-2 pi i j / n), computed in long double
+template<typename T>
+inline complex<T> _bz_fftRoot(long long j, long long n)
+{
+    const long double a = -2 * 3.14159265358979323846264338327950288L
+        * (long double)(j % n) / n;
+    return complex<T>(T(std::cos(a)), T(std::sin(a)));
+}
+
+template<typename T>
+FFTPlan<T>::FFTPlan(int n)
+    : n_(n), scratchSize_(n), inner_(0)
+{
+    BZPRECONDITION(n >= 0);
+
+    int rest = n;
+    while (rest > 1 && rest % 4 == 0) { radices_.push_back(4); rest /= 4; }
+    while (rest > 1 && rest % 2 == 0) { radices_.push_back(2); rest /= 2; }
+    while (rest > 1 && rest % 3 == 0) { radices_.push_back(3); rest /= 3; }
+    while (rest > 1 && rest % 5 == 0) { radices_.push_back(5); rest /= 5; }
+
+    if (rest > 1)
+    {
+        // Bluestein: X[k] = c[k] sum_j (x[j] c[j]) conj(c[k-j]), with
+        // the chirp c[k] = exp(-pi i k^2/n), as a cyclic convolution
+        // of length m >= 2n-1
+        radices_.clear();
+        int m = 1;
+        while (m < 2*n-1)
+            m *= 2;
+        inner_ = new FFTPlan<T>(m);
+        scratchSize_ = m + inner_->scratchSize_;
+
+        chirp_.resize(n);
+        for (long long k=0; k < n; ++k)
+            chirp_[k] = _bz_fftRoot<T>(k*k % (2*n), 2*n);
+
+        kernel_.assign(m, T_complex(0));
+        for (int k=0; k < n; ++k)
+        {
+            kernel_[k] = conj(chirp_[k]) / T(m);
+            if (k)
+                kernel_[m-k] = kernel_[k];
+        }
+        vector<T_complex> scratch(inner_->scratchSize_);
+        inner_->execute(&kernel_[0], &scratch[0]);
+        return;
+    }
+
+    // Twiddle factors of each stage of length ns = radix * m
+    int ns = n;
+    for (size_t s=0; s < radices_.size(); ++s)
+    {
+        const int r = radices_[s], m = ns / r;
+        for (int p=0; p < m; ++p)
+            for (int j=1; j < r; ++j)
+                twiddles_.push_back(_bz_fftRoot<T>((long long)j*p, ns));
+        ns = m;
+    }
+}
+
+template<typename T>
+FFTPlan<T>::~FFTPlan()
+{
+    delete inner_;
+}
+
+/** Plans by key, deleted at exit. */
+template<typename T_key, typename T_plan>
+class _bz_FFTPlanCache {
+public:
+    ~_bz_FFTPlanCache()
+    {
+        typename std::map<T_key, T_plan*>::iterator i;
+        for (i = plans_.begin(); i != plans_.end(); ++i)
+            delete i->second;
+    }
+
+    T_plan*& operator[](const T_key& key)
+    { return plans_[key]; }
+
+private:
+    std::map<T_key, T_plan*> plans_;
+};
+
+template<typename T>
+const FFTPlan<T>& FFTPlan<T>::get(int n)
+{
+    static _bz_FFTPlanCache<int, FFTPlan<T> > cache;
+    FFTPlan<T>* plan;
+#ifdef _OPENMP
+#pragma omp critical (bz_fftplans)
+#endif
+    {
+        FFTPlan<T>*& p = cache[n];
+        if (!p)
+            p = new FFTPlan<T>(n);
+        plan = p;
+    }
+    return *plan;
+}
+
+template<typename T>
+sizeType FFTPlan<T>::workspaceSize(int batch) const
+{
+    const sizeType single = n_ + scratchSize_;
+    if (batch <= 1 || inner_)
+        return single;
+    const sizeType batched = 2 * sizeType(batch) * n_;
+    return batched > single ? batched : single;
+}
+
+template<typename T>
+int FFTPlan<T>::nextFastLength(int n)
+{
+    for (int m = n > 1 ? n : 1; ; ++m)
+    {
+        int rest = m;
+        while (rest % 2 == 0) rest /= 2;
+        while (rest % 3 == 0) rest /= 3;
+        while (rest % 5 == 0) rest /= 5;
+        if (rest == 1)
+            return m;
+    }
+}
+
+/*
+ * One stage of the Stockham transform: x holds s interleaved sequences
+ * of length r*m, which are split into r sequences of length m each,
+ * stored interleaved in y:
+ *
+ *   y[q + s*(r*p + j)] = w^(j*p) sum_k x[q + s*(p + k*m)] exp(-2 pi i j k/r)
+ *
+ * The inner loops run over the s sequences, which are contiguous.
+ */
+template<typename T>
+void _bz_fftStage(int r, int m, int s, const complex<T>* restrict w,
+                  const complex<T>* restrict x, complex<T>* restrict y)
+{
+    typedef complex<T> T_complex;
+    const diffType ms = diffType(m) * s;
+
+    switch (r) {
+    case 2:
+        for (int p=0; p < m; ++p, w += 1)
+        {
+            const T_complex w1 = w[0];
+            const T_complex* restrict x0 = x + diffType(p)*s;
+            T_complex* restrict y0 = y + diffType(2*p)*s;
+            for (int q=0; q < s; ++q)
+            {
+                const T_complex a0 = x0[q], a1 = x0[q+ms];
+                y0[q] = a0 + a1;
+                y0[q+s] = _bz_fftMul(a0 - a1, w1);
+            }
+        }
+        break;
+
+    case 3:
+    {
+        const T c = T(-0.5L);
+        const T sn = T(0.86602540378443864676372317075293618L);
+        for (int p=0; p < m; ++p, w += 2)
+        {
+            const T_complex w1 = w[0], w2 = w[1];
+            const T_complex* restrict x0 = x + diffType(p)*s;
+            T_complex* restrict y0 = y + diffType(3*p)*s;
+            for (int q=0; q < s; ++q)
+            {
+                const T_complex a0 = x0[q], a1 = x0[q+ms], a2 = x0[q+2*ms];
+                const T_complex t1 = a1 + a2;
+                const T_complex u = a0 + c * t1;
+                const T_complex v = _bz_fftMulMinusI(sn * (a1 - a2));
+                y0[q] = a0 + t1;
+                y0[q+s] = _bz_fftMul(u + v, w1);
+                y0[q+2*s] = _bz_fftMul(u - v, w2);
+            }
+        }
+        break;
+    }
+
+    case 4:
+        for (int p=0; p < m; ++p, w += 3)
+        {
+            const T_complex w1 = w[0], w2 = w[1], w3 = w[2];
+            const T_complex* restrict x0 = x + diffType(p)*s;
+            T_complex* restrict y0 = y + diffType(4*p)*s;
+            for (int q=0; q < s; ++q)
+            {
+                const T_complex a0 = x0[q], a1 = x0[q+ms],
+                    a2 = x0[q+2*ms], a3 = x0[q+3*ms];
+                const T_complex t0 = a0 + a2, t1 = a0 - a2;
+                const T_complex t2 = a1 + a3;
+                const T_complex t3 = _bz_fftMulMinusI(a1 - a3);
+                y0[q] = t0 + t2;
+                y0[q+s] = _bz_fftMul(t1 + t3, w1);
+                y0[q+2*s] = _bz_fftMul(t0 - t2, w2);
+                y0[q+3*s] = _bz_fftMul(t1 - t3, w3);
+            }
+        }
+        break;
+
+    case 5:
+    {
+        const T c1 = T(0.30901699437494742410229341718281906L);
+        const T c2 = T(-0.80901699437494742410229341718281906L);
+        const T s1 = T(0.95105651629515357211643933337938214L);
+        const T s2 = T(0.58778525229247312916870595463907277L);
+        for (int p=0; p < m; ++p, w += 4)
+        {
+            const T_complex w1 = w[0], w2 = w[1], w3 = w[2], w4 = w[3];
+            const T_complex* restrict x0 = x + diffType(p)*s;
+            T_complex* restrict y0 = y + diffType(5*p)*s;
+            for (int q=0; q < s; ++q)
+            {
+                const T_complex a0 = x0[q], a1 = x0[q+ms],
+                    a2 = x0[q+2*ms], a3 = x0[q+3*ms], a4 = x0[q+4*ms];
+                const T_complex t1 = a1 + a4, t2 = a2 + a3;
+                const T_complex t3 = a1 - a4, t4 = a2 - a3;
+                const T_complex u1 = a0 + c1 * t1 + c2 * t2;
+                const T_complex u2 = a0 + c2 * t1 + c1 * t2;
+                const T_complex v1 = _bz_fftMulMinusI(s1 * t3 + s2 * t4);
+                const T_complex v2 = _bz_fftMulMinusI(s2 * t3 - s1 * t4);
+                y0[q] = a0 + t1 + t2;
+                y0[q+s] = _bz_fftMul(u1 + v1, w1);
+                y0[q+2*s] = _bz_fftMul(u2 + v2, w2);
+                y0[q+3*s] = _bz_fftMul(u2 - v2, w3);
+                y0[q+4*s] = _bz_fftMul(u1 - v1, w4);
+            }
+        }
+        break;
+    }
+
+    default:
+        BZPRECONDITION(0);
+    }
+}
+
+template<typename T>
+void FFTPlan<T>::execute(T_complex* restrict x, T_complex* restrict y,
+                         int batch) const
+{
+    if (inner_)
+    {
+        BZPRECONDITION(batch == 1);
+        executeBluestein(x, y);
+        return;
+    }
+
+    // the batch sequences are transformed like the subsequences of
+    // the later stages
+    T_complex* in = x;
+    T_complex* out = y;
+    const T_complex* w = radices_.empty() ? 0 : &twiddles_[0];
+    int ns = n_, s = batch;
+    for (size_t stage=0; stage < radices_.size(); ++stage)
+    {
+        const int r = radices_[stage], m = ns / r;
+        _bz_fftStage(r, m, s, w, in, out);
+        w += (r-1) * m;
+        ns = m;
+        s *= r;
+        T_complex* t = in;
+        in = out;
+        out = t;
+    }
+
+    if (in != x)
+        for (diffType i=0; i < diffType(n_)*batch; ++i)
+            x[i] = in[i];
+}
+
+template<typename T>
+void FFTPlan<T>::executeBluestein(T_complex* restrict x,
+                                  T_complex* restrict y) const
+{
+    const int m = inner_->length();
+    T_complex* restrict a = y;
+
+    int k = 0;
+    for (; k < n_; ++k)
+        a[k] = _bz_fftMul(x[k], chirp_[k]);
+    for (; k < m; ++k)
+        a[k] = T_complex(0);
+
+    inner_->execute(a, y + m);
+
+    // inverse transform of the product, as conj(forward(conj))
+    for (k=0; k < m; ++k)
+        a[k] = conj(_bz_fftMul(a[k], kernel_[k]));
+    inner_->execute(a, y + m);
+
+    for (k=0; k < n_; ++k)
+        x[k] = _bz_fftMul(chirp_[k], conj(a[k]));
+}
+
+template<typename T>
+void FFTPlan<T>::transform(T_complex* data, diffType stride, bool inverse,
+                           T_complex* work) const
+{
+    if (n_ <= 1)
+        return;
+
+    if ((stride == 1) && !inverse)
+    {
+        execute(data, work);
+        return;
+    }
+
+    // The inverse transform is conj(forward(conj(x)))
+    T_complex* restrict x = work;
+    if (inverse)
+        for (int i=0; i < n_; ++i)
+            x[i] = conj(data[i*stride]);
+    else
+        for (int i=0; i < n_; ++i)
+            x[i] = data[i*stride];
+
+    execute(x, work + n_);
+
+    if (inverse)
+        for (int i=0; i < n_; ++i)
+            data[i*stride] = conj(x[i]);
+    else
+        for (int i=0; i < n_; ++i)
+            data[i*stride] = x[i];
+}
+
+template<typename T>
+void FFTPlan<T>::transformBatch(T_complex* data, diffType stride,
+                                diffType batchStride, int batch,
+                                bool inverse, T_complex* work) const
+{
+    if (n_ <= 1)
+        return;
+
+    if ((batch == 1) || inner_)
+    {
+        for (int b=0; b < batch; ++b)
+            transform(data + b*batchStride, stride, inverse, work);
+        return;
+    }
+
+    // interleave the sequences: element j of sequence b goes to
+    // x[b + batch*j]
+    T_complex* restrict x = work;
+    for (int j=0; j < n_; ++j)
+    {
+        const T_complex* restrict d = data + j*stride;
+        T_complex* restrict xj = x + j*batch;
+        if (inverse)
+            for (int b=0; b < batch; ++b)
+                xj[b] = conj(d[b*batchStride]);
+        else
+            for (int b=0; b < batch; ++b)
+                xj[b] = d[b*batchStride];
+    }
+
+    execute(x, work + sizeType(batch)*n_, batch);
+
+    for (int j=0; j < n_; ++j)
+    {
+        T_complex* restrict d = data + j*stride;
+        const T_complex* restrict xj = x + j*batch;
+        if (inverse)
+            for (int b=0; b < batch; ++b)
+                d[b*batchStride] = conj(xj[b]);
+        else
+            for (int b=0; b < batch; ++b)
+                d[b*batchStride] = xj[b];
+    }
+}
+
+template<typename T>
+RealFFTPlan<T>::RealFFTPlan(int n)
+    : n_(n), plan_(FFTPlan<T>::get(n % 2 ? n : n/2))
+{
+    BZPRECONDITION(n >= 1);
+    if (n % 2 == 0)
+        for (int k=0; k <= n/2; ++k)
+            twiddles_.push_back(_bz_fftRoot<T>(k, n));
+}
+
+template<typename T>
+const RealFFTPlan<T>& RealFFTPlan<T>::get(int n)
+{
+    static _bz_FFTPlanCache<int, RealFFTPlan<T> > cache;
+    RealFFTPlan<T>* plan;
+#ifdef _OPENMP
+#pragma omp critical (bz_realfftplans)
+#endif
+    {
+        RealFFTPlan<T>*& p = cache[n];
+        if (!p)
+            p = new RealFFTPlan<T>(n);
+        plan = p;
+    }
+    return *plan;
+}
+
+/*
+ * A real sequence x of even length n = 2m is transformed as the
+ * complex sequence z[j] = x[2j] + i x[2j+1] of length m. With E and O
+ * the transforms of the even and odd elements of x,
+ *
+ *   E[k] = (Z[k] + conj(Z[m-k])) / 2,   O[k] = (Z[k] - conj(Z[m-k])) / 2i
+ *   X[k] = E[k] + exp(-2 pi i k/n) O[k]
+ */
+template<typename T>
+void RealFFTPlan<T>::forward(const T* in, diffType inStride, T_complex* out,
+                             diffType outStride, T_complex* work) const
+{
+    T_complex* restrict z = work;
+
+    if (n_ % 2)
+    {
+        for (int j=0; j < n_; ++j)
+            z[j] = T_complex(in[j*inStride]);
+        plan_.execute(z, work + n_);
+        for (int k=0; k <= n_/2; ++k)
+            out[k*outStride] = z[k];
+        return;
+    }
+
+    const int m = n_ / 2;
+    for (int j=0; j < m; ++j)
+        z[j] = T_complex(in[2*j*inStride], in[(2*j+1)*inStride]);
+    plan_.execute(z, work + m);
+
+    const T half = T(0.5);
+    for (int k=0; k <= m; ++k)
+    {
+        const T_complex zk = z[k < m ? k : 0];
+        const T_complex zc = conj(z[k > 0 ? m-k : 0]);
+        const T_complex e = (zk + zc) * half;
+        const T_complex o = _bz_fftMulMinusI(zk - zc) * half;
+        out[k*outStride] = e + _bz_fftMul(twiddles_[k], o);
+    }
+}
+
+/* The inverse recovers 2 E[k] and 2 O[k] from X[k] and conj(X[m-k]),
+   and transforms Z[k] = 2 E[k] + 2i O[k] back, which gives n z. */
+template<typename T>
+void RealFFTPlan<T>::inverse(const T_complex* in, diffType inStride, T* out,
+                             diffType outStride, T_complex* work) const
+{
+    T_complex* restrict z = work;
+
+    // inverse transforms are done as conj(forward(conj))
+    if (n_ % 2)
+    {
+        z[0] = conj(in[0]);
+        for (int k=1; k <= n_/2; ++k)
+        {
+            z[k] = conj(in[k*inStride]);
+            z[n_-k] = in[k*inStride];
+        }
+        plan_.execute(z, work + n_);
+        for (int j=0; j < n_; ++j)
+            out[j*outStride] = z[j].real();
+        return;
+    }
+
+    const int m = n_ / 2;
+    for (int k=0; k < m; ++k)
+    {
+        const T_complex xk = in[k*inStride];
+        const T_complex xc = conj(in[(m-k)*inStride]);
+        const T_complex e = xk + xc;
+        const T_complex o = _bz_fftMul(xk - xc, conj(twiddles_[k]));
+        z[k] = conj(e + T_complex(-o.imag(), o.real()));
+    }
+    plan_.execute(z, work + m);
+
+    for (int j=0; j < m; ++j)
+    {
+        out[2*j*outStride] = z[j].real();
+        out[(2*j+1)*outStride] = -z[j].imag();
+    }
+}
+
+template<typename T, int N>
+ArrayFFTPlan<T,N>::ArrayFFTPlan(const TinyVector<int,N>& extent,
+                                const TinyVector<diffType,N>& stride)
+    : extent_(extent), stride_(stride)
+{
+    for (int d=0; d < N; ++d)
+        plans_[d] = &FFTPlan<T>::get(extent(d));
+}
+
+template<typename T, int N>
+const ArrayFFTPlan<T,N>&
+ArrayFFTPlan<T,N>::get(const TinyVector<int,N>& extent,
+                       const TinyVector<diffType,N>& stride)
+{
+    static _bz_FFTPlanCache<vector<diffType>, ArrayFFTPlan<T,N> > cache;
+    vector<diffType> key(2*N);
+    for (int d=0; d < N; ++d)
+    {
+        key[d] = extent(d);
+        key[N+d] = stride(d);
+    }
+
+    ArrayFFTPlan<T,N>* plan;
+#ifdef _OPENMP
+#pragma omp critical (bz_arrayfftplans)
+#endif
+    {
+        ArrayFFTPlan<T,N>*& p = cache[key];
+        if (!p)
+            p = new ArrayFFTPlan<T,N>(extent, stride);
+        plan = p;
+    }
+    return *plan;
+}
+
+template<typename T, int N>
+void ArrayFFTPlan<T,N>::execute(T_complex* data, int rank,
+                                FFTDirection direction) const
+{
+    for (int d=0; d < N; ++d)
+        if (((rank < 0) || (d == rank)) && (extent_(d) > 1))
+            _bz_fftLines(data, extent_, stride_, d, *plans_[d],
+                         direction == fftInverse, true);
+}
+
+// offset of the first element of line l of the ranks other than rank
+// and inner
+template<int N>
+inline diffType _bz_fftLineOffset(sizeType l, const TinyVector<int,N>& extent,
+                                  const TinyVector<diffType,N>& stride,
+                                  int rank, int inner = -1)
+{
+    diffType offset = 0;
+    for (int d=N-1; d >= 0; --d)
+        if ((d != rank) && (d != inner))
+        {
+            offset += diffType(l % extent(d)) * stride(d);
+            l /= extent(d);
+        }
+    return offset;
+}
+
+/*
+ * The lines are transformed in batches of neighbours along the other
+ * rank with the smallest stride, so that the gathers and scatters of
+ * strided lines use whole cache lines.
+ */
+template<typename T, int N>
+void _bz_fftLines(complex<T>* data, const TinyVector<int,N>& extent,
+                  const TinyVector<diffType,N>& stride, int rank,
+                  const FFTPlan<T>& plan, bool inverse, bool parallel)
+{
+    BZPRECONDITION(plan.length() == extent(rank));
+
+    sizeType numLines = 1;
+    int inner = -1;
+    for (int d=0; d < N; ++d)
+        if (d != rank)
+        {
+            numLines *= extent(d);
+            if ((extent(d) > 1) && ((inner < 0) ||
+                (BZ_MATHFN_SCOPE(labs)(stride(d))
+                 < BZ_MATHFN_SCOPE(labs)(stride(inner)))))
+                inner = d;
+        }
+    if ((numLines == 0) || (plan.length() <= 1))
+        return;
+
+    const int innerExtent = inner < 0 ? 1 : extent(inner);
+    const diffType innerStride = inner < 0 ? 0 : stride(inner);
+    const int batch = innerExtent < BZ_FFT_BATCH_SIZE ?
+        innerExtent : BZ_FFT_BATCH_SIZE;
+    const int chunks = (innerExtent + batch - 1) / batch;
+    const diffType numItems = diffType(numLines / innerExtent) * chunks;
+
+#ifdef _OPENMP
+    parallel = parallel && (numItems > 1) && !omp_in_parallel();
+#pragma omp parallel if (parallel)
+#endif
+    {
+        vector<complex<T> > work(plan.workspaceSize(batch));
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (diffType item=0; item < numItems; ++item)
+        {
+            const int first = int(item % chunks) * batch;
+            const int count = first + batch <= innerExtent ?
+                batch : innerExtent - first;
+            plan.transformBatch(data + _bz_fftLineOffset(item / chunks,
+                                    extent, stride, rank, inner)
+                                + first * innerStride,
+                                stride(rank), innerStride, count, inverse,
+                                &work[0]);
+        }
+    }
+}
+
+// A view of A with lbounds 0
+template<typename T, int N>
+inline Array<T,N> _bz_fftZeroBased(const Array<T,N>& A)
+{
+    Array<T,N> V(A);
+    V.reindexSelf(TinyVector<int,N>(0));
+    return V;
+}
+
+template<typename T, int N>
+void fftInPlace(Array<complex<T>,N>& A, FFTDirection direction)
+{
+    if (A.numElements() == 0)
+        return;
+    ArrayFFTPlan<T,N>::get(A.extent(), A.stride()).
+        execute(A.data(), -1, direction);
+    if (direction == fftInverse)
+        A *= T(1) / T(A.numElements());
+}
+
+template<typename T, int N>
+void fftInPlace(Array<complex<T>,N>& A, int rank, FFTDirection direction)
+{
+    BZPRECONDITION((rank >= 0) && (rank < N));
+    if (A.numElements() == 0)
+        return;
+    ArrayFFTPlan<T,N>::get(A.extent(), A.stride()).
+        execute(A.data(), rank, direction);
+    if (direction == fftInverse)
+        A *= T(1) / T(A.extent(rank));
+}
+
+template<typename T, int N>
+Array<complex<T>,N> fft(const Array<complex<T>,N>& A)
+{
+    Array<complex<T>,N> X(A.extent());
+    X = _bz_fftZeroBased(A);
+    fftInPlace(X, fftForward);
+    return X;
+}
+
+template<typename T, int N>
+Array<complex<T>,N> ifft(const Array<complex<T>,N>& A)
+{
+    Array<complex<T>,N> X(A.extent());
+    X = _bz_fftZeroBased(A);
+    fftInPlace(X, fftInverse);
+    return X;
+}
+
+template<typename T, int N>
+Array<complex<T>,N> rfft(const Array<T,N>& A)
+{
+    const int last = N-1;
+    const int n = A.extent(last);
+    TinyVector<int,N> extent(A.extent());
+    extent(last) = n/2 + 1;
+    Array<complex<T>,N> X(extent);
+    if (A.numElements() == 0)
+        return X;
+
+    // real transforms along the last rank
+    const RealFFTPlan<T>& plan = RealFFTPlan<T>::get(n);
+    const diffType numLines = A.numElements() / n;
+#ifdef _OPENMP
+#pragma omp parallel if ((numLines > 1) && !omp_in_parallel())
+#endif
+    {
+        vector<complex<T> > work(plan.workspaceSize());
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (diffType l=0; l < numLines; ++l)
+            plan.forward(A.data() + _bz_fftLineOffset(l, A.extent(),
+                                                      A.stride(), last),
+                         A.stride(last),
+                         X.data() + _bz_fftLineOffset(l, X.extent(),
+                                                      X.stride(), last),
+                         X.stride(last), &work[0]);
+    }
+
+    // complex transforms along the others
+    const ArrayFFTPlan<T,N>& plan2 =
+        ArrayFFTPlan<T,N>::get(X.extent(), X.stride());
+    for (int d=0; d < last; ++d)
+        plan2.execute(X.data(), d, fftForward);
+    return X;
+}
+
+template<typename T, int N>
+Array<T,N> irfft(const Array<complex<T>,N>& X, int n)
+{
+    const int last = N-1;
+    BZPRECONDITION(X.extent(last) == n/2 + 1);
+    TinyVector<int,N> extent(X.extent());
+    extent(last) = n;
+    Array<T,N> A(extent);
+    if (A.numElements() == 0)
+        return A;
+
+    Array<complex<T>,N> Y(X.extent());
+    Y = _bz_fftZeroBased(X);
+    const ArrayFFTPlan<T,N>& plan2 =
+        ArrayFFTPlan<T,N>::get(Y.extent(), Y.stride());
+    for (int d=0; d < last; ++d)
+        plan2.execute(Y.data(), d, fftInverse);
+
+    const RealFFTPlan<T>& plan = RealFFTPlan<T>::get(n);
+    const diffType numLines = A.numElements() / n;
+#ifdef _OPENMP
+#pragma omp parallel if ((numLines > 1) && !omp_in_parallel())
+#endif
+    {
+        vector<complex<T> > work(plan.workspaceSize());
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (diffType l=0; l < numLines; ++l)
+            plan.inverse(Y.data() + _bz_fftLineOffset(l, Y.extent(),
+                                                      Y.stride(), last),
+                         Y.stride(last),
+                         A.data() + _bz_fftLineOffset(l, A.extent(),
+                                                      A.stride(), last),
+                         A.stride(last), &work[0]);
+    }
+
+    A *= T(1) / T(A.numElements());
+    return A;
+}
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_FFT_CC
@@ -0,0 +1,230 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/fft.h   Fast Fourier transforms
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_FFT_H
+#define BZ_ARRAY_FFT_H
+
+#ifndef BZ_ARRAY_H
+ #error <blitz/array/fft.h> must be included after <blitz/array.h>
+#endif
+
+#include <complex>
+#include <vector>
+#include <map>
+
+#ifdef _OPENMP
+ #include <omp.h>
+#endif
+
+/*
+ * Discrete Fourier transforms of arrays of complex<T> and T, T being
+ * float, double or long double:
+ *
+ *   X[k] = sum_j x[j] exp(-2 pi i j k / n)          (forward)
+ *   x[j] = 1/n sum_k X[k] exp(+2 pi i j k / n)      (inverse)
+ *
+ *   fft(A), ifft(A)       transform a complex array along all ranks,
+ *                         returning a new array with lbounds 0
+ *   fftInPlace(A, dir)    transforms A in place along all ranks, or
+ *   fftInPlace(A, r, dir) only along rank r
+ *   rfft(A)               transforms a real array; along the last
+ *                         rank only the n/2+1 non-negative frequencies
+ *                         are returned
+ *   irfft(X, n)           inverse of rfft, n being the extent of the
+ *                         last rank of the result
+ *
+ * A may be any view (any strides, including reversed ranks). The
+ * transforms are done along one rank at a time, each of the lines of
+ * a rank being transformed by a one-dimensional plan. Lines are
+ * transformed in batches of BZ_FFT_BATCH_SIZE neighbouring lines,
+ * interleaved so that the butterflies operate on one element of each
+ * line at a time and vectorize, and the batches are split between
+ * OpenMP threads.
+ *
+ * FFTPlan<T> transforms one length. Lengths whose prime factors are
+ * 2, 3 and 5 are transformed with a self-sorting (Stockham)
+ * mixed-radix algorithm using radix 4, 2, 3 and 5 butterflies; other
+ * lengths with Bluestein's algorithm, which expresses the transform as
+ * a convolution of power-of-two length. Its transforms are not scaled.
+ * ArrayFFTPlan<T,N> transforms arrays of one shape and stride. Plans
+ * only hold twiddle factors and may be used by several threads at
+ * once, each with its own workspace. The plans returned by get() are
+ * cached for the lifetime of the program.
+ */
+
+BZ_NAMESPACE(blitz)
+
+enum FFTDirection { fftForward, fftInverse };
+
+template<typename T>
+class FFTPlan {
+public:
+    typedef complex<T> T_complex;
+
+    explicit FFTPlan(int n);
+    ~FFTPlan();
+
+    /// The cached plan of length n.
+    static const FFTPlan& get(int n);
+
+    int length() const
+    { return n_; }
+
+    /** Number of complex elements of the workspace of transform(), or
+        of transformBatch() with the given batch size. */
+    sizeType workspaceSize(int batch = 1) const;
+
+    /** Transforms the n elements data[0], data[stride], ... in
+        place, using work as scratch space. */
+    void transform(T_complex* data, diffType stride, bool inverse,
+                   T_complex* work) const;
+
+    /** Transforms the batch sequences starting at data[0],
+        data[batchStride], ... which are usually neighbours in memory. */
+    void transformBatch(T_complex* data, diffType stride,
+                        diffType batchStride, int batch, bool inverse,
+                        T_complex* work) const;
+
+    /// The smallest length >= n whose only prime factors are 2, 3 and 5.
+    static int nextFastLength(int n);
+
+private:
+    FFTPlan(const FFTPlan&);
+    void operator=(const FFTPlan&);
+
+    /* Forward transform of batch interleaved sequences in x (element j
+       of sequence b being x[b + batch*j]), y is scratch. */
+    void execute(T_complex* restrict x, T_complex* restrict y,
+                 int batch = 1) const;
+    void executeBluestein(T_complex* restrict x, T_complex* restrict y) const;
+
+    template<typename T2> friend class RealFFTPlan;
+
+    int n_;
+    sizeType scratchSize_;
+
+    // Stockham stages: radices, and for each stage the twiddle factors
+    // w^(j*p) for the (radix-1)*m pairs (p,j)
+    vector<int> radices_;
+    vector<T_complex> twiddles_;
+
+    // Bluestein: power-of-two plan, chirp exp(-pi i k^2/n), and the
+    // scaled transform of the conjugate chirp
+    FFTPlan* inner_;
+    vector<T_complex> chirp_;
+    vector<T_complex> kernel_;
+};
+
+/** Transforms of real sequences of length n to their n/2+1
+    non-negative frequencies and back. Even lengths are transformed as
+    complex sequences of length n/2. The inverse is not scaled. */
+template<typename T>
+class RealFFTPlan {
+public:
+    typedef complex<T> T_complex;
+
+    explicit RealFFTPlan(int n);
+
+    static const RealFFTPlan& get(int n);
+
+    int length() const
+    { return n_; }
+
+    sizeType workspaceSize() const
+    { return 2 * sizeType(n_) + plan_.scratchSize_ + 2; }
+
+    void forward(const T* in, diffType inStride, T_complex* out,
+                 diffType outStride, T_complex* work) const;
+    void inverse(const T_complex* in, diffType inStride, T* out,
+                 diffType outStride, T_complex* work) const;
+
+private:
+    int n_;
+    const FFTPlan<T>& plan_;
+    // exp(-2 pi i k / n) for k <= n/2, for even n
+    vector<T_complex> twiddles_;
+};
+
+/** Transforms of arrays with one shape and stride along any of their
+    ranks. */
+template<typename T, int N>
+class ArrayFFTPlan {
+public:
+    typedef complex<T> T_complex;
+
+    ArrayFFTPlan(const TinyVector<int,N>& extent,
+                 const TinyVector<diffType,N>& stride);
+
+    static const ArrayFFTPlan& get(const TinyVector<int,N>& extent,
+                                   const TinyVector<diffType,N>& stride);
+
+    /** Transforms the array whose first element is at data along rank
+        (all ranks if rank < 0), without scaling. */
+    void execute(T_complex* data, int rank, FFTDirection direction) const;
+
+private:
+    TinyVector<int,N> extent_;
+    TinyVector<diffType,N> stride_;
+    const FFTPlan<T>* plans_[N];
+};
+
+/** Transforms all lines along one rank of the N-dimensional array
+    with the given extents and strides whose first element is at
+    data. The lines are split between OpenMP threads if parallel is
+    true. */
+template<typename T, int N>
+void _bz_fftLines(complex<T>* data, const TinyVector<int,N>& extent,
+                  const TinyVector<diffType,N>& stride, int rank,
+                  const FFTPlan<T>& plan, bool inverse, bool parallel);
+
+template<typename T, int N>
+void fftInPlace(Array<complex<T>,N>& A, FFTDirection direction = fftForward);
+
+template<typename T, int N>
+void fftInPlace(Array<complex<T>,N>& A, int rank,
+                FFTDirection direction = fftForward);
+
+template<typename T, int N>
+Array<complex<T>,N> fft(const Array<complex<T>,N>& A);
+
+template<typename T, int N>
+Array<complex<T>,N> ifft(const Array<complex<T>,N>& A);
+
+template<typename T, int N>
+Array<complex<T>,N> rfft(const Array<T,N>& A);
+
+template<typename T, int N>
+Array<T,N> irfft(const Array<complex<T>,N>& X, int n);
+
+BZ_NAMESPACE_END
+
+#include <blitz/array/fft.cc>
+
+#endif // BZ_ARRAY_FFT_H
@@ -0,0 +1,247 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/indexset.h  Precompiled index sets for array indirection
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_INDEXSET_H
+#define BZ_ARRAY_INDEXSET_H
+
+#include <blitz/array/domain.h>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+BZ_NAMESPACE(blitz)
+
+/** Traits class which converts the elements of an indirection
+    container to array positions. For rank-1 arrays, a container of
+    int can be used instead of a container of TinyVector<int,1>. */
+template<typename T_point, int N_rank>
+struct _bz_indirectPosition {
+    static const TinyVector<int,N_rank>& get(const T_point& p)
+    { return p; }
+};
+
+template<>
+struct _bz_indirectPosition<int, 1> {
+    static TinyVector<int,1> get(int p)
+    { return TinyVector<int,1>(p); }
+};
+
+/** A list of array positions which has been translated into memory
+    offsets for a particular array layout.
+
+    Indirection through an STL container of TinyVector<int,N> has to
+    compute the address of every point each time it is used. A
+    CompiledIndexSet does that once, so that A[I] = expr reduces to a
+    gather from the operands of expr and a scatter into A. The set
+    can be used with any array having the same bounds and strides as
+    the one it was compiled for, for example all the time levels of
+    a simulation.
+
+    If sortForLocality is true, the points are reordered by memory
+    offset so that the gather and scatter sweep through memory in
+    storage order. Repeated points keep their relative order, so an
+    assignment gives the same result as with the original list.
+    position(i) returns the index in the original container of the
+    i'th point of the set. */
+template<int N_rank>
+class CompiledIndexSet {
+public:
+    typedef TinyVector<int,N_rank>      T_index;
+    typedef TinyVector<diffType,N_rank> T_stride;
+    typedef T_index                     value_type;
+    typedef _bz_typename std::vector<T_index>::const_iterator const_iterator;
+    typedef const_iterator              iterator;
+
+    CompiledIndexSet()
+        : minOffset_(0), maxOffset_(0), sorted_(false), unique_(true)
+    {
+        lbound_ = 0;
+        extent_ = 0;
+        stride_ = 0;
+    }
+
+    template<typename T_container, typename T_numtype>
+    CompiledIndexSet(const T_container& points,
+        const Array<T_numtype,N_rank>& array, bool sortForLocality = true)
+    { compile(points, array, sortForLocality); }
+
+    template<typename T_container, typename T_numtype>
+    void compile(const T_container& points,
+        const Array<T_numtype,N_rank>& array, bool sortForLocality = true);
+
+    sizeType size() const
+    { return offsets_.size(); }
+
+    bool empty() const
+    { return offsets_.empty(); }
+
+    /// Offset of the i'th point relative to Array::dataZero().
+    diffType offset(sizeType i) const
+    { return offsets_[i]; }
+
+    const diffType* offsets() const
+    { return offsets_.empty() ? 0 : &offsets_[0]; }
+
+    /// Smallest and largest offset in the set.
+    diffType minOffset() const
+    { return minOffset_; }
+
+    diffType maxOffset() const
+    { return maxOffset_; }
+
+    const T_index& point(sizeType i) const
+    { return points_[i]; }
+
+    const_iterator begin() const
+    { return points_.begin(); }
+
+    const_iterator end() const
+    { return points_.end(); }
+
+    /// Index in the original container of the i'th point.
+    sizeType position(sizeType i) const
+    { return sorted_ ? position_[i] : i; }
+
+    bool isSorted() const
+    { return sorted_; }
+
+    /// True if no point occurs more than once in the set.
+    bool isUnique() const
+    { return unique_; }
+
+    const T_index& lbound() const
+    { return lbound_; }
+
+    const T_index& extent() const
+    { return extent_; }
+
+    const T_stride& stride() const
+    { return stride_; }
+
+    /** Returns true if the offsets of the set are valid for the array,
+        that is if it has the bounds and strides of the array the set
+        was compiled for. */
+    template<typename T_numtype>
+    bool isCompatible(const Array<T_numtype,N_rank>& array) const
+    {
+        for (int i=0; i < N_rank; ++i)
+            if ((array.lbound(i) != lbound_(i))
+                || (array.extent(i) != extent_(i))
+                || (array.stride(i) != stride_(i)))
+                return false;
+        return true;
+    }
+
+protected:
+    std::vector<diffType> offsets_;
+    std::vector<T_index>  points_;
+    std::vector<sizeType> position_;
+    T_index  lbound_;
+    T_index  extent_;
+    T_stride stride_;
+    diffType minOffset_;
+    diffType maxOffset_;
+    bool sorted_;
+    bool unique_;
+};
+
+template<int N_rank>
+template<typename T_container, typename T_numtype>
+void CompiledIndexSet<N_rank>::compile(const T_container& points,
+    const Array<T_numtype,N_rank>& array, bool sortForLocality)
+{
+    typedef _bz_indirectPosition<_bz_typename T_container::value_type,
+        N_rank> T_position;
+
+    lbound_ = array.lbound();
+    extent_ = array.extent();
+    stride_ = array.stride();
+    sorted_ = sortForLocality;
+
+    std::vector<std::pair<diffType,sizeType> > keys;
+    std::vector<T_index> original;
+
+    _bz_typename T_container::const_iterator iter = points.begin(),
+        end = points.end();
+    for (sizeType i=0; iter != end; ++iter, ++i)
+    {
+        const T_index p = T_position::get(*iter);
+
+        BZPRECHECK(array.isInRange(p),
+            "CompiledIndexSet: position " << p << " is out of range" << endl
+            << "Array lower bounds: " << array.lbound() << endl
+            << "Array upper bounds: " << array.ubound() << endl)
+
+        diffType offset = 0;
+        for (int r=0; r < N_rank; ++r)
+            offset += p(r) * stride_(r);
+
+        keys.push_back(std::make_pair(offset, i));
+        original.push_back(p);
+    }
+
+    // Pairs compare on the original position after the offset, so
+    // this keeps repeated points in their original order.
+    if (sorted_)
+        std::sort(keys.begin(), keys.end());
+
+    const sizeType n = keys.size();
+    offsets_.resize(n);
+    points_.resize(n);
+    position_.resize(sorted_ ? n : 0);
+    minOffset_ = maxOffset_ = 0;
+
+    for (sizeType i=0; i < n; ++i)
+    {
+        offsets_[i] = keys[i].first;
+        points_[i] = original[keys[i].second];
+        if (sorted_)
+            position_[i] = keys[i].second;
+
+        if ((i == 0) || (offsets_[i] < minOffset_))
+            minOffset_ = offsets_[i];
+        if ((i == 0) || (offsets_[i] > maxOffset_))
+            maxOffset_ = offsets_[i];
+    }
+
+    unique_ = true;
+    if (!sorted_)
+        std::sort(keys.begin(), keys.end());
+    for (sizeType i=1; i < n; ++i)
+        if (keys[i].first == keys[i-1].first)
+        {
+            unique_ = false;
+            break;
+        }
+}
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_INDEXSET_H
@@ -34,6 +34,9 @@
 
 #include <blitz/array/asexpr.h>
 #include <blitz/array/cartesian.h>
+#include <blitz/array/indexset.h>
+#include <blitz/array/mask.h>
+#include <blitz/update.h>
 
 BZ_NAMESPACE(blitz)
 
@@ -48,41 +51,361 @@ public:
     template<typename T_expr>
     void operator=(T_expr expr);
 
+    // Accumulating updates. A position which occurs several times in
+    // the index container is updated once for every occurrence, in
+    // the order of the container.
+    template<typename T_expr>
+    void operator+=(T_expr expr);
+    template<typename T_expr>
+    void operator-=(T_expr expr);
+    template<typename T_expr>
+    void operator*=(T_expr expr);
+    template<typename T_expr>
+    void operator/=(T_expr expr);
+
 protected:
     T_array& array_;
     T_index& index_;
 };
 
 // Forward declarations
-template<typename T_array, typename T_arrayiter, typename T_subdomain, typename T_expr>
+template<typename T_array, typename T_arrayiter, typename T_subdomain, 
+         typename T_expr, typename T_update>
 inline void applyOverSubdomain(const T_array& array, T_arrayiter& arrayIter,
-    T_subdomain subdomain, T_expr expr);
-template<typename T_array, typename T_arrayiter, int N_rank, typename T_expr>
+    T_subdomain subdomain, T_expr expr, T_update);
+template<typename T_array, typename T_arrayiter, int N_rank, typename T_expr,
+         typename T_update>
 inline void applyOverSubdomain(const T_array& array, T_arrayiter& arrayIter,
     RectDomain<N_rank> subdomain,
-    T_expr expr);
+    T_expr expr, T_update);
+template<typename T_array, typename T_index, typename T_expr, 
+         typename T_update>
+inline void _bz_indirectUpdate(T_array& array, T_index& index, T_expr expr,
+    T_update);
+template<typename T_array, int N_rank, typename T_expr, typename T_update>
+inline void _bz_indirectUpdate(T_array& array, 
+    CompiledIndexSet<N_rank>& index, T_expr expr, T_update);
+template<typename T_array, int N_rank, typename T_expr, typename T_update>
+inline void _bz_indirectUpdate(T_array& array, 
+    RunListDomain<N_rank>& domain, T_expr expr, T_update);
+template<typename T_array, int N_rank, typename T_expr, typename T_update>
+inline void _bz_indirectUpdate(T_array& array, 
+    CompiledMask<N_rank>& mask, T_expr expr, T_update);
 
 template<typename T_array, typename T_index> template<typename T_rhs>
 void IndirectArray<T_array, T_index>::operator=(T_rhs rhs)
 {
     typedef _bz_typename asExpr<T_rhs>::T_expr T_expr;
-    T_expr expr(rhs);
 
-    _bz_typename T_array::T_iterator arrayIter(array_);
+    _bz_indirectUpdate(array_, index_, T_expr(rhs), 
+        _bz_update<_bz_typename T_array::T_numtype,
+                   _bz_typename T_expr::T_result>());
+}
+
+#define BZ_INDIRECT_UPDATE(op,name)                                     \
+template<typename T_array, typename T_index> template<typename T_rhs>   \
+void IndirectArray<T_array, T_index>::operator op(T_rhs rhs)            \
+{                                                                       \
+    typedef _bz_typename asExpr<T_rhs>::T_expr T_expr;                  \
+                                                                        \
+    _bz_indirectUpdate(array_, index_, T_expr(rhs),                     \
+        name<_bz_typename T_array::T_numtype,                           \
+             _bz_typename T_expr::T_result>());                         \
+}
+
+BZ_INDIRECT_UPDATE(+=, _bz_plus_update)
+BZ_INDIRECT_UPDATE(-=, _bz_minus_update)
+BZ_INDIRECT_UPDATE(*=, _bz_multiply_update)
+BZ_INDIRECT_UPDATE(/=, _bz_divide_update)
+
+#undef BZ_INDIRECT_UPDATE
+
+/** Returns true if all array operands of the expression have the
+    same strides as the array, so that the expression can be read at
+    the memory offset of a position in the array. */
+template<typename T_array, typename T_expr>
+inline bool _bz_indirectCanGather(const T_array& array, const T_expr& expr)
+{
+    if (T_expr::numIndexPlaceholders > 0)
+        return false;
+
+    for (int i=0; i < T_array::rank_; ++i)
+        if (!expr.isStride(i, array.stride(i)))
+            return false;
+
+    return true;
+}
+
+/** Helper class which applies an indirect update over a container of
+    subdomains (RectDomain<N> strips) one at a time. */
+template<typename T_subdomain>
+struct _bz_indirectApplier {
+    template<typename T_array, typename T_index, typename T_expr, 
+             typename T_update>
+    static void apply(T_array& array, T_index& index, T_expr& expr, T_update)
+    {
+        _bz_typename T_array::T_iterator arrayIter(array);
+
+        _bz_typename T_index::iterator iter = index.begin(),
+                           end = index.end();
 
-    _bz_typename T_index::iterator iter = index_.begin(),
-                       end = index_.end();
+        for (; iter != end; ++iter)
+        {
+            _bz_typename T_index::value_type subdomain = *iter;
+            applyOverSubdomain(array, arrayIter, subdomain, expr, 
+                T_update());
+        }
+    }
+};
 
-    for (; iter != end; ++iter)
+/** Specialization for containers of single positions. Rather than
+    moving iterators to every point, the position is converted to a
+    memory offset which is used to both scatter into the array and
+    gather from the expression. Expressions with index placeholders
+    are evaluated at the position, and only expressions whose
+    operands have a different layout fall back to moving iterators. */
+template<int N_rank>
+struct _bz_indirectPointApplier {
+    template<typename T_array, typename T_index, typename T_expr, 
+             typename T_update>
+    static void apply(T_array& array, T_index& index, T_expr& expr, T_update)
     {
-        _bz_typename T_index::value_type subdomain = *iter;
-        applyOverSubdomain(array_, arrayIter, subdomain, expr);
+        typedef _bz_typename T_array::T_numtype T_numtype;
+        typedef _bz_indirectPosition<_bz_typename T_index::value_type, 
+            N_rank> T_position;
+
+        _bz_typename T_index::iterator iter = index.begin(),
+                           end = index.end();
+
+        if (T_expr::numIndexPlaceholders > 0)
+        {
+            for (; iter != end; ++iter)
+            {
+                const TinyVector<int,N_rank> p = T_position::get(*iter);
+                BZPRECHECK(array.isInRange(p),
+                    "In indirection using an STL container, one of the"
+                    << endl << "positions is out of range: " << endl << p)
+                T_update::update(array(p), expr(p));
+            }
+            return;
+        }
+
+        if (!_bz_indirectCanGather(array, expr))
+        {
+            _bz_typename T_array::T_iterator arrayIter(array);
+            for (; iter != end; ++iter)
+                applyOverSubdomain(array, arrayIter, T_position::get(*iter),
+                    expr, T_update());
+            return;
+        }
+
+        const TinyVector<diffType,N_rank>& stride = array.stride();
+        const TinyVector<int,N_rank> lbound = array.lbound();
+        T_numtype* restrict data = array.dataZero();
+
+        diffType origin = 0;
+        for (int r=0; r < N_rank; ++r)
+            origin += lbound(r) * stride(r);
+        expr.moveTo(lbound);
+
+        for (; iter != end; ++iter)
+        {
+            const TinyVector<int,N_rank> p = T_position::get(*iter);
+
+            BZPRECHECK(array.isInRange(p),
+                "In indirection using an STL container, one of the"
+                << endl << "positions is out of range: " << endl << p
+                << endl << "Array lower bounds: " << array.lbound() << endl
+                << "Array upper bounds: " << array.ubound() << endl)
+
+            diffType offset = 0;
+            for (int r=0; r < N_rank; ++r)
+                offset += p(r) * stride(r);
+
+            T_update::update(data[offset], expr.fastRead(offset - origin));
+        }
     }
+};
+
+template<int N_rank>
+struct _bz_indirectApplier<TinyVector<int,N_rank> > 
+    : public _bz_indirectPointApplier<N_rank> { };
+
+template<>
+struct _bz_indirectApplier<int> : public _bz_indirectPointApplier<1> { };
+
+/** Applies an update to the positions of an indirection container. */
+template<typename T_array, typename T_index, typename T_expr, 
+         typename T_update>
+inline void _bz_indirectUpdate(T_array& array, T_index& index, T_expr expr,
+    T_update)
+{
+    _bz_indirectApplier<_bz_typename T_index::value_type>::apply(array, 
+        index, expr, T_update());
+}
+
+/** Applies an update to the positions of a precompiled index set. The
+    offsets of the set are used directly, so this loop is a pure
+    gather/scatter which the compiler can vectorize. If there are no
+    repeated points in the set the iterations are independent. */
+template<typename T_array, int N_rank, typename T_expr, typename T_update>
+inline void _bz_indirectUpdate(T_array& array, 
+    CompiledIndexSet<N_rank>& index, T_expr expr, T_update)
+{
+    typedef _bz_typename T_array::T_numtype T_numtype;
+
+    BZPRECHECK(index.isCompatible(array),
+        "CompiledIndexSet used with an array with different bounds or"
+        << endl << "strides than the one it was compiled for." << endl
+        << "Array lower bounds: " << array.lbound() << endl
+        << "Array extent: " << array.extent() << endl
+        << "Index set lower bounds: " << index.lbound() << endl
+        << "Index set extent: " << index.extent())
+
+    const diffType n = index.size();
+    if (n == 0)
+        return;
+
+    if (!_bz_indirectCanGather(array, expr))
+    {
+        _bz_indirectPointApplier<N_rank>::apply(array, index, expr, 
+            T_update());
+        return;
+    }
+
+    const TinyVector<int,N_rank> lbound = array.lbound();
+    diffType origin = 0;
+    for (int r=0; r < N_rank; ++r)
+        origin += lbound(r) * array.stride(r);
+    expr.moveTo(lbound);
+
+    T_numtype* restrict data = array.dataZero();
+    const diffType* restrict offsets = index.offsets();
+
+    if (index.isUnique())
+    {
+#ifdef BZ_USE_ALIGNMENT_PRAGMAS
+#pragma ivdep
+#endif
+        for (diffType i=0; i < n; ++i)
+            T_update::update(data[offsets[i]], 
+                expr.fastRead(offsets[i] - origin));
+    }
+    else {
+        for (diffType i=0; i < n; ++i)
+            T_update::update(data[offsets[i]], 
+                expr.fastRead(offsets[i] - origin));
+    }
+}
+
+/** Applies an update over the runs of a run-list domain. If the array
+    and all operands have unit stride along the runs, each run is
+    evaluated like the unit-stride loops of the array evaluator: in
+    chunks of BZ_VECTORIZED_LOOP_WIDTH elements read with fastRead_tv,
+    then element by element with fastRead. Otherwise the runs are
+    evaluated with strided iteration. */
+template<typename T_array, int N_rank, typename T_expr, typename T_update>
+inline void _bz_runListUpdate(T_array& array, 
+    const RunListDomain<N_rank>& domain, T_expr& expr, T_update)
+{
+    typedef _bz_typename T_array::T_numtype T_numtype;
+
+    const sizeType numRuns = domain.numRuns();
+    const int r = domain.runRank();
+
+    if (T_expr::numIndexPlaceholders > 0)
+    {
+        for (sizeType i=0; i < numRuns; ++i)
+        {
+            TinyVector<int,N_rank> pos = domain.runStart(i);
+            const int length = domain.runLength(i);
+            for (int j=0; j < length; ++j, ++pos(r))
+                T_update::update(array(pos), expr(pos));
+        }
+        return;
+    }
+
+    const TinyVector<diffType,N_rank>& stride = array.stride();
+    const diffType arrayStride = stride(r);
+    const bool useUnitStride = (arrayStride == 1) && expr.isUnitStride(r);
+
+    if (!useUnitStride)
+        expr.loadStride(r);
+
+    for (sizeType i=0; i < numRuns; ++i)
+    {
+        const TinyVector<int,N_rank>& start = domain.runStart(i);
+        const int length = domain.runLength(i);
+
+        diffType offset = 0;
+        for (int j=0; j < N_rank; ++j)
+            offset += start(j) * stride(j);
+        T_numtype* restrict data = array.dataZero() + offset;
+
+        expr.moveTo(start);
+
+        if (useUnitStride)
+        {
+            // stencils (minWidth 0) can only use the scalar loop
+            const int loop_width = BZ_VECTORIZED_LOOP_WIDTH;
+            int j = 0;
+            if ((T_expr::minWidth > 0) && (loop_width > 1))
+                for (; j <= length - loop_width; j += loop_width)
+                    chunked_updater<T_numtype, T_expr, T_update, loop_width>::
+                        unaligned_update(data, expr, j);
+            for (; j < length; ++j)
+                T_update::update(data[j], expr.fastRead(j));
+        }
+        else {
+            for (int j=0; j < length; ++j)
+            {
+                T_update::update(*data, *expr);
+                data += arrayStride;
+                expr.advance();
+            }
+        }
+    }
+}
+
+/** Applies an update to the positions of a run-list domain. */
+template<typename T_array, int N_rank, typename T_expr, typename T_update>
+inline void _bz_indirectUpdate(T_array& array, 
+    RunListDomain<N_rank>& domain, T_expr expr, T_update)
+{
+    if (domain.isEmpty())
+        return;
+
+    BZPRECHECK(array.isInRange(domain.boundingBox().lbound())
+        && array.isInRange(domain.boundingBox().ubound()),
+        "RunListDomain is not contained in the array:" << endl
+        << "Domain bounding box: " << domain.boundingBox().lbound()
+        << " to " << domain.boundingBox().ubound() << endl
+        << "Array lower bounds: " << array.lbound() << endl
+        << "Array upper bounds: " << array.ubound() << endl)
+
+    _bz_runListUpdate(array, domain, expr, T_update());
+}
+
+/** Applies an update to the true elements of a compiled mask. */
+template<typename T_array, int N_rank, typename T_expr, typename T_update>
+inline void _bz_indirectUpdate(T_array& array, 
+    CompiledMask<N_rank>& mask, T_expr expr, T_update)
+{
+    BZPRECHECK(mask.isCompatible(array),
+        "CompiledMask used with an array with different bounds than"
+        << endl << "the mask it was compiled from." << endl
+        << "Array lower bounds: " << array.lbound() << endl
+        << "Array extent: " << array.extent() << endl
+        << "Mask lower bounds: " << mask.lbound() << endl
+        << "Mask extent: " << mask.extent())
+
+    _bz_runListUpdate(array, mask, expr, T_update());
 }
 
-template<typename T_array, typename T_arrayiter, typename T_subdomain, typename T_expr>
+template<typename T_array, typename T_arrayiter, typename T_subdomain, 
+         typename T_expr, typename T_update>
 inline void applyOverSubdomain(const T_array& BZ_DEBUG_PARAM(array), T_arrayiter& arrayIter, 
-    T_subdomain subdomain, T_expr expr)
+    T_subdomain subdomain, T_expr expr, T_update)
 {
     BZPRECHECK(array.isInRange(subdomain),
         "In indirection using an STL container of TinyVector<int,"
@@ -94,14 +417,16 @@ inline void applyOverSubdomain(const T_array& BZ_DEBUG_PARAM(array), T_arrayiter
     arrayIter.moveTo(subdomain);
     expr.moveTo(subdomain);
 
-    *const_cast<_bz_typename T_arrayiter::T_numtype*>(arrayIter.data()) = *expr;
+    T_update::update(*const_cast<_bz_typename T_arrayiter::T_numtype*>(
+        arrayIter.data()), *expr);
 }
 
 // Specialization for RectDomain<N>
-template<typename T_array, typename T_arrayiter, int N_rank, typename T_expr>
+template<typename T_array, typename T_arrayiter, int N_rank, typename T_expr,
+         typename T_update>
 inline void applyOverSubdomain(const T_array& BZ_DEBUG_PARAM(array), T_arrayiter& arrayIter, 
     RectDomain<N_rank> subdomain,
-    T_expr expr)
+    T_expr expr, T_update)
 {
     typedef _bz_typename T_array::T_numtype T_numtype;
 
@@ -172,7 +497,7 @@ inline void applyOverSubdomain(const T_array& BZ_DEBUG_PARAM(array), T_arrayiter
 
         int length = ubound - lbound + 1;
         for (int i=0; i < length; ++i)
-            *data++ = expr.fastRead(i);
+            T_update::update(*data++, expr.fastRead(i));
     }
     else {
 #endif
@@ -182,8 +507,8 @@ inline void applyOverSubdomain(const T_array& BZ_DEBUG_PARAM(array), T_arrayiter
 
     for (int i=lbound; i <= ubound; ++i)
     {
-        *const_cast<_bz_typename T_arrayiter::T_numtype*>(arrayIter.data()) 
-            = *expr;
+        T_update::update(*const_cast<_bz_typename T_arrayiter::T_numtype*>(
+            arrayIter.data()), *expr);
         expr.advance();
         arrayIter.advance();
     }
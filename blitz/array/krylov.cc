@@ -0,0 +1,723 @@
+/***************************************************************************
+ * blitz/array/krylov.cc   Krylov solvers for linear systems
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_KRYLOV_CC
+#define BZ_ARRAY_KRYLOV_CC
+
+#ifndef BZ_ARRAY_KRYLOV_H
+ #error <blitz/array/krylov.cc> must be included via <blitz/array/krylov.h>
+#endif
+
+BZ_NAMESPACE(blitz)
+
+/*
+ * The solvers work on the elements of contiguous arrays as plain
+ * vectors. Each kernel below is one pass over them, doing the updates
+ * of a step and accumulating its inner products: kernel(first, last,
+ * sums) handles elements first..last-1 and adds to sums.
+ */
+
+// elements per block of the kernels combining several vectors
+const int _bz_krylovBlockSize = 256;
+
+/** Runs kernel over n elements, returning its numSums sums in sums.
+    Large passes are split between OpenMP threads; the partial sums are
+    added in thread order, so the results do not depend on timing. */
+template<typename T, typename T_kernel>
+void _bz_krylovPass(const T_kernel& kernel, sizeType n, T* sums,
+                    int numSums)
+{
+    for (int k=0; k < numSums; ++k)
+        sums[k] = T(0);
+
+#ifdef _OPENMP
+    if ((n >= BZ_KRYLOV_THREADING_THRESHOLD) && !omp_in_parallel())
+    {
+        const int maxThreads = omp_get_max_threads();
+        vector<T> partial(sizeType(maxThreads) * numSums + 1, T(0));
+#pragma omp parallel num_threads(maxThreads)
+        {
+            const int nthreads = omp_get_num_threads();
+            const int thread = omp_get_thread_num();
+            kernel(diffType(n) * thread / nthreads,
+                   diffType(n) * (thread+1) / nthreads,
+                   &partial[0] + thread * numSums);
+        }
+        for (int t=0; t < maxThreads; ++t)
+            for (int k=0; k < numSums; ++k)
+                sums[k] += partial[t * numSums + k];
+        return;
+    }
+#endif
+
+    kernel(0, n, sums);
+}
+
+// y = x
+template<typename T>
+struct _bz_krylovCopy {
+    T* restrict y;
+    const T* restrict x;
+
+    _bz_krylovCopy(T* y_, const T* x_) : y(y_), x(x_) { }
+
+    void operator()(diffType first, diffType last, T*) const
+    {
+        for (diffType i=first; i < last; ++i)
+            y[i] = x[i];
+    }
+};
+
+// y = a x
+template<typename T>
+struct _bz_krylovScale {
+    T* restrict y;
+    const T* restrict x;
+    T a;
+
+    _bz_krylovScale(T* y_, const T* x_, T a_) : y(y_), x(x_), a(a_) { }
+
+    void operator()(diffType first, diffType last, T*) const
+    {
+        for (diffType i=first; i < last; ++i)
+            y[i] = a * x[i];
+    }
+};
+
+// (x, y)
+template<typename T>
+struct _bz_krylovDot {
+    const T* restrict x;
+    const T* restrict y;
+
+    _bz_krylovDot(const T* x_, const T* y_) : x(x_), y(y_) { }
+
+    void operator()(diffType first, diffType last, T* sums) const
+    {
+        T s = T(0);
+        for (diffType i=first; i < last; ++i)
+            s += _bz_krylovTraits<T>::conj(x[i]) * y[i];
+        sums[0] += s;
+    }
+};
+
+// r = b - r, (r, r)
+template<typename T>
+struct _bz_krylovResidual {
+    T* restrict r;
+    const T* restrict b;
+
+    _bz_krylovResidual(T* r_, const T* b_) : r(r_), b(b_) { }
+
+    void operator()(diffType first, diffType last, T* sums) const
+    {
+        T s = T(0);
+        for (diffType i=first; i < last; ++i)
+        {
+            const T t = b[i] - r[i];
+            r[i] = t;
+            s += _bz_krylovTraits<T>::abs2(t);
+        }
+        sums[0] += s;
+    }
+};
+
+// y += a x, (y, y)
+template<typename T>
+struct _bz_krylovAxpy {
+    T* restrict y;
+    const T* restrict x;
+    T a;
+
+    _bz_krylovAxpy(T* y_, const T* x_, T a_) : y(y_), x(x_), a(a_) { }
+
+    void operator()(diffType first, diffType last, T* sums) const
+    {
+        T s = T(0);
+        for (diffType i=first; i < last; ++i)
+        {
+            const T t = y[i] + a * x[i];
+            y[i] = t;
+            s += _bz_krylovTraits<T>::abs2(t);
+        }
+        sums[0] += s;
+    }
+};
+
+// (x, y), (x, x)
+template<typename T>
+struct _bz_krylovDot2 {
+    const T* restrict x;
+    const T* restrict y;
+
+    _bz_krylovDot2(const T* x_, const T* y_) : x(x_), y(y_) { }
+
+    void operator()(diffType first, diffType last, T* sums) const
+    {
+        T s = T(0), t = T(0);
+        for (diffType i=first; i < last; ++i)
+        {
+            s += _bz_krylovTraits<T>::conj(x[i]) * y[i];
+            t += _bz_krylovTraits<T>::abs2(x[i]);
+        }
+        sums[0] += s;
+        sums[1] += t;
+    }
+};
+
+// CG: x += alpha p, r -= alpha q, (r, r)
+template<typename T>
+struct _bz_krylovCGUpdate {
+    T* restrict x;
+    T* restrict r;
+    const T* restrict p;
+    const T* restrict q;
+    T alpha;
+
+    _bz_krylovCGUpdate(T* x_, T* r_, const T* p_, const T* q_, T alpha_)
+        : x(x_), r(r_), p(p_), q(q_), alpha(alpha_) { }
+
+    void operator()(diffType first, diffType last, T* sums) const
+    {
+        T s = T(0);
+        for (diffType i=first; i < last; ++i)
+        {
+            x[i] += alpha * p[i];
+            const T t = r[i] - alpha * q[i];
+            r[i] = t;
+            s += _bz_krylovTraits<T>::abs2(t);
+        }
+        sums[0] += s;
+    }
+};
+
+// p = r + beta (p - omega v); CG uses omega = 0
+template<typename T>
+struct _bz_krylovDirection {
+    T* restrict p;
+    const T* restrict r;
+    const T* restrict v;
+    T beta, omega;
+
+    _bz_krylovDirection(T* p_, const T* r_, const T* v_, T beta_, T omega_)
+        : p(p_), r(r_), v(v_), beta(beta_), omega(omega_) { }
+
+    void operator()(diffType first, diffType last, T*) const
+    {
+        if (v)
+            for (diffType i=first; i < last; ++i)
+                p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        else
+            for (diffType i=first; i < last; ++i)
+                p[i] = r[i] + beta * p[i];
+    }
+};
+
+// BiCGStab: x += alpha p + omega s, s -= omega t, (rhat, s), (s, s)
+template<typename T>
+struct _bz_krylovBiCGUpdate {
+    T* restrict x;
+    T* restrict s;
+    const T* restrict p;
+    const T* restrict t;
+    const T* restrict rhat;
+    T alpha, omega;
+
+    _bz_krylovBiCGUpdate(T* x_, T* s_, const T* p_, const T* t_,
+                         const T* rhat_, T alpha_, T omega_)
+        : x(x_), s(s_), p(p_), t(t_), rhat(rhat_), alpha(alpha_),
+          omega(omega_) { }
+
+    void operator()(diffType first, diffType last, T* sums) const
+    {
+        T rho = T(0), rr = T(0);
+        for (diffType i=first; i < last; ++i)
+        {
+            x[i] += alpha * p[i] + omega * s[i];
+            const T r = s[i] - omega * t[i];
+            s[i] = r;
+            rho += _bz_krylovTraits<T>::conj(rhat[i]) * r;
+            rr += _bz_krylovTraits<T>::abs2(r);
+        }
+        sums[0] += rho;
+        sums[1] += rr;
+    }
+};
+
+// (v[j], w) for j < k, and (w, w)
+template<typename T>
+struct _bz_krylovDots {
+    const T* const* v;
+    int k;
+    const T* restrict w;
+
+    _bz_krylovDots(const T* const* v_, int k_, const T* w_)
+        : v(v_), k(k_), w(w_) { }
+
+    void operator()(diffType first, diffType last, T* sums) const
+    {
+        for (diffType b=first; b < last; b += _bz_krylovBlockSize)
+        {
+            const diffType e = b + _bz_krylovBlockSize < last ?
+                b + _bz_krylovBlockSize : last;
+            for (int j=0; j < k; ++j)
+            {
+                const T* restrict vj = v[j];
+                T s = T(0);
+                for (diffType i=b; i < e; ++i)
+                    s += _bz_krylovTraits<T>::conj(vj[i]) * w[i];
+                sums[j] += s;
+            }
+            T s = T(0);
+            for (diffType i=b; i < e; ++i)
+                s += _bz_krylovTraits<T>::abs2(w[i]);
+            sums[k] += s;
+        }
+    }
+};
+
+// w += sum c[j] v[j], (w, w)
+template<typename T>
+struct _bz_krylovCombine {
+    T* restrict w;
+    const T* const* v;
+    const T* c;
+    int k;
+
+    _bz_krylovCombine(T* w_, const T* const* v_, const T* c_, int k_)
+        : w(w_), v(v_), c(c_), k(k_) { }
+
+    void operator()(diffType first, diffType last, T* sums) const
+    {
+        for (diffType b=first; b < last; b += _bz_krylovBlockSize)
+        {
+            const diffType e = b + _bz_krylovBlockSize < last ?
+                b + _bz_krylovBlockSize : last;
+            for (int j=0; j < k; ++j)
+            {
+                const T* restrict vj = v[j];
+                const T cj = c[j];
+                for (diffType i=b; i < e; ++i)
+                    w[i] += cj * vj[i];
+            }
+            T s = T(0);
+            for (diffType i=b; i < e; ++i)
+                s += _bz_krylovTraits<T>::abs2(w[i]);
+            sums[0] += s;
+        }
+    }
+};
+
+template<typename T, int N>
+void KrylovSolver<T,N>::allocate(const Array<T,N>& x, int count)
+{
+    if (((int)work_.size() == count + 2)
+        && all(work_[0].lbound() == x.lbound())
+        && all(work_[0].extent() == x.extent())
+        && all(work_[0].ordering() == x.ordering()))
+        return;
+
+    work_.clear();
+    GeneralArrayStorage<N> storage(x.ordering(), true);
+    for (int k=0; k < count; ++k)
+        work_.push_back(Array<T,N>(x.lbound(), x.extent(), storage));
+    // copies of x and b, allocated when needed
+    work_.push_back(Array<T,N>());
+    work_.push_back(Array<T,N>());
+}
+
+template<typename T, int N>
+inline bool _bz_krylovStoredLike(const Array<T,N>& A, const Array<T,N>& W)
+{
+    return all(A.extent() == W.extent()) && all(A.stride() == W.stride())
+        && A.isStorageContiguous();
+}
+
+template<typename T, int N>
+Array<T,N>& KrylovSolver<T,N>::flatten(Array<T,N>& x)
+{
+    if (_bz_krylovStoredLike(x, work_[0]))
+        return x;
+
+    Array<T,N>& X = work_[work_.size() - 2];
+    if (X.numElements() == 0)
+        X.reference(Array<T,N>(work_[0].lbound(), work_[0].extent(),
+                               GeneralArrayStorage<N>(x.ordering(), true)));
+    X = x;
+    return X;
+}
+
+template<typename T, int N>
+const Array<T,N>& KrylovSolver<T,N>::flatten(const Array<T,N>& b)
+{
+    BZPRECONDITION(all(b.extent() == work_[0].extent()));
+    if (_bz_krylovStoredLike(b, work_[0]))
+        return b;
+
+    Array<T,N>& B = work_[work_.size() - 1];
+    if (B.numElements() == 0)
+        B.reference(Array<T,N>(work_[0].lbound(), work_[0].extent(),
+                               GeneralArrayStorage<N>(b.ordering(), true)));
+    Array<T,N> bv(b);
+    bv.reindexSelf(B.lbound());
+    B = bv;
+    return B;
+}
+
+template<typename T, int N>
+void KrylovSolver<T,N>::unflatten(Array<T,N>& x, const Array<T,N>& X)
+{
+    if (&X != &x)
+        x = X;
+}
+
+template<typename T, int N>
+double KrylovSolver<T,N>::target(const T* b) const
+{
+    T sums[1];
+    _bz_krylovPass(_bz_krylovDot<T>(b, b), size(), sums, 1);
+    const double bnorm = BZ_MATHFN_SCOPE(sqrt)(_bz_krylovTraits<T>::real(
+        sums[0]));
+    return relative_ * bnorm > absolute_ ? relative_ * bnorm : absolute_;
+}
+
+template<typename T, int N>
+bool KrylovSolver<T,N>::finished(int iteration, double residual,
+                                 double target, KrylovResult& result) const
+{
+    result.iterations = iteration;
+    result.residual = residual;
+    result.converged = residual <= target;
+
+    bool stop = result.converged || (iteration >= maxIterations_);
+    if (callback_ && !callback_(iteration, residual, callbackData_))
+        stop = true;
+    return stop;
+}
+
+template<typename T>
+inline double _bz_krylovNorm(T sum)
+{
+    return BZ_MATHFN_SCOPE(sqrt)(_bz_krylovTraits<T>::real(sum));
+}
+
+template<typename T, int N> template<typename T_operator>
+KrylovResult ConjugateGradient<T,N>::solve(const T_operator& A,
+                                           Array<T,N>& x,
+                                           const Array<T,N>& b)
+{
+    this->allocate(x, 3);
+    Array<T,N>& r = this->work(0);
+    Array<T,N>& p = this->work(1);
+    Array<T,N>& q = this->work(2);
+    Array<T,N>& X = this->flatten(x);
+    const Array<T,N>& B = this->flatten(b);
+
+    const sizeType n = this->size();
+    T* xd = X.dataFirst();
+    T* rd = r.dataFirst();
+    T* pd = p.dataFirst();
+    T* qd = q.dataFirst();
+    const double target = this->target(B.dataFirst());
+
+    KrylovResult result;
+    T sums[1];
+    A(X, r);
+    _bz_krylovPass(_bz_krylovResidual<T>(rd, B.dataFirst()), n, sums, 1);
+    T rho = sums[0];
+    if (!this->finished(0, _bz_krylovNorm(rho), target, result))
+    {
+        _bz_krylovPass(_bz_krylovCopy<T>(pd, rd), n, sums, 0);
+        for (int iteration=1; ; ++iteration)
+        {
+            A(p, q);
+            _bz_krylovPass(_bz_krylovDot<T>(pd, qd), n, sums, 1);
+            if (sums[0] == T(0))
+                break;
+            const T alpha = rho / sums[0];
+
+            _bz_krylovPass(_bz_krylovCGUpdate<T>(xd, rd, pd, qd, alpha), n,
+                           sums, 1);
+            const T rhoNew = sums[0];
+            if (this->finished(iteration, _bz_krylovNorm(rhoNew), target,
+                               result))
+                break;
+
+            _bz_krylovPass(_bz_krylovDirection<T>(pd, rd, 0, rhoNew / rho,
+                                                  T(0)), n, sums, 0);
+            rho = rhoNew;
+        }
+    }
+
+    this->unflatten(x, X);
+    return result;
+}
+
+/*
+ * BiCGStab (van der Vorst), with the residual s = r - alpha v
+ * overwriting r.
+ */
+template<typename T, int N> template<typename T_operator>
+KrylovResult BiCGStab<T,N>::solve(const T_operator& A, Array<T,N>& x,
+                                  const Array<T,N>& b)
+{
+    this->allocate(x, 5);
+    Array<T,N>& r = this->work(0);
+    Array<T,N>& rhat = this->work(1);
+    Array<T,N>& p = this->work(2);
+    Array<T,N>& v = this->work(3);
+    Array<T,N>& t = this->work(4);
+    Array<T,N>& X = this->flatten(x);
+    const Array<T,N>& B = this->flatten(b);
+
+    const sizeType n = this->size();
+    T* xd = X.dataFirst();
+    T* rd = r.dataFirst();
+    T* rhatd = rhat.dataFirst();
+    T* pd = p.dataFirst();
+    T* vd = v.dataFirst();
+    T* td = t.dataFirst();
+    const double target = this->target(B.dataFirst());
+
+    KrylovResult result;
+    T sums[2];
+    A(X, r);
+    _bz_krylovPass(_bz_krylovResidual<T>(rd, B.dataFirst()), n, sums, 1);
+    T rho = sums[0];
+    if (!this->finished(0, _bz_krylovNorm(rho), target, result))
+    {
+        _bz_krylovPass(_bz_krylovCopy<T>(rhatd, rd), n, sums, 0);
+        _bz_krylovPass(_bz_krylovCopy<T>(pd, rd), n, sums, 0);
+        for (int iteration=1; ; ++iteration)
+        {
+            A(p, v);
+            _bz_krylovPass(_bz_krylovDot<T>(rhatd, vd), n, sums, 1);
+            if (sums[0] == T(0))
+                break;
+            const T alpha = rho / sums[0];
+
+            _bz_krylovPass(_bz_krylovAxpy<T>(rd, vd, -alpha), n, sums, 1);
+            const double snorm = _bz_krylovNorm(sums[0]);
+            if (snorm <= target)
+            {
+                _bz_krylovPass(_bz_krylovAxpy<T>(xd, pd, alpha), n, sums, 1);
+                this->finished(iteration, snorm, target, result);
+                break;
+            }
+
+            A(r, t);
+            _bz_krylovPass(_bz_krylovDot2<T>(td, rd), n, sums, 2);
+            if (sums[1] == T(0))
+                break;
+            const T omega = sums[0] / sums[1];
+
+            _bz_krylovPass(_bz_krylovBiCGUpdate<T>(xd, rd, pd, td, rhatd,
+                                                   alpha, omega), n, sums, 2);
+            const T rhoNew = sums[0];
+            if (this->finished(iteration, _bz_krylovNorm(sums[1]), target,
+                               result) || (rhoNew == T(0)) || (omega == T(0)))
+                break;
+
+            _bz_krylovPass(_bz_krylovDirection<T>(pd, rd, vd,
+                               (rhoNew / rho) * (alpha / omega), omega),
+                           n, sums, 0);
+            rho = rhoNew;
+        }
+    }
+
+    this->unflatten(x, X);
+    return result;
+}
+
+/*
+ * Restarted GMRES (Saad and Schultz). The Arnoldi vectors are
+ * orthogonalized by classical Gram-Schmidt, which needs one pass for
+ * the inner products with all previous vectors and one for the
+ * update; it is repeated when the norm drops by more than a factor
+ * 0.7, which keeps the basis as orthogonal as modified Gram-Schmidt
+ * would. The least-squares problem is solved with Givens rotations.
+ */
+template<typename T, int N> template<typename T_operator>
+KrylovResult GMRES<T,N>::solve(const T_operator& A, Array<T,N>& x,
+                               const Array<T,N>& b)
+{
+    typedef _bz_krylovTraits<T> traits;
+    const int m = restart_;
+    this->allocate(x, m + 2);
+    Array<T,N>& w = this->work(m + 1);
+    Array<T,N>& X = this->flatten(x);
+    const Array<T,N>& B = this->flatten(b);
+
+    const sizeType n = this->size();
+    T* xd = X.dataFirst();
+    T* wd = w.dataFirst();
+    vector<T*> v(m + 1);
+    for (int j=0; j <= m; ++j)
+        v[j] = this->work(j).dataFirst();
+    const T* const* vc = &v[0];
+    const double target = this->target(B.dataFirst());
+
+    H_.resize((m + 1) * m);
+    c_.resize(m);
+    s_.resize(m);
+    g_.resize(m + 1);
+    vector<T> sums(m + 2), h(m + 2);
+
+    KrylovResult result;
+    int iteration = 0;
+    bool stop = false;
+    while (!stop)
+    {
+        A(X, w);
+        _bz_krylovPass(_bz_krylovResidual<T>(wd, B.dataFirst()), n, &sums[0],
+                       1);
+        const double beta = _bz_krylovNorm(sums[0]);
+        if ((iteration == 0) && this->finished(0, beta, target, result))
+            break;
+        if (beta == 0)
+            break;
+        _bz_krylovPass(_bz_krylovScale<T>(v[0], wd, T(1 / beta)), n,
+                       &sums[0], 0);
+        g_.assign(m + 1, T(0));
+        g_[0] = T(beta);
+
+        int k = 0;
+        while ((k < m) && !stop)
+        {
+            ++iteration;
+            Array<T,N>& vk = this->work(k);
+            A(vk, w);
+
+            // w -= sum (v[j], w) v[j], twice if needed
+            T* Hk = &H_[0] + k * (m + 1);
+            for (int j=0; j <= k+1; ++j)
+                Hk[j] = T(0);
+            double norm;
+            for (int pass=0; ; ++pass)
+            {
+                _bz_krylovPass(_bz_krylovDots<T>(vc, k+1, wd), n, &sums[0],
+                               k + 2);
+                const double before = _bz_krylovNorm(sums[k+1]);
+                for (int j=0; j <= k; ++j)
+                {
+                    Hk[j] += sums[j];
+                    h[j] = -sums[j];
+                }
+                _bz_krylovPass(_bz_krylovCombine<T>(wd, vc, &h[0], k+1), n,
+                               &sums[0], 1);
+                norm = _bz_krylovNorm(sums[0]);
+                if ((norm > 0.7 * before) || (pass == 1))
+                    break;
+            }
+            Hk[k+1] = T(norm);
+            if (norm != 0)
+                _bz_krylovPass(_bz_krylovScale<T>(v[k+1], wd, T(1 / norm)),
+                               n, &sums[0], 0);
+
+            // apply the previous rotations, and a new one zeroing Hk[k+1]
+            for (int j=0; j < k; ++j)
+            {
+                const T a = Hk[j], d = Hk[j+1];
+                Hk[j] = c_[j] * a + s_[j] * d;
+                Hk[j+1] = c_[j] * d - traits::conj(s_[j]) * a;
+            }
+            const double a = traits::abs(Hk[k]), d = norm;
+            if (d == 0)
+            {
+                c_[k] = T(1);
+                s_[k] = T(0);
+            }
+            else if (a == 0)
+            {
+                c_[k] = T(0);
+                s_[k] = T(1);
+            }
+            else
+            {
+                const double t = BZ_MATHFN_SCOPE(sqrt)(a*a + d*d);
+                c_[k] = T(a / t);
+                s_[k] = Hk[k] * T(d / (a * t));
+            }
+            Hk[k] = c_[k] * Hk[k] + s_[k] * Hk[k+1];
+            Hk[k+1] = T(0);
+            g_[k+1] = -traits::conj(s_[k]) * g_[k];
+            g_[k] = c_[k] * g_[k];
+            ++k;
+
+            stop = this->finished(iteration, traits::abs(g_[k]), target,
+                                  result) || (norm == 0);
+        }
+
+        // x += sum y[j] v[j], H y = g being upper triangular
+        for (int i=k-1; i >= 0; --i)
+        {
+            T yi = g_[i];
+            for (int j=i+1; j < k; ++j)
+                yi -= H_[j * (m + 1) + i] * h[j];
+            h[i] = yi / H_[i * (m + 1) + i];
+        }
+        _bz_krylovPass(_bz_krylovCombine<T>(xd, vc, &h[0], k), n, &sums[0],
+                       1);
+    }
+
+    this->unflatten(x, X);
+    return result;
+}
+
+template<typename T>
+void DenseOperator<T>::operator()(const Array<T,1>& x, Array<T,1>& y) const
+{
+    BZPRECONDITION((A_.extent(0) == y.extent(0))
+                   && (A_.extent(1) == x.extent(0)));
+    const int rows = A_.extent(0), cols = A_.extent(1);
+    const T* restrict a0 = &A_(A_.lbound());
+    const diffType as0 = A_.stride(0), as1 = A_.stride(1);
+    const T* restrict xd = &x(x.lbound(0));
+    const diffType xs = x.stride(0);
+    T* restrict yd = &y(y.lbound(0));
+    const diffType ys = y.stride(0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) \
+    if ((sizeType(rows) * cols >= BZ_KRYLOV_THREADING_THRESHOLD) \
+        && !omp_in_parallel())
+#endif
+    for (int i=0; i < rows; ++i)
+    {
+        const T* restrict a = a0 + i * as0;
+        T s = T(0);
+        for (int j=0; j < cols; ++j)
+            s += a[j * as1] * xd[j * xs];
+        yd[i * ys] = s;
+    }
+}
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_KRYLOV_CC
@@ -0,0 +1,249 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/krylov.h   Krylov solvers for linear systems
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_KRYLOV_H
+#define BZ_ARRAY_KRYLOV_H
+
+#ifndef BZ_ARRAY_H
+ #error <blitz/array/krylov.h> must be included after <blitz/array.h>
+#endif
+
+#include <complex>
+#include <vector>
+
+#ifdef _OPENMP
+ #include <omp.h>
+#endif
+
+/*
+ * Iterative solvers of A x = b, x and b being Array<T,N> of the same
+ * shape and T a floating-point or complex type:
+ *
+ *   ConjugateGradient<T,N>   A Hermitian positive definite
+ *   BiCGStab<T,N>            any nonsingular A
+ *   GMRES<T,N>(restart)      any nonsingular A, restarted every
+ *                            restart iterations
+ *
+ * The operator A is any object with
+ *
+ *   void operator()(const Array<T,N>& x, Array<T,N>& y) const
+ *
+ * setting y = A x, where y has the domain of x: a matrix-free functor,
+ * a DenseOperator wrapping an Array<T,2> (N = 1), or a StencilOperator
+ * applying a stencil over the interior of the domain.
+ *
+ * solve(A, x, b) starts from the initial guess in x and stops when the
+ * residual norm |b - A x| is at most max(relative * |b|, absolute), or
+ * after the maximum number of iterations. The vector updates and the
+ * inner products of each step are fused into single passes over the
+ * data, split between OpenMP threads for large vectors. A solver keeps
+ * its work arrays between solves of the same shape. Nothing is printed;
+ * a callback may be set to watch (or stop) the iterations.
+ */
+
+BZ_NAMESPACE(blitz)
+
+/** Called with the initial residual norm (iteration 0) and after each
+    iteration with its residual norm; returning false stops the
+    solver. */
+typedef bool (*KrylovCallback)(int iteration, double residual, void* data);
+
+struct KrylovResult {
+    int iterations;
+    double residual;
+    bool converged;
+};
+
+template<typename T>
+struct _bz_krylovTraits {
+    static T conj(T x)
+    { return x; }
+    static T abs2(T x)
+    { return x * x; }
+    static double abs(T x)
+    { return BZ_MATHFN_SCOPE(fabs)(double(x)); }
+    static double real(T x)
+    { return double(x); }
+};
+
+template<typename T>
+struct _bz_krylovTraits<complex<T> > {
+    static complex<T> conj(const complex<T>& x)
+    { return complex<T>(x.real(), -x.imag()); }
+    static complex<T> abs2(const complex<T>& x)
+    { return complex<T>(x.real()*x.real() + x.imag()*x.imag()); }
+    static double abs(const complex<T>& x)
+    { return double(std::abs(x)); }
+    static double real(const complex<T>& x)
+    { return double(x.real()); }
+};
+
+/** Solver parameters and work arrays shared by the Krylov solvers. */
+template<typename T, int N>
+class KrylovSolver {
+public:
+    KrylovSolver()
+        : maxIterations_(1000), relative_(1e-8), absolute_(0),
+          callback_(0), callbackData_(0)
+    { }
+
+    void setMaxIterations(int n)
+    { maxIterations_ = n; }
+
+    int maxIterations() const
+    { return maxIterations_; }
+
+    /// Stop when |b - A x| <= max(relative * |b|, absolute).
+    void setTolerance(double relative, double absolute = 0)
+    {
+        relative_ = relative;
+        absolute_ = absolute;
+    }
+
+    void setCallback(KrylovCallback callback, void* data = 0)
+    {
+        callback_ = callback;
+        callbackData_ = data;
+    }
+
+protected:
+    /* Makes count contiguous work arrays with the domain of x, plus two
+       for copies of x and b when they are not stored like them. */
+    void allocate(const Array<T,N>& x, int count);
+
+    Array<T,N>& work(int k)
+    { return work_[k]; }
+
+    /* x itself if it is stored like the work arrays, else a copy of
+       it which is stored like them. */
+    Array<T,N>& flatten(Array<T,N>& x);
+    const Array<T,N>& flatten(const Array<T,N>& b);
+    // copies the solution X back to x if X is a copy
+    void unflatten(Array<T,N>& x, const Array<T,N>& X);
+
+    // the residual norm at which to stop
+    double target(const T* b) const;
+
+    /* Records the state after an iteration, calls the callback and
+       returns true if the solver should stop. */
+    bool finished(int iteration, double residual, double target,
+                  KrylovResult& result) const;
+
+    sizeType size() const
+    { return work_.empty() ? 0 : work_[0].numElements(); }
+
+    int maxIterations_;
+    double relative_, absolute_;
+    KrylovCallback callback_;
+    void* callbackData_;
+
+    vector<Array<T,N> > work_;
+};
+
+template<typename T, int N>
+class ConjugateGradient : public KrylovSolver<T,N> {
+public:
+    template<typename T_operator>
+    KrylovResult solve(const T_operator& A, Array<T,N>& x,
+                       const Array<T,N>& b);
+};
+
+template<typename T, int N>
+class BiCGStab : public KrylovSolver<T,N> {
+public:
+    template<typename T_operator>
+    KrylovResult solve(const T_operator& A, Array<T,N>& x,
+                       const Array<T,N>& b);
+};
+
+template<typename T, int N>
+class GMRES : public KrylovSolver<T,N> {
+public:
+    explicit GMRES(int restart = 30)
+        : restart_(restart)
+    { BZPRECONDITION(restart >= 1); }
+
+    void setRestart(int restart)
+    {
+        BZPRECONDITION(restart >= 1);
+        restart_ = restart;
+    }
+
+    template<typename T_operator>
+    KrylovResult solve(const T_operator& A, Array<T,N>& x,
+                       const Array<T,N>& b);
+
+private:
+    int restart_;
+    // Hessenberg matrix (column-major), rotations and right-hand side
+    vector<T> H_, c_, s_, g_;
+};
+
+/** The operator y = A x of a dense matrix. */
+template<typename T>
+class DenseOperator {
+public:
+    explicit DenseOperator(const Array<T,2>& A)
+        : A_(A)
+    { }
+
+    void operator()(const Array<T,1>& x, Array<T,1>& y) const;
+
+private:
+    Array<T,2> A_;
+};
+
+/** The operator y = stencil(x) over the interior of the domain of x,
+    y being 0 on the boundary. The stencil is applied with
+    applyStencil() (<blitz/array/stencils.h>). */
+template<typename T_stencil>
+class StencilOperator {
+public:
+    explicit StencilOperator(const T_stencil& stencil)
+        : stencil_(stencil)
+    { }
+
+    template<typename T, int N>
+    void operator()(const Array<T,N>& x, Array<T,N>& y) const
+    {
+        Array<T,N> xv(x);
+        y = 0;
+        applyStencil(stencil_, y, xv);
+    }
+
+private:
+    T_stencil stencil_;
+};
+
+BZ_NAMESPACE_END
+
+#include <blitz/array/krylov.cc>
+
+#endif // BZ_ARRAY_KRYLOV_H
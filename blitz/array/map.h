@@ -440,6 +440,9 @@ public:
   //       : iter_(a)
   //   { }
 
+  /// The mapped expression.
+  const T_expr& iter() const { return iter_; }
+
   // these bypass the FAI and go directly to the array. That should
   // prevent any performance impact of using the FAI instead of an
   // array directly.
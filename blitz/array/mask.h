@@ -0,0 +1,114 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/mask.h  Compiled masks for sparse masked assignment
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_MASK_H
+#define BZ_ARRAY_MASK_H
+
+#include <blitz/array/runlist.h>
+
+BZ_NAMESPACE(blitz)
+
+/** A mask compressed into runs of consecutive true elements.
+
+    A = where(mask, expr, A) evaluates expr and reads A over the whole
+    domain, which is wasteful when only a few elements of the mask are
+    set. A CompiledMask scans the mask once and stores the runs of set
+    elements along the rank with the smallest stride in the mask's
+    storage. A[m] = expr then evaluates expr only over these runs. When
+    A and the operands have unit stride along the runs, long runs are
+    evaluated in vectorized chunks with fastRead_tv, like the unit-stride
+    loops of ordinary array assignments; otherwise each run uses a
+    strided loop. The other update operators (A[m] += expr etc.) work
+    the same way.
+
+    The runs are stored as positions, so a compiled mask can be reused
+    with any array having the same bounds as the mask, for example in
+    every step of a time loop. It is a RunListDomain which also
+    remembers the bounds of the mask. */
+template<int N_rank>
+class CompiledMask : public RunListDomain<N_rank> {
+public:
+    typedef RunListDomain<N_rank> T_base;
+    typedef TinyVector<int,N_rank> T_index;
+
+    CompiledMask()
+    {
+        lbound_ = 0;
+        extent_ = 0;
+    }
+
+    template<typename T_numtype>
+    explicit CompiledMask(const Array<T_numtype,N_rank>& mask)
+    { compile(mask); }
+
+    template<typename T_expr>
+    explicit CompiledMask(_bz_ArrayExpr<T_expr> expr)
+    { compile(Array<bool,N_rank>(expr)); }
+
+    /// Recomputes the runs; the mask is true where it is nonzero.
+    template<typename T_numtype>
+    void compile(const Array<T_numtype,N_rank>& mask)
+    {
+        lbound_ = mask.lbound();
+        extent_ = mask.extent();
+        T_base::clear();
+        T_base::runRank_ = mask.ordering(0);
+        T_base::addMask(mask);
+    }
+
+    /// Number of true elements in the mask.
+    sizeType numActive() const
+    { return T_base::numElements(); }
+
+    const T_index& lbound() const
+    { return lbound_; }
+
+    const T_index& extent() const
+    { return extent_; }
+
+    /// Returns true if the array has the bounds of the mask.
+    template<typename T_numtype>
+    bool isCompatible(const Array<T_numtype,N_rank>& array) const
+    {
+        for (int i=0; i < N_rank; ++i)
+            if ((array.lbound(i) != lbound_(i))
+                || (array.extent(i) != extent_(i)))
+                return false;
+        return true;
+    }
+
+protected:
+    T_index  lbound_;
+    T_index  extent_;
+};
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_MASK_H
@@ -0,0 +1,503 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/patches.h   Collections of equally-shaped patches
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_PATCHES_H
+#define BZ_ARRAY_PATCHES_H
+
+#ifndef BZ_ARRAY_H
+ #error <blitz/array/patches.h> must be included after <blitz/array.h>
+#endif
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+ #include <omp.h>
+#endif
+
+/*
+ * PatchCollection<T,N> holds the patches of a block-structured mesh:
+ * N-dimensional patches of the same extent, each placed at its origin
+ * in a common index space and surrounded by ghost cells. The patches
+ * are stored one after the other in a single block of memory, each
+ * starting on a SIMD vector boundary.
+ *
+ *   PatchCollection<double,3> U(shape(16,16,16), 2);
+ *   U.addPatch(shape(0,0,0));
+ *   U.addPatch(shape(16,0,0));
+ *   ...
+ *   PatchCollection<double,3> V = U.copy();
+ *   U = 2 * V + 1;            // all the interiors, in one loop nest
+ *   U.exchangeGhosts();       // ghost cells from the neighbouring patches
+ *   Array<double,3> P = U.patch(1);   // indexed from origin - ghost
+ *
+ * Expressions of PatchCollections with the same extent and number of
+ * patches, and of scalars, are evaluated over the interiors of all the
+ * patches as one N+1 dimensional array expression (interiors()). With
+ * OpenMP and BZ_THREADSAFE, large ones are split by patches between
+ * threads; the parts of the Arrays in the expression are then taken in
+ * each thread, which needs thread-safe reference counts.
+ *
+ * exchangeGhosts() copies into the ghost cells of each patch the
+ * interior cells of the patches overlapping them. The copies are
+ * planned once, after the last patch is added. Ghost cells which are
+ * in no other patch are left for the boundary conditions. Patches must
+ * not overlap each other's interiors.
+ *
+ * addPatch() may move the elements, like the insertions of a
+ * std::vector: views taken before are then invalid. Copies of a
+ * PatchCollection refer to the same elements, as copies of Arrays do.
+ */
+
+BZ_NAMESPACE(blitz)
+
+/// A copy of a box of interior cells of a patch into ghost cells.
+template<int N_rank>
+struct _bz_PatchCopy {
+    // offsets of the first element of the box, in the storage
+    diffType dest, source;
+    TinyVector<int,N_rank> extent;
+};
+
+template<typename P_numtype, int N_rank>
+class PatchCollection
+    : public ETBase<PatchCollection<P_numtype,N_rank> > {
+public:
+    typedef P_numtype T_numtype;
+    typedef TinyVector<int,N_rank> T_index;
+    typedef Array<P_numtype,N_rank> T_patch;
+    typedef Array<P_numtype,N_rank+1> T_batch;
+
+    static const int rank_ = N_rank;
+
+    PatchCollection()
+        : extent_(0), ghost_(0), patchSize_(0), interiorOffset_(0),
+          ghostElements_(0), planned_(true)
+    { }
+
+    /// Patches of the given interior extent, with ghost cells.
+    PatchCollection(const T_index& extent, int ghost)
+    { setLayout(extent, ghost); }
+
+    /** A collection with the same patches, and a copy of the elements,
+        ghost cells included. */
+    PatchCollection copy() const;
+
+    /// Adds a patch at origin, returning its number.
+    int addPatch(const T_index& origin)
+    {
+        if (numPatches() == capacity())
+            reserve(numPatches() ? 2 * numPatches() : 1);
+        origins_.push_back(origin);
+        planned_ = false;
+        return numPatches() - 1;
+    }
+
+    /// Allocates storage for n patches.
+    void reserve(int n);
+
+    int numPatches() const
+    { return int(origins_.size()); }
+
+    int capacity() const
+    { return patchSize_ ? int(data_.extent(0) / patchSize_) : 0; }
+
+    const T_index& extent() const
+    { return extent_; }
+
+    int ghost() const
+    { return ghost_; }
+
+    const T_index& origin(int p) const
+    { return origins_[p]; }
+
+    /// The indices of the interior of patch p.
+    RectDomain<N_rank> interiorDomain(int p) const
+    { return RectDomain<N_rank>(origins_[p], origins_[p] + extent_ - 1); }
+
+    /// The indices of patch p, ghost cells included.
+    RectDomain<N_rank> domain(int p) const
+    {
+        return RectDomain<N_rank>(origins_[p] - ghost_,
+                                  origins_[p] + extent_ - 1 + ghost_);
+    }
+
+    /// Patch p with its ghost cells, indexed from origin(p) - ghost().
+    T_patch patch(int p) const
+    {
+        BZPRECONDITION((p >= 0) && (p < numPatches()));
+        GeneralArrayStorage<N_rank> storage;
+        storage.setBase(origins_[p] - ghost_);
+        return T_patch(first() + p * patchSize_, extent_ + 2 * ghost_,
+                       stride_, neverDeleteData, storage);
+    }
+
+    /// The interior of patch p, indexed from origin(p).
+    T_patch interior(int p) const
+    {
+        BZPRECONDITION((p >= 0) && (p < numPatches()));
+        GeneralArrayStorage<N_rank> storage;
+        storage.setBase(origins_[p]);
+        return T_patch(first() + p * patchSize_ + interiorOffset_, extent_,
+                       stride_, neverDeleteData, storage);
+    }
+
+    /** The interiors of all the patches as one array, indexed by the
+        patch number and then from 0 in the patch. */
+    T_batch interiors() const
+    { return batch(extent_, interiorOffset_, 0); }
+
+    /** All the patches with their ghost cells, indexed by the patch
+        number and then from -ghost() in the patch. */
+    T_batch patches() const
+    { return batch(extent_ + 2 * ghost_, 0, -ghost_); }
+
+    /** Copies into the ghost cells of every patch the interior cells
+        of the other patches at the same indices. */
+    void exchangeGhosts();
+
+    /// The number of elements copied by exchangeGhosts().
+    sizeType numGhostElements() const
+    {
+        if (!planned_)
+            plan();
+        return ghostElements_;
+    }
+
+    // Assignment to the interiors
+
+    PatchCollection& operator=(const PatchCollection& c)
+    {
+        typedef typename asExpr<PatchCollection>::T_expr T_expr;
+        evaluate(asExpr<PatchCollection>::getExpr(c),
+            _bz_update<T_numtype, typename T_expr::T_result>());
+        return *this;
+    }
+
+#define BZ_PATCH_UPDATE(op,name)                                        \
+    template<typename T_expr>                                           \
+    PatchCollection& operator op(const ETBase<T_expr>& expr)            \
+    {                                                                   \
+        typedef typename asExpr<T_expr>::T_expr T_operand;              \
+        evaluate(asExpr<T_expr>::getExpr(expr.unwrap()),                \
+            name<T_numtype, typename T_operand::T_result>());           \
+        return *this;                                                   \
+    }                                                                   \
+                                                                        \
+    PatchCollection& operator op(T_numtype x)                           \
+    {                                                                   \
+        typedef _bz_ArrayExpr<_bz_ArrayExprConstant<T_numtype> > T_operand; \
+        evaluate(T_operand(x), name<T_numtype, T_numtype>());           \
+        return *this;                                                   \
+    }
+
+    BZ_PATCH_UPDATE(=, _bz_update)
+    BZ_PATCH_UPDATE(+=, _bz_plus_update)
+    BZ_PATCH_UPDATE(-=, _bz_minus_update)
+    BZ_PATCH_UPDATE(*=, _bz_multiply_update)
+    BZ_PATCH_UPDATE(/=, _bz_divide_update)
+
+#undef BZ_PATCH_UPDATE
+
+private:
+    void setLayout(const T_index& extent, int ghost);
+
+    P_numtype* first() const
+    { return const_cast<P_numtype*>(data_.data()); }
+
+    T_batch batch(const T_index& shape, diffType offset, int base) const;
+
+    template<typename T_expr, typename T_update>
+    void evaluate(const T_expr& expr, T_update);
+
+    void plan() const;
+
+    Array<P_numtype,1> data_;
+    std::vector<T_index> origins_;
+    T_index extent_;
+    // strides in a patch, ghost cells included
+    TinyVector<diffType,N_rank> stride_;
+    int ghost_;
+    diffType patchSize_, interiorOffset_;
+    // the plan is a cache, rebuilt after patches are added
+    mutable std::vector<_bz_PatchCopy<N_rank> > copies_;
+    mutable sizeType ghostElements_;
+    mutable bool planned_;
+};
+
+template<typename P_numtype, int N_rank>
+struct asExpr<PatchCollection<P_numtype,N_rank> > {
+    typedef _bz_ArrayExpr<FastArrayCopyIterator<P_numtype,N_rank+1> > T_expr;
+    static T_expr getExpr(const PatchCollection<P_numtype,N_rank>& x)
+    { return T_expr(FastArrayCopyIterator<P_numtype,N_rank+1>(x.interiors())); }
+};
+
+template<typename P_numtype, int N_rank>
+void PatchCollection<P_numtype,N_rank>::setLayout(const T_index& extent,
+    int ghost)
+{
+    BZPRECONDITION(ghost >= 0);
+    extent_ = extent;
+    ghost_ = ghost;
+    diffType size = 1;
+    interiorOffset_ = 0;
+    for (int r=N_rank - 1; r >= 0; --r)
+    {
+        stride_(r) = size;
+        interiorOffset_ += ghost * size;
+        size *= extent(r) + 2 * ghost;
+    }
+    // every patch starts on a SIMD vector
+    const diffType width = simdTypes<P_numtype>::vecWidth;
+    patchSize_ = (size + width - 1) / width * width;
+    ghostElements_ = 0;
+    planned_ = true;
+}
+
+template<typename P_numtype, int N_rank>
+void PatchCollection<P_numtype,N_rank>::reserve(int n)
+{
+    if (n <= capacity())
+        return;
+    Array<P_numtype,1> data(n * patchSize_);
+    const diffType used = numPatches() * patchSize_;
+    if (used > 0)
+        data(Range(0, used - 1)) = data_(Range(0, used - 1));
+    data_.reference(data);
+}
+
+template<typename P_numtype, int N_rank>
+PatchCollection<P_numtype,N_rank> PatchCollection<P_numtype,N_rank>::copy()
+    const
+{
+    PatchCollection c(extent_, ghost_);
+    c.reserve(numPatches());
+    for (int p=0; p < numPatches(); ++p)
+        c.addPatch(origins_[p]);
+    const diffType used = numPatches() * patchSize_;
+    if (used > 0)
+        c.data_(Range(0, used - 1)) = data_(Range(0, used - 1));
+    return c;
+}
+
+template<typename P_numtype, int N_rank>
+Array<P_numtype,N_rank+1> PatchCollection<P_numtype,N_rank>::batch(
+    const T_index& shape, diffType offset, int base) const
+{
+    if (numPatches() == 0)
+        return T_batch();
+
+    TinyVector<int,N_rank+1> batchShape, batchBase;
+    TinyVector<diffType,N_rank+1> batchStride;
+    batchShape(0) = numPatches();
+    batchBase(0) = 0;
+    batchStride(0) = patchSize_;
+    for (int r=0; r < N_rank; ++r)
+    {
+        batchShape(r + 1) = shape(r);
+        batchBase(r + 1) = base;
+        batchStride(r + 1) = stride_(r);
+    }
+    GeneralArrayStorage<N_rank+1> storage;
+    storage.setBase(batchBase);
+    return T_batch(first() + offset, batchShape, batchStride,
+                   neverDeleteData, storage);
+}
+
+/** Evaluates expr, of the shape of interiors(), into the interiors.
+    With OpenMP, large collections are split into one range of patches
+    per thread, each assigned as a part of interiors(). Taking the parts
+    of the Arrays in expr changes their reference counts, so this is
+    only done when these are thread-safe. */
+template<typename P_numtype, int N_rank>
+template<typename T_expr, typename T_update>
+void PatchCollection<P_numtype,N_rank>::evaluate(const T_expr& expr,
+    T_update)
+{
+    const int n = numPatches();
+    if (n == 0)
+        return;
+    T_batch dest(interiors());
+
+#if defined(_OPENMP) && defined(BZ_THREADSAFE)
+    const sizeType size = dest.numElements();
+    if ((n > 1) && (size >= BZ_PATCH_THREADING_THRESHOLD)
+        && !omp_in_parallel())
+    {
+        BZPRECHECK(expr.shapeCheck(dest.shape()),
+            "PatchCollection assigned an expression of another shape");
+
+        // the subdomains of expr start at its own lbounds
+        TinyVector<int,N_rank+1> base;
+        for (int r=0; r <= N_rank; ++r)
+            base(r) = (expr.lbound(r) == INT_MIN) ? 0 : expr.lbound(r);
+
+#pragma omp parallel
+        {
+            const int nthreads = omp_get_num_threads();
+            const int thread = omp_get_thread_num();
+            const int p0 = int(diffType(n) * thread / nthreads);
+            const int p1 = int(diffType(n) * (thread + 1) / nthreads);
+            if (p0 < p1)
+            {
+                TinyVector<int,N_rank+1> lbound(0), ubound;
+                lbound(0) = p0;
+                ubound(0) = p1 - 1;
+                for (int r=0; r < N_rank; ++r)
+                    ubound(r + 1) = extent_(r) - 1;
+                T_batch part(dest(RectDomain<N_rank+1>(lbound, ubound)));
+                _bz_evaluate(part, expr(RectDomain<N_rank+1>(base + lbound,
+                    base + ubound)), T_update());
+            }
+        }
+        return;
+    }
+#endif
+
+    _bz_evaluate(dest, expr, T_update());
+}
+
+/** Plans the ghost cell exchange: for each patch p, the interiors of
+    the patches q overlapping the ghost cells of p. The patches are
+    sorted by the first coordinate of their origins, so that only those
+    close enough along rank 0 are compared. */
+template<typename P_numtype, int N_rank>
+void PatchCollection<P_numtype,N_rank>::plan() const
+{
+    const int n = numPatches();
+    copies_.clear();
+    ghostElements_ = 0;
+
+    // (first coordinate of the origin, patch number), in order
+    std::vector<std::pair<int,int> > order(n);
+    for (int p=0; p < n; ++p)
+        order[p] = std::make_pair(origins_[p](0), p);
+    std::sort(order.begin(), order.end());
+
+    for (int p=0; p < n; ++p)
+    {
+        const T_index lo = origins_[p] - ghost_;
+        const T_index hi = origins_[p] + extent_ - 1 + ghost_;
+
+        // the patches q with origins_[q](0) + extent_(0) > lo(0)
+        std::vector<std::pair<int,int> >::const_iterator iter =
+            std::lower_bound(order.begin(), order.end(),
+                             std::make_pair(lo(0) - extent_(0) + 1, INT_MIN));
+        for (; (iter != order.end()) && (iter->first <= hi(0)); ++iter)
+        {
+            const int q = iter->second;
+            if (q == p)
+                continue;
+            _bz_PatchCopy<N_rank> copy;
+            T_index first;
+            bool overlap = true, interiorsOverlap = true;
+            for (int r=0; r < N_rank; ++r)
+            {
+                const int qlo = origins_[q](r);
+                const int qhi = qlo + extent_(r) - 1;
+                first(r) = std::max(lo(r), qlo);
+                copy.extent(r) = std::min(hi(r), qhi) - first(r) + 1;
+                overlap = overlap && (copy.extent(r) > 0);
+                interiorsOverlap = interiorsOverlap
+                    && (std::max(origins_[p](r), qlo)
+                        <= std::min(hi(r) - ghost_, qhi));
+            }
+            BZPRECHECK(!interiorsOverlap,
+                "PatchCollection patches " << p << " and " << q
+                << " overlap");
+            if (!overlap)
+                continue;
+
+            copy.dest = p * patchSize_;
+            copy.source = q * patchSize_;
+            for (int r=0; r < N_rank; ++r)
+            {
+                copy.dest += (first(r) - lo(r)) * stride_(r);
+                copy.source += (first(r) - origins_[q](r) + ghost_)
+                    * stride_(r);
+            }
+            copies_.push_back(copy);
+            ghostElements_ += product(copy.extent);
+        }
+    }
+    planned_ = true;
+}
+
+/** Runs the planned copies. Each writes ghost cells of one patch and
+    reads interior cells of another one, so they are independent, and
+    are split between OpenMP threads for large exchanges. */
+template<typename P_numtype, int N_rank>
+void PatchCollection<P_numtype,N_rank>::exchangeGhosts()
+{
+    if (!planned_)
+        plan();
+    P_numtype* const data = first();
+    const int numCopies = int(copies_.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) \
+  if ((ghostElements_ >= BZ_PATCH_THREADING_THRESHOLD) && !omp_in_parallel())
+#endif
+    for (int k=0; k < numCopies; ++k)
+    {
+        const _bz_PatchCopy<N_rank>& copy = copies_[k];
+        P_numtype* restrict dest = data + copy.dest;
+        const P_numtype* restrict source = data + copy.source;
+        const int length = copy.extent(N_rank - 1);
+
+        // the lines of the box along the last rank; both patches have
+        // the same strides
+        T_index i(0);
+        diffType offset = 0;
+        for (;;)
+        {
+            for (int j=0; j < length; ++j)
+                dest[offset + j] = source[offset + j];
+
+            int r = N_rank - 2;
+            for (; r >= 0; --r)
+            {
+                offset += stride_(r);
+                if (++i(r) < copy.extent(r))
+                    break;
+                offset -= copy.extent(r) * stride_(r);
+                i(r) = 0;
+            }
+            if (r < 0)
+                break;
+        }
+    }
+}
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_PATCHES_H
@@ -33,6 +33,32 @@
 
 BZ_NAMESPACE(blitz)
 
+#ifdef BZ_EXPR_PROFILING
+/** Creates the profile entry of a full reduction, described like the
+    Tau profiles. */
+template<typename T_expr, typename T_reduction>
+ExprProfileEntry* _bz_reductionProfileEntry(const T_expr& expr, T_reduction)
+{
+    BZ_STD_SCOPE(string) description = T_reduction::name();
+    description += "(";
+    prettyPrintFormat format(true);   // Terse mode on
+    expr.prettyPrint(description, format);
+    description += ")";
+    return ExprProfile::add(description);
+}
+#endif
+
+#ifdef BZ_TRAVERSAL_HOOKS
+template<typename T_expr>
+sizeType _bz_reductionElements(const T_expr& expr)
+{
+    sizeType n = 1;
+    for (int i=0; i < T_expr::rank_; ++i)
+        n *= expr.ubound(i) - expr.lbound(i) + 1;
+    return n;
+}
+#endif
+
 template<typename T_expr, typename T_reduction>
 _bz_typename T_reduction::T_resulttype
 _bz_ArrayExprFullReduce(T_expr expr, T_reduction reduction)
@@ -52,6 +78,14 @@ _bz_ArrayExprFullReduce(T_expr expr, T_reduction reduction)
     TAU_PROFILE(" ", exprDescription, TAU_BLITZ);
 #endif // BZ_TAU_PROFILING
 
+#ifdef BZ_EXPR_PROFILING
+    static ExprProfileEntry* const profileEntry =
+        _bz_reductionProfileEntry(expr, reduction);
+    _bz_ExprProfileScope profileScope(profileEntry,
+                                      _bz_reductionElements(expr));
+#endif
+    BZ_TRAVERSAL_TAKEN(indexTraversal, _bz_reductionElements(expr));
+
     return _bz_reduceWithIndexTraversal(expr, reduction);
 
 #ifdef BZ_NOT_IMPLEMENTED_FLAG
@@ -146,6 +180,14 @@ template<typename T_expr, typename T_reduction>
 _bz_typename T_reduction::T_resulttype
 _bz_reduceWithIndexVectorTraversal(T_expr expr, T_reduction reduction)
 {
+#ifdef BZ_EXPR_PROFILING
+    static ExprProfileEntry* const profileEntry =
+        _bz_reductionProfileEntry(expr, reduction);
+    _bz_ExprProfileScope profileScope(profileEntry,
+                                      _bz_reductionElements(expr));
+#endif
+    BZ_TRAVERSAL_TAKEN(indexTraversal, _bz_reductionElements(expr));
+
     // We are doing minIndex/maxIndex, so initialize with lower bound
     return _bz_reduceWithIndexTraversalGeneric<TinyVector<int,T_expr::rank_> >(expr,reduction);
 }
@@ -0,0 +1,465 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/runlist.h  Irregular domains stored as runs of elements
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_RUNLIST_H
+#define BZ_ARRAY_RUNLIST_H
+
+#include <blitz/array/domain.h>
+#include <vector>
+#include <algorithm>
+
+BZ_NAMESPACE(blitz)
+
+/** An irregular set of array positions, stored as a sorted list of
+    runs of consecutive positions along one rank (the run rank).
+
+    A RunListDomain is much more compact than a list of points for
+    regions such as the fluid cells of a porous medium, and arrays can
+    be indexed by it like by an STL container of positions:
+    A[domain] = expr evaluates expr only over the domain, each run
+    with a contiguous loop. The run rank should be the rank with the
+    smallest stride in the arrays (the last rank for the default
+    C-style storage) for those loops to be unit stride.
+
+    The runs are kept sorted (by position in the other ranks taken in
+    order, then by position along the run rank) and disjoint, with
+    adjacent runs merged. Runs added with addRun() or addPoint() are
+    only merged in when normalize() is called. Domains with the same
+    run rank can be combined with the | (union) and & (intersection)
+    operators, and grown with dilate(). */
+template<int N_rank>
+class RunListDomain {
+public:
+    typedef TinyVector<int,N_rank> T_index;
+
+    struct Run {
+        T_index first;
+        int length;
+    };
+
+    explicit RunListDomain(int runRank = N_rank-1)
+        : runRank_(runRank), numElements_(0)
+    { }
+
+    /// All the positions of a rectangular domain.
+    explicit RunListDomain(const RectDomain<N_rank>& domain,
+        int runRank = N_rank-1);
+
+    /** The positions where a mask is nonzero. The runs are oriented
+        along the rank with the smallest stride of the mask. */
+    template<typename T_numtype>
+    explicit RunListDomain(const Array<T_numtype,N_rank>& mask)
+        : runRank_(mask.ordering(0)), numElements_(0)
+    { addMask(mask); }
+
+    template<typename T_expr>
+    explicit RunListDomain(_bz_ArrayExpr<T_expr> expr)
+        : runRank_(N_rank-1), numElements_(0)
+    { addMask(Array<bool,N_rank>(expr)); }
+
+    int runRank() const
+    { return runRank_; }
+
+    sizeType numRuns() const
+    { return runs_.size(); }
+
+    /// Number of positions in the domain.
+    sizeType numElements() const
+    { return numElements_; }
+
+    bool isEmpty() const
+    { return runs_.empty(); }
+
+    const Run& run(sizeType i) const
+    { return runs_[i]; }
+
+    /// Position of the first element of the i'th run.
+    const T_index& runStart(sizeType i) const
+    { return runs_[i].first; }
+
+    int runLength(sizeType i) const
+    { return runs_[i].length; }
+
+    /// Smallest rectangular domain containing all the positions.
+    RectDomain<N_rank> boundingBox() const;
+
+    /// Requires the runs to be normalized.
+    bool contains(const T_index& pos) const;
+
+    void addRun(const T_index& first, int length)
+    {
+        if (length <= 0)
+            return;
+        Run run;
+        run.first = first;
+        run.length = length;
+        runs_.push_back(run);
+        numElements_ += length;
+    }
+
+    void addPoint(const T_index& pos)
+    { addRun(pos, 1); }
+
+    /// Adds the positions where a mask is nonzero.
+    template<typename T_numtype>
+    void addMask(const Array<T_numtype,N_rank>& mask);
+
+    /// Sorts the runs and merges overlapping and adjacent runs.
+    void normalize();
+
+    /** True if the runs are sorted and disjoint, with no adjacent runs,
+        as normalize() leaves them. */
+    bool isNormalized() const;
+
+    void clear()
+    {
+        runs_.clear();
+        numElements_ = 0;
+    }
+
+    /// Strict ordering of positions used to sort the runs.
+    bool isBefore(const T_index& a, const T_index& b) const
+    {
+        for (int i=0; i < N_rank; ++i)
+            if ((i != runRank_) && (a(i) != b(i)))
+                return a(i) < b(i);
+        return a(runRank_) < b(runRank_);
+    }
+
+    /// True if the positions only differ along the run rank.
+    bool isSameLine(const T_index& a, const T_index& b) const
+    {
+        for (int i=0; i < N_rank; ++i)
+            if ((i != runRank_) && (a(i) != b(i)))
+                return false;
+        return true;
+    }
+
+protected:
+    struct RunLess {
+        RunLess(const RunListDomain* domain) : domain_(domain) { }
+        bool operator()(const Run& a, const Run& b) const
+        { return domain_->isBefore(a.first, b.first); }
+        const RunListDomain* domain_;
+    };
+
+    std::vector<Run> runs_;
+    int runRank_;
+    sizeType numElements_;
+};
+
+template<int N_rank>
+RunListDomain<N_rank>::RunListDomain(const RectDomain<N_rank>& domain,
+    int runRank)
+    : runRank_(runRank), numElements_(0)
+{
+    const T_index lbound = domain.lbound();
+    const T_index ubound = domain.ubound();
+    for (int i=0; i < N_rank; ++i)
+        if (ubound(i) < lbound(i))
+            return;
+
+    const int length = ubound(runRank_) - lbound(runRank_) + 1;
+    T_index pos = lbound;
+    while (true)
+    {
+        addRun(pos, length);
+
+        int i = N_rank - 1;
+        for (; i >= 0; --i)
+        {
+            if (i == runRank_)
+                continue;
+            if (++pos(i) <= ubound(i))
+                break;
+            pos(i) = lbound(i);
+        }
+        if (i < 0)
+            break;
+    }
+}
+
+template<int N_rank>
+template<typename T_numtype>
+void RunListDomain<N_rank>::addMask(const Array<T_numtype,N_rank>& mask)
+{
+    if (mask.numElements() == 0)
+        return;
+
+    const T_index lbound = mask.lbound();
+    const T_index extent = mask.extent();
+    const int length = extent(runRank_);
+    const diffType stride = mask.stride(runRank_);
+    T_index pos = lbound;
+
+    // Scan the lines along the run rank in storage order
+    while (true)
+    {
+        const T_numtype* restrict line = &mask(pos);
+
+        int i = 0;
+        while (i < length)
+        {
+            if (!line[i * stride])
+            {
+                ++i;
+                continue;
+            }
+
+            const int first = i;
+            while ((i < length) && line[i * stride])
+                ++i;
+
+            T_index start = pos;
+            start(runRank_) += first;
+            addRun(start, i - first);
+        }
+
+        int j = 0;
+        for (; j < N_rank; ++j)
+        {
+            const int r = mask.ordering(j);
+            if (r == runRank_)
+                continue;
+            if (++pos(r) < lbound(r) + extent(r))
+                break;
+            pos(r) = lbound(r);
+        }
+
+        if (j == N_rank)
+            break;
+    }
+
+    normalize();
+}
+
+template<int N_rank>
+void RunListDomain<N_rank>::normalize()
+{
+    if (runs_.empty())
+        return;
+
+    std::sort(runs_.begin(), runs_.end(), RunLess(this));
+
+    sizeType last = 0;
+    numElements_ = runs_[0].length;
+    for (sizeType i=1; i < runs_.size(); ++i)
+    {
+        Run& prev = runs_[last];
+        const Run& run = runs_[i];
+        const int prevEnd = prev.first(runRank_) + prev.length;
+
+        if (isSameLine(prev.first, run.first)
+            && (run.first(runRank_) <= prevEnd))
+        {
+            const int end = run.first(runRank_) + run.length;
+            if (end > prevEnd)
+            {
+                prev.length += end - prevEnd;
+                numElements_ += end - prevEnd;
+            }
+        }
+        else {
+            runs_[++last] = run;
+            numElements_ += run.length;
+        }
+    }
+    runs_.resize(last + 1);
+}
+
+template<int N_rank>
+bool RunListDomain<N_rank>::isNormalized() const
+{
+    for (sizeType i=1; i < runs_.size(); ++i)
+    {
+        const Run& prev = runs_[i-1];
+        const Run& run = runs_[i];
+        if (!isBefore(prev.first, run.first))
+            return false;
+        if (isSameLine(prev.first, run.first)
+            && (run.first(runRank_) <= prev.first(runRank_) + prev.length))
+            return false;
+    }
+    return true;
+}
+
+template<int N_rank>
+RectDomain<N_rank> RunListDomain<N_rank>::boundingBox() const
+{
+    T_index lbound, ubound;
+    if (runs_.empty())
+    {
+        lbound = 0;
+        ubound = -1;
+        return RectDomain<N_rank>(lbound, ubound);
+    }
+
+    lbound = runs_[0].first;
+    ubound = runs_[0].first;
+    for (sizeType i=0; i < runs_.size(); ++i)
+    {
+        T_index last = runs_[i].first;
+        last(runRank_) += runs_[i].length - 1;
+        for (int j=0; j < N_rank; ++j)
+        {
+            lbound(j) = std::min(lbound(j), runs_[i].first(j));
+            ubound(j) = std::max(ubound(j), last(j));
+        }
+    }
+    return RectDomain<N_rank>(lbound, ubound);
+}
+
+template<int N_rank>
+bool RunListDomain<N_rank>::contains(const T_index& pos) const
+{
+    // Find the last run starting at or before pos
+    Run key;
+    key.first = pos;
+    key.length = 1;
+    _bz_typename std::vector<Run>::const_iterator iter =
+        std::upper_bound(runs_.begin(), runs_.end(), key, RunLess(this));
+    if (iter == runs_.begin())
+        return false;
+    --iter;
+    return isSameLine(iter->first, pos)
+        && (pos(runRank_) < iter->first(runRank_) + iter->length);
+}
+
+/** Union of two domains with the same run rank. */
+template<int N_rank>
+RunListDomain<N_rank> operator|(const RunListDomain<N_rank>& a,
+    const RunListDomain<N_rank>& b)
+{
+    BZPRECONDITION(a.runRank() == b.runRank());
+
+    RunListDomain<N_rank> c(a);
+    for (sizeType i=0; i < b.numRuns(); ++i)
+        c.addRun(b.runStart(i), b.runLength(i));
+    c.normalize();
+    return c;
+}
+
+/** Intersection of two domains with the same run rank. The sorted run
+    lists are walked in step, so this is linear in the number of runs;
+    runs added with addRun() or addPoint() must have been merged in with
+    normalize() first. */
+template<int N_rank>
+RunListDomain<N_rank> operator&(const RunListDomain<N_rank>& a,
+    const RunListDomain<N_rank>& b)
+{
+    BZPRECONDITION(a.runRank() == b.runRank());
+    BZPRECHECK(a.isNormalized() && b.isNormalized(),
+        "RunListDomain intersection of domains whose runs are not sorted"
+        << endl << "and disjoint: call normalize() after addRun() or "
+        << "addPoint().")
+
+    const int r = a.runRank();
+    RunListDomain<N_rank> c(r);
+    sizeType i = 0, j = 0;
+    while ((i < a.numRuns()) && (j < b.numRuns()))
+    {
+        const TinyVector<int,N_rank>& p = a.runStart(i);
+        const TinyVector<int,N_rank>& q = b.runStart(j);
+        const int endA = p(r) + a.runLength(i);
+        const int endB = q(r) + b.runLength(j);
+
+        if (a.isSameLine(p, q))
+        {
+            const int first = std::max(p(r), q(r));
+            const int end = std::min(endA, endB);
+            if (first < end)
+            {
+                TinyVector<int,N_rank> start = p;
+                start(r) = first;
+                c.addRun(start, end - first);
+            }
+
+            if (endA < endB)
+                ++i;
+            else
+                ++j;
+        }
+        else if (a.isBefore(p, q))
+            ++i;
+        else
+            ++j;
+    }
+    return c;
+}
+
+/** Grows a domain by radius(i) positions in each direction of rank i,
+    including diagonal neighbours. The result may extend past the
+    bounds of an array; intersect it with a domain built from
+    the array's RectDomain to clip it. */
+template<int N_rank>
+RunListDomain<N_rank> dilate(const RunListDomain<N_rank>& a,
+    const TinyVector<int,N_rank>& radius)
+{
+    const int r = a.runRank();
+    RunListDomain<N_rank> c(r);
+    TinyVector<int,N_rank> offset;
+
+    for (sizeType i=0; i < a.numRuns(); ++i)
+    {
+        offset = -radius;
+        offset(r) = 0;
+        while (true)
+        {
+            TinyVector<int,N_rank> start = a.runStart(i) + offset;
+            start(r) -= radius(r);
+            c.addRun(start, a.runLength(i) + 2 * radius(r));
+
+            int j = N_rank - 1;
+            for (; j >= 0; --j)
+            {
+                if (j == r)
+                    continue;
+                if (++offset(j) <= radius(j))
+                    break;
+                offset(j) = -radius(j);
+            }
+            if (j < 0)
+                break;
+        }
+    }
+
+    c.normalize();
+    return c;
+}
+
+template<int N_rank>
+RunListDomain<N_rank> dilate(const RunListDomain<N_rank>& a, int radius)
+{
+    return dilate(a, TinyVector<int,N_rank>(radius));
+}
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_RUNLIST_H
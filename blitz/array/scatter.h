@@ -0,0 +1,390 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/scatter.h  Accumulating scatter updates through index lists
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_SCATTER_H
+#define BZ_ARRAY_SCATTER_H
+
+#include <blitz/array/indexset.h>
+#include <blitz/update.h>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#ifdef _OPENMP
+ #include <omp.h>
+#endif
+
+/*
+ * scatterAdd(A, I, v), scatterMin(A, I, v) and scatterMax(A, I, v)
+ * combine the i'th value of v into the array element at the i'th
+ * position of the index list I. I is either a CompiledIndexSet or an
+ * STL container of positions as used for indirection, and v is a
+ * rank-1 array with one value per position or a single scalar which
+ * is used for all positions.
+ *
+ * A position which occurs several times in I receives the values of
+ * all of its occurrences. Serially they are applied in the order of
+ * I. When compiled with OpenMP, large scatters are done in parallel
+ * with one of three conflict-free schemes:
+ *
+ *  - If I is a sorted CompiledIndexSet, the points are split between
+ *    threads so that all occurrences of a position belong to the same
+ *    thread. The result is identical to the serial one.
+ *  - If the positions are dense (the range of memory touched times the
+ *    number of threads is not much larger than the number of points,
+ *    as for a histogram), each thread accumulates into a private buffer
+ *    and the buffers are merged into the array.
+ *  - Otherwise additions to built-in types use atomic updates, and
+ *    other updates are done on a copy of the index list sorted by
+ *    offset as in the first case.
+ *
+ * With the last two schemes, floating-point sums may differ from the
+ * serial result by rounding because they are added in another order.
+ */
+
+BZ_NAMESPACE(blitz)
+
+/** Traits class describing how a scatter updater can be parallelized.
+    hasIdentity is true if private buffers can be initialized to a
+    value which leaves an element unchanged when merged, and isAtomic
+    is true if the update can be done with an atomic instruction. */
+template<typename T_update>
+struct _bz_scatterTraits {
+    static const bool hasIdentity = false;
+    static const bool isAtomic = false;
+};
+
+template<typename T_dest, typename T_source>
+struct _bz_scatterTraits<_bz_plus_update<T_dest,T_source> > {
+    static const bool hasIdentity = true;
+    static const bool isAtomic =
+        std::numeric_limits<T_dest>::is_specialized
+        && std::numeric_limits<T_source>::is_specialized;
+
+    static T_dest identity()
+    { return T_dest(0); }
+};
+
+template<typename T_dest, typename T_source>
+struct _bz_scatterTraits<_bz_min_update<T_dest,T_source> > {
+    static const bool hasIdentity =
+        std::numeric_limits<T_dest>::is_specialized;
+    static const bool isAtomic = false;
+
+    static T_dest identity()
+    { return std::numeric_limits<T_dest>::max(); }
+};
+
+template<typename T_dest, typename T_source>
+struct _bz_scatterTraits<_bz_max_update<T_dest,T_source> > {
+    static const bool hasIdentity =
+        std::numeric_limits<T_dest>::is_specialized;
+    static const bool isAtomic = false;
+
+    static T_dest identity()
+    {
+        return std::numeric_limits<T_dest>::is_integer ?
+            std::numeric_limits<T_dest>::min() :
+            -std::numeric_limits<T_dest>::max();
+    }
+};
+
+/** Atomic addition, only instantiated for built-in types. */
+template<bool isAtomic>
+struct _bz_scatterAtomic {
+    template<typename T_update, typename T_dest, typename T_source>
+    static void update(T_dest& x, T_source y, T_update)
+    { T_update::update(x, y); }
+};
+
+template<>
+struct _bz_scatterAtomic<true> {
+    template<typename T_update, typename T_dest, typename T_source>
+    static void update(T_dest& x, T_source y, T_update)
+    {
+        const T_dest value = static_cast<T_dest>(y);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        x += value;
+    }
+};
+
+/** Source of the values of a scatter: a rank-1 array ... */
+template<typename T_numtype>
+class _bz_scatterValues {
+public:
+    _bz_scatterValues(const Array<T_numtype,1>& values)
+        : data_(values.data()), stride_(values.stride(0))
+    { }
+
+    T_numtype operator[](sizeType i) const
+    { return data_[i * stride_]; }
+
+protected:
+    const T_numtype* restrict data_;
+    diffType stride_;
+};
+
+/** ... or a single value used for all points. */
+template<typename T_numtype>
+class _bz_scatterConstant {
+public:
+    _bz_scatterConstant(T_numtype value)
+        : value_(value)
+    { }
+
+    T_numtype operator[](sizeType) const
+    { return value_; }
+
+protected:
+    T_numtype value_;
+};
+
+/** An index list sorted by offset, built when an unsorted list has to
+    be partitioned between threads. It has the offset/position
+    interface of CompiledIndexSet. */
+class _bz_scatterSortedKeys {
+public:
+    template<int N_rank>
+    _bz_scatterSortedKeys(const CompiledIndexSet<N_rank>& index)
+        : keys_(index.size())
+    {
+        for (sizeType i=0; i < keys_.size(); ++i)
+            keys_[i] = std::make_pair(index.offset(i), index.position(i));
+        std::sort(keys_.begin(), keys_.end());
+    }
+
+    diffType offset(sizeType i) const
+    { return keys_[i].first; }
+
+    sizeType position(sizeType i) const
+    { return keys_[i].second; }
+
+protected:
+    std::vector<std::pair<diffType,sizeType> > keys_;
+};
+
+/** Returns the first point of the k'th of nparts parts of an index list
+    sorted by offset. The boundaries are moved forward so that all the
+    occurrences of a position fall in the same part. */
+template<typename T_index>
+inline sizeType _bz_scatterSplit(const T_index& index, sizeType n,
+    int k, int nparts)
+{
+    if (k == 0)
+        return 0;
+    if (k == nparts)
+        return n;
+
+    sizeType first = (n / nparts) * k + (n % nparts) * k / nparts;
+    while ((first < n) && (index.offset(first) == index.offset(first-1)))
+        ++first;
+    return first;
+}
+
+template<typename T_numtype, typename T_index, typename T_values,
+         typename T_update>
+inline void _bz_scatterSerial(T_numtype* restrict data,
+    const T_index& index, sizeType first, sizeType last,
+    const T_values& values, T_update)
+{
+    for (sizeType i=first; i < last; ++i)
+        T_update::update(data[index.offset(i)], values[index.position(i)]);
+}
+
+#ifdef _OPENMP
+
+/** Each thread updates the positions of a contiguous part of an index
+    list sorted by offset, so no two threads touch the same element. */
+template<typename T_numtype, typename T_index, typename T_values,
+         typename T_update>
+void _bz_scatterPartitioned(T_numtype* data, const T_index& index,
+    sizeType n, const T_values& values, T_update)
+{
+#pragma omp parallel
+    {
+        const int nthreads = omp_get_num_threads();
+        const int thread = omp_get_thread_num();
+
+        _bz_scatterSerial(data, index,
+            _bz_scatterSplit(index, n, thread, nthreads),
+            _bz_scatterSplit(index, n, thread + 1, nthreads),
+            values, T_update());
+    }
+}
+
+/** Each thread accumulates its share of the points into a private
+    buffer covering the offsets of the index set. The buffers are then
+    merged into the array, skipping elements no thread has touched. */
+template<typename T_numtype, int N_rank, typename T_values,
+         typename T_update>
+void _bz_scatterPrivatized(T_numtype* data,
+    const CompiledIndexSet<N_rank>& index, const T_values& values, T_update)
+{
+    typedef _bz_scatterTraits<T_update> T_traits;
+
+    const T_numtype identity = T_traits::identity();
+    const diffType n = index.size();
+    const diffType base = index.minOffset();
+    const diffType span = index.maxOffset() - base + 1;
+    const int maxThreads = omp_get_max_threads();
+
+    std::vector<T_numtype> buffers(span * maxThreads, identity);
+    T_numtype* restrict buffer = &buffers[0];
+    int nthreads = 1;
+
+#pragma omp parallel num_threads(maxThreads)
+    {
+#pragma omp single
+        nthreads = omp_get_num_threads();
+
+        T_numtype* restrict mine = buffer + omp_get_thread_num() * span;
+
+#pragma omp for schedule(static)
+        for (diffType i=0; i < n; ++i)
+            T_update::update(mine[index.offset(i) - base],
+                values[index.position(i)]);
+
+#pragma omp for schedule(static)
+        for (diffType j=0; j < span; ++j)
+            for (int t=0; t < nthreads; ++t)
+            {
+                const T_numtype x = buffer[t * span + j];
+                if (!(x == identity))
+                    T_update::update(data[base + j], x);
+            }
+    }
+}
+
+/** Unordered update with atomic instructions. */
+template<typename T_numtype, int N_rank, typename T_values,
+         typename T_update>
+void _bz_scatterAtomicUpdate(T_numtype* data,
+    const CompiledIndexSet<N_rank>& index, const T_values& values, T_update)
+{
+    const diffType n = index.size();
+
+#pragma omp parallel for schedule(static)
+    for (diffType i=0; i < n; ++i)
+        _bz_scatterAtomic<_bz_scatterTraits<T_update>::isAtomic>::update(
+            data[index.offset(i)], values[index.position(i)], T_update());
+}
+
+#endif // _OPENMP
+
+/** Applies a scatter update through a compiled index set, choosing
+    between the serial and the parallel schemes. */
+template<typename T_numtype, int N_rank, typename T_values,
+         typename T_update>
+void _bz_scatter(Array<T_numtype,N_rank>& array,
+    const CompiledIndexSet<N_rank>& index, const T_values& values, T_update)
+{
+    BZPRECHECK(index.isCompatible(array),
+        "CompiledIndexSet used with an array with different bounds or"
+        << endl << "strides than the one it was compiled for." << endl
+        << "Array lower bounds: " << array.lbound() << endl
+        << "Array extent: " << array.extent() << endl
+        << "Index set lower bounds: " << index.lbound() << endl
+        << "Index set extent: " << index.extent())
+
+    T_numtype* data = array.dataZero();
+    const sizeType n = index.size();
+
+#ifdef _OPENMP
+    typedef _bz_scatterTraits<T_update> T_traits;
+
+    const int nthreads = omp_get_max_threads();
+    if ((n >= BZ_SCATTER_THREADING_THRESHOLD) && (nthreads > 1)
+        && !omp_in_parallel())
+    {
+        const sizeType span = index.maxOffset() - index.minOffset() + 1;
+
+        if (index.isSorted())
+            _bz_scatterPartitioned(data, index, n, values, T_update());
+        else if (T_traits::hasIdentity && (span * nthreads
+            <= BZ_SCATTER_PRIVATIZE_RATIO * n))
+            _bz_scatterPrivatized(data, index, values, T_update());
+        else if (T_traits::isAtomic)
+            _bz_scatterAtomicUpdate(data, index, values, T_update());
+        else
+            _bz_scatterPartitioned(data, _bz_scatterSortedKeys(index), n,
+                values, T_update());
+        return;
+    }
+#endif
+
+    _bz_scatterSerial(data, index, 0, n, values, T_update());
+}
+
+/** Container version: the positions are translated into offsets (in
+    the original order) first. */
+template<typename T_numtype, int N_rank, typename T_container,
+         typename T_values, typename T_update>
+void _bz_scatter(Array<T_numtype,N_rank>& array,
+    const T_container& points, const T_values& values, T_update)
+{
+    _bz_scatter(array, CompiledIndexSet<N_rank>(points, array, false),
+        values, T_update());
+}
+
+#define BZ_DECL_SCATTER(name,updater)                                   \
+template<typename T_numtype, int N_rank, typename T_index,              \
+         typename T_value>                                              \
+void name(Array<T_numtype,N_rank>& array, const T_index& index,         \
+    const Array<T_value,1>& values)                                     \
+{                                                                       \
+    BZPRECHECK(values.numElements() == sizeType(index.size()),          \
+        #name ": number of values (" << values.numElements()            \
+        << ") differs from the number of positions ("                   \
+        << index.size() << ")")                                         \
+    _bz_scatter(array, index, _bz_scatterValues<T_value>(values),       \
+        updater<T_numtype, T_value>());                                 \
+}                                                                       \
+                                                                        \
+template<typename T_numtype, int N_rank, typename T_index,              \
+         typename T_value>                                              \
+void name(Array<T_numtype,N_rank>& array, const T_index& index,         \
+    T_value value)                                                      \
+{                                                                       \
+    _bz_scatter(array, index, _bz_scatterConstant<T_value>(value),      \
+        updater<T_numtype, T_value>());                                 \
+}
+
+BZ_DECL_SCATTER(scatterAdd, _bz_plus_update)
+BZ_DECL_SCATTER(scatterMin, _bz_min_update)
+BZ_DECL_SCATTER(scatterMax, _bz_max_update)
+
+#undef BZ_DECL_SCATTER
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_SCATTER_H
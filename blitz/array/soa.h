@@ -0,0 +1,989 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/soa.h   Multicomponent arrays stored as structures of arrays
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_SOA_H
+#define BZ_ARRAY_SOA_H
+
+#ifndef BZ_ARRAY_H
+ #error <blitz/array/soa.h> must be included after <blitz/array.h>
+#endif
+
+/*
+ * SoAArray<T,N> is an N-dimensional array of a multicomponent type T
+ * (TinyVector, TinyMatrix or complex, see multicomponent_traits),
+ * storing each component in its own contiguous Array, instead of
+ * interleaving them as Array<T,N> does. A[c] is the Array of component
+ * c, with unit stride; A(i,j,k) reads an element and assigns it
+ * through a proxy.
+ *
+ * Expressions of SoAArrays, scalars of the component type, constants
+ * of type T and expressions of (non-multicomponent) Arrays, which are
+ * used for every component, are built with + - * / and evaluated one
+ * component at a time:
+ *
+ *   SoAArray<TinyVector<double,3>,3> V(n,n,n), W(n,n,n);
+ *   Array<double,3> rho(n,n,n);
+ *   V = V + dt * W / rho;
+ *
+ * does V[c] = V[c] + dt * W[c] / rho for each c, so that every
+ * component is an ordinary unit-stride Blitz++ assignment. The
+ * operators act on each component separately, as those of TinyVector
+ * do; the product of two complex SoAArrays is not their complex
+ * product.
+ *
+ * AoSoAArray<T,N,W> holds the same elements in one block of memory,
+ * splitting the rows of the last rank into runs of W elements (a cache
+ * line of components by default, BZ_AOSOA_BLOCK_BYTES) and storing
+ * each run as W values of component 0, then W values of component 1,
+ * and so on. The components of an element are then a few cache lines
+ * apart, while each run of a component is aligned and contiguous.
+ * Expressions of AoSoAArrays, scalars and constants are built with the
+ * same operators, and evaluated block by block with a constant inner
+ * loop of W lanes:
+ *
+ *   AoSoAArray<TinyVector<double,3>,3> V(n,n,n), W(n,n,n);
+ *   V += dt * W;
+ *
+ * The AoSoAArrays of an expression have the same width and extents;
+ * arrays of scalars cannot be used in them, as their elements are
+ * stored in another order.
+ */
+
+BZ_NAMESPACE(blitz)
+
+template<typename P_numtype, int N_rank> class SoAArray;
+template<typename P_numtype, int N_rank,
+         int N_width = BZ_AOSOA_BLOCK_BYTES
+             / sizeof(typename multicomponent_traits<P_numtype>::T_element)>
+class AoSoAArray;
+
+/** Base class of the SoA expression nodes: each node has a type
+    T_component and a method component(c) giving the expression of
+    component c. The nodes of multicomponent values also have the
+    types T_numtype and T_element of their elements and components,
+    void for the others.
+
+    The nodes which AoSoAArrays can be assigned also have a method
+    lane(c, block, i) giving the value of type T_lane of component c at
+    lane i of a block of AoSoAArray elements, and shapeCheck(extent,
+    width) checking the AoSoAArrays of the expression. */
+template<typename T>
+struct _bz_SoABase {
+    const T& unwrap() const
+    { return static_cast<const T&>(*this); }
+};
+
+// T1 unless it is void
+template<typename T1, typename T2>
+struct _bz_SoASelect {
+    typedef T1 T_selected;
+};
+
+template<typename T2>
+struct _bz_SoASelect<void,T2> {
+    typedef T2 T_selected;
+};
+
+// How nodes keep their operands: arrays by reference, the others by
+// value.
+template<typename T>
+struct _bz_SoAStore {
+    typedef T T_stored;
+};
+
+template<typename P_numtype, int N_rank>
+struct _bz_SoAStore<SoAArray<P_numtype,N_rank> > {
+    typedef const SoAArray<P_numtype,N_rank>& T_stored;
+};
+
+template<typename P_numtype, int N_rank, int N_width>
+struct _bz_SoAStore<AoSoAArray<P_numtype,N_rank,N_width> > {
+    typedef const AoSoAArray<P_numtype,N_rank,N_width>& T_stored;
+};
+
+// a scalar of the component type, the same for all components
+template<typename T>
+struct _bz_SoAScalar : public _bz_SoABase<_bz_SoAScalar<T> > {
+    typedef T T_component;
+    typedef T T_lane;
+    typedef void T_numtype;
+    typedef void T_element;
+
+    _bz_SoAScalar(T value) : value_(value) { }
+
+    T component(int) const
+    { return value_; }
+
+    T lane(int, diffType, int) const
+    { return value_; }
+
+    template<int N_rank>
+    bool shapeCheck(const TinyVector<int,N_rank>&, int) const
+    { return true; }
+
+    T value_;
+};
+
+// a multicomponent constant, whose components are used in turn
+template<typename P_numtype>
+struct _bz_SoAConstant : public _bz_SoABase<_bz_SoAConstant<P_numtype> > {
+    typedef typename multicomponent_traits<P_numtype>::T_element T_component;
+    typedef T_component T_lane;
+    typedef void T_numtype;
+    typedef void T_element;
+
+    _bz_SoAConstant(const P_numtype& value) : value_(value) { }
+
+    T_component component(int c) const
+    { return reinterpret_cast<const T_component*>(&value_)[c]; }
+
+    T_component lane(int c, diffType, int) const
+    { return component(c); }
+
+    template<int N_rank>
+    bool shapeCheck(const TinyVector<int,N_rank>&, int) const
+    { return true; }
+
+    P_numtype value_;
+};
+
+// an array expression, the same for all components
+template<typename T_expr>
+struct _bz_SoABroadcast : public _bz_SoABase<_bz_SoABroadcast<T_expr> > {
+    typedef T_expr T_component;
+    typedef typename T_expr::T_numtype T_lane;
+    typedef void T_numtype;
+    typedef void T_element;
+
+    _bz_SoABroadcast(const T_expr& expr) : expr_(expr) { }
+
+    const T_expr& component(int) const
+    { return expr_; }
+
+    T_expr expr_;
+};
+
+template<typename T_expr, template<typename> class T_op>
+struct _bz_SoAUnary : public _bz_SoABase<_bz_SoAUnary<T_expr,T_op> > {
+    typedef typename T_expr::T_component T_operand;
+    typedef typename BzUnaryExprResult<T_op,T_operand>::T_result T_component;
+    typedef typename T_op<typename T_expr::T_lane>::T_numtype T_lane;
+    typedef typename T_expr::T_numtype T_numtype;
+    typedef typename T_expr::T_element T_element;
+
+    _bz_SoAUnary(const T_expr& expr) : expr_(expr) { }
+
+    T_component component(int c) const
+    { return T_component(asExpr<T_operand>::getExpr(expr_.component(c))); }
+
+    T_lane lane(int c, diffType block, int i) const
+    { return T_op<typename T_expr::T_lane>::apply(expr_.lane(c, block, i)); }
+
+    template<int N_rank>
+    bool shapeCheck(const TinyVector<int,N_rank>& extent, int width) const
+    { return expr_.shapeCheck(extent, width); }
+
+    typename _bz_SoAStore<T_expr>::T_stored expr_;
+};
+
+template<typename T_expr1, typename T_expr2,
+         template<typename, typename> class T_op>
+struct _bz_SoABinary
+    : public _bz_SoABase<_bz_SoABinary<T_expr1,T_expr2,T_op> > {
+    typedef typename T_expr1::T_component T_operand1;
+    typedef typename T_expr2::T_component T_operand2;
+    typedef typename BzBinaryExprResult<T_op,T_operand1,
+                                        T_operand2>::T_result T_component;
+    typedef T_op<typename T_expr1::T_lane,
+                 typename T_expr2::T_lane> T_laneOp;
+    typedef typename T_laneOp::T_numtype T_lane;
+    typedef typename _bz_SoASelect<typename T_expr1::T_numtype,
+        typename T_expr2::T_numtype>::T_selected T_numtype;
+    typedef typename _bz_SoASelect<typename T_expr1::T_element,
+        typename T_expr2::T_element>::T_selected T_element;
+
+    _bz_SoABinary(const T_expr1& expr1, const T_expr2& expr2)
+        : expr1_(expr1), expr2_(expr2) { }
+
+    T_component component(int c) const
+    {
+        return T_component(asExpr<T_operand1>::getExpr(expr1_.component(c)),
+                           asExpr<T_operand2>::getExpr(expr2_.component(c)));
+    }
+
+    T_lane lane(int c, diffType block, int i) const
+    {
+        return T_laneOp::apply(expr1_.lane(c, block, i),
+                               expr2_.lane(c, block, i));
+    }
+
+    template<int N_rank>
+    bool shapeCheck(const TinyVector<int,N_rank>& extent, int width) const
+    {
+        return expr1_.shapeCheck(extent, width)
+            && expr2_.shapeCheck(extent, width);
+    }
+
+    typename _bz_SoAStore<T_expr1>::T_stored expr1_;
+    typename _bz_SoAStore<T_expr2>::T_stored expr2_;
+};
+
+/** Reference to an element of a SoAArray or AoSoAArray, as returned
+    by its operator(). */
+template<typename P_array>
+class _bz_SoAReference {
+public:
+    typedef typename P_array::T_numtype T_numtype;
+    typedef typename P_array::T_element T_element;
+    typedef TinyVector<int,P_array::rank_> T_index;
+
+    _bz_SoAReference(P_array& array, const T_index& index)
+        : array_(array), index_(index) { }
+
+    operator T_numtype() const
+    { return static_cast<const P_array&>(array_)(index_); }
+
+    _bz_SoAReference& operator=(const T_numtype& x)
+    {
+        for (int c=0; c < P_array::numComponents; ++c)
+            array_.element(c, index_) =
+                reinterpret_cast<const T_element*>(&x)[c];
+        return *this;
+    }
+
+    _bz_SoAReference& operator=(const _bz_SoAReference& x)
+    { return *this = T_numtype(x); }
+
+    T_element& operator[](int c) const
+    { return array_.element(c, index_); }
+
+private:
+    P_array& array_;
+    T_index index_;
+};
+
+template<typename P_numtype, int N_rank>
+class SoAArray : public _bz_SoABase<SoAArray<P_numtype,N_rank> > {
+public:
+    typedef P_numtype T_numtype;
+    typedef typename multicomponent_traits<P_numtype>::T_element T_element;
+    typedef Array<T_element,N_rank> T_array;
+    typedef T_array T_component;
+    typedef T_element T_lane;
+    typedef _bz_SoAReference<SoAArray> T_reference;
+
+    static const int rank_ = N_rank;
+    static const int numComponents =
+        multicomponent_traits<P_numtype>::numComponents;
+
+    SoAArray()
+    { }
+
+    explicit SoAArray(const TinyVector<int,N_rank>& extent,
+        const GeneralArrayStorage<N_rank>& storage
+            = GeneralArrayStorage<N_rank>())
+    { allocate(storage.base(), extent, storage); }
+
+    SoAArray(const TinyVector<int,N_rank>& lbounds,
+        const TinyVector<int,N_rank>& extent,
+        const GeneralArrayStorage<N_rank>& storage
+            = GeneralArrayStorage<N_rank>())
+    { allocate(lbounds, extent, storage); }
+
+    explicit SoAArray(int extent0)
+    { allocate(TinyVector<int,1>(extent0)); }
+
+    SoAArray(int extent0, int extent1)
+    { allocate(BZ_BLITZ_SCOPE(shape)(extent0, extent1)); }
+
+    SoAArray(int extent0, int extent1, int extent2)
+    { allocate(BZ_BLITZ_SCOPE(shape)(extent0, extent1, extent2)); }
+
+    SoAArray(int extent0, int extent1, int extent2, int extent3)
+    { allocate(BZ_BLITZ_SCOPE(shape)(extent0, extent1, extent2, extent3)); }
+
+    /// A copy of the interleaved array A, with its domain.
+    explicit SoAArray(const Array<P_numtype,N_rank>& A)
+    {
+        allocate(A.lbound(), A.extent(), GeneralArrayStorage<N_rank>(
+            A.ordering(), true));
+        *this = A;
+    }
+
+    /** Like Array, copies are views of the same data; assignment
+        copies the elements. */
+    SoAArray(const SoAArray& A)
+        : _bz_SoABase<SoAArray>()
+    { reference(A); }
+
+    void reference(const SoAArray& A)
+    {
+        for (int c=0; c < numComponents; ++c)
+            components_[c].reference(A.components_[c]);
+    }
+
+    SoAArray copy() const
+    {
+        SoAArray A;
+        for (int c=0; c < numComponents; ++c)
+            A.components_[c].reference(components_[c].copy());
+        return A;
+    }
+
+    void resize(const TinyVector<int,N_rank>& extent)
+    {
+        for (int c=0; c < numComponents; ++c)
+            components_[c].resize(extent);
+    }
+
+    /// The array of component c.
+    T_array& operator[](int c)
+    { return components_[c]; }
+
+    const T_array& operator[](int c) const
+    { return components_[c]; }
+
+    const T_array& component(int c) const
+    { return components_[c]; }
+
+    /// Component c of the element at index.
+    T_element& element(int c, const TinyVector<int,N_rank>& index)
+    { return components_[c](index); }
+
+    TinyVector<int,N_rank> lbound() const
+    { return components_[0].lbound(); }
+
+    int lbound(int rank) const
+    { return components_[0].lbound(rank); }
+
+    TinyVector<int,N_rank> ubound() const
+    { return components_[0].ubound(); }
+
+    int ubound(int rank) const
+    { return components_[0].ubound(rank); }
+
+    const TinyVector<int,N_rank>& extent() const
+    { return components_[0].extent(); }
+
+    int extent(int rank) const
+    { return components_[0].extent(rank); }
+
+    const TinyVector<int,N_rank>& shape() const
+    { return components_[0].shape(); }
+
+    RectDomain<N_rank> domain() const
+    { return components_[0].domain(); }
+
+    sizeType numElements() const
+    { return components_[0].numElements(); }
+
+    // Element access
+
+    P_numtype operator()(const TinyVector<int,N_rank>& index) const
+    {
+        P_numtype x;
+        for (int c=0; c < numComponents; ++c)
+            reinterpret_cast<T_element*>(&x)[c] = components_[c](index);
+        return x;
+    }
+
+    P_numtype operator()(int i0) const
+    { return (*this)(TinyVector<int,1>(i0)); }
+
+    P_numtype operator()(int i0, int i1) const
+    { return (*this)(TinyVector<int,2>(i0, i1)); }
+
+    P_numtype operator()(int i0, int i1, int i2) const
+    { return (*this)(TinyVector<int,3>(i0, i1, i2)); }
+
+    P_numtype operator()(int i0, int i1, int i2, int i3) const
+    { return (*this)(TinyVector<int,4>(i0, i1, i2, i3)); }
+
+    T_reference operator()(const TinyVector<int,N_rank>& index)
+    { return T_reference(*this, index); }
+
+    T_reference operator()(int i0)
+    { return T_reference(*this, TinyVector<int,1>(i0)); }
+
+    T_reference operator()(int i0, int i1)
+    { return T_reference(*this, TinyVector<int,2>(i0, i1)); }
+
+    T_reference operator()(int i0, int i1, int i2)
+    { return T_reference(*this, TinyVector<int,3>(i0, i1, i2)); }
+
+    T_reference operator()(int i0, int i1, int i2, int i3)
+    { return T_reference(*this, TinyVector<int,4>(i0, i1, i2, i3)); }
+
+    // Assignment, one component at a time
+
+    SoAArray& operator=(const SoAArray& A)
+    {
+        for (int c=0; c < numComponents; ++c)
+            components_[c] = A.components_[c];
+        return *this;
+    }
+
+    template<typename T_expr>
+    SoAArray& operator=(const _bz_SoABase<T_expr>& expr)
+    {
+        for (int c=0; c < numComponents; ++c)
+            components_[c] = expr.unwrap().component(c);
+        return *this;
+    }
+
+    SoAArray& operator=(const Array<P_numtype,N_rank>& A);
+
+    SoAArray& operator=(const P_numtype& x)
+    { return *this = _bz_SoAConstant<P_numtype>(x); }
+
+    SoAArray& operator=(T_element x)
+    {
+        for (int c=0; c < numComponents; ++c)
+            components_[c] = x;
+        return *this;
+    }
+
+#define BZ_SOA_UPDATE(op)                                               \
+    template<typename T_expr>                                           \
+    SoAArray& operator op(const _bz_SoABase<T_expr>& expr)              \
+    {                                                                   \
+        for (int c=0; c < numComponents; ++c)                           \
+            components_[c] op expr.unwrap().component(c);               \
+        return *this;                                                   \
+    }                                                                   \
+                                                                        \
+    SoAArray& operator op(const P_numtype& x)                           \
+    { return *this op _bz_SoAConstant<P_numtype>(x); }                  \
+                                                                        \
+    SoAArray& operator op(T_element x)                                  \
+    {                                                                   \
+        for (int c=0; c < numComponents; ++c)                           \
+            components_[c] op x;                                        \
+        return *this;                                                   \
+    }
+
+    BZ_SOA_UPDATE(+=)
+    BZ_SOA_UPDATE(-=)
+    BZ_SOA_UPDATE(*=)
+    BZ_SOA_UPDATE(/=)
+
+#undef BZ_SOA_UPDATE
+
+    /// Copies the elements to the interleaved array A.
+    void copyTo(Array<P_numtype,N_rank>& A) const;
+
+private:
+    void allocate(const TinyVector<int,N_rank>& lbounds,
+                  const TinyVector<int,N_rank>& extent,
+                  const GeneralArrayStorage<N_rank>& storage)
+    {
+        GeneralArrayStorage<N_rank> s(storage.ordering(),
+                                      storage.ascendingFlag());
+        for (int c=0; c < numComponents; ++c)
+            components_[c].reference(T_array(lbounds, extent, s));
+    }
+
+    void allocate(const TinyVector<int,N_rank>& extent)
+    { allocate(TinyVector<int,N_rank>(0), extent,
+               GeneralArrayStorage<N_rank>()); }
+
+    T_array components_[numComponents];
+};
+
+template<typename P_numtype, int N_rank>
+SoAArray<P_numtype,N_rank>&
+SoAArray<P_numtype,N_rank>::operator=(const Array<P_numtype,N_rank>& A)
+{
+    BZPRECONDITION(all(A.extent() == extent()));
+    Array<P_numtype,N_rank> B(A);
+    B.reindexSelf(lbound());
+    for (int c=0; c < numComponents; ++c)
+        components_[c] = B[c];
+    return *this;
+}
+
+template<typename P_numtype, int N_rank>
+void SoAArray<P_numtype,N_rank>::copyTo(Array<P_numtype,N_rank>& A) const
+{
+    BZPRECONDITION(all(A.extent() == extent()));
+    Array<P_numtype,N_rank> B(A);
+    B.reindexSelf(lbound());
+    for (int c=0; c < numComponents; ++c)
+        B[c] = components_[c];
+}
+
+/// The sum of all elements, summed one component at a time.
+template<typename P_numtype, int N_rank>
+P_numtype sum(const SoAArray<P_numtype,N_rank>& A)
+{
+    typedef typename multicomponent_traits<P_numtype>::T_element T_element;
+    P_numtype x;
+    for (int c=0; c < SoAArray<P_numtype,N_rank>::numComponents; ++c)
+        reinterpret_cast<T_element*>(&x)[c] = sum(A[c]);
+    return x;
+}
+
+/** Multicomponent array stored as an array of structures of arrays:
+    runs of N_width consecutive elements along the last rank are stored
+    as one block holding the run of each component in turn. */
+template<typename P_numtype, int N_rank, int N_width>
+class AoSoAArray
+    : public _bz_SoABase<AoSoAArray<P_numtype,N_rank,N_width> > {
+public:
+    typedef P_numtype T_numtype;
+    typedef typename multicomponent_traits<P_numtype>::T_element T_element;
+    typedef Array<T_element,N_rank+1> T_component;
+    typedef T_element T_lane;
+    typedef _bz_SoAReference<AoSoAArray> T_reference;
+
+    static const int rank_ = N_rank;
+    static const int numComponents =
+        multicomponent_traits<P_numtype>::numComponents;
+    static const int width = N_width;
+
+    AoSoAArray()
+        : lbound_(0), extent_(0), rowBlocks_(0), numBlocks_(0), first_(0)
+    { }
+
+    explicit AoSoAArray(const TinyVector<int,N_rank>& extent)
+    { allocate(TinyVector<int,N_rank>(0), extent); }
+
+    AoSoAArray(const TinyVector<int,N_rank>& lbounds,
+               const TinyVector<int,N_rank>& extent)
+    { allocate(lbounds, extent); }
+
+    explicit AoSoAArray(int extent0)
+    { allocate(TinyVector<int,N_rank>(0), TinyVector<int,1>(extent0)); }
+
+    AoSoAArray(int extent0, int extent1)
+    {
+        allocate(TinyVector<int,N_rank>(0),
+                 BZ_BLITZ_SCOPE(shape)(extent0, extent1));
+    }
+
+    AoSoAArray(int extent0, int extent1, int extent2)
+    {
+        allocate(TinyVector<int,N_rank>(0),
+                 BZ_BLITZ_SCOPE(shape)(extent0, extent1, extent2));
+    }
+
+    AoSoAArray(int extent0, int extent1, int extent2, int extent3)
+    {
+        allocate(TinyVector<int,N_rank>(0),
+                 BZ_BLITZ_SCOPE(shape)(extent0, extent1, extent2, extent3));
+    }
+
+    /// A copy of the interleaved array A, with its domain.
+    explicit AoSoAArray(const Array<P_numtype,N_rank>& A)
+    {
+        allocate(A.lbound(), A.extent());
+        *this = A;
+    }
+
+    /// Copies are views of the same data; assignment copies the elements.
+    AoSoAArray(const AoSoAArray& A)
+        : _bz_SoABase<AoSoAArray>()
+    { reference(A); }
+
+    void reference(const AoSoAArray& A)
+    {
+        data_.reference(A.data_);
+        lbound_ = A.lbound_;
+        extent_ = A.extent_;
+        rowBlocks_ = A.rowBlocks_;
+        numBlocks_ = A.numBlocks_;
+        first_ = A.first_;
+    }
+
+    AoSoAArray copy() const
+    {
+        AoSoAArray A(lbound_, extent_);
+        A.data_ = data_;
+        return A;
+    }
+
+    void resize(const TinyVector<int,N_rank>& extent)
+    { allocate(lbound_, extent); }
+
+    /** Component c, as an array of rank N_rank+1 indexed from 0: the
+        last rank of the elements is split into a rank of blocks and a
+        rank of width lanes, the lanes past the last element of a row
+        being padding. Like Array<T,N>::operator[], the view does not
+        keep the data alive. */
+    T_component operator[](int c) const
+    { return component(c); }
+
+    T_component component(int c) const;
+
+    /// Component c of the element at index.
+    T_element& element(int c, const TinyVector<int,N_rank>& index) const
+    { return first_[offset(index) + c * N_width]; }
+
+    /// The first element of the storage, padding included.
+    T_element* data() const
+    { return first_; }
+
+    /// The number of blocks of width elements, padding included.
+    diffType numBlocks() const
+    { return numBlocks_; }
+
+    const TinyVector<int,N_rank>& lbound() const
+    { return lbound_; }
+
+    int lbound(int rank) const
+    { return lbound_(rank); }
+
+    TinyVector<int,N_rank> ubound() const
+    { return lbound_ + extent_ - 1; }
+
+    int ubound(int rank) const
+    { return lbound_(rank) + extent_(rank) - 1; }
+
+    const TinyVector<int,N_rank>& extent() const
+    { return extent_; }
+
+    int extent(int rank) const
+    { return extent_(rank); }
+
+    const TinyVector<int,N_rank>& shape() const
+    { return extent_; }
+
+    RectDomain<N_rank> domain() const
+    { return RectDomain<N_rank>(lbound_, ubound()); }
+
+    sizeType numElements() const
+    { return product(extent_); }
+
+    // Expression leaf
+
+    T_element lane(int c, diffType block, int i) const
+    { return first_[(block * numComponents + c) * N_width + i]; }
+
+    bool shapeCheck(const TinyVector<int,N_rank>& extent, int width) const
+    { return width == N_width && all(extent == extent_); }
+
+    // Element access
+
+    P_numtype operator()(const TinyVector<int,N_rank>& index) const
+    {
+        P_numtype x;
+        const T_element* restrict p = first_ + offset(index);
+        for (int c=0; c < numComponents; ++c)
+            reinterpret_cast<T_element*>(&x)[c] = p[c * N_width];
+        return x;
+    }
+
+    P_numtype operator()(int i0) const
+    { return (*this)(TinyVector<int,1>(i0)); }
+
+    P_numtype operator()(int i0, int i1) const
+    { return (*this)(TinyVector<int,2>(i0, i1)); }
+
+    P_numtype operator()(int i0, int i1, int i2) const
+    { return (*this)(TinyVector<int,3>(i0, i1, i2)); }
+
+    P_numtype operator()(int i0, int i1, int i2, int i3) const
+    { return (*this)(TinyVector<int,4>(i0, i1, i2, i3)); }
+
+    T_reference operator()(const TinyVector<int,N_rank>& index)
+    { return T_reference(*this, index); }
+
+    T_reference operator()(int i0)
+    { return T_reference(*this, TinyVector<int,1>(i0)); }
+
+    T_reference operator()(int i0, int i1)
+    { return T_reference(*this, TinyVector<int,2>(i0, i1)); }
+
+    T_reference operator()(int i0, int i1, int i2)
+    { return T_reference(*this, TinyVector<int,3>(i0, i1, i2)); }
+
+    T_reference operator()(int i0, int i1, int i2, int i3)
+    { return T_reference(*this, TinyVector<int,4>(i0, i1, i2, i3)); }
+
+    // Assignment, one block at a time
+
+    AoSoAArray& operator=(const AoSoAArray& A)
+    {
+        evaluate(A, _bz_update<T_element,T_element>());
+        return *this;
+    }
+
+    AoSoAArray& operator=(const Array<P_numtype,N_rank>& A);
+
+#define BZ_AOSOA_UPDATE(op, updater)                                    \
+    template<typename T_expr>                                           \
+    AoSoAArray& operator op(const _bz_SoABase<T_expr>& expr)            \
+    {                                                                   \
+        evaluate(expr.unwrap(),                                         \
+            updater<T_element,_bz_typename T_expr::T_lane>());          \
+        return *this;                                                   \
+    }                                                                   \
+                                                                        \
+    AoSoAArray& operator op(const P_numtype& x)                         \
+    { return *this op _bz_SoAConstant<P_numtype>(x); }                  \
+                                                                        \
+    AoSoAArray& operator op(T_element x)                                \
+    { return *this op _bz_SoAScalar<T_element>(x); }
+
+    BZ_AOSOA_UPDATE(=, _bz_update)
+    BZ_AOSOA_UPDATE(+=, _bz_plus_update)
+    BZ_AOSOA_UPDATE(-=, _bz_minus_update)
+    BZ_AOSOA_UPDATE(*=, _bz_multiply_update)
+    BZ_AOSOA_UPDATE(/=, _bz_divide_update)
+
+#undef BZ_AOSOA_UPDATE
+
+    /// Copies the elements to the interleaved array A.
+    void copyTo(Array<P_numtype,N_rank>& A) const;
+
+private:
+    void allocate(const TinyVector<int,N_rank>& lbounds,
+                  const TinyVector<int,N_rank>& extent);
+
+    // offset of component 0 of the element at index
+    diffType offset(const TinyVector<int,N_rank>& index) const
+    {
+        diffType block = 0;
+        for (int r=0; r < N_rank - 1; ++r)
+            block = block * extent_(r) + (index(r) - lbound_(r));
+        const int i = index(N_rank - 1) - lbound_(N_rank - 1);
+        block = block * rowBlocks_ + i / N_width;
+        return block * numComponents * N_width + i % N_width;
+    }
+
+    /* Updates the elements one block at a time. The full blocks have
+       the constant trip count N_width; the last block of a row only
+       updates its real lanes, so that the padding stays zero (a /=
+       would otherwise turn it into NaN). */
+    template<typename T_expr, typename T_update>
+    void evaluate(const T_expr& expr, T_update)
+    {
+        BZPRECONDITION(expr.shapeCheck(extent_, N_width));
+        const int tail = extent_(N_rank - 1) - int(rowBlocks_ - 1) * N_width;
+        for (diffType block=0; block < numBlocks_; ++block)
+        {
+            if ((block + 1) % rowBlocks_ != 0 || tail == N_width)
+                evaluateBlock(expr, T_update(), block, N_width);
+            else
+                evaluateBlock(expr, T_update(), block, tail);
+        }
+    }
+
+    template<typename T_expr, typename T_update>
+    void evaluateBlock(const T_expr& expr, T_update, diffType block,
+                       int lanes)
+    {
+        for (int c=0; c < numComponents; ++c)
+        {
+            T_element* restrict p = first_
+                + (block * numComponents + c) * N_width;
+            for (int i=0; i < lanes; ++i)
+                T_update::update(p[i], expr.lane(c, block, i));
+        }
+    }
+
+    Array<T_element,1> data_;
+    TinyVector<int,N_rank> lbound_, extent_;
+    diffType rowBlocks_, numBlocks_;
+    T_element* first_;
+};
+
+template<typename P_numtype, int N_rank, int N_width>
+void AoSoAArray<P_numtype,N_rank,N_width>::allocate(
+    const TinyVector<int,N_rank>& lbounds,
+    const TinyVector<int,N_rank>& extent)
+{
+    lbound_ = lbounds;
+    extent_ = extent;
+    rowBlocks_ = (extent(N_rank - 1) + N_width - 1) / N_width;
+    numBlocks_ = rowBlocks_;
+    for (int r=0; r < N_rank - 1; ++r)
+        numBlocks_ *= extent(r);
+    // the padding is zeroed, so that it holds finite values
+    data_.reference(Array<T_element,1>(numBlocks_ * numComponents * N_width));
+    data_ = T_element();
+    first_ = data_.data();
+}
+
+template<typename P_numtype, int N_rank, int N_width>
+Array<typename multicomponent_traits<P_numtype>::T_element,N_rank+1>
+AoSoAArray<P_numtype,N_rank,N_width>::component(int c) const
+{
+    BZPRECONDITION((c >= 0) && (c < numComponents));
+    TinyVector<int,N_rank+1> shape;
+    TinyVector<diffType,N_rank+1> stride;
+    for (int r=0; r < N_rank - 1; ++r)
+        shape(r) = extent_(r);
+    shape(N_rank - 1) = rowBlocks_;
+    shape(N_rank) = N_width;
+    stride(N_rank) = 1;
+    stride(N_rank - 1) = numComponents * N_width;
+    for (int r=N_rank - 2; r >= 0; --r)
+        stride(r) = stride(r + 1) * shape(r + 1);
+    return T_component(first_ + c * N_width, shape, stride);
+}
+
+template<typename P_numtype, int N_rank, int N_width>
+AoSoAArray<P_numtype,N_rank,N_width>&
+AoSoAArray<P_numtype,N_rank,N_width>::operator=(
+    const Array<P_numtype,N_rank>& A)
+{
+    BZPRECONDITION(all(A.extent() == extent_));
+    Array<P_numtype,N_rank> B(A);
+    B.reindexSelf(lbound_);
+    typename Array<P_numtype,N_rank>::const_iterator iter = B.begin(),
+        end = B.end();
+    for (; iter != end; ++iter)
+        (*this)(iter.position()) = *iter;
+    return *this;
+}
+
+template<typename P_numtype, int N_rank, int N_width>
+void AoSoAArray<P_numtype,N_rank,N_width>::copyTo(
+    Array<P_numtype,N_rank>& A) const
+{
+    BZPRECONDITION(all(A.extent() == extent_));
+    Array<P_numtype,N_rank> B(A);
+    B.reindexSelf(lbound_);
+    typename Array<P_numtype,N_rank>::iterator iter = B.begin(),
+        end = B.end();
+    for (; iter != end; ++iter)
+        *iter = (*this)(iter.position());
+}
+
+/// The sum of all elements, the padding excluded.
+template<typename P_numtype, int N_rank, int N_width>
+P_numtype sum(const AoSoAArray<P_numtype,N_rank,N_width>& A)
+{
+    typedef typename multicomponent_traits<P_numtype>::T_element T_element;
+    const int numComponents = AoSoAArray<P_numtype,N_rank,N_width>::
+        numComponents;
+    const int length = A.extent(N_rank - 1);
+    const diffType rowBlocks = (length + N_width - 1) / N_width;
+    P_numtype x;
+    for (int c=0; c < numComponents; ++c)
+    {
+        T_element s = T_element();
+        for (diffType block=0; block < A.numBlocks(); ++block)
+        {
+            const T_element* restrict p = A.data()
+                + (block * numComponents + c) * N_width;
+            const int rest = length - int(block % rowBlocks) * N_width;
+            const int lanes = rest < N_width ? rest : N_width;
+            for (int i=0; i < lanes; ++i)
+                s += p[i];
+        }
+        reinterpret_cast<T_element*>(&x)[c] = s;
+    }
+    return x;
+}
+
+/*
+ * Operators building SoA expressions. One operand at least is a SoA
+ * expression; the other may be a SoA expression, a scalar of the
+ * component type, a multicomponent constant, or an array expression.
+ */
+
+#define BZ_SOA_BINARY(name, op)                                          \
+template<typename T1, typename T2>                                       \
+inline _bz_SoABinary<T1,T2,op>                                           \
+name(const _bz_SoABase<T1>& a, const _bz_SoABase<T2>& b)                 \
+{ return _bz_SoABinary<T1,T2,op>(a.unwrap(), b.unwrap()); }              \
+                                                                         \
+template<typename T1, typename T2>                                       \
+inline _bz_SoABinary<T1,_bz_SoABroadcast<                                \
+    _bz_typename asExpr<T2>::T_expr>,op>                                 \
+name(const _bz_SoABase<T1>& a, const ETBase<T2>& b)                      \
+{                                                                        \
+    typedef _bz_SoABroadcast<_bz_typename asExpr<T2>::T_expr> T_b;       \
+    return _bz_SoABinary<T1,T_b,op>(a.unwrap(),                          \
+        T_b(asExpr<T2>::getExpr(b.unwrap())));                           \
+}                                                                        \
+                                                                         \
+template<typename T1, typename T2>                                       \
+inline _bz_SoABinary<_bz_SoABroadcast<                                   \
+    _bz_typename asExpr<T1>::T_expr>,T2,op>                              \
+name(const ETBase<T1>& a, const _bz_SoABase<T2>& b)                      \
+{                                                                        \
+    typedef _bz_SoABroadcast<_bz_typename asExpr<T1>::T_expr> T_a;       \
+    return _bz_SoABinary<T_a,T2,op>(                                     \
+        T_a(asExpr<T1>::getExpr(a.unwrap())), b.unwrap());               \
+}                                                                        \
+                                                                         \
+template<typename T1>                                                    \
+inline _bz_SoABinary<T1,_bz_SoAScalar<                                   \
+    _bz_typename T1::T_element>,op>                                      \
+name(const _bz_SoABase<T1>& a, _bz_typename T1::T_element b)             \
+{                                                                        \
+    typedef _bz_SoAScalar<_bz_typename T1::T_element> T_b;               \
+    return _bz_SoABinary<T1,T_b,op>(a.unwrap(), T_b(b));                 \
+}                                                                        \
+                                                                         \
+template<typename T2>                                                    \
+inline _bz_SoABinary<_bz_SoAScalar<                                      \
+    _bz_typename T2::T_element>,T2,op>                                   \
+name(_bz_typename T2::T_element a, const _bz_SoABase<T2>& b)             \
+{                                                                        \
+    typedef _bz_SoAScalar<_bz_typename T2::T_element> T_a;               \
+    return _bz_SoABinary<T_a,T2,op>(T_a(a), b.unwrap());                 \
+}                                                                        \
+                                                                         \
+template<typename T1>                                                    \
+inline _bz_SoABinary<T1,_bz_SoAConstant<                                 \
+    _bz_typename T1::T_numtype>,op>                                      \
+name(const _bz_SoABase<T1>& a, const _bz_typename T1::T_numtype& b)      \
+{                                                                        \
+    typedef _bz_SoAConstant<_bz_typename T1::T_numtype> T_b;             \
+    return _bz_SoABinary<T1,T_b,op>(a.unwrap(), T_b(b));                 \
+}                                                                        \
+                                                                         \
+template<typename T2>                                                    \
+inline _bz_SoABinary<_bz_SoAConstant<                                    \
+    _bz_typename T2::T_numtype>,T2,op>                                   \
+name(const _bz_typename T2::T_numtype& a, const _bz_SoABase<T2>& b)      \
+{                                                                        \
+    typedef _bz_SoAConstant<_bz_typename T2::T_numtype> T_a;             \
+    return _bz_SoABinary<T_a,T2,op>(T_a(a), b.unwrap());                 \
+}
+
+BZ_SOA_BINARY(operator+, Add)
+BZ_SOA_BINARY(operator-, Subtract)
+BZ_SOA_BINARY(operator*, Multiply)
+BZ_SOA_BINARY(operator/, Divide)
+
+#undef BZ_SOA_BINARY
+
+template<typename T>
+inline _bz_SoAUnary<T,UnaryMinus> operator-(const _bz_SoABase<T>& a)
+{ return _bz_SoAUnary<T,UnaryMinus>(a.unwrap()); }
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_SOA_H
@@ -0,0 +1,369 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/static.h   Arrays with extents fixed at compile time
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_STATIC_H
+#define BZ_ARRAY_STATIC_H
+
+#ifndef BZ_ARRAY_H
+ #error <blitz/array/static.h> must be included after <blitz/array.h>
+#endif
+
+/*
+ * StaticArray<T, StaticShape<N0,N1,N2,N3>, N_base> is an array of rank
+ * 1 to 4 whose extents N0, N1, ... and index base are template
+ * parameters. The elements are stored row-major in the object itself,
+ * aligned on BZ_SIMD_WIDTH, and nothing else is: lengths, strides and
+ * bases are constants known to the compiler.
+ *
+ *   StaticArray<double, StaticShape<16,16,16> > A, B;
+ *   StaticArray<double, StaticShape<20,20,20>, -2> C;   // 2 ghost cells
+ *   A = 2 * B + 1;
+ *   Array<double,3> D(16,16,16);
+ *   D = A + sin(B);
+ *
+ * StaticArrays are operands of Array expressions like Arrays. An
+ * expression assigned to a StaticArray whose operands are stored with
+ * the same strides (StaticArrays of the same shape, and contiguous
+ * Arrays of that shape) is evaluated in a single loop of constant
+ * length, which the compiler unrolls and vectorizes; other
+ * expressions are assigned to an Array view of the data.
+ */
+
+BZ_NAMESPACE(blitz)
+
+/** The extents of a StaticArray, of rank 1 to 4: the rank is the
+    number of nonzero extents. */
+template<int N0, int N1 = 0, int N2 = 0, int N3 = 0>
+struct StaticShape {
+    static const int rank = (N1 == 0) ? 1 : (N2 == 0) ? 2 : (N3 == 0) ? 3 : 4;
+
+    static const sizeType numElements = sizeType(N0) * (N1 ? N1 : 1)
+        * (N2 ? N2 : 1) * (N3 ? N3 : 1);
+
+    static int extent(int r)
+    { return (r == 0) ? N0 : (r == 1) ? N1 : (r == 2) ? N2 : N3; }
+
+    /// The stride of rank r, in row-major order.
+    static diffType stride(int r)
+    {
+        diffType s = 1;
+        for (int q=rank - 1; q > r; --q)
+            s *= extent(q);
+        return s;
+    }
+};
+
+template<typename P_numtype, typename P_shape, int N_base = 0>
+class StaticArray;
+
+/** The iterator of StaticArray operands in expressions. It reads the
+    elements as FastArrayIterator does, but the strides, extents and
+    bounds it gets from the StaticArray are constants, so the loops of
+    the evaluator have constant bounds and strides. */
+template<typename P_numtype, typename P_shape, int N_base>
+class FastStaticArrayIterator
+    : public FastArrayIteratorBase<P_numtype, P_shape::rank,
+                                   const StaticArray<P_numtype,P_shape,N_base>&> {
+public:
+    typedef StaticArray<P_numtype,P_shape,N_base> T_static;
+    typedef FastArrayIteratorBase<P_numtype, P_shape::rank,
+                                  const T_static&> T_base;
+    typedef typename T_base::T_numtype T_numtype;
+    typedef typename T_base::T_array T_array;
+    typedef typename T_base::T_iterator T_iterator;
+    typedef const T_static& T_ctorArg1;
+    typedef typename T_base::T_ctorArg2 T_ctorArg2;
+    typedef typename T_base::T_range_result T_range_result;
+
+    using T_base::rank_;
+    using T_base::numArrayOperands;
+    using T_base::numTVOperands;
+    using T_base::numTMOperands;
+    using T_base::numIndexPlaceholders;
+
+    FastStaticArrayIterator(const FastStaticArrayIterator& x)
+        : T_base(x)
+    { }
+
+    FastStaticArrayIterator(const T_static& array)
+        : T_base(array, array.data())
+    { }
+
+    using T_base::operator=;
+    void operator=(const FastStaticArrayIterator& x)
+    { T_base::operator=(x); }
+
+    using T_base::operator();
+
+    void prettyPrint(BZ_STD_SCOPE(string) &str,
+        prettyPrintFormat& format) const
+    {
+        if (format.tersePrintingSelected())
+            str += format.nextArrayOperandSymbol();
+        else {
+            str += "StaticArray<";
+            str += BZ_DEBUG_TEMPLATE_AS_STRING_LITERAL(T_numtype);
+            str += ">";
+        }
+    }
+};
+
+template<typename P_numtype, typename P_shape, int N_base>
+class StaticArray : public ETBase<StaticArray<P_numtype,P_shape,N_base> > {
+public:
+    typedef P_numtype T_numtype;
+    typedef P_shape T_shape;
+
+    static const int rank_ = P_shape::rank;
+    static const sizeType numElements_ = P_shape::numElements;
+
+    typedef TinyVector<int,rank_> T_index;
+    typedef Array<P_numtype,rank_> T_array;
+    typedef FastStaticArrayIterator<P_numtype,P_shape,N_base> T_iterator;
+
+    StaticArray()
+    { }
+
+    explicit StaticArray(T_numtype x)
+    { *this = x; }
+
+    template<typename T_expr>
+    explicit StaticArray(const ETBase<T_expr>& expr)
+    { *this = expr; }
+
+    // The shape, constant
+
+    static int rank()
+    { return rank_; }
+
+    static sizeType numElements()
+    { return numElements_; }
+
+    static int base(int)
+    { return N_base; }
+
+    static int lbound(int)
+    { return N_base; }
+
+    static int ubound(int rank)
+    { return N_base + P_shape::extent(rank) - 1; }
+
+    static int extent(int rank)
+    { return P_shape::extent(rank); }
+
+    static diffType stride(int rank)
+    { return P_shape::stride(rank); }
+
+    static int ordering(int rank)
+    { return rank_ - 1 - rank; }
+
+    static bool isRankStoredAscending(int)
+    { return true; }
+
+    static bool canCollapse(int outerRank, int innerRank)
+    { return stride(innerRank) * extent(innerRank) == stride(outerRank); }
+
+    static T_index lbound()
+    { return T_index(N_base); }
+
+    static T_index ubound()
+    { return lbound() + shape() - 1; }
+
+    static T_index shape()
+    {
+        T_index s;
+        for (int r=0; r < rank_; ++r)
+            s(r) = extent(r);
+        return s;
+    }
+
+    static T_index length()
+    { return shape(); }
+
+    static RectDomain<rank_> domain()
+    { return RectDomain<rank_>(lbound(), ubound()); }
+
+    static bool isInRange(const T_index& index)
+    {
+        for (int r=0; r < rank_; ++r)
+            if ((index(r) < N_base) || (index(r) - N_base >= extent(r)))
+                return false;
+        return true;
+    }
+
+    // Element access
+
+    T_numtype* data()
+    { return data_; }
+
+    const T_numtype* data() const
+    { return data_; }
+
+    T_numtype* dataFirst()
+    { return data_; }
+
+    const T_numtype* dataFirst() const
+    { return data_; }
+
+    const T_numtype& operator()(const T_index& index) const
+    { return data_[offset(index)]; }
+
+    T_numtype& operator()(const T_index& index)
+    { return data_[offset(index)]; }
+
+    const T_numtype& operator()(int i0) const
+    { return (*this)(TinyVector<int,1>(i0)); }
+
+    T_numtype& operator()(int i0)
+    { return (*this)(TinyVector<int,1>(i0)); }
+
+    const T_numtype& operator()(int i0, int i1) const
+    { return (*this)(TinyVector<int,2>(i0, i1)); }
+
+    T_numtype& operator()(int i0, int i1)
+    { return (*this)(TinyVector<int,2>(i0, i1)); }
+
+    const T_numtype& operator()(int i0, int i1, int i2) const
+    { return (*this)(TinyVector<int,3>(i0, i1, i2)); }
+
+    T_numtype& operator()(int i0, int i1, int i2)
+    { return (*this)(TinyVector<int,3>(i0, i1, i2)); }
+
+    const T_numtype& operator()(int i0, int i1, int i2, int i3) const
+    { return (*this)(TinyVector<int,4>(i0, i1, i2, i3)); }
+
+    T_numtype& operator()(int i0, int i1, int i2, int i3)
+    { return (*this)(TinyVector<int,4>(i0, i1, i2, i3)); }
+
+    /** An Array referring to the elements, with the same domain. It
+        is valid while this StaticArray exists. */
+    T_array view() const
+    {
+        GeneralArrayStorage<rank_> storage;
+        storage.base() = N_base;
+        return T_array(const_cast<T_numtype*>(data_), shape(),
+                       neverDeleteData, storage);
+    }
+
+    /// A subarray, as an Array referring to the elements.
+    T_array operator()(const RectDomain<rank_>& subdomain) const
+    { return view()(subdomain); }
+
+    T_iterator beginFast() const
+    { return T_iterator(*this); }
+
+    // Assignment
+
+#define BZ_STATIC_UPDATE(op,name)                                       \
+    template<typename T_expr>                                           \
+    StaticArray& operator op(const ETBase<T_expr>& expr)                \
+    {                                                                   \
+        typedef typename asExpr<T_expr>::T_expr T_operand;              \
+        evaluate(T_operand(expr.unwrap()),                              \
+            name<T_numtype, typename T_operand::T_result>());           \
+        return *this;                                                   \
+    }                                                                   \
+                                                                        \
+    StaticArray& operator op(T_numtype x)                               \
+    {                                                                   \
+        typedef _bz_ArrayExpr<_bz_ArrayExprConstant<T_numtype> > T_operand; \
+        evaluate(T_operand(x), name<T_numtype, T_numtype>());           \
+        return *this;                                                   \
+    }
+
+    BZ_STATIC_UPDATE(=, _bz_update)
+    BZ_STATIC_UPDATE(+=, _bz_plus_update)
+    BZ_STATIC_UPDATE(-=, _bz_minus_update)
+    BZ_STATIC_UPDATE(*=, _bz_multiply_update)
+    BZ_STATIC_UPDATE(/=, _bz_divide_update)
+
+#undef BZ_STATIC_UPDATE
+
+private:
+    static diffType offset(const T_index& index)
+    {
+        BZPRECONDITION(isInRange(index));
+        diffType k = 0;
+        for (int r=0; r < rank_; ++r)
+            k += (index(r) - N_base) * stride(r);
+        return k;
+    }
+
+    template<typename T_expr, typename T_update>
+    void evaluate(T_expr expr, T_update);
+
+    BZ_ALIGN_VARIABLE(T_numtype, data_[numElements_], BZ_SIMD_WIDTH)
+};
+
+template<typename P_numtype, typename P_shape, int N_base>
+struct asExpr<StaticArray<P_numtype,P_shape,N_base> > {
+    typedef _bz_ArrayExpr<FastStaticArrayIterator<P_numtype,P_shape,N_base> >
+        T_expr;
+    static T_expr getExpr(const StaticArray<P_numtype,P_shape,N_base>& x)
+    { return x.beginFast(); }
+};
+
+/** Evaluates expr into the elements. When all the operands of expr are
+    stored with the strides of this array, which is known at compile
+    time for the StaticArrays, the elements are read at the same
+    offsets with fastRead in one loop of constant length. Otherwise,
+    and for expressions which need the indices, expr is assigned to
+    view() by the Array evaluator. */
+template<typename P_numtype, typename P_shape, int N_base>
+template<typename T_expr, typename T_update>
+inline void StaticArray<P_numtype,P_shape,N_base>::evaluate(T_expr expr,
+    T_update)
+{
+    bool flat = (T_expr::numIndexPlaceholders == 0)
+        && (T_expr::numTVOperands == 0) && (T_expr::numTMOperands == 0)
+        && (T_expr::minWidth > 0)
+        && ((T_expr::rank_ == rank_) || (T_expr::numArrayOperands == 0))
+        && expr.shapeCheck(shape());
+    for (int r=0; flat && (r < rank_); ++r)
+        flat = expr.isStride(r, stride(r));
+
+    if (!flat)
+    {
+        T_array A(view());
+        _bz_evaluate(A, expr, T_update());
+        return;
+    }
+
+    T_numtype* restrict data = data_;
+#ifdef BZ_USE_ALIGNMENT_PRAGMAS
+#pragma ivdep
+#endif
+    for (sizeType i=0; i < numElements_; ++i)
+        T_update::update(data[i], expr.fastRead(i));
+}
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_STATIC_H
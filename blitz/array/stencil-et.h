@@ -109,8 +109,8 @@ class _bz_StencilExpr {
     numTMOperands = T_expr::numTMOperands,
     numIndexPlaceholders = T_expr::numIndexPlaceholders,
   /// vectorization of stencils is disabled by setting this to 0.
-    minWidth = 0, //T_expr::minWidth,
-    maxWidth = 0, //T_expr::maxWidth,
+    minWidth = 0,
+    maxWidth = 0,
     rank_ = T_expr::rank_;
   
  _bz_StencilExpr(const _bz_StencilExpr<T_expr, T_numtype>& a)
@@ -253,8 +253,8 @@ class _bz_StencilExpr2 {
     numIndexPlaceholders = T_expr1::numIndexPlaceholders
     + T_expr2::numIndexPlaceholders,
   /// vectorization of stencils is disabled by setting this to 0.
-    minWidth = 0, //BZ_MIN(T_expr1::minWidth, T_expr2::minWidth),
-    maxWidth = 0, //BZ_MAX(T_expr1::maxWidth, T_expr2::maxWidth),
+    minWidth = 0,
+    maxWidth = 0,
       rank_ = BZ_MAX(T_expr1::rank_, T_expr2::rank_);
   
   _bz_StencilExpr2(const _bz_StencilExpr2<T_expr1, T_expr2, T_numtype>& a)
@@ -197,51 +197,23 @@ inline void getStencilExtent(TinyVector<int,N_rank>& minb,
 }
 
 /*
- * This version applies a stencil to a set of 3D arrays.  Up to 11 arrays
- * may be used.  Any unused arrays are turned into dummyArray objects.
- * Operations on dummyArray objects are translated into no-ops.
+ * The _bz_applyStencilLines functions apply a stencil over a part of
+ * the interior domain lbound..ubound.  The domain is treated as a
+ * sequence of lines along the last rank (single points for 1D arrays),
+ * numbered in the order of the serial loop, and the lines
+ * [firstLine, lastLine) are visited.  Each call has its own iterators,
+ * so calls on disjoint line ranges may run concurrently.
  */
 template<typename T_stencil, typename T_numtype1, typename T_array2,
     class T_array3, typename T_array4, typename T_array5, typename T_array6,
     class T_array7, typename T_array8, typename T_array9, typename T_array10,
     class T_array11>
-void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,3>& A,
+void _bz_applyStencilLines(const T_stencil& stencil, Array<T_numtype1,3>& A,
     T_array2& B, T_array3& C, T_array4& D, T_array5& E, T_array6& F,
-    T_array7& G, T_array8& H, T_array9& I, T_array10& J, T_array11& K)
+    T_array7& G, T_array8& H, T_array9& I, T_array10& J, T_array11& K,
+    const TinyVector<int,3>& lbound, const TinyVector<int,3>& ubound,
+    sizeType firstLine, sizeType lastLine)
 {
-    checkShapes(A,B,C,D,E,F,G,H,I,J,K);
- 
-    // Determine stencil extent
-    TinyVector<int,3> minb, maxb;
-    getStencilExtent(minb, maxb, stencil, A, B, C, D, E, F, G, H, I, J, K);
-
-    // Now determine the subdomain over which the stencil
-    // can be applied without worrying about overrunning the
-    // boundaries of the array
-    int stencil_lbound0 = minb(0);
-    int stencil_lbound1 = minb(1);
-    int stencil_lbound2 = minb(2);
-
-    int stencil_ubound0 = maxb(0);
-    int stencil_ubound1 = maxb(1);
-    int stencil_ubound2 = maxb(2);
-
-    int lbound0 = (extrema::max)(A.lbound(0), A.lbound(0) - stencil_lbound0);
-    int lbound1 = (extrema::max)(A.lbound(1), A.lbound(1) - stencil_lbound1);
-    int lbound2 = (extrema::max)(A.lbound(2), A.lbound(2) - stencil_lbound2);
-
-    int ubound0 = (extrema::min)(A.ubound(0), A.ubound(0) - stencil_ubound0);
-    int ubound1 = (extrema::min)(A.ubound(1), A.ubound(1) - stencil_ubound1);
-    int ubound2 = (extrema::min)(A.ubound(2), A.ubound(2) - stencil_ubound2);
-
-#if 0
-    cout << "Stencil bounds are:" << endl
-     << lbound0 << '\t' << ubound0 << endl
-     << lbound1 << '\t' << ubound1 << endl
-     << lbound2 << '\t' << ubound2 << endl;
-#endif
-
-    // Now do the actual loop
     FastArrayIterator<T_numtype1,3> Aiter(A);
     _bz_typename T_array2::T_iterator Biter(B);
     _bz_typename T_array3::T_iterator Citer(C);
@@ -267,10 +239,15 @@ void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,3>& A,
     Jiter.loadStride(2);
     Kiter.loadStride(2);
 
-    for (int i=lbound0; i <= ubound0; ++i)
+    const int lbound2 = lbound(2);
+    const int ubound2 = ubound(2);
+    const sizeType extent1 = ubound(1) - lbound(1) + 1;
+
+    for (sizeType line=firstLine; line < lastLine; ++line)
     {
-      for (int j=lbound1; j <= ubound1; ++j)
-      {
+        const int i = lbound(0) + int(line / extent1);
+        const int j = lbound(1) + int(line % extent1);
+
         Aiter.moveTo(i,j,lbound2);
         Biter.moveTo(i,j,lbound2);
         Citer.moveTo(i,j,lbound2);
@@ -300,51 +277,19 @@ void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,3>& A,
             Jiter.advance();
             Kiter.advance();
         }
-      }
     }
 }
 
-/*
- * This version applies a stencil to a set of 2D arrays.  Up to 11 arrays
- * may be used.  Any unused arrays are turned into dummyArray objects.
- * Operations on dummyArray objects are translated into no-ops.
- */
 template<typename T_stencil, typename T_numtype1, typename T_array2,
     class T_array3, typename T_array4, typename T_array5, typename T_array6,
     class T_array7, typename T_array8, typename T_array9, typename T_array10,
     class T_array11>
-void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,2>& A,
-    T_array2& B, T_array3& C, T_array4& D, T_array5& E, T_array6& F, 
-    T_array7& G, T_array8& H, T_array9& I, T_array10& J, T_array11& K)
+void _bz_applyStencilLines(const T_stencil& stencil, Array<T_numtype1,2>& A,
+    T_array2& B, T_array3& C, T_array4& D, T_array5& E, T_array6& F,
+    T_array7& G, T_array8& H, T_array9& I, T_array10& J, T_array11& K,
+    const TinyVector<int,2>& lbound, const TinyVector<int,2>& ubound,
+    sizeType firstLine, sizeType lastLine)
 {
-    checkShapes(A,B,C,D,E,F,G,H,I,J,K);
-
-    // Determine stencil extent
-    TinyVector<int,2> minb, maxb;
-    getStencilExtent(minb, maxb, stencil, A, B, C, D, E, F, G, H, I, J, K);
-
-    // Now determine the subdomain over which the stencil
-    // can be applied without worrying about overrunning the
-    // boundaries of the array
-    int stencil_lbound0 = minb(0);
-    int stencil_lbound1 = minb(1);
-
-    int stencil_ubound0 = maxb(0);
-    int stencil_ubound1 = maxb(1);
-
-    int lbound0 = (extrema::max)(A.lbound(0), A.lbound(0) - stencil_lbound0);
-    int lbound1 = (extrema::max)(A.lbound(1), A.lbound(1) - stencil_lbound1);
-
-    int ubound0 = (extrema::min)(A.ubound(0), A.ubound(0) - stencil_ubound0);
-    int ubound1 = (extrema::min)(A.ubound(1), A.ubound(1) - stencil_ubound1);
-
-#if 0
-    cout << "Stencil bounds are:" << endl
-     << lbound0 << '\t' << ubound0 << endl
-     << lbound1 << '\t' << ubound1 << endl;
-#endif 
-
-    // Now do the actual loop
     FastArrayIterator<T_numtype1,2> Aiter(A);
     _bz_typename T_array2::T_iterator Biter(B);
     _bz_typename T_array3::T_iterator Citer(C);
@@ -370,8 +315,13 @@ void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,2>& A,
     Jiter.loadStride(1);
     Kiter.loadStride(1);
 
-    for (int i=lbound0; i <= ubound0; ++i)
+    const int lbound1 = lbound(1);
+    const int ubound1 = ubound(1);
+
+    for (sizeType line=firstLine; line < lastLine; ++line)
     {
+        const int i = lbound(0) + int(line);
+
         Aiter.moveTo(i,lbound1);
         Biter.moveTo(i,lbound1);
         Citer.moveTo(i,lbound1);
@@ -404,40 +354,16 @@ void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,2>& A,
     }
 }
 
-/*
- * This version applies a stencil to a set of 1D arrays.  Up to 11 arrays
- * may be used.  Any unused arrays are turned into dummyArray objects.
- * Operations on dummyArray objects are translated into no-ops.
- */
 template<typename T_stencil, typename T_numtype1, typename T_array2,
     class T_array3, typename T_array4, typename T_array5, typename T_array6,
     class T_array7, typename T_array8, typename T_array9, typename T_array10,
     class T_array11>
-void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,1>& A,
-    T_array2& B, T_array3& C, T_array4& D, T_array5& E, T_array6& F, 
-    T_array7& G, T_array8& H, T_array9& I, T_array10& J, T_array11& K)
+void _bz_applyStencilLines(const T_stencil& stencil, Array<T_numtype1,1>& A,
+    T_array2& B, T_array3& C, T_array4& D, T_array5& E, T_array6& F,
+    T_array7& G, T_array8& H, T_array9& I, T_array10& J, T_array11& K,
+    const TinyVector<int,1>& lbound, const TinyVector<int,1>&,
+    sizeType firstLine, sizeType lastLine)
 {
-    checkShapes(A,B,C,D,E,F,G,H,I,J,K);
-
-    // Determine stencil extent
-    TinyVector<int,1> minb, maxb;
-    getStencilExtent(minb, maxb, stencil, A, B, C, D, E, F, G, H, I, J, K);
-
-    // Now determine the subdomain over which the stencil
-    // can be applied without worrying about overrunning the
-    // boundaries of the array
-    int stencil_lbound0 = minb(0);
-    int stencil_ubound0 = maxb(0);
-
-    int lbound0 = (extrema::max)(A.lbound(0), A.lbound(0) - stencil_lbound0);
-    int ubound0 = (extrema::min)(A.ubound(0), A.ubound(0) - stencil_ubound0);
-
-#if 0
-    cout << "Stencil bounds are:" << endl
-     << lbound0 << '\t' << ubound0 << endl;
-#endif
-
-    // Now do the actual loop
     FastArrayIterator<T_numtype1,1> Aiter(A);
     _bz_typename T_array2::T_iterator Biter(B);
     _bz_typename T_array3::T_iterator Citer(C);
@@ -464,19 +390,20 @@ void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,1>& A,
     Kiter.loadStride(0);
 
     // Patch from Derrick Bass
-    Aiter.moveTo(lbound0);
-    Biter.moveTo(lbound0);
-    Citer.moveTo(lbound0);
-    Diter.moveTo(lbound0);
-    Eiter.moveTo(lbound0);
-    Fiter.moveTo(lbound0);
-    Giter.moveTo(lbound0);
-    Hiter.moveTo(lbound0);
-    Iiter.moveTo(lbound0);
-    Jiter.moveTo(lbound0);
-    Kiter.moveTo(lbound0);
-
-    for (int i=lbound0; i <= ubound0; ++i)
+    const int first = lbound(0) + int(firstLine);
+    Aiter.moveTo(first);
+    Biter.moveTo(first);
+    Citer.moveTo(first);
+    Diter.moveTo(first);
+    Eiter.moveTo(first);
+    Fiter.moveTo(first);
+    Giter.moveTo(first);
+    Hiter.moveTo(first);
+    Iiter.moveTo(first);
+    Jiter.moveTo(first);
+    Kiter.moveTo(first);
+
+    for (sizeType i=firstLine; i < lastLine; ++i)
     {
         stencil.apply(Aiter, Biter, Citer, Diter, Eiter, Fiter, Giter,
             Hiter, Iiter, Jiter, Kiter);
@@ -495,6 +422,210 @@ void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,1>& A,
     }
 }
 
+/*
+ * Applies a stencil over the interior domain lbound..ubound.  With
+ * BZ_PARALLEL_STENCILS and OpenMP, domains of at least
+ * BZ_STENCIL_THREADING_THRESHOLD points are split into one contiguous
+ * slab of lines per thread.  Slabs follow the serial loop order, so
+ * each thread sweeps a compact block of the arrays and only the
+ * stencil halo at its two faces is shared with its neighbours.  The
+ * split depends only on the domain and the number of threads, and every
+ * point is updated exactly once, so the result does not depend on the
+ * scheduling.  This requires that the stencil does not read points of
+ * an array which it writes (in-place, Gauss-Seidel like updates must
+ * be applied serially).
+ *
+ * OpenMP keeps its worker threads alive between parallel regions, so
+ * repeated calls in a time loop reuse the same threads.  The threads
+ * are bound close to the master thread (OpenMP 4.0 proc_bind) so that
+ * each thread keeps working on the same cores, and hence the same
+ * part of the arrays, from one call to the next; OMP_PLACES and
+ * OMP_WAIT_POLICY can be used to control placement and spinning.
+ */
+template<int N_rank, typename T_stencil, typename T_numtype1,
+    typename T_array2, typename T_array3, typename T_array4,
+    typename T_array5, typename T_array6, typename T_array7,
+    typename T_array8, typename T_array9, typename T_array10,
+    typename T_array11>
+void _bz_applyStencilInterior(const T_stencil& stencil,
+    Array<T_numtype1,N_rank>& A, T_array2& B, T_array3& C, T_array4& D,
+    T_array5& E, T_array6& F, T_array7& G, T_array8& H, T_array9& I,
+    T_array10& J, T_array11& K,
+    const TinyVector<int,N_rank>& lbound, const TinyVector<int,N_rank>& ubound)
+{
+    // Number of lines, and of points per line
+    sizeType numLines = 1;
+    for (int r=0; r < N_rank; ++r)
+    {
+        if (ubound(r) < lbound(r))
+            return;
+        if (r < N_rank-1)
+            numLines *= ubound(r) - lbound(r) + 1;
+    }
+    sizeType lineLength = ubound(N_rank-1) - lbound(N_rank-1) + 1;
+    if (N_rank == 1)
+    {
+        numLines = lineLength;
+        lineLength = 1;
+    }
+
+#if defined(BZ_PARALLEL_STENCILS) && defined(_OPENMP)
+    if ((numLines * lineLength >= BZ_STENCIL_THREADING_THRESHOLD)
+        && (numLines > 1) && !omp_in_parallel())
+    {
+#if _OPENMP >= 201307
+#pragma omp parallel proc_bind(close)
+#else
+#pragma omp parallel
+#endif
+        {
+            const sizeType nthreads = omp_get_num_threads();
+            const sizeType thread = omp_get_thread_num();
+
+            _bz_applyStencilLines(stencil, A, B, C, D, E, F, G, H, I, J, K,
+                lbound, ubound, numLines * thread / nthreads,
+                numLines * (thread + 1) / nthreads);
+        }
+        return;
+    }
+#endif
+
+    _bz_applyStencilLines(stencil, A, B, C, D, E, F, G, H, I, J, K,
+        lbound, ubound, 0, numLines);
+}
+
+/*
+ * This version applies a stencil to a set of 3D arrays.  Up to 11 arrays
+ * may be used.  Any unused arrays are turned into dummyArray objects.
+ * Operations on dummyArray objects are translated into no-ops.
+ */
+template<typename T_stencil, typename T_numtype1, typename T_array2,
+    class T_array3, typename T_array4, typename T_array5, typename T_array6,
+    class T_array7, typename T_array8, typename T_array9, typename T_array10,
+    class T_array11>
+void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,3>& A,
+    T_array2& B, T_array3& C, T_array4& D, T_array5& E, T_array6& F,
+    T_array7& G, T_array8& H, T_array9& I, T_array10& J, T_array11& K)
+{
+    checkShapes(A,B,C,D,E,F,G,H,I,J,K);
+ 
+    // Determine stencil extent
+    TinyVector<int,3> minb, maxb;
+    getStencilExtent(minb, maxb, stencil, A, B, C, D, E, F, G, H, I, J, K);
+
+    // Now determine the subdomain over which the stencil
+    // can be applied without worrying about overrunning the
+    // boundaries of the array
+    int stencil_lbound0 = minb(0);
+    int stencil_lbound1 = minb(1);
+    int stencil_lbound2 = minb(2);
+
+    int stencil_ubound0 = maxb(0);
+    int stencil_ubound1 = maxb(1);
+    int stencil_ubound2 = maxb(2);
+
+    int lbound0 = (extrema::max)(A.lbound(0), A.lbound(0) - stencil_lbound0);
+    int lbound1 = (extrema::max)(A.lbound(1), A.lbound(1) - stencil_lbound1);
+    int lbound2 = (extrema::max)(A.lbound(2), A.lbound(2) - stencil_lbound2);
+
+    int ubound0 = (extrema::min)(A.ubound(0), A.ubound(0) - stencil_ubound0);
+    int ubound1 = (extrema::min)(A.ubound(1), A.ubound(1) - stencil_ubound1);
+    int ubound2 = (extrema::min)(A.ubound(2), A.ubound(2) - stencil_ubound2);
+
+#if 0
+    cout << "Stencil bounds are:" << endl
+     << lbound0 << '\t' << ubound0 << endl
+     << lbound1 << '\t' << ubound1 << endl
+     << lbound2 << '\t' << ubound2 << endl;
+#endif
+
+    _bz_applyStencilInterior(stencil, A, B, C, D, E, F, G, H, I, J, K,
+        TinyVector<int,3>(lbound0, lbound1, lbound2),
+        TinyVector<int,3>(ubound0, ubound1, ubound2));
+}
+
+/*
+ * This version applies a stencil to a set of 2D arrays.  Up to 11 arrays
+ * may be used.  Any unused arrays are turned into dummyArray objects.
+ * Operations on dummyArray objects are translated into no-ops.
+ */
+template<typename T_stencil, typename T_numtype1, typename T_array2,
+    class T_array3, typename T_array4, typename T_array5, typename T_array6,
+    class T_array7, typename T_array8, typename T_array9, typename T_array10,
+    class T_array11>
+void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,2>& A,
+    T_array2& B, T_array3& C, T_array4& D, T_array5& E, T_array6& F, 
+    T_array7& G, T_array8& H, T_array9& I, T_array10& J, T_array11& K)
+{
+    checkShapes(A,B,C,D,E,F,G,H,I,J,K);
+
+    // Determine stencil extent
+    TinyVector<int,2> minb, maxb;
+    getStencilExtent(minb, maxb, stencil, A, B, C, D, E, F, G, H, I, J, K);
+
+    // Now determine the subdomain over which the stencil
+    // can be applied without worrying about overrunning the
+    // boundaries of the array
+    int stencil_lbound0 = minb(0);
+    int stencil_lbound1 = minb(1);
+
+    int stencil_ubound0 = maxb(0);
+    int stencil_ubound1 = maxb(1);
+
+    int lbound0 = (extrema::max)(A.lbound(0), A.lbound(0) - stencil_lbound0);
+    int lbound1 = (extrema::max)(A.lbound(1), A.lbound(1) - stencil_lbound1);
+
+    int ubound0 = (extrema::min)(A.ubound(0), A.ubound(0) - stencil_ubound0);
+    int ubound1 = (extrema::min)(A.ubound(1), A.ubound(1) - stencil_ubound1);
+
+#if 0
+    cout << "Stencil bounds are:" << endl
+     << lbound0 << '\t' << ubound0 << endl
+     << lbound1 << '\t' << ubound1 << endl;
+#endif 
+
+    _bz_applyStencilInterior(stencil, A, B, C, D, E, F, G, H, I, J, K,
+        TinyVector<int,2>(lbound0, lbound1),
+        TinyVector<int,2>(ubound0, ubound1));
+}
+
+/*
+ * This version applies a stencil to a set of 1D arrays.  Up to 11 arrays
+ * may be used.  Any unused arrays are turned into dummyArray objects.
+ * Operations on dummyArray objects are translated into no-ops.
+ */
+template<typename T_stencil, typename T_numtype1, typename T_array2,
+    class T_array3, typename T_array4, typename T_array5, typename T_array6,
+    class T_array7, typename T_array8, typename T_array9, typename T_array10,
+    class T_array11>
+void applyStencil_imp(const T_stencil& stencil, Array<T_numtype1,1>& A,
+    T_array2& B, T_array3& C, T_array4& D, T_array5& E, T_array6& F, 
+    T_array7& G, T_array8& H, T_array9& I, T_array10& J, T_array11& K)
+{
+    checkShapes(A,B,C,D,E,F,G,H,I,J,K);
+
+    // Determine stencil extent
+    TinyVector<int,1> minb, maxb;
+    getStencilExtent(minb, maxb, stencil, A, B, C, D, E, F, G, H, I, J, K);
+
+    // Now determine the subdomain over which the stencil
+    // can be applied without worrying about overrunning the
+    // boundaries of the array
+    int stencil_lbound0 = minb(0);
+    int stencil_ubound0 = maxb(0);
+
+    int lbound0 = (extrema::max)(A.lbound(0), A.lbound(0) - stencil_lbound0);
+    int ubound0 = (extrema::min)(A.ubound(0), A.ubound(0) - stencil_ubound0);
+
+#if 0
+    cout << "Stencil bounds are:" << endl
+     << lbound0 << '\t' << ubound0 << endl;
+#endif
+
+    _bz_applyStencilInterior(stencil, A, B, C, D, E, F, G, H, I, J, K,
+        TinyVector<int,1>(lbound0), TinyVector<int,1>(ubound0));
+}
+
 /*
  * These 11 versions of applyStencil handle from 1 to 11 array parameters.
  * They pad their argument list with enough dummyArray objects to call
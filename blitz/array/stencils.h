@@ -37,6 +37,10 @@
 
 #include <blitz/array/stencilops.h>
 
+#if defined(BZ_PARALLEL_STENCILS) && defined(_OPENMP)
+ #include <omp.h>
+#endif
+
 // NEEDS_WORK: currently stencilExtent returns int(1).  What if the
 // stencil contains calls to math functions, or divisions, etc.?
 // Should at least return a number of the appropriate type.  Probably
@@ -0,0 +1,628 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/array/tiled.h   Arrays stored as tiles in Morton order
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ****************************************************************************/
+#ifndef BZ_ARRAY_TILED_H
+#define BZ_ARRAY_TILED_H
+
+#ifndef BZ_ARRAY_H
+ #error <blitz/array/tiled.h> must be included after <blitz/array.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+/*
+ * TiledArray<T,N> is an N-dimensional array stored as cubic tiles of
+ * edge^N elements, edge being a power of two chosen so that a tile fits
+ * in BZ_TILE_BYTES (a page, by default). Each tile is stored row-major
+ * and the tiles follow one another in Morton (Z) order of their
+ * positions, so that moving along any rank stays within a tile most of
+ * the time, and neighbouring tiles are mostly close in memory. Elements
+ * are accessed with A(i,j,k) as for Array.
+ *
+ * Expressions of TiledArrays and scalars, built with + - * /, are
+ * evaluated one tile at a time, each tile being an ordinary Blitz++
+ * array assignment:
+ *
+ *   TiledArray<double,3> A(n,n,n), B(n,n,n);
+ *   A = 2 * B + 1;
+ *   A += B.transpose(2,1,0);
+ *
+ * transpose() makes a view with permuted ranks, as Array::transpose
+ * does; assigning it transposes a tile at a time, in cache. The
+ * TiledArrays of an expression have the same extents and tile edge, and
+ * the array assigned should not overlap another array of the expression
+ * except element for element.
+ */
+
+BZ_NAMESPACE(blitz)
+
+template<typename P_numtype, int N_rank> class TiledArray;
+
+/** Base class of the tiled expression nodes: each node has a type
+    T_tile and a method tile(t) giving the expression of the tile at
+    position t of the tile grid, indexed from t * edge along each rank;
+    and shapeCheck(extent, edge) checking its TiledArrays. */
+template<typename T>
+struct _bz_TiledBase {
+    const T& unwrap() const
+    { return static_cast<const T&>(*this); }
+};
+
+// a TiledArray in an expression, which keeps the view of its current
+// tile
+template<typename P_numtype, int N_rank>
+struct _bz_TiledLeaf
+    : public _bz_TiledBase<_bz_TiledLeaf<P_numtype,N_rank> > {
+    typedef P_numtype T_numtype;
+    typedef Array<P_numtype,N_rank> T_tile;
+
+    _bz_TiledLeaf(const TiledArray<P_numtype,N_rank>& array)
+        : array_(array) { }
+
+    const T_tile& tile(const TinyVector<int,N_rank>& t) const
+    {
+        view_.reference(array_.tile(t));
+        return view_;
+    }
+
+    bool shapeCheck(const TinyVector<int,N_rank>& extent, int edge) const
+    { return edge == array_.edge() && all(extent == array_.extent()); }
+
+    const TiledArray<P_numtype,N_rank>& array_;
+    mutable T_tile view_;
+};
+
+// How nodes keep their operands: TiledArrays as leaves, the others as
+// they are.
+template<typename T>
+struct _bz_TiledNode {
+    typedef T T_node;
+};
+
+template<typename P_numtype, int N_rank>
+struct _bz_TiledNode<TiledArray<P_numtype,N_rank> > {
+    typedef _bz_TiledLeaf<P_numtype,N_rank> T_node;
+};
+
+// a scalar, the same for all tiles
+template<typename T>
+struct _bz_TiledScalar : public _bz_TiledBase<_bz_TiledScalar<T> > {
+    typedef T T_numtype;
+    typedef T T_tile;
+
+    _bz_TiledScalar(T value) : value_(value) { }
+
+    template<int N_rank>
+    T tile(const TinyVector<int,N_rank>&) const
+    { return value_; }
+
+    template<int N_rank>
+    bool shapeCheck(const TinyVector<int,N_rank>&, int) const
+    { return true; }
+
+    T value_;
+};
+
+template<typename T_expr, template<typename> class T_op>
+struct _bz_TiledUnary : public _bz_TiledBase<_bz_TiledUnary<T_expr,T_op> > {
+    typedef typename _bz_TiledNode<T_expr>::T_node T_node;
+    typedef typename T_node::T_tile T_operand;
+    typedef typename BzUnaryExprResult<T_op,T_operand>::T_result T_tile;
+    typedef typename T_op<typename T_node::T_numtype>::T_numtype T_numtype;
+
+    _bz_TiledUnary(const T_expr& expr) : expr_(expr) { }
+
+    template<int N_rank>
+    T_tile tile(const TinyVector<int,N_rank>& t) const
+    { return T_tile(asExpr<T_operand>::getExpr(expr_.tile(t))); }
+
+    template<int N_rank>
+    bool shapeCheck(const TinyVector<int,N_rank>& extent, int edge) const
+    { return expr_.shapeCheck(extent, edge); }
+
+    T_node expr_;
+};
+
+template<typename T_expr1, typename T_expr2,
+         template<typename, typename> class T_op>
+struct _bz_TiledBinary
+    : public _bz_TiledBase<_bz_TiledBinary<T_expr1,T_expr2,T_op> > {
+    typedef typename _bz_TiledNode<T_expr1>::T_node T_node1;
+    typedef typename _bz_TiledNode<T_expr2>::T_node T_node2;
+    typedef typename T_node1::T_tile T_operand1;
+    typedef typename T_node2::T_tile T_operand2;
+    typedef typename BzBinaryExprResult<T_op,T_operand1,
+                                        T_operand2>::T_result T_tile;
+    typedef typename T_op<typename T_node1::T_numtype,
+                          typename T_node2::T_numtype>::T_numtype T_numtype;
+
+    _bz_TiledBinary(const T_expr1& expr1, const T_expr2& expr2)
+        : expr1_(expr1), expr2_(expr2) { }
+
+    template<int N_rank>
+    T_tile tile(const TinyVector<int,N_rank>& t) const
+    {
+        return T_tile(asExpr<T_operand1>::getExpr(expr1_.tile(t)),
+                      asExpr<T_operand2>::getExpr(expr2_.tile(t)));
+    }
+
+    template<int N_rank>
+    bool shapeCheck(const TinyVector<int,N_rank>& extent, int edge) const
+    {
+        return expr1_.shapeCheck(extent, edge)
+            && expr2_.shapeCheck(extent, edge);
+    }
+
+    T_node1 expr1_;
+    T_node2 expr2_;
+};
+
+// Orders tile positions along the Morton curve, by comparing them
+// along the rank of the most significant differing bit.
+template<int N_rank>
+struct _bz_MortonLess {
+    bool operator()(const TinyVector<int,N_rank>& a,
+                    const TinyVector<int,N_rank>& b) const
+    {
+        int rank = 0;
+        unsigned msb = 0;
+        for (int r=0; r < N_rank; ++r)
+        {
+            const unsigned x = unsigned(a(r) ^ b(r));
+            if (msb < x && msb < (msb ^ x))
+            {
+                rank = r;
+                msb = x;
+            }
+        }
+        return a(rank) < b(rank);
+    }
+};
+
+template<typename P_numtype, int N_rank>
+class TiledArray : public _bz_TiledBase<TiledArray<P_numtype,N_rank> > {
+public:
+    typedef P_numtype T_numtype;
+    typedef Array<P_numtype,N_rank> T_tile;
+
+    static const int rank_ = N_rank;
+
+    TiledArray()
+        : lbound_(0), extent_(0), stride_(0), edge_(1), shift_(0),
+          tileSize_(0), first_(0)
+    { }
+
+    /** An array of the given extent, with tiles of edge elements along
+        each rank (a power of two), or the largest tiles fitting in
+        BZ_TILE_BYTES if edge is 0. */
+    explicit TiledArray(const TinyVector<int,N_rank>& extent, int edge = 0)
+    { allocate(TinyVector<int,N_rank>(0), extent, edge); }
+
+    TiledArray(const TinyVector<int,N_rank>& lbounds,
+               const TinyVector<int,N_rank>& extent, int edge = 0)
+    { allocate(lbounds, extent, edge); }
+
+    explicit TiledArray(int extent0)
+    { allocate(TinyVector<int,N_rank>(0), TinyVector<int,1>(extent0), 0); }
+
+    TiledArray(int extent0, int extent1)
+    {
+        allocate(TinyVector<int,N_rank>(0),
+                 BZ_BLITZ_SCOPE(shape)(extent0, extent1), 0);
+    }
+
+    TiledArray(int extent0, int extent1, int extent2)
+    {
+        allocate(TinyVector<int,N_rank>(0),
+                 BZ_BLITZ_SCOPE(shape)(extent0, extent1, extent2), 0);
+    }
+
+    TiledArray(int extent0, int extent1, int extent2, int extent3)
+    {
+        allocate(TinyVector<int,N_rank>(0),
+                 BZ_BLITZ_SCOPE(shape)(extent0, extent1, extent2, extent3), 0);
+    }
+
+    /// A copy of the array A, with its domain.
+    explicit TiledArray(const Array<P_numtype,N_rank>& A, int edge = 0)
+    {
+        allocate(A.lbound(), A.extent(), edge);
+        *this = A;
+    }
+
+    /// Copies are views of the same data; assignment copies the elements.
+    TiledArray(const TiledArray& A)
+        : _bz_TiledBase<TiledArray>()
+    { reference(A); }
+
+    void reference(const TiledArray& A)
+    {
+        data_.reference(A.data_);
+        tiles_.reference(A.tiles_);
+        lbound_ = A.lbound_;
+        extent_ = A.extent_;
+        stride_ = A.stride_;
+        ordering_ = A.ordering_;
+        edge_ = A.edge_;
+        shift_ = A.shift_;
+        tileSize_ = A.tileSize_;
+        first_ = A.first_;
+    }
+
+    /// A copy stored in the usual order, even if this is a transpose.
+    TiledArray copy() const
+    {
+        TiledArray A(lbound_, extent_, edge_);
+        A = *this;
+        return A;
+    }
+
+    void resize(const TinyVector<int,N_rank>& extent)
+    { allocate(lbound_, extent, edge_); }
+
+    /** A view of the same data with its ranks permuted: rank r of the
+        view is rank r_r of this array, as for Array::transpose. */
+    TiledArray transpose(int r0, int r1, int r2 = 0, int r3 = 0) const;
+
+    /// The tile at position t of the tile grid, indexed from t * edge().
+    T_tile tile(const TinyVector<int,N_rank>& t) const;
+
+    /// The extent of the tile grid along each rank.
+    const TinyVector<int,N_rank>& tileExtent() const
+    { return tiles_.extent(); }
+
+    int edge() const
+    { return edge_; }
+
+    const TinyVector<int,N_rank>& lbound() const
+    { return lbound_; }
+
+    int lbound(int rank) const
+    { return lbound_(rank); }
+
+    TinyVector<int,N_rank> ubound() const
+    { return lbound_ + extent_ - 1; }
+
+    int ubound(int rank) const
+    { return lbound_(rank) + extent_(rank) - 1; }
+
+    const TinyVector<int,N_rank>& extent() const
+    { return extent_; }
+
+    int extent(int rank) const
+    { return extent_(rank); }
+
+    const TinyVector<int,N_rank>& shape() const
+    { return extent_; }
+
+    RectDomain<N_rank> domain() const
+    { return RectDomain<N_rank>(lbound_, ubound()); }
+
+    sizeType numElements() const
+    { return product(extent_); }
+
+    // Element access
+
+    const P_numtype& operator()(const TinyVector<int,N_rank>& index) const
+    { return first_[offset(index)]; }
+
+    P_numtype& operator()(const TinyVector<int,N_rank>& index)
+    { return first_[offset(index)]; }
+
+    const P_numtype& operator()(int i0) const
+    { return (*this)(TinyVector<int,1>(i0)); }
+
+    P_numtype& operator()(int i0)
+    { return (*this)(TinyVector<int,1>(i0)); }
+
+    const P_numtype& operator()(int i0, int i1) const
+    { return (*this)(TinyVector<int,2>(i0, i1)); }
+
+    P_numtype& operator()(int i0, int i1)
+    { return (*this)(TinyVector<int,2>(i0, i1)); }
+
+    const P_numtype& operator()(int i0, int i1, int i2) const
+    { return (*this)(TinyVector<int,3>(i0, i1, i2)); }
+
+    P_numtype& operator()(int i0, int i1, int i2)
+    { return (*this)(TinyVector<int,3>(i0, i1, i2)); }
+
+    const P_numtype& operator()(int i0, int i1, int i2, int i3) const
+    { return (*this)(TinyVector<int,4>(i0, i1, i2, i3)); }
+
+    P_numtype& operator()(int i0, int i1, int i2, int i3)
+    { return (*this)(TinyVector<int,4>(i0, i1, i2, i3)); }
+
+    // Assignment, one tile at a time
+
+    TiledArray& operator=(const TiledArray& A)
+    { return *this = _bz_TiledLeaf<P_numtype,N_rank>(A); }
+
+    TiledArray& operator=(const Array<P_numtype,N_rank>& A);
+
+#define BZ_TILED_UPDATE(op)                                             \
+    template<typename T_expr>                                           \
+    TiledArray& operator op(const _bz_TiledBase<T_expr>& expr)          \
+    {                                                                   \
+        const typename _bz_TiledNode<T_expr>::T_node node(expr.unwrap()); \
+        BZPRECONDITION(node.shapeCheck(extent_, edge_));                \
+        typename Array<diffType,N_rank>::iterator iter = tiles_.begin(),  \
+            end = tiles_.end();                                         \
+        for (; iter != end; ++iter)                                     \
+        {                                                               \
+            T_tile view(tile(iter.position()));                         \
+            view op node.tile(iter.position());                         \
+        }                                                               \
+        return *this;                                                   \
+    }                                                                   \
+                                                                        \
+    TiledArray& operator op(P_numtype x)                                \
+    { return *this op _bz_TiledScalar<P_numtype>(x); }
+
+    BZ_TILED_UPDATE(=)
+    BZ_TILED_UPDATE(+=)
+    BZ_TILED_UPDATE(-=)
+    BZ_TILED_UPDATE(*=)
+    BZ_TILED_UPDATE(/=)
+
+#undef BZ_TILED_UPDATE
+
+    /// Copies the elements to the array A.
+    void copyTo(Array<P_numtype,N_rank>& A) const;
+
+private:
+    void allocate(const TinyVector<int,N_rank>& lbounds,
+                  const TinyVector<int,N_rank>& extent, int edge);
+
+    diffType offset(const TinyVector<int,N_rank>& index) const
+    {
+        TinyVector<int,N_rank> t;
+        diffType inner = 0;
+        for (int r=0; r < N_rank; ++r)
+        {
+            const int i = index(r) - lbound_(r);
+            BZPRECONDITION((i >= 0) && (i < extent_(r)));
+            t(r) = i >> shift_;
+            inner += (i & (edge_ - 1)) * stride_(r);
+        }
+        return tiles_(t) * tileSize_ + inner;
+    }
+
+    // the part of the array A in tile t
+    Array<P_numtype,N_rank> section(const Array<P_numtype,N_rank>& A,
+                                    const TinyVector<int,N_rank>& t) const;
+
+    Array<P_numtype,1> data_;
+    // the index of each tile in data_, in tiles
+    Array<diffType,N_rank> tiles_;
+    TinyVector<int,N_rank> lbound_, extent_;
+    // strides and storage order of the elements of a tile
+    TinyVector<diffType,N_rank> stride_;
+    TinyVector<int,N_rank> ordering_;
+    int edge_, shift_;
+    diffType tileSize_;
+    P_numtype* first_;
+};
+
+template<typename P_numtype, int N_rank>
+void TiledArray<P_numtype,N_rank>::allocate(
+    const TinyVector<int,N_rank>& lbounds,
+    const TinyVector<int,N_rank>& extent, int edge)
+{
+    if (edge <= 0)
+    {
+        // the largest power of two whose tiles fit in BZ_TILE_BYTES
+        edge = 1;
+        for (;;)
+        {
+            sizeType bytes = sizeof(P_numtype);
+            for (int r=0; r < N_rank; ++r)
+                bytes *= 2 * edge;
+            if (bytes > BZ_TILE_BYTES)
+                break;
+            edge *= 2;
+        }
+    }
+    BZPRECHECK((edge & (edge - 1)) == 0,
+        "TiledArray tile edge must be a power of two, not " << edge);
+
+    lbound_ = lbounds;
+    extent_ = extent;
+    edge_ = edge;
+    for (shift_ = 0; (1 << shift_) < edge; ++shift_)
+        ;
+    tileSize_ = 1;
+    for (int r=N_rank - 1; r >= 0; --r)
+    {
+        stride_(r) = tileSize_;
+        ordering_(N_rank - 1 - r) = r;
+        tileSize_ *= edge;
+    }
+
+    // number the tiles along the Morton curve
+    TinyVector<int,N_rank> grid;
+    for (int r=0; r < N_rank; ++r)
+        grid(r) = (extent(r) + edge - 1) >> shift_;
+    tiles_.reference(Array<diffType,N_rank>(grid));
+    vector<TinyVector<int,N_rank> > positions;
+    positions.reserve(tiles_.numElements());
+    typename Array<diffType,N_rank>::iterator iter = tiles_.begin(),
+        end = tiles_.end();
+    for (; iter != end; ++iter)
+        positions.push_back(iter.position());
+    std::sort(positions.begin(), positions.end(), _bz_MortonLess<N_rank>());
+    for (sizeType k=0; k < positions.size(); ++k)
+        tiles_(positions[k]) = k;
+
+    data_.reference(Array<P_numtype,1>(tiles_.numElements() * tileSize_));
+    first_ = data_.data();
+}
+
+template<typename P_numtype, int N_rank>
+TiledArray<P_numtype,N_rank> TiledArray<P_numtype,N_rank>::transpose(
+    int r0, int r1, int r2, int r3) const
+{
+    const int ranks[4] = { r0, r1, r2, r3 };
+    BZPRECONDITION(N_rank <= 4);
+    TiledArray A(*this);
+    A.tiles_.transposeSelf(r0, r1, r2, r3);
+    for (int r=0; r < N_rank; ++r)
+    {
+        A.lbound_(r) = lbound_(ranks[r]);
+        A.extent_(r) = extent_(ranks[r]);
+        A.stride_(r) = stride_(ranks[r]);
+    }
+    // the ranks by increasing stride
+    for (int r=0; r < N_rank; ++r)
+        A.ordering_(r) = r;
+    for (int r=1; r < N_rank; ++r)
+        for (int s=r; s > 0 && A.stride_(A.ordering_(s))
+                 < A.stride_(A.ordering_(s - 1)); --s)
+            std::swap(A.ordering_(s), A.ordering_(s - 1));
+    return A;
+}
+
+template<typename P_numtype, int N_rank>
+Array<P_numtype,N_rank>
+TiledArray<P_numtype,N_rank>::tile(const TinyVector<int,N_rank>& t) const
+{
+    TinyVector<int,N_rank> base, shape;
+    for (int r=0; r < N_rank; ++r)
+    {
+        base(r) = t(r) * edge_;
+        shape(r) = extent_(r) - base(r) < edge_ ? extent_(r) - base(r) : edge_;
+    }
+    GeneralArrayStorage<N_rank> storage(ordering_,
+        TinyVector<bool,N_rank>(true), contiguousData);
+    storage.setBase(base);
+    return T_tile(first_ + tiles_(t) * tileSize_, shape, stride_, storage);
+}
+
+template<typename P_numtype, int N_rank>
+Array<P_numtype,N_rank> TiledArray<P_numtype,N_rank>::section(
+    const Array<P_numtype,N_rank>& A, const TinyVector<int,N_rank>& t) const
+{
+    TinyVector<int,N_rank> first, last;
+    for (int r=0; r < N_rank; ++r)
+    {
+        first(r) = A.lbound(r) + t(r) * edge_;
+        last(r) = first(r) + edge_ - 1;
+        if (last(r) > A.ubound(r))
+            last(r) = A.ubound(r);
+    }
+    Array<P_numtype,N_rank> B(A(RectDomain<N_rank>(first, last)));
+    B.reindexSelf(t * edge_);
+    return B;
+}
+
+template<typename P_numtype, int N_rank>
+TiledArray<P_numtype,N_rank>&
+TiledArray<P_numtype,N_rank>::operator=(const Array<P_numtype,N_rank>& A)
+{
+    BZPRECONDITION(all(A.extent() == extent_));
+    typename Array<diffType,N_rank>::iterator iter = tiles_.begin(),
+        end = tiles_.end();
+    for (; iter != end; ++iter)
+    {
+        T_tile view(tile(iter.position()));
+        view = section(A, iter.position());
+    }
+    return *this;
+}
+
+template<typename P_numtype, int N_rank>
+void TiledArray<P_numtype,N_rank>::copyTo(Array<P_numtype,N_rank>& A) const
+{
+    BZPRECONDITION(all(A.extent() == extent_));
+    typename Array<diffType,N_rank>::const_iterator iter = tiles_.begin(),
+        end = tiles_.end();
+    for (; iter != end; ++iter)
+    {
+        Array<P_numtype,N_rank> B(section(A, iter.position()));
+        B = tile(iter.position());
+    }
+}
+
+/// The sum of all elements, summed a tile at a time.
+template<typename P_numtype, int N_rank>
+BZ_SUMTYPE(P_numtype) sum(const TiledArray<P_numtype,N_rank>& A)
+{
+    BZ_SUMTYPE(P_numtype) s = 0;
+    const TinyVector<int,N_rank> grid = A.tileExtent();
+    Array<char,N_rank> positions(grid);
+    typename Array<char,N_rank>::const_iterator iter = positions.begin(),
+        end = positions.end();
+    for (; iter != end; ++iter)
+        s += sum(A.tile(iter.position()));
+    return s;
+}
+
+/*
+ * Operators building tiled expressions. One operand at least is a
+ * TiledArray or a tiled expression; the other may also be a scalar.
+ */
+
+#define BZ_TILED_BINARY(name, op)                                        \
+template<typename T1, typename T2>                                       \
+inline _bz_TiledBinary<T1,T2,op>                                         \
+name(const _bz_TiledBase<T1>& a, const _bz_TiledBase<T2>& b)             \
+{ return _bz_TiledBinary<T1,T2,op>(a.unwrap(), b.unwrap()); }            \
+                                                                         \
+template<typename T1>                                                    \
+inline _bz_TiledBinary<T1,_bz_TiledScalar<_bz_typename T1::T_numtype>,op> \
+name(const _bz_TiledBase<T1>& a, _bz_typename T1::T_numtype b)           \
+{                                                                        \
+    typedef _bz_TiledScalar<_bz_typename T1::T_numtype> T_b;             \
+    return _bz_TiledBinary<T1,T_b,op>(a.unwrap(), T_b(b));               \
+}                                                                        \
+                                                                         \
+template<typename T2>                                                    \
+inline _bz_TiledBinary<_bz_TiledScalar<_bz_typename T2::T_numtype>,T2,op> \
+name(_bz_typename T2::T_numtype a, const _bz_TiledBase<T2>& b)           \
+{                                                                        \
+    typedef _bz_TiledScalar<_bz_typename T2::T_numtype> T_a;             \
+    return _bz_TiledBinary<T_a,T2,op>(T_a(a), b.unwrap());               \
+}
+
+BZ_TILED_BINARY(operator+, Add)
+BZ_TILED_BINARY(operator-, Subtract)
+BZ_TILED_BINARY(operator*, Multiply)
+BZ_TILED_BINARY(operator/, Divide)
+
+#undef BZ_TILED_BINARY
+
+template<typename T>
+inline _bz_TiledUnary<T,UnaryMinus> operator-(const _bz_TiledBase<T>& a)
+{ return _bz_TiledUnary<T,UnaryMinus>(a.unwrap()); }
+
+BZ_NAMESPACE_END
+
+#endif // BZ_ARRAY_TILED_H
@@ -51,14 +51,14 @@ Benchmark<P_parameter>::Benchmark(unsigned numImplementations)
     numImplementations_ = numImplementations;
     numStoredImplementations_ = 0;
     implementations_ = new BenchmarkImplementation<P_parameter>* [numImplementations_];
-    rates_.resize(numImplementations, numParameterSettings());
-    Mflops_.resize(numImplementations, numParameterSettings());
+    harness_ = 0;
 }
 
 template<typename P_parameter>
 Benchmark<P_parameter>::~Benchmark()
 {
     delete [] implementations_;
+    delete harness_;
 }
 
 template<typename P_parameter>
@@ -80,48 +80,84 @@ void Benchmark<P_parameter>::run(ostream& log)
     BZPRECONDITION(state_ == initialized);
     state_ = running;
 
-    Timer t;
-
+    const int numSettings = numParameterSettings();
+    Array<P_parameter,1> parameters(numSettings);
+    Array<long,1> iterations(numSettings);
+    Array<double,1> ops(numSettings);
+    for (int i=0; i < numSettings; ++i)
+    {
+        parameters(i) = getParameterSetting(i);
+        iterations(i) = getIterationSetting(i);
+    }
+    ops = 1;
+
+    delete harness_;
+    harness_ = new BenchmarkExt<P_parameter>(description(), 
+        numImplementations_);
+    harness_->setNumParameters(numSettings);
+    harness_->setParameterVector(parameters);
+    harness_->setParameterDescription(parameterDescription());
+    harness_->setIterations(iterations);
+    harness_->setOpsPerIteration(ops);
+    harness_->setDependentVariable("ops");
+
+    rates_.resize(numImplementations_, numSettings);
+    Mflops_.resize(numImplementations_, numSettings);
+
+    harness_->beginBenchmarking();
     for (unsigned j=0; j < numImplementations_; ++j)
     {
-        for (unsigned i=0; i < numParameterSettings(); ++i)
-        {
-            log  << setw(20) << implementations_[j]->implementationName()
-                 << " " << setw(8) << getParameterSetting(i) << "  ";
-            log.flush();
+        harness_->beginImplementation(
+            implementations_[j]->implementationName());
 
+        for (int i=0; i < numSettings; ++i)
+        {
             implementations_[j]->initialize(getParameterSetting(i));
             implementations_[j]->tickle();
 
-            unsigned long iterations = getIterationSetting(i);
+            const long n = iterations(i);
+            while (harness_->repeat())
+            {
+                harness_->start();
+                implementations_[j]->run(n);
+                harness_->stop();
+            }
+
+            harness_->startOverhead();
+            implementations_[j]->runOverhead(n);
+            harness_->stopOverhead();
 
-            t.start();
-            implementations_[j]->run(iterations);
-            t.stop();
-            double tm = t.elapsedSeconds();
+            implementations_[j]->done();
+        }
 
-            t.start();
-            implementations_[j]->runOverhead(iterations);
-            t.stop();
-            double tmOverhead = t.elapsedSeconds();
+        harness_->endImplementation();
+    }
+    harness_->endBenchmarking();
 
-            rates_(j,i) = iterations / (tm - tmOverhead);
-            Mflops_(j,i) = rates_(j,i) 
+    // the statistics are available once the benchmarking has ended
+    for (unsigned j=0; j < numImplementations_; ++j)
+    {
+        for (int i=0; i < numSettings; ++i)
+        {
+            rates_(int(j),i) = 1.0 / harness_->getTime(j,i);
+            Mflops_(int(j),i) = rates_(int(j),i) 
                 * implementations_[j]->flopsPerIteration() / 1.0e+6;
 
-            log << setw(10) << (rates_(j,i)/1.0e+6) << " Mops/s ";
+            log  << setw(20) << implementations_[j]->implementationName()
+                 << " " << setw(8) << getParameterSetting(i) << "  ";
+            log << setw(10) << (rates_(int(j),i)/1.0e+6) << " Mops/s ";
 
             if (implementations_[j]->flopsPerIteration() != 0)
             {
-                log << "[" << setw(7) << Mflops_(j,i) << " Mflops]";
+                log << "[" << setw(7) << Mflops_(int(j),i) << " Mflops]";
             }
 
-            log << endl;
-            log.flush();
-
-            implementations_[j]->done();
+            log << "  (" << harness_->getRuns(j,i) << " runs, MAD "
+                << 100.0 * harness_->getMAD(j,i) / harness_->getTime(j,i) 
+                << "%)" << endl;
         }
     }
+    log.flush();
 
     state_ = done;
 }
@@ -134,7 +170,7 @@ double Benchmark<P_parameter>::getMflops(unsigned implementation,
     BZPRECONDITION(implementation < numImplementations_);
     BZPRECONDITION(setting < numParameterSettings());
 
-    return Mflops_(implementation, setting);
+    return Mflops_(int(implementation), int(setting));
 }
 
 template<typename P_parameter>
@@ -145,7 +181,47 @@ double Benchmark<P_parameter>::getRate(unsigned implementation,
     BZPRECONDITION(implementation < numImplementations_);
     BZPRECONDITION(setting < numParameterSettings());
 
-    return rates_(implementation, setting);
+    return rates_(int(implementation), int(setting));
+}
+
+/// Median time of one iteration, overhead subtracted.
+template<typename P_parameter>
+double Benchmark<P_parameter>::getTime(unsigned implementation,
+    unsigned setting) const
+{
+    BZPRECONDITION(state_ == done);
+    return harness_->getTime(implementation, setting);
+}
+
+/// Median absolute deviation of the time of one iteration.
+template<typename P_parameter>
+double Benchmark<P_parameter>::getMAD(unsigned implementation,
+    unsigned setting) const
+{
+    BZPRECONDITION(state_ == done);
+    return harness_->getMAD(implementation, setting);
+}
+
+template<typename P_parameter>
+int Benchmark<P_parameter>::getRuns(unsigned implementation,
+    unsigned setting) const
+{
+    BZPRECONDITION(state_ == done);
+    return harness_->getRuns(implementation, setting);
+}
+
+template<typename P_parameter>
+void Benchmark<P_parameter>::saveJSON(const char* filename) const
+{
+    BZPRECONDITION(state_ == done);
+    harness_->saveJSON(filename);
+}
+
+template<typename P_parameter>
+void Benchmark<P_parameter>::saveCSV(const char* filename) const
+{
+    BZPRECONDITION(state_ == done);
+    harness_->saveCSV(filename);
 }
 
 template<typename P_parameter>
@@ -158,6 +234,12 @@ void Benchmark<P_parameter>::saveMatlabGraph(const char* filename) const
       std::string pyfn(filename);
       pyfn=pyfn.replace(pyfn.find(".m"),2,std::string(".py"),0,3);
       savePylabGraph(pyfn.c_str());
+
+      // machine-readable results next to the graphs
+      std::string base(filename);
+      base.erase(base.find(".m"));
+      saveJSON((base + ".json").c_str());
+      saveCSV((base + ".csv").c_str());
     }
 
     ofstream ofs(filename);
@@ -240,7 +322,7 @@ void Benchmark<P_parameter>::savePylabGraph(const char* filename) const
 
     ofs << "semilogx(parm,Mf)\ntitle('" << description() << "')\n"
         << "xlabel('" << parameterDescription() << "')\n" 
-        << "ylabel('Mflops')\n";
+        << "ylabel('Mflops')\n"
         << "legend([";
     
     for (int j=0; j < numImplementations_; ++j)
@@ -32,8 +32,7 @@
 #ifndef BZ_BENCH_H
 #define BZ_BENCH_H
 
-#include <blitz/matrix.h>
-#include <blitz/timer.h>
+#include <blitz/benchext.h>
 
 #if defined(BZ_HAVE_STD)
 #include <cmath>
@@ -52,6 +51,15 @@ class BenchmarkImplementation;
 // The template parameter T is the parameter type which is varied in
 // the benchmark.  Typically T will be an unsigned, and will represent
 // the length of a vector, size of an array, etc.
+//
+// run() times the implementations with the repeat() loop of
+// BenchmarkExt<T>: warm-up runs, cache flushes, and runs until the
+// median time is precise enough. The rates are computed from the
+// median time of an iteration, less the overhead measured by
+// runOverhead(). getTime(), getMAD() and getRuns() give the
+// statistics, and saveJSON() and saveCSV() save them, with the rate
+// in operations (iterations) per unit of time; saveMatlabGraph()
+// writes those files too.
 
 template<typename P_parameter = unsigned>
 class Benchmark {
@@ -72,6 +80,12 @@ public:
 
     double getRate(unsigned implementation, unsigned setting) const;
 
+    double getTime(unsigned implementation, unsigned setting) const;
+    double getMAD(unsigned implementation, unsigned setting) const;
+    int getRuns(unsigned implementation, unsigned setting) const;
+
+    void saveJSON(const char* filename) const;
+    void saveCSV(const char* filename) const;
     void saveMatlabGraph(const char* filename) const;
     void savePylabGraph(const char* filename) const;
 
@@ -104,8 +118,10 @@ private:
 
     BenchmarkImplementation<T_parameter>** implementations_;
 
-    Matrix<double,RowMajor> rates_;       // Iterations per second array
-    Matrix<double,RowMajor> Mflops_;
+    BenchmarkExt<T_parameter>* harness_;  // Runs and statistics
+
+    Array<double,2> rates_;       // Iterations per second array
+    Array<double,2> Mflops_;
 };
 
 template<typename P_parameter>
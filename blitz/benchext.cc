@@ -44,6 +44,10 @@
  #include <string.h>
 #endif
 
+#if defined(BZ_HAVE_SCHED_SETAFFINITY) || defined(BZ_HAVE_SCHED_GETCPU)
+ #include <sched.h>
+#endif
+
 BZ_NAMESPACE(blitz)
 
 template<typename P_parameter>
@@ -77,6 +81,19 @@ BenchmarkExt<P_parameter>::BenchmarkExt(const char* name,
     // Set up initial state
     state_ = initializing;
     implementationNumber_ = 0;
+    repeating_ = false;
+
+    // repeat() defaults
+    warmup_ = 1;
+    minRuns_ = 3;
+    maxRuns_ = 20;
+    maxSeconds_ = 10.;
+    confidence_ = 0.02;
+    flushBuffer_.resize(8 * BZ_L2_CACHE_ESTIMATED_SIZE);
+    cpu_ = -1;
+    pin_ = true;
+    bandwidth_ = peakRate_ = 0;
+    checksum_ = 0;
 }
 
 template<typename P_parameter>
@@ -94,11 +111,17 @@ void BenchmarkExt<P_parameter>::setNumParameters(int numParameters)
     parameters_.resize(numParameters_);
     iterations_.resize(numParameters_);
     flopsPerIteration_.resize(numParameters_);
+    bytesPerIteration_.resize(numParameters_);
+    bytesPerIteration_ = 0;
 
     // Set up timer and Mflops array
     times_.resize(numImplementations_, numParameters_);
     instr_.resize(numImplementations_, numParameters_);
     flops_.resize(numImplementations_, numParameters_);
+    mad_.resize(numImplementations_, numParameters_);
+    runs_.resize(numImplementations_, numParameters_);
+    mad_ = 0;
+    runs_ = 1;
 }
 
 template<typename P_parameter>
@@ -133,6 +156,27 @@ void BenchmarkExt<P_parameter>::setOpsPerIteration(Array<double,1>
     flopsPerIteration_ = flopsPerIteration;
 }
 
+/// Set the bytes of memory traffic per iteration, for the roofline.
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::setBytesPerIteration(Array<double,1> 
+    bytesPerIteration)
+{
+    BZPRECONDITION(bytesPerIteration_.size() == bytesPerIteration.size());
+
+    bytesPerIteration_ = bytesPerIteration;
+}
+
+/** Set the roofline ceilings instead of measuring them: the memory
+    bandwidth in bytes, and the peak rate in operations, per timer
+    unit (seconds or cycles, see Timer::indep_var()). */
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::setRoofline(double bandwidth, 
+                                            double peakRate)
+{
+    bandwidth_ = bandwidth;
+    peakRate_ = peakRate;
+}
+
 /** Set the dependent variable of the measurements. If the independent
     variable is seconds, we output "G<dvar>/s", if it is cycles, we
     output "<dvar/c". */
@@ -155,10 +199,88 @@ void BenchmarkExt<P_parameter>::setDependentVariable(const char* dvar)
     }
 }
 
+/// Set the number of runs done by repeat() before recording.
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::setWarmup(int runs)
+{
+    BZPRECONDITION(runs >= 0);
+    warmup_ = runs;
+}
+
+/** Set the number of runs recorded by repeat(). At least \a minRuns
+    are recorded, and at most \a maxRuns, or as many as fit in \a
+    maxSeconds. */
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::setRepetitions(int minRuns, int maxRuns,
+                                               double maxSeconds)
+{
+    BZPRECONDITION((minRuns > 0) && (maxRuns >= minRuns));
+    minRuns_ = minRuns;
+    maxRuns_ = maxRuns;
+    maxSeconds_ = maxSeconds;
+}
+
+/** repeat() stops when the half-width of the 95% confidence interval
+    of the median time is less than this fraction of the median. */
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::setConfidence(double relativeHalfWidth)
+{
+    confidence_ = relativeHalfWidth;
+}
+
+/** Set the size of the buffer written by repeat() before each run to
+    flush the caches. It should be a few times larger than the last
+    level cache; 0 disables the flushing. */
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::setCacheFlush(size_t bytes)
+{
+    flushBuffer_.resize(bytes);
+}
+
+/** By default the benchmark is pinned to the processor it runs on
+    when beginBenchmarking() is called, so that it isn't migrated
+    between runs. This sets another processor, or disables pinning if
+    \a cpu is negative. The pinning is not done when compiled with
+    OpenMP and using more than one thread. */
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::setCpu(int cpu)
+{
+    BZPRECONDITION(state_ == initializing);
+    cpu_ = cpu;
+    pin_ = cpu >= 0;
+}
+
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::pinToCpu()
+{
+#ifdef _OPENMP
+    if (omp_get_max_threads() > 1)
+        return;
+#endif
+#ifdef BZ_HAVE_SCHED_SETAFFINITY
+    int cpu = cpu_;
+#ifdef BZ_HAVE_SCHED_GETCPU
+    if (cpu < 0)
+        cpu = sched_getcpu();
+#endif
+    if (cpu < 0)
+        return;
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0)
+        cerr << "Warning: could not pin the benchmark to cpu " << cpu 
+             << endl;
+#endif
+}
+
 template<typename P_parameter>
 void BenchmarkExt<P_parameter>::beginBenchmarking()
 {
     BZPRECONDITION(state_ == initializing);
+    if (pin_)
+        pinToCpu();
     state_ = benchmarking;
 }
 
@@ -208,6 +330,88 @@ long BenchmarkExt<P_parameter>::getIterations() const
     return iterations_(parameterNumber_);
 }
 
+/** Returns true while the current parameter needs another run, and
+    then flushes the caches. When it returns false the statistics of
+    the runs have been recorded and the benchmark has moved on to the
+    next parameter. */
+template<typename P_parameter>
+bool BenchmarkExt<P_parameter>::repeat()
+{
+    BZPRECONDITION(state_ == benchmarkingImplementation);
+    BZPRECONDITION(parameterNumber_ < numParameters_);
+
+    if (!repeating_)
+    {
+        repeating_ = true;
+        run_ = 0;
+        runTime_ = 0;
+        sampleTimes_.clear();
+        sampleInstr_.clear();
+        sampleFlops_.clear();
+    }
+    else if (endRuns())
+    {
+        repeating_ = false;
+        ++parameterNumber_;
+        return false;
+    }
+
+    flushCaches();
+    return true;
+}
+
+/// Records the statistics and returns true if no more runs are needed.
+template<typename P_parameter>
+bool BenchmarkExt<P_parameter>::endRuns()
+{
+    const int n = sampleTimes_.size();
+    if (n < minRuns_)
+        return false;
+
+    std::vector<double> x(sampleTimes_);
+    const double med = median(x);
+    for (int i=0; i < n; ++i)
+        x[i] = BZ_MATHFN_SCOPE(fabs)(sampleTimes_[i] - med);
+    const double mad = median(x);
+
+    // The standard error of the median of normally distributed
+    // samples is 1.2533 sigma/sqrt(n), and sigma = 1.4826 MAD.
+    const double halfWidth = 1.96 * 1.2533 * 1.4826 * mad / BZ_MATHFN_SCOPE(sqrt)(double(n));
+    if ((halfWidth > confidence_ * med) && (n < maxRuns_) 
+        && (runTime_ < maxSeconds_))
+        return false;
+
+    const int i = implementationNumber_, j = parameterNumber_;
+    times_(i, j) = med;
+    mad_(i, j) = mad;
+    runs_(i, j) = n;
+    x = sampleInstr_;
+    instr_(i, j) = static_cast<long long>(median(x));
+    x = sampleFlops_;
+    flops_(i, j) = static_cast<long long>(median(x));
+    return true;
+}
+
+template<typename P_parameter>
+double BenchmarkExt<P_parameter>::median(std::vector<double>& x)
+{
+    const size_t n = x.size();
+    std::nth_element(x.begin(), x.begin() + n/2, x.end());
+    const double upper = x[n/2];
+    if (n % 2)
+        return upper;
+    return 0.5 * (upper + *std::max_element(x.begin(), x.begin() + n/2));
+}
+
+/// Writes a buffer larger than the caches, so that runs start cold.
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::flushCaches()
+{
+    const size_t n = flushBuffer_.size();
+    for (size_t i=0; i < n; i += BZ_L1_CACHE_LINE_SIZE)
+        ++flushBuffer_[i];
+}
+
 template<typename P_parameter>
 inline void BenchmarkExt<P_parameter>::start()
 {
@@ -224,6 +428,17 @@ inline void BenchmarkExt<P_parameter>::stop()
     BZPRECONDITION(state_ == running);
     state_ = benchmarkingImplementation;
 
+    if (repeating_)
+    {
+        if (run_++ < warmup_)
+            return;
+        sampleTimes_.push_back(timer_.elapsed());
+        sampleInstr_.push_back(timer_.instr());
+        sampleFlops_.push_back(timer_.flops());
+        runTime_ += timer_.elapsed();
+        return;
+    }
+
     times_(int(implementationNumber_), int(parameterNumber_)) = timer_.elapsed();
     instr_(int(implementationNumber_), int(parameterNumber_)) = timer_.instr();
     flops_(int(implementationNumber_), int(parameterNumber_)) = timer_.flops();
@@ -269,6 +484,8 @@ inline void BenchmarkExt<P_parameter>::skip()
     BZPRECONDITION(state_ == benchmarkingImplementation);
     BZPRECONDITION(parameterNumber_ < numParameters_);
     times_(int(implementationNumber_), int(parameterNumber_)) = blitz::quiet_NaN(double());
+    mad_(int(implementationNumber_), int(parameterNumber_)) = blitz::quiet_NaN(double());
+    runs_(int(implementationNumber_), int(parameterNumber_)) = 0;
     ++parameterNumber_;
     state_ = benchmarkingImplementation;
 }
@@ -291,6 +508,89 @@ void BenchmarkExt<P_parameter>::endBenchmarking()
     BZPRECONDITION(implementationNumber_ == numImplementations_);
     
     state_ = done;
+
+    if (any(bytesPerIteration_ > 0))
+    {
+        if ((bandwidth_ <= 0) || (peakRate_ <= 0))
+            measureRoofline();
+        printRoofline();
+    }
+}
+
+/** Measure the roofline ceilings with the benchmark timer. The memory
+    bandwidth is the best of a few STREAM triads over arrays larger
+    than the caches, and the peak rate the best of a few multiply-add
+    loops over an array in the L1 cache. */
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::measureRoofline()
+{
+    const int numRuns = 5;
+
+    const size_t n = std::max(flushBuffer_.size(), 
+        size_t(8 * BZ_L2_CACHE_ESTIMATED_SIZE)) / sizeof(double);
+    std::vector<double> av(n, 0.), bv(n, 1.), cv(n, 2.);
+    double* restrict a = &av[0];
+    const double* restrict b = &bv[0];
+    const double* restrict c = &cv[0];
+    const double q = 3.;
+
+    double best = blitz::huge(double());
+    for (int run=0; run < numRuns; ++run)
+    {
+        timer_.start();
+        for (size_t i=0; i < n; ++i)
+            a[i] = b[i] + q * c[i];
+        timer_.stop();
+        best = std::min(best, double(timer_.elapsed()));
+    }
+    checksum_ += a[n/2];
+    if (bandwidth_ <= 0)
+        bandwidth_ = 3 * sizeof(double) * n / best;
+
+    const int m = BZ_L1_CACHE_ESTIMATED_SIZE / (4 * sizeof(double));
+    const long reps = 20000;
+    std::vector<double> yv(m, 1.);
+    double* restrict y = &yv[0];
+
+    best = blitz::huge(double());
+    for (int run=0; run < numRuns; ++run)
+    {
+        timer_.start();
+        for (long r=0; r < reps; ++r)
+        {
+            for (int i=0; i < m; ++i)
+                y[i] = y[i] * 0.999999 + 1e-6;
+            sink();
+        }
+        timer_.stop();
+        best = std::min(best, double(timer_.elapsed()));
+    }
+    checksum_ += y[m/2];
+    if (peakRate_ <= 0)
+        peakRate_ = 2. * m * reps / best;
+}
+
+/** Print the percentage of the roofline of each implementation at the
+    largest parameter, which is the one most likely to run from main
+    memory. The other parameters are in the saved results. */
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::printRoofline() const
+{
+    const int i = maxIndex(parameters_)[0];
+    if (bytesPerIteration_(i) <= 0)
+        return;
+
+    cout << description_ << ": memory bandwidth " 
+         << bandwidth_ * timerconversion_ << " Gbytes/" 
+         << timer_.indep_var() << ", peak " 
+         << peakRate_ * timerconversion_ << " " << depvar_ << endl
+         << "Percent of roofline at " << parameterDescription_ << " " 
+         << parameters_(i) << ":" << endl;
+
+    for (unsigned j=0; j < numImplementations_; ++j)
+        if (getRuns(j,i) > 0)
+            cout << "\t" << implementationDescriptions_[j] << ": " 
+                 << getRooflinePercent(j,i) << "%" << endl;
 }
 
 template<typename P_parameter>
@@ -325,6 +625,180 @@ double BenchmarkExt<P_parameter>::getflopsperc(int implementation,
       times_(int(implementation), int(parameterNum));
 }
 
+/// Elapsed time (or cycles) of one iteration, overhead subtracted.
+template<typename P_parameter>
+double BenchmarkExt<P_parameter>::getTime(int implementation,
+                                          int parameterNum) const
+{
+    BZPRECONDITION(state_ == done);
+    return times_(implementation, parameterNum) / iterations_(parameterNum);
+}
+
+/// Median absolute deviation of the time of one iteration.
+template<typename P_parameter>
+double BenchmarkExt<P_parameter>::getMAD(int implementation,
+                                         int parameterNum) const
+{
+    BZPRECONDITION(state_ == done);
+    return mad_(implementation, parameterNum) / iterations_(parameterNum);
+}
+
+template<typename P_parameter>
+int BenchmarkExt<P_parameter>::getRuns(int implementation,
+                                       int parameterNum) const
+{
+    BZPRECONDITION(state_ == done);
+    return runs_(implementation, parameterNum);
+}
+
+/// Achieved memory bandwidth in G bytes per second (or bytes/cycle).
+template<typename P_parameter>
+double BenchmarkExt<P_parameter>::getBandwidth(int implementation,
+                                               int parameterNum) const
+{
+    BZPRECONDITION(state_ == done);
+    return 1.0*iterations_(parameterNum) * bytesPerIteration_(parameterNum)
+      / times_(implementation, parameterNum) * timerconversion_;
+}
+
+/// Operations per byte of memory traffic.
+template<typename P_parameter>
+double BenchmarkExt<P_parameter>::getIntensity(int parameterNum) const
+{
+    return flopsPerIteration_(parameterNum) / bytesPerIteration_(parameterNum);
+}
+
+/// Achieved rate in percent of the roofline at this intensity.
+template<typename P_parameter>
+double BenchmarkExt<P_parameter>::getRooflinePercent(int implementation,
+                                                     int parameterNum) const
+{
+    BZPRECONDITION(state_ == done);
+    BZPRECONDITION((bandwidth_ > 0) && (peakRate_ > 0));
+    const double ceiling = std::min(peakRate_, 
+        getIntensity(parameterNum) * bandwidth_);
+    return 100. * iterations_(parameterNum) * flopsPerIteration_(parameterNum)
+      / times_(implementation, parameterNum) / ceiling;
+}
+
+template<typename P_parameter>
+string BenchmarkExt<P_parameter>::csvField(const string& s)
+{
+    string q = "\"";
+    for (size_t i=0; i < s.size(); ++i)
+    {
+        if (s[i] == '"')
+            q += '"';
+        q += s[i];
+    }
+    return q + "\"";
+}
+
+template<typename P_parameter>
+string BenchmarkExt<P_parameter>::quoted(const string& s)
+{
+    string q = "\"";
+    for (size_t i=0; i < s.size(); ++i)
+    {
+        if ((s[i] == '"') || (s[i] == '\\'))
+            q += '\\';
+        q += s[i];
+    }
+    return q + "\"";
+}
+
+/** Save the results as JSON: the benchmark description and units, and
+    for each implementation and parameter the time per iteration, its
+    MAD, the number of runs and the rate. Times of skipped parameters
+    are null. With the bytes per iteration set, the roofline ceilings
+    and for each result the bandwidth, intensity and percentage of the
+    roofline are included. */
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::saveJSON(const char* filename) const
+{
+    BZPRECONDITION(state_ == done);
+
+    ofstream ofs(filename);
+    assert(ofs.good());
+    ofs << setprecision(12);
+
+    ofs << "{\n  \"benchmark\": " << quoted(description_) << ",\n"
+        << "  \"parameter\": " << quoted(parameterDescription_) << ",\n"
+        << "  \"timeUnit\": " << quoted(timer_.indep_var()) << ",\n"
+        << "  \"rateUnit\": " << quoted(depvar_) << ",\n";
+    if (bandwidth_ > 0)
+        ofs << "  \"bandwidthCeiling\": " << bandwidth_ * timerconversion_ 
+            << ",\n  \"peakCeiling\": " << peakRate_ * timerconversion_ 
+            << ",\n";
+    ofs << "  \"implementations\": [";
+
+    for (unsigned j=0; j < numImplementations_; ++j)
+    {
+        ofs << (j ? "," : "") << "\n    {\n      \"name\": " 
+            << quoted(implementationDescriptions_[j]) << ",\n"
+            << "      \"results\": [";
+        for (unsigned i=0; i < numParameters_; ++i)
+        {
+            ofs << (i ? "," : "") << "\n        { \"parameter\": " 
+                << double(parameters_(i))
+                << ", \"iterations\": " << iterations_(i)
+                << ", \"runs\": " << getRuns(j,i);
+            if (getRuns(j,i) == 0)
+                ofs << ", \"time\": null, \"mad\": null, \"rate\": null";
+            else
+                ofs << ", \"time\": " << getTime(j,i)
+                    << ", \"mad\": " << getMAD(j,i)
+                    << ", \"rate\": " << getMflops(j,i);
+            if ((getRuns(j,i) > 0) && (bytesPerIteration_(i) > 0) 
+                && (bandwidth_ > 0))
+                ofs << ", \"bandwidth\": " << getBandwidth(j,i)
+                    << ", \"intensity\": " << getIntensity(i)
+                    << ", \"roofline\": " << getRooflinePercent(j,i);
+            ofs << ", \"instr\": " << instr_(int(j), int(i))
+                << ", \"flops\": " << flops_(int(j), int(i)) << " }";
+        }
+        ofs << "\n      ]\n    }";
+    }
+    ofs << "\n  ]\n}" << endl;
+}
+
+/** Save the results as CSV, one line per implementation and
+    parameter. The columns are those of saveJSON(). */
+template<typename P_parameter>
+void BenchmarkExt<P_parameter>::saveCSV(const char* filename) const
+{
+    BZPRECONDITION(state_ == done);
+
+    ofstream ofs(filename);
+    assert(ofs.good());
+    ofs << setprecision(12);
+
+    ofs << "benchmark,implementation,parameter,iterations,runs,time,mad,"
+        << "rate,instr,flops,bandwidth,intensity,roofline" << endl;
+    for (unsigned j=0; j < numImplementations_; ++j)
+        for (unsigned i=0; i < numParameters_; ++i)
+        {
+            ofs << csvField(description_) << ","
+                << csvField(implementationDescriptions_[j]) << ","
+                << double(parameters_(i)) << "," << iterations_(i) << ","
+                << getRuns(j,i) << ",";
+            if (getRuns(j,i) > 0)
+                ofs << getTime(j,i) << "," << getMAD(j,i) << ","
+                    << getMflops(j,i);
+            else
+                ofs << ",,";
+            ofs << "," << instr_(int(j), int(i)) << "," 
+                << flops_(int(j), int(i)) << ",";
+            if ((getRuns(j,i) > 0) && (bytesPerIteration_(i) > 0) 
+                && (bandwidth_ > 0))
+                ofs << getBandwidth(j,i) << "," << getIntensity(i) << ","
+                    << getRooflinePercent(j,i);
+            else
+                ofs << ",,";
+            ofs << endl;
+        }
+}
+
 template<typename P_parameter>
 void BenchmarkExt<P_parameter>::saveMatlabGraph(const char* filename, const char* graphType) const
 {
@@ -335,6 +809,12 @@ void BenchmarkExt<P_parameter>::saveMatlabGraph(const char* filename, const char
       std::string pyfn(filename);
       pyfn=pyfn.replace(pyfn.find(".m"),2,std::string(".py"),0,3);
       savePylabGraph(pyfn.c_str());
+
+      // machine-readable results next to the graphs
+      std::string base(filename);
+      base.erase(base.find(".m"));
+      saveJSON((base + ".json").c_str());
+      saveCSV((base + ".csv").c_str());
     }
 
     ofstream ofs(filename);
@@ -44,17 +44,45 @@
 
 #include <math.h>
 #include <string>
+#include <algorithm>
 
 // NEEDS_WORK: replace use of const char* with <string>, once standard
 // library is widely supported.
 
 BZ_NAMESPACE(blitz)
 
+extern void sink();
+
 // Declaration of class BenchmarkExt<T>
 // The template parameter T is the parameter type which is varied in
 // the benchmark.  Typically T will be an unsigned, and will represent
 // the length of a vector, size of an array, etc.
-
+//
+// An implementation can be timed once per parameter, by calling
+// start() and stop(), or repeatedly until the measurement is precise
+// enough:
+//
+//   while (bench.repeat()) {
+//       bench.start();
+//       ... 
+//       bench.stop();
+//   }
+//
+// repeat() first does warm-up runs that are not recorded, and flushes
+// the caches before each run. The runs stop when the 95% confidence
+// interval of the median time is within the set fraction of it, or
+// after the maximum number of runs or time. The median time, the
+// median absolute deviation (MAD) and the number of runs are
+// recorded, and saved by saveJSON() and saveCSV().
+//
+// If the bytes of memory traffic per iteration are set, the results
+// also include the achieved bandwidth, the arithmetic intensity and
+// the percentage of the roofline: the lower of the peak rate and the
+// intensity times the memory bandwidth. Both ceilings are measured
+// when benchmarking ends (a STREAM triad over arrays larger than the
+// caches, and a multiply-add loop in L1), unless set by setRoofline().
+// Since the bandwidth ceiling is that of main memory, sizes that fit
+// in the caches can be above 100%.
 template<typename P_parameter = unsigned>
 class BenchmarkExt {
 
@@ -70,8 +98,16 @@ public:
     void setParameterDescription(const char* string);
   void setIterations(Array<long,1> iters);
   void setOpsPerIteration(Array<double,1> flopsPerIteration);
+  void setBytesPerIteration(Array<double,1> bytesPerIteration);
+  void setRoofline(double bandwidth, double peakRate);
   void setDependentVariable(const char* string);
 
+    void setWarmup(int runs);
+    void setRepetitions(int minRuns, int maxRuns, double maxSeconds = 10.);
+    void setConfidence(double relativeHalfWidth);
+    void setCacheFlush(size_t bytes);
+    void setCpu(int cpu);
+
     void beginBenchmarking();
 
     void beginImplementation(const char* description);
@@ -81,6 +117,7 @@ public:
     T_parameter getParameter() const;
     long        getIterations() const;
 
+    bool repeat();
     inline void start();
     inline void stop();
 
@@ -95,7 +132,15 @@ public:
     double getMflops(unsigned implementation, unsigned parameterNum) const;
     double getinstrperc(int implementation, int parameterNum) const;
     double getflopsperc(int implementation, int parameterNum) const;
-
+    double getTime(int implementation, int parameterNum) const;
+    double getMAD(int implementation, int parameterNum) const;
+    int getRuns(int implementation, int parameterNum) const;
+    double getBandwidth(int implementation, int parameterNum) const;
+    double getIntensity(int parameterNum) const;
+    double getRooflinePercent(int implementation, int parameterNum) const;
+
+    void saveJSON(const char* filename) const;
+    void saveCSV(const char* filename) const;
     void saveMatlabGraph(const char* filename, const char* graphType="semilogx") const;
     void savePylabGraph(const char* filename, const char* graphType="semilogx") const;
 
@@ -103,6 +148,15 @@ protected:
     BenchmarkExt(const BenchmarkExt<P_parameter>&) { }
     void operator=(const BenchmarkExt<P_parameter>&) { }
 
+    void flushCaches();
+    void measureRoofline();
+    void printRoofline() const;
+    void pinToCpu();
+    bool endRuns();
+    static double median(std::vector<double>& x);
+    static string quoted(const string& s);
+    static string csvField(const string& s);
+
     enum { initializing, benchmarking, benchmarkingImplementation, 
        running, runningOverhead, done } state_;
 
@@ -115,10 +169,29 @@ protected:
   Array<double,2> times_;       // Elapsed time
   Array<long long,2> instr_;       // instructions according to timer
   Array<long long,2> flops_;       // flops according to timer
+  Array<double,2> mad_;         // MAD of the elapsed times
+  Array<int,2> runs_;           // recorded runs
+
+  // state of repeat()
+  bool repeating_;
+  int run_;
+  double runTime_;
+  std::vector<double> sampleTimes_, sampleInstr_, sampleFlops_;
+
+  int warmup_, minRuns_, maxRuns_;
+  double maxSeconds_, confidence_;
+  std::vector<char> flushBuffer_;
+  int cpu_;
+  bool pin_;
 
   Array<T_parameter,1> parameters_;
   Array<long,1> iterations_;
   Array<double,1> flopsPerIteration_;
+  Array<double,1> bytesPerIteration_;
+
+  // roofline ceilings per timer unit, 0 if unknown
+  double bandwidth_, peakRate_;
+  double checksum_;
 
     Timer timer_;
 
@@ -194,5 +194,6 @@ BZ_NAMESPACE_END
 #endif
 
 #include <blitz/bzdebug.h>           // Debugging macros
+#include <blitz/exprprofile.h>       // Expression profiling
 
 #endif // BZ_BLITZ_H
@@ -117,17 +117,22 @@ _bz_global int  assertSuccessCount BZ_GLOBAL_INIT(0);
     }
   }
 
-    #define BZASSERT(X)        blitz::checkAssert(X, __FILE__, __LINE__)
-    #define BZPRECONDITION(X)  blitz::checkAssert(X, __FILE__, __LINE__)
-    #define BZPOSTCONDITION(X) blitz::checkAssert(X, __FILE__, __LINE__)
-    #define BZSTATECHECK(X,Y)  blitz::checkAssert(X == Y, __FILE__, __LINE__)
+    // checkAssert is only called when the check fails, so that the
+    // checks may be in constexpr functions evaluated at compile time
+    #define BZASSERT(X)        ((X) ? (void)0 : \
+                                blitz::checkAssert(false, __FILE__, __LINE__))
+    #define BZPRECONDITION(X)  BZASSERT(X)
+    #define BZPOSTCONDITION(X) BZASSERT(X)
+    #define BZSTATECHECK(X,Y)  BZASSERT(X == Y)
     #define BZPRECHECK(X,Y)                                    \
         {                                                      \
-            if ((assertFailMode == false) && (!(X)))           \
-                BZ_STD_SCOPE(cerr) << Y << BZ_STD_SCOPE(endl); \
-            blitz::checkAssert(X, __FILE__, __LINE__);         \
+            if (!(X))                                          \
+            {                                                  \
+                if (assertFailMode == false)                   \
+                    BZ_STD_SCOPE(cerr) << Y << BZ_STD_SCOPE(endl); \
+                blitz::checkAssert(false, __FILE__, __LINE__); \
+            }                                                  \
         }
-
     #define BZ_DEBUG_MESSAGE(X)                                          \
         {                                                                \
             if (assertFailMode == false)                                 \
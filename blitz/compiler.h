@@ -106,6 +106,28 @@
     #endif
 #endif
 
+// The constexpr functions of TinyVector and TinyMatrix have loops and
+// assignments, which need C++14. Before C++20, a constexpr constructor
+// must also initialize all the members: BZ_CONSTEXPR_INIT(x)
+// initializes the member x when it is needed. The variables of
+// TinyVector and TinyMatrix type in constexpr functions, whose default
+// constructors leave them uninitialized, are given a value v with
+// BZ_CONSTEXPR_VALUE(v).
+#if !defined(BZ_DISABLE_CONSTEXPR) && __cplusplus >= 201402L
+    #define BZ_HAVE_CONSTEXPR
+    #define BZ_CONSTEXPR     constexpr
+    #define BZ_CONSTEXPR_VALUE(v)  (v)
+    #if __cpp_constexpr >= 201907L
+        #define BZ_CONSTEXPR_INIT(x)
+    #else
+        #define BZ_CONSTEXPR_INIT(x)   : x()
+    #endif
+#else
+    #define BZ_CONSTEXPR
+    #define BZ_CONSTEXPR_INIT(x)
+    #define BZ_CONSTEXPR_VALUE(v)
+#endif
+
 #if !defined(BZ_HAVE_BOOL) && !defined(BZ_NO_BOOL_KLUDGE)
     #define bool    int
     #define true    1
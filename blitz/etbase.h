@@ -39,15 +39,16 @@ class ETBase {
 public:
   typedef T T_unwrapped;
 
-    ETBase() 
+    BZ_CONSTEXPR ETBase() 
     { }
 
-    ETBase(const ETBase<T>&)
+    BZ_CONSTEXPR ETBase(const ETBase<T>&)
     { }
     
-    T& unwrap() { return static_cast<T&>(*this); }
+    BZ_CONSTEXPR T& unwrap() { return static_cast<T&>(*this); }
     
-    const T& unwrap() const { return static_cast<const T&>(*this); }
+    BZ_CONSTEXPR const T& unwrap() const
+    { return static_cast<const T&>(*this); }
 
     ETBase<T>& wrap() { return static_cast<ETBase<T>&>(*this); }
 
@@ -0,0 +1,426 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/exprprofile.h   Built-in profiling of array expressions
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ***************************************************************************/
+
+/* When BZ_EXPR_PROFILING is defined, every array expression assigned
+   with _bz_evaluate and every full reduction is timed. There is one
+   entry for each distinct expression type, identified by its terse
+   pretty-printed form (computed the first time the expression is
+   evaluated), holding the number of calls, the number of elements,
+   the total time and how often each traversal path was taken. The
+   table is printed to cerr at exit, or on demand with
+   ExprProfile::dump().
+
+   When BZ_TRAVERSAL_COUNTERS is defined, global counters record the
+   calls and elements of each traversal path, and how the unit-stride
+   loops were split between the vectorized chunks, the peeled and the
+   scalar elements. They are cheap enough for release builds and are
+   read with TraversalCounters::get().
+
+   The entries and counters are updated atomically when compiling with
+   OpenMP, but not with other threading models. The times of nested
+   evaluations (e.g. a reduction inside an expression) are included in
+   the enclosing one. */
+
+#ifndef BZ_EXPRPROFILE_H
+#define BZ_EXPRPROFILE_H
+
+BZ_NAMESPACE(blitz)
+
+/// Traversal paths of array expressions.
+enum TraversalPath {
+  indexTraversal,         // with index placeholders, and reductions
+  stridedTraversal,       // stack traversal, strides differ
+  unitStrideTraversal,    // stack traversal, unit strides
+  commonStrideTraversal,  // stack traversal, a common stride
+  tiled2DTraversal,       // 2D stencil tiling
+  fastTraversal,          // space-filling curve
+  permutedCopy,           // tiled copy of a permuted array
+  numTraversalPaths
+};
+
+/// Ways the unit-stride loop is done, see _bz_evaluateWithUnitStride.
+enum UnitStrideLoop {
+  binaryUnrolledLoop,     // short, by _bz_meta_binaryAssign
+  alignedChunkedLoop,     // vectorized, operands aligned
+  unalignedChunkedLoop,   // vectorized, only the stores aligned
+  scalarLoop,             // not vectorizable (e.g. stencils)
+  numUnitStrideLoops
+};
+
+/** Adds n to a counter, atomically when compiling with OpenMP. */
+inline void _bz_traversalCount(unsigned long long& counter,
+                               unsigned long long n)
+{
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+  counter += n;
+}
+
+BZ_NAMESPACE_END
+
+#if defined(BZ_EXPR_PROFILING) || defined(BZ_TRAVERSAL_COUNTERS)
+ #define BZ_TRAVERSAL_HOOKS
+ #include <algorithm>
+#endif
+
+#ifdef BZ_TRAVERSAL_COUNTERS
+
+BZ_NAMESPACE(blitz)
+
+/** Counters of the traversal decisions of all expressions. */
+struct TraversalCounters {
+  enum { maxCollapsedLoops = 12 };
+
+  // calls and elements of each TraversalPath
+  unsigned long long calls[numTraversalPaths];
+  unsigned long long elements[numTraversalPaths];
+
+  // inner loops and elements of each UnitStrideLoop
+  unsigned long long unitStrideLoops[numUnitStrideLoops];
+  unsigned long long unitStrideElements[numUnitStrideLoops];
+
+  // inner loops that peeled elements to align the stores, and the
+  // number of peeled elements
+  unsigned long long peeledLoops;
+  unsigned long long peeledElements;
+  // scalar elements after the vectorized chunks, and the elements
+  // assigned by _bz_meta_binaryAssign one at a time
+  unsigned long long remainderElements;
+  unsigned long long binaryAssignScalarElements;
+
+  // stack traversals by number of loops collapsed into the inner one
+  unsigned long long collapsedLoops[maxCollapsedLoops];
+
+  TraversalCounters() { reset(); }
+
+  /// The counters of this program.
+  static TraversalCounters& get()
+  { static TraversalCounters c; return c; }
+
+  void reset()
+  {
+    std::fill(calls, calls + numTraversalPaths, 0ULL);
+    std::fill(elements, elements + numTraversalPaths, 0ULL);
+    std::fill(unitStrideLoops, unitStrideLoops + numUnitStrideLoops, 0ULL);
+    std::fill(unitStrideElements, unitStrideElements + numUnitStrideLoops,
+              0ULL);
+    peeledLoops = peeledElements = 0;
+    remainderElements = binaryAssignScalarElements = 0;
+    std::fill(collapsedLoops, collapsedLoops + maxCollapsedLoops, 0ULL);
+  }
+
+  void print(ostream& os = cout) const;
+};
+
+inline void TraversalCounters::print(ostream& os) const
+{
+  static const char* pathNames[numTraversalPaths] = { "index", "strided",
+    "unit-stride", "common-stride", "tiled-2D", "fast", "permuted-copy" };
+  static const char* loopNames[numUnitStrideLoops] = { "binary-unrolled",
+    "aligned-chunked", "unaligned-chunked", "scalar" };
+
+  os << "[Blitz++] Traversal counters" << endl;
+  for (int p=0; p < numTraversalPaths; ++p)
+    if (calls[p])
+      os << setw(16) << pathNames[p] << ": " << calls[p] << " calls, "
+         << elements[p] << " elements" << endl;
+  for (int l=0; l < numUnitStrideLoops; ++l)
+    if (unitStrideLoops[l])
+      os << setw(16) << loopNames[l] << ": " << unitStrideLoops[l]
+         << " loops, " << unitStrideElements[l] << " elements" << endl;
+  os << setw(16) << "peeled" << ": " << peeledLoops << " loops, "
+     << peeledElements << " elements" << endl
+     << setw(16) << "remainder" << ": " << remainderElements
+     << " elements, " << binaryAssignScalarElements
+     << " in binary-unrolled loops" << endl
+     << setw(16) << "collapsed" << ":";
+  for (int d=0; d < maxCollapsedLoops; ++d)
+    if (collapsedLoops[d])
+      os << " " << d << ":" << collapsedLoops[d];
+  os << endl;
+}
+
+BZ_NAMESPACE_END
+
+#define BZ_TRAVERSAL_COUNT(counter, n) \
+  _bz_traversalCount(TraversalCounters::get().counter, n)
+
+#else // BZ_TRAVERSAL_COUNTERS
+
+#define BZ_TRAVERSAL_COUNT(counter, n)
+
+#endif // BZ_TRAVERSAL_COUNTERS
+
+#ifdef BZ_EXPR_PROFILING
+
+#include <vector>
+#include <string>
+
+#ifdef BZ_HAVE_CLOCK_GETTIME
+ #include <time.h>
+#else
+ #include <sys/time.h>
+#endif
+
+#if defined(__GNUC__) || defined(__INTEL_COMPILER)
+ #define BZ_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+ #define BZ_THREAD_LOCAL __declspec(thread)
+#else
+ #define BZ_THREAD_LOCAL
+#endif
+
+BZ_NAMESPACE(blitz)
+
+/// Profile of one expression type.
+struct ExprProfileEntry {
+  string description;
+  unsigned long long calls;
+  unsigned long long elements;
+  double seconds;
+  // number of calls that used each TraversalPath
+  unsigned long long pathCalls[numTraversalPaths];
+
+  ExprProfileEntry(const string& d)
+    : description(d), calls(0), elements(0), seconds(0)
+  { std::fill(pathCalls, pathCalls + numTraversalPaths, 0ULL); }
+};
+
+/** The table of expression profiles. The entries are never freed, so
+    that they outlive the function-local statics that point to them. */
+class ExprProfile {
+public:
+  /// Print the table, most expensive expression first.
+  static void dump(ostream& os = cerr);
+
+  /// Zero the counters of all entries.
+  static void reset();
+
+  /// Set whether the table is printed at exit (the default).
+  static void setDumpAtExit(bool dump)
+  { dumper().enabled = dump; }
+
+  static const vector<ExprProfileEntry*>& entries()
+  { return table(); }
+
+  /// Returns the entry with this description, or 0.
+  static const ExprProfileEntry* find(const string& description);
+
+  /** Returns the entry with this description, added if there is none
+      yet. Expression types which print the same (the same expression
+      on arrays of different types, for example) share an entry. */
+  static ExprProfileEntry* add(const string& description);
+
+  static double now()
+  {
+#ifdef BZ_HAVE_CLOCK_GETTIME
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1e-9*t.tv_nsec;
+#else
+    struct timeval t;
+    gettimeofday(&t, 0);
+    return t.tv_sec + 1e-6*t.tv_usec;
+#endif
+  }
+
+private:
+  struct Dumper {
+    bool enabled;
+    Dumper() : enabled(true) { }
+    ~Dumper() { if (enabled && !table().empty()) dump(cerr); }
+  };
+
+  static vector<ExprProfileEntry*>& table()
+  { static vector<ExprProfileEntry*> t; return t; }
+
+  // constructed after the table, so destroyed before it
+  static Dumper& dumper()
+  { static Dumper d; return d; }
+
+  static bool moreExpensive(const ExprProfileEntry* a,
+                            const ExprProfileEntry* b)
+  { return a->seconds > b->seconds; }
+};
+
+inline ExprProfileEntry* ExprProfile::add(const string& description)
+{
+  ExprProfileEntry* entry = 0;
+#ifdef _OPENMP
+#pragma omp critical (bz_exprprofile)
+#endif
+  {
+    vector<ExprProfileEntry*>& t = table();
+    for (size_t i=0; i < t.size(); ++i)
+      if (t[i]->description == description) {
+        entry = t[i];
+        break;
+      }
+    if (!entry) {
+      entry = new ExprProfileEntry(description);
+      t.push_back(entry);
+    }
+    dumper();
+  }
+  return entry;
+}
+
+inline const ExprProfileEntry* ExprProfile::find(const string& description)
+{
+  const vector<ExprProfileEntry*>& t = table();
+  for (size_t i=0; i < t.size(); ++i)
+    if (t[i]->description == description)
+      return t[i];
+  return 0;
+}
+
+inline void ExprProfile::reset()
+{
+  vector<ExprProfileEntry*>& t = table();
+  for (size_t i=0; i < t.size(); ++i) {
+    t[i]->calls = t[i]->elements = 0;
+    t[i]->seconds = 0;
+    std::fill(t[i]->pathCalls, t[i]->pathCalls + numTraversalPaths, 0ULL);
+  }
+}
+
+inline void ExprProfile::dump(ostream& os)
+{
+  static const char* pathNames[numTraversalPaths] = { "index", "strided",
+    "unit-stride", "common-stride", "tiled-2D", "fast", "permuted-copy" };
+
+  vector<ExprProfileEntry*> t(table());
+  std::stable_sort(t.begin(), t.end(), moreExpensive);
+
+  const streamsize precision = os.precision(4);
+  os << "[Blitz++] Expression profile" << endl
+     << setw(12) << "seconds" << setw(12) << "calls" << setw(14)
+     << "elements" << setw(10) << "ns/elem" << "  paths: expression"
+     << endl;
+  for (size_t i=0; i < t.size(); ++i) {
+    const ExprProfileEntry& e = *t[i];
+    if (e.calls == 0)
+      continue;
+    os << setw(12) << e.seconds << setw(12) << e.calls << setw(14)
+       << e.elements << setw(10)
+       << (e.elements ? 1e9 * e.seconds / e.elements : 0.) << "  ";
+    const char* sep = "";
+    for (int p=0; p < numTraversalPaths; ++p)
+      if (e.pathCalls[p]) {
+        os << sep << pathNames[p];
+        if (e.pathCalls[p] != e.calls)
+          os << "(" << e.pathCalls[p] << ")";
+        sep = ",";
+      }
+    os << ": " << e.description << endl;
+  }
+  os.precision(precision);
+}
+
+/** Times one evaluation of an expression, and collects the traversal
+    paths it takes through _bz_profileTraversal(). */
+class _bz_ExprProfileScope {
+public:
+  _bz_ExprProfileScope(ExprProfileEntry* entry, sizeType elements)
+    : entry_(entry), elements_(elements), paths_(0),
+      enclosing_(current())
+  {
+    current() = this;
+    start_ = ExprProfile::now();
+  }
+
+  ~_bz_ExprProfileScope()
+  {
+    const double t = ExprProfile::now() - start_;
+    current() = enclosing_;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    entry_->calls += 1;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    entry_->elements += elements_;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    entry_->seconds += t;
+    for (int p=0; p < numTraversalPaths; ++p)
+      if (paths_ & (1 << p)) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        entry_->pathCalls[p] += 1;
+      }
+  }
+
+  void path(TraversalPath p)
+  { paths_ |= 1 << p; }
+
+  static _bz_ExprProfileScope*& current()
+  { static BZ_THREAD_LOCAL _bz_ExprProfileScope* c = 0; return c; }
+
+private:
+  ExprProfileEntry* entry_;
+  sizeType elements_;
+  unsigned paths_;
+  double start_;
+  _bz_ExprProfileScope* enclosing_;
+};
+
+inline void _bz_profileTraversal(TraversalPath p)
+{
+  _bz_ExprProfileScope* s = _bz_ExprProfileScope::current();
+  if (s)
+    s->path(p);
+}
+
+BZ_NAMESPACE_END
+
+#define BZ_PROFILE_TRAVERSAL(path) _bz_profileTraversal(path)
+
+#else // BZ_EXPR_PROFILING
+
+#define BZ_PROFILE_TRAVERSAL(path)
+
+#endif // BZ_EXPR_PROFILING
+
+/* Marks the traversal path taken by an evaluation of the given number
+   of elements. */
+#define BZ_TRAVERSAL_TAKEN(path, n)        \
+  do {                                      \
+    BZ_PROFILE_TRAVERSAL(path);             \
+    BZ_TRAVERSAL_COUNT(calls[path], 1);     \
+    BZ_TRAVERSAL_COUNT(elements[path], n);  \
+  } while (0)
+
+#endif // BZ_EXPRPROFILE_H
@@ -5,82 +5,85 @@
 
 import time, pdb
 
-# definitions of the loops (from loops.data)
+# definitions of the loops (from loops.data): name, arrays, scalars,
+# (number type, size), flops and bytes of memory traffic per element,
+# and the loop expression. The bytes count each array read before it
+# is written, and each array written, once.
 loops=[
-    ("loop1", ("x","y"),(), ("double", 8), 1, "$x = sqrt($y)"),
-    ("loop2", ("x","y"),("u"), ("double", 8), 1, "$x = $y/u"),
-    ("loop3", ("x","y"), ("a"), ("double", 8), 2, "$y = $y + a*$x"),
-    ("loop5", ("x","a","b"), (), ("double", 8), 1, "$x = $a+$b"),
-    ("loop6", ("x","a","b"), (), ("double", 8), 1, "$x = $a*$b"),
-    ("loop8", ("a","x"), ("u"), ("double", 8), 1, "$x = u/$a"),
-    ("loop9", ("a","x"), (), ("double", 8), 1, "$x = $x+$a"),
-    ("loop10", ("x","a","b","c"), ("u"), ("double", 8), 3, "$x = u+$a+$b+$c"),
-    ("loop11", ("x","a","b","c","d"), (), ("double", 8), 3, "$x = $a+$b+$c+$d"),
-    ("loop12", ("y","x","a","b","c","d"), ("u"), ("double", 8), 4,
+    ("loop1", ("x","y"),(), ("double", 8), 1, 16, "$x = sqrt($y)"),
+    ("loop2", ("x","y"),("u"), ("double", 8), 1, 16, "$x = $y/u"),
+    ("loop3", ("x","y"), ("a"), ("double", 8), 2, 24, "$y = $y + a*$x"),
+    ("loop5", ("x","a","b"), (), ("double", 8), 1, 24, "$x = $a+$b"),
+    ("loop6", ("x","a","b"), (), ("double", 8), 1, 24, "$x = $a*$b"),
+    ("loop8", ("a","x"), ("u"), ("double", 8), 1, 16, "$x = u/$a"),
+    ("loop9", ("a","x"), (), ("double", 8), 1, 24, "$x = $x+$a"),
+    ("loop10", ("x","a","b","c"), ("u"), ("double", 8), 3, 32, "$x = u+$a+$b+$c"),
+    ("loop11", ("x","a","b","c","d"), (), ("double", 8), 3, 40, "$x = $a+$b+$c+$d"),
+    ("loop12", ("y","x","a","b","c","d"), ("u"), ("double", 8), 4, 48,
      "$y = u+$a; $x = $a+$b+$c+$d"),
-    ("loop13", ("y","x","a","b","c","d"), ("u"), ("double", 8), 4,
+    ("loop13", ("y","x","a","b","c","d"), ("u"), ("double", 8), 4, 48,
      "$x = $a+$b+$c+$d; $y = u+$d"),
-    ("loop14", ("y","x","a","b"), (), ("double", 8), 2,
+    ("loop14", ("y","x","a","b"), (), ("double", 8), 2, 32,
      "$x = $a+$b; $y = $a-$b"),
-    ("loop15", ("x","a","b","c"), (), ("double", 8), 3, "$x = $c + $a*$b"),
-    ("loop16", ("y","x","a","b","c"), ("u"), ("double", 8), 4,
+    ("loop15", ("x","a","b","c"), (), ("double", 8), 3, 32, "$x = $c + $a*$b"),
+    ("loop16", ("y","x","a","b","c"), ("u"), ("double", 8), 4, 40,
      "$x = $a+$b+$c; $y = $x+$c+u"),
-    ("loop17", ("x","a","b","c","d"), (), ("double", 8), 3,
+    ("loop17", ("x","a","b","c","d"), (), ("double", 8), 3, 40,
      "$x = ($a+$b)*($c+$d)"),
-    ("loop18", ("x","a","b"), ("u","v"), ("double", 8), 3, "$x = (u+$a)*(v+$b)"),
-    ("loop19", ("y","x","a","b"), ("u","v"), ("double", 8), 2,
+    ("loop18", ("x","a","b"), ("u","v"), ("double", 8), 3, 24, "$x = (u+$a)*(v+$b)"),
+    ("loop19", ("y","x","a","b"), ("u","v"), ("double", 8), 2, 32,
      "$x = u*$a; $y = v*$b"),
-    ("loop21", ("x","a","b","c","d"), (), ("double", 8), 3,
+    ("loop21", ("x","a","b","c","d"), (), ("double", 8), 3, 40,
      "$x = $a*$b + $c*$d"),
-    ("loop22", ("x","a","b","c","d"), (), ("double", 8), 4,
+    ("loop22", ("x","a","b","c","d"), (), ("double", 8), 4, 48,
      "$x = $x + $a*$b + $c*$d"),
-    ("loop23", ("x","a","b","c","d","y"), (), ("double", 8), 4,
+    ("loop23", ("x","a","b","c","d","y"), (), ("double", 8), 4, 48,
      "$x = $a*$b + $c*$d; $y = $b+$d"),
-    ("loop24", ("x","a","b","c","d","y"), (), ("double", 8), 6,
+    ("loop24", ("x","a","b","c","d","y"), (), ("double", 8), 6, 48,
      "$x = $a*$c - $b*$c; $y = $a*$d + $b+$c"),
-    ("loop25", ("x","a","b","c","y"), ("u","v","w"), ("double", 8), 6,
+    ("loop25", ("x","a","b","c","y"), ("u","v","w"), ("double", 8), 6, 40,
      "$x = u*$b; $y = v*$b + w*$a + u*$c"),
-    ("loop36", ("x","e"),(), ("double", 8), 1, "$x = exp($e)"),
+    ("loop36", ("x","e"),(), ("double", 8), 1, 16, "$x = exp($e)"),
     # loops added by Patrik to specifically test different assignments
     # and very large expressions
-    ("loop100",("a","b","c","d","x"),("u","v","w","z"),("double",8),18,
+    ("loop100",("a","b","c","d","x"),("u","v","w","z"),("double",8),18, 40,
      "$x=(1.0-$c*$c)/((4*w)*sin(1.0+$c*$c-2*v*$c))*$a*$b*u*exp(-z*$d)"),
     #(pow substituted for sin since it's ** in f77)
 # and loops with floats to test vectorization impact
-    ("floop1", ("x","y"),(), ("float", 4), 1, "$x = sqrt($y)"),
-    ("floop2", ("x","y"),("u"), ("float", 4), 1, "$x = $y/u"),
-    ("floop3", ("x","y"), ("a"), ("float", 4), 2, "$y = $y + a*$x"),
-    ("floop5", ("x","a","b"), (), ("float", 4), 1, "$x = $a+$b"),
-    ("floop6", ("x","a","b"), (), ("float", 4), 1, "$x = $a*$b"),
-    ("floop8", ("a","x"), ("u"), ("float", 4), 1, "$x = u/$a"),
-    ("floop9", ("a","x"), (), ("float", 4), 1, "$x = $x+$a"),
-    ("floop10", ("x","a","b","c"), ("u"), ("float", 4), 3, "$x = u+$a+$b+$c"),
-    ("floop11", ("x","a","b","c","d"), (), ("float", 4), 3, "$x = $a+$b+$c+$d"),
-    ("floop12", ("y","x","a","b","c","d"), ("u"), ("float", 4), 4,
+    ("floop1", ("x","y"),(), ("float", 4), 1, 8, "$x = sqrt($y)"),
+    ("floop2", ("x","y"),("u"), ("float", 4), 1, 8, "$x = $y/u"),
+    ("floop3", ("x","y"), ("a"), ("float", 4), 2, 12, "$y = $y + a*$x"),
+    ("floop5", ("x","a","b"), (), ("float", 4), 1, 12, "$x = $a+$b"),
+    ("floop6", ("x","a","b"), (), ("float", 4), 1, 12, "$x = $a*$b"),
+    ("floop8", ("a","x"), ("u"), ("float", 4), 1, 8, "$x = u/$a"),
+    ("floop9", ("a","x"), (), ("float", 4), 1, 12, "$x = $x+$a"),
+    ("floop10", ("x","a","b","c"), ("u"), ("float", 4), 3, 16, "$x = u+$a+$b+$c"),
+    ("floop11", ("x","a","b","c","d"), (), ("float", 4), 3, 20, "$x = $a+$b+$c+$d"),
+    ("floop12", ("y","x","a","b","c","d"), ("u"), ("float", 4), 4, 24,
      "$y = u+$a; $x = $a+$b+$c+$d"),
-    ("floop13", ("y","x","a","b","c","d"), ("u"), ("float", 4), 4,
+    ("floop13", ("y","x","a","b","c","d"), ("u"), ("float", 4), 4, 24,
      "$x = $a+$b+$c+$d; $y = u+$d"),
-    ("floop14", ("y","x","a","b"), (), ("float", 4), 2,
+    ("floop14", ("y","x","a","b"), (), ("float", 4), 2, 16,
      "$x = $a+$b; $y = $a-$b"),
-    ("floop15", ("x","a","b","c"), (), ("float", 4), 3, "$x = $c + $a*$b"),
-    ("floop16", ("y","x","a","b","c"), ("u"), ("float", 4), 4,
+    ("floop15", ("x","a","b","c"), (), ("float", 4), 3, 16, "$x = $c + $a*$b"),
+    ("floop16", ("y","x","a","b","c"), ("u"), ("float", 4), 4, 20,
      "$x = $a+$b+$c; $y = $x+$c+u"),
-    ("floop17", ("x","a","b","c","d"), (), ("float", 4), 3,
+    ("floop17", ("x","a","b","c","d"), (), ("float", 4), 3, 20,
      "$x = ($a+$b)*($c+$d)"),
-    ("floop18", ("x","a","b"), ("u","v"), ("float", 4), 3, "$x = (u+$a)*(v+$b)"),
-    ("floop19", ("y","x","a","b"), ("u","v"), ("float", 4), 2,
+    ("floop18", ("x","a","b"), ("u","v"), ("float", 4), 3, 12, "$x = (u+$a)*(v+$b)"),
+    ("floop19", ("y","x","a","b"), ("u","v"), ("float", 4), 2, 16,
      "$x = u*$a; $y = v*$b"),
-    ("floop21", ("x","a","b","c","d"), (), ("float", 4), 3,
+    ("floop21", ("x","a","b","c","d"), (), ("float", 4), 3, 20,
      "$x = $a*$b + $c*$d"),
-    ("floop22", ("x","a","b","c","d"), (), ("float", 4), 4,
+    ("floop22", ("x","a","b","c","d"), (), ("float", 4), 4, 24,
      "$x = $x + $a*$b + $c*$d"),
-    ("floop23", ("x","a","b","c","d","y"), (), ("float", 4), 4,
+    ("floop23", ("x","a","b","c","d","y"), (), ("float", 4), 4, 24,
      "$x = $a*$b + $c*$d; $y = $b+$d"),
-    ("floop24", ("x","a","b","c","d","y"), (), ("float", 4), 6,
+    ("floop24", ("x","a","b","c","d","y"), (), ("float", 4), 6, 24,
      "$x = $a*$c - $b*$c; $y = $a*$d + $b+$c"),
-    ("floop25", ("x","a","b","c","y"), ("u","v","w"), ("float", 4), 6,
+    ("floop25", ("x","a","b","c","y"), ("u","v","w"), ("float", 4), 6, 20,
      "$x = u*$b; $y = v*$b + w*$a + u*$c"),
-    ("floop36", ("x","e"),(), ("float", 4), 1, "$x = exp($e)")
+    ("floop36", ("x","e"),(), ("float", 4), 1, 8, "$x = exp($e)")
 ]
 
 # handy access functions for readability
@@ -94,8 +97,10 @@ def loopnumtype(loop):
     return loop[3]
 def loopflops(loop):
     return loop[4]
-def loopexpr(loop):
+def loopbytes(loop):
     return loop[5]
+def loopexpr(loop):
+    return loop[6]
 
 def cc(l):
     return reduce(lambda a,b: a+b, l, "")
@@ -176,6 +181,7 @@ def gencpp(loop):
         ("loopname",loopname(loop)),
         ("LOOPNAME",loopname(loop).upper()),
         ("loopflops",`loopflops(loop)`),
+        ("loopbytes",`loopbytes(loop)`),
         ("gentime",time.asctime(time.gmtime())),
         ("fortrandecls", fortrandecls(loop)),
         ("scalarargdecl", cc([", %s %s"%(loopnumtype(loop)[0], n)
@@ -332,16 +338,19 @@ int main()
     Array<int,1> parameters(numSizes);
     Array<long,1> iters(numSizes);
     Array<double,1> flops(numSizes);
+    Array<double,1> bytes(numSizes);
 
     parameters=pow(pow(2.,0.25),tensor::i)+tensor::i;
     flops = #loopflops# * parameters;
-    iters = 100000000L / flops;
+    bytes = #loopbytes# * parameters;
+    iters = 25000000L / flops;
     iters = where(iters<2, 2, iters);
     cout << iters << endl;
     
     bench.setParameterVector(parameters);
     bench.setIterations(iters);
     bench.setOpsPerIteration(flops);
+    bench.setBytesPerIteration(bytes);
     bench.setDependentVariable("flops");
     bench.beginBenchmarking();
 
@@ -400,13 +409,16 @@ void VectorVersion(BenchmarkExt<int>& bench#scalarargdecl#)
 
 #vectordeclandfill#
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            #looparrayexpr#;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                #looparrayexpr#;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -433,13 +445,16 @@ void VectorVersion(BenchmarkExt<int>& bench#scalarargdecl#)
 
 #arraydeclandfill#
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            #looparrayexpr#;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                #looparrayexpr#;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -466,13 +481,16 @@ void VectorVersion(BenchmarkExt<int>& bench#scalarargdecl#)
 
 #arraydeclandfill#
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            #looparrayindexexpr#;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                #looparrayindexexpr#;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -498,13 +516,16 @@ void VectorVersion(BenchmarkExt<int>& bench#scalarargdecl#)
 
 #unalignedarraydeclandfill#
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            #looparrayexpr#;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                #looparrayexpr#;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -530,13 +551,16 @@ void VectorVersion(BenchmarkExt<int>& bench#scalarargdecl#)
 
 #misalignedarraydeclandfill#
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            #looparrayexpr#;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                #looparrayexpr#;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -563,13 +587,16 @@ void ValarrayVersion(BenchmarkExt<int>& bench#scalarargdecl#)
 
 #valarraydeclandfill#
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            #looparrayexpr#;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                #looparrayexpr#;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -595,10 +622,13 @@ void F77Version(BenchmarkExt<int>& bench#scalarargdecl#)
 
 #carraydeclandfill#        
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            #loopname#_f77(N#arrayargs##scalarargs#);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                #loopname#_f77(N#arrayargs##scalarargs#);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -626,10 +656,13 @@ void F90Version(BenchmarkExt<int>& bench#scalarargdecl#)
 
 #carraydeclandfill#
 
-        bench.start();
-        for (int iter=0; iter < iters; ++iter)
-            #loopname#_f90(N#arrayargs##scalarargs#);
-        bench.stop();
+        while (bench.repeat())
+        {
+            bench.start();
+            for (int iter=0; iter < iters; ++iter)
+                #loopname#_f90(N#arrayargs##scalarargs#);
+            bench.stop();
+        }
 
         bench.startOverhead();
         for (int iter=0; iter < iters; ++iter)
@@ -701,13 +734,16 @@ void TinyVectorVersion(BenchmarkExt<int>& bench#scalarargdecl#)
 
 #tvdeclandfill#
 
-        bench.start();
-        for (long i=0; i < iters; ++i)
+        while (bench.repeat())
         {
-            #looparrayexpr#;
-            sink();
+            bench.start();
+            for (long i=0; i < iters; ++i)
+            {
+                #looparrayexpr#;
+                sink();
+            }
+            bench.stop();
         }
-        bench.stop();
 
         bench.startOverhead();
         for (long i=0; i < iters; ++i) {
@@ -116,6 +116,199 @@ template<> struct _bz_evaluator<1> {
   static void evaluateWithIndexTraversal(T_dest&, T_expr, T_update);
 };
 
+#ifdef BZ_EXPR_PROFILING
+/** Creates the profile entry of an assignment, described like the Tau
+    profiles. */
+template<typename T_expr, typename T_update>
+ExprProfileEntry* _bz_exprProfileEntry(const T_expr& expr, T_update)
+{
+  BZ_STD_SCOPE(string) description = "A";
+  prettyPrintFormat format(true);   // Terse mode on
+  format.nextArrayOperandSymbol();
+  T_update::prettyPrint(description);
+  expr.prettyPrint(description, format);
+  return ExprProfile::add(description);
+}
+#endif
+
+/* Copies the array whose element at the lbound of dest is *source, and
+   whose strides along the ranks of dest are sourceStride, to dest, when
+   their ranks of smallest stride differ, and returns true; else returns
+   false. The plane of those two ranks is cut in square tiles which fit
+   in the L1 cache, so that neither array is walked with a large stride
+   through more memory than the cache holds. */
+template<typename T_numtype, int N_rank, typename T_source, typename T_update>
+bool _bz_permutedCopy(Array<T_numtype,N_rank>& dest, const T_source* source,
+                      const TinyVector<diffType,N_rank>& sourceStride,
+                      T_update)
+{
+  const TinyVector<int,N_rank> extent = dest.extent();
+  const TinyVector<diffType,N_rank> destStride = dest.stride();
+
+  // the ranks of smallest stride, ignoring those of length 1
+  int a = -1, b = -1;
+  diffType minDest = 0, minSource = 0;
+  for (int r=0; r < N_rank; ++r)
+    if (extent(r) > 1)
+    {
+      const diffType d = destStride(r) < 0 ? -destStride(r) : destStride(r);
+      const diffType s = sourceStride(r) < 0 ? -sourceStride(r)
+        : sourceStride(r);
+      if ((a < 0) || (d < minDest))
+      {
+        a = r;
+        minDest = d;
+      }
+      if ((b < 0) || (s < minSource))
+      {
+        b = r;
+        minSource = s;
+      }
+    }
+  if (a == b)
+    return false;
+
+  // the two arrays must not overlap, the order of the updates changing
+  T_numtype* const destData = &dest(dest.lbound());
+  const T_numtype* destFirst = destData;
+  const T_numtype* destLast = destFirst;
+  const T_source* sourceFirst = source;
+  const T_source* sourceLast = source;
+  for (int r=0; r < N_rank; ++r)
+  {
+    const diffType d = (extent(r) - 1) * destStride(r);
+    const diffType s = (extent(r) - 1) * sourceStride(r);
+    (d < 0 ? destFirst : destLast) += d;
+    (s < 0 ? sourceFirst : sourceLast) += s;
+  }
+  if (((const void*)sourceFirst <= (const void*)destLast)
+      && ((const void*)destFirst <= (const void*)sourceLast))
+    return false;
+
+  const int tile = BZ_PERMUTE_TILE;
+  const int La = extent(a), Lb = extent(b);
+  const diffType Da = destStride(a), Db = destStride(b);
+  const diffType Sa = sourceStride(a), Sb = sourceStride(b);
+
+  // the other ranks, traversed outside the tiles
+  TinyVector<int,N_rank> outer;
+  int numOuter = 0;
+  diffType outerCount = 1;
+  for (int r=0; r < N_rank; ++r)
+    if ((r != a) && (r != b))
+    {
+      outer(numOuter++) = r;
+      outerCount *= extent(r);
+    }
+
+  const diffType tilesB = (Lb + tile - 1) / tile;
+  const diffType work = outerCount * tilesB;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) \
+  if (dest.numElements() >= BZ_PERMUTE_THREADING_THRESHOLD)
+#endif
+  for (diffType k=0; k < work; ++k)
+  {
+    diffType o = k / tilesB;
+    const int b0 = int(k % tilesB) * tile;
+    const int b1 = (b0 + tile < Lb) ? b0 + tile : Lb;
+    diffType destOffset = 0, sourceOffset = 0;
+    for (int q=numOuter - 1; q >= 0; --q)
+    {
+      const int r = outer(q);
+      const int i = int(o % extent(r));
+      o /= extent(r);
+      destOffset += i * destStride(r);
+      sourceOffset += i * sourceStride(r);
+    }
+    T_numtype* restrict d = destData + destOffset;
+    const T_source* restrict s = source + sourceOffset;
+
+    for (int a0=0; a0 < La; a0 += tile)
+    {
+      const int a1 = (a0 + tile < La) ? a0 + tile : La;
+      for (int j=b0; j < b1; ++j)
+        for (int i=a0; i < a1; ++i)
+          T_update::update(d[i * Da + j * Db], s[i * Sa + j * Sb]);
+    }
+  }
+  return true;
+}
+
+/** _bz_tryPermutedCopy<T_expr>::tryCopy(dest, expr) assigns expr to
+    dest with _bz_permutedCopy and returns true if expr is an array, or
+    an index mapping permuting the ranks of an array (such as
+    A(tensor::j,tensor::i)), stored in another order than dest. */
+template<typename T_expr>
+struct _bz_tryPermutedCopy {
+  template<typename T_dest, typename T_update>
+  static bool tryCopy(T_dest&, const T_expr&, T_update)
+  { return false; }
+};
+
+template<typename T_source, int N_rank>
+struct _bz_tryPermutedCopy<_bz_ArrayExpr<FastArrayIterator<T_source,N_rank> > > {
+  typedef _bz_ArrayExpr<FastArrayIterator<T_source,N_rank> > T_expr;
+
+  template<typename T_dest, typename T_update>
+  static bool tryCopy(T_dest&, const T_expr&, T_update)
+  { return false; }
+
+  template<typename T_numtype, typename T_update>
+  static bool tryCopy(Array<T_numtype,N_rank>& dest, const T_expr& expr,
+                      T_update)
+  {
+    if (N_rank < 2)
+      return false;
+    const Array<T_source,N_rank>& A = expr.iter().array();
+    return _bz_permutedCopy(dest, &A(A.lbound()), A.stride(), T_update());
+  }
+};
+
+template<typename T_source, int N_rank, int N_map0, int N_map1,
+         int N_map2, int N_map3, int N_map4, int N_map5, int N_map6,
+         int N_map7, int N_map8, int N_map9, int N_map10>
+struct _bz_tryPermutedCopy<_bz_ArrayExpr<ArrayIndexMapping<
+    _bz_ArrayExpr<FastArrayIterator<T_source,N_rank> >, N_map0, N_map1,
+    N_map2, N_map3, N_map4, N_map5, N_map6, N_map7, N_map8, N_map9,
+    N_map10> > > {
+  typedef _bz_ArrayExpr<ArrayIndexMapping<
+    _bz_ArrayExpr<FastArrayIterator<T_source,N_rank> >, N_map0, N_map1,
+    N_map2, N_map3, N_map4, N_map5, N_map6, N_map7, N_map8, N_map9,
+    N_map10> > T_expr;
+
+  template<typename T_dest, typename T_update>
+  static bool tryCopy(T_dest&, const T_expr&, T_update)
+  { return false; }
+
+  template<typename T_numtype, typename T_update>
+  static bool tryCopy(Array<T_numtype,N_rank>& dest, const T_expr& expr,
+                      T_update)
+  {
+    if (N_rank < 2)
+      return false;
+    const int map[11] = { N_map0, N_map1, N_map2, N_map3, N_map4, N_map5,
+                          N_map6, N_map7, N_map8, N_map9, N_map10 };
+    const Array<T_source,N_rank>& A = expr.iter().iter().iter().array();
+
+    // rank r of A is indexed by rank map[r] of dest
+    TinyVector<int,N_rank> index;
+    TinyVector<diffType,N_rank> stride;
+    TinyVector<bool,N_rank> mapped(false);
+    for (int r=0; r < N_rank; ++r)
+    {
+      const int d = map[r];
+      if (mapped(d))
+        return false;
+      mapped(d) = true;
+      index(r) = dest.lbound(d);
+      stride(d) = A.stride(r);
+    }
+    return _bz_permutedCopy(dest, &A(index), stride, T_update());
+  }
+};
+
 /**
   Assign an expression to a container.  For performance reasons, this
   function forwards to functions implementing one of several traversal
@@ -134,6 +327,8 @@ template<> struct _bz_evaluator<1> {
   - 2D tiled traversal follows a tiled traversal, to improve cache reuse
     for 2D stencils.  Space filling curves have too much overhead to use
     in two-dimensions. 
+  - Permuted copy assigns a transposed or index-permuted array tile by
+    tile (see _bz_permutedCopy).
  */
 template<typename T_dest, typename T_expr, typename T_update>
 _bz_forceinline void
@@ -219,12 +414,26 @@ _bz_evaluate(T_dest& dest, T_expr expr, T_update)
     TAU_PROFILE(" ", exprDescription, TAU_BLITZ);
 #endif
 
+#ifdef BZ_EXPR_PROFILING
+    static ExprProfileEntry* const profileEntry =
+      _bz_exprProfileEntry(expr, T_update());
+    _bz_ExprProfileScope profileScope(profileEntry, n);
+#endif
+
+    // A permutation of a single array is copied tile by tile
+    if (_bz_tryPermutedCopy<T_expr>::tryCopy(dest, expr, T_update()))
+    {
+      BZ_TRAVERSAL_TAKEN(permutedCopy, n);
+      return;
+    }
+
     // Determine which evaluation mechanism to use 
     if (T_expr::numIndexPlaceholders > 0)
     {
         // The expression involves index placeholders, so have to
         // use index traversal rather than stack traversal.
 
+      BZ_TRAVERSAL_TAKEN(indexTraversal, n);
       _bz_evaluator<T_dest::rank_>::evaluateWithIndexTraversal(dest, expr, T_update());
       return;
     }
@@ -241,8 +450,10 @@ _bz_evaluate(T_dest& dest, T_expr expr, T_update)
         enum { isStencil = (N_rank >= 3) && (T_expr::numArrayOperands > 6)
             && (T_expr::numIndexPlaceholders == 0) };
 
-        if (_bz_tryFastTraversal<isStencil>::tryFast(dest, expr, T_update()))
+        if (_bz_tryFastTraversal<isStencil>::tryFast(dest, expr, T_update())) {
+            BZ_TRAVERSAL_TAKEN(fastTraversal, n);
             return;
+        }
 
 #endif
 #endif
@@ -266,6 +477,7 @@ _bz_evaluate(T_dest& dest, T_expr expr, T_update)
             
             int cacheNeeded = 3 * 3 * sizeof(T_numtype) * dest.length(dest.ordering(0));
             if (cacheNeeded > BZ_L1_CACHE_ESTIMATED_SIZE) {
+	      BZ_TRAVERSAL_TAKEN(tiled2DTraversal, n);
 	      _bz_evaluateWithTiled2DTraversal(dest, expr, T_update());
 		return;
 	    }
@@ -353,6 +565,7 @@ public:
 				       diffType ubound, diffType pos, 
 				       T_update) {
       if(ubound&1) {
+	BZ_TRAVERSAL_COUNT(binaryAssignScalarElements, 1);
 	T_update::update(data[pos], expr.fastRead(pos));
 	++pos;
       }
@@ -400,6 +613,8 @@ _bz_evaluateWithUnitStride(T_dest& dest, typename T_dest::T_iterator& iter,
     BZ_DEBUG_MESSAGE("\tshort expression, using binary meta-unroll assignment.");
 #endif
 
+    BZ_TRAVERSAL_COUNT(unitStrideLoops[binaryUnrolledLoop], 1);
+    BZ_TRAVERSAL_COUNT(unitStrideElements[binaryUnrolledLoop], ubound);
     _bz_meta_binaryAssign<BZ_MAX_BITS_FOR_BINARY_UNROLL-1>::
       assign(data, expr, ubound, 0, T_update());
     return;
@@ -448,6 +663,19 @@ _bz_evaluateWithUnitStride(T_dest& dest, typename T_dest::T_iterator& iter,
 #endif
 
 
+#ifdef BZ_TRAVERSAL_COUNTERS
+  {
+    const UnitStrideLoop loop = (unvectorizable || loop_width <= 1) ?
+      scalarLoop : can_align ? alignedChunkedLoop : unalignedChunkedLoop;
+    BZ_TRAVERSAL_COUNT(unitStrideLoops[loop], 1);
+    BZ_TRAVERSAL_COUNT(unitStrideElements[loop], ubound);
+    if (loop == alignedChunkedLoop && uneven_start > 0) {
+      BZ_TRAVERSAL_COUNT(peeledLoops, 1);
+      BZ_TRAVERSAL_COUNT(peeledElements, uneven_start);
+    }
+  }
+#endif
+
   if(!unvectorizable && (loop_width>1)) {
     // If the expression can be aligned, we do so.
     if(can_align) {
@@ -488,6 +716,7 @@ _bz_evaluateWithUnitStride(T_dest& dest, typename T_dest::T_iterator& iter,
 	chunked_updater<T_numtype, T_expr, T_update, loop_width>::
 	  unaligned_update(data, expr, i);
     }
+    BZ_TRAVERSAL_COUNT(remainderElements, ubound-i);
   }
 
   // now complete the loop with the tailing scalar elements not done
@@ -576,6 +805,7 @@ evaluateWithStackTraversal(T_dest& dest, T_expr expr, T_update)
 #ifdef BZ_DEBUG_TRAVERSE
   BZ_DEBUG_MESSAGE("\tshortcutting evaluation of single-element expression");
 #endif
+    BZ_TRAVERSAL_TAKEN(stridedTraversal, 1);
     T_update::update(*const_cast<typename T_dest::T_numtype*>(iter.data()), *expr);
     return;
   }
@@ -588,6 +818,7 @@ evaluateWithStackTraversal(T_dest& dest, T_expr expr, T_update)
 
   if(useUnitStride) {
     const diffType ubound = dest.length(firstRank);
+    BZ_TRAVERSAL_TAKEN(unitStrideTraversal, ubound);
     _bz_evaluateWithUnitStride(dest, iter, expr, ubound, T_update());
     return;
   }
@@ -604,6 +835,7 @@ evaluateWithStackTraversal(T_dest& dest, T_expr expr, T_update)
 #endif
 
   if (useCommonStride) {
+    BZ_TRAVERSAL_TAKEN(commonStrideTraversal, dest.length(firstRank));
     const diffType ubound = dest.length(firstRank) * commonStride;
     _bz_evaluateWithCommonStride(dest, iter, expr, ubound, commonStride, T_update());
     return;
@@ -614,6 +846,7 @@ evaluateWithStackTraversal(T_dest& dest, T_expr expr, T_update)
 #endif
 
   // not common stride
+  BZ_TRAVERSAL_TAKEN(stridedTraversal, dest.length(firstRank));
   typedef typename T_dest::T_numtype T_numtype;
   const T_numtype * last = iter.data() + dest.length(firstRank) 
     * dest.stride(firstRank);
@@ -781,6 +1014,11 @@ evaluateWithStackTraversal(T_dest& dest, T_expr expr, T_update)
 
 #endif // BZ_COLLAPSE_LOOPS
 
+    BZ_TRAVERSAL_TAKEN(useUnitStride ? unitStrideTraversal :
+                       useCommonStride ? commonStrideTraversal :
+                       stridedTraversal, dest.numElements());
+    BZ_TRAVERSAL_COUNT(collapsedLoops[firstNoncollapsedLoop-1], 1);
+
     /*
      * Now we actually perform the loops.  This while loop contains
      * two parts: first, the innermost loop is performed.  Then we
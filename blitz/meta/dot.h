@@ -42,127 +42,44 @@
 
 BZ_NAMESPACE(blitz)
 
+/*
+ * The sums below run from the last element to the first, in the order
+ * in which the recursive metaprograms they replace added up the
+ * elements, so that the results are the same. Their loops have
+ * constant bounds, which the compilers unroll, without instantiating
+ * one class per element.
+ */
+
+/** a[I] * b[I] + ... + a[N-1] * b[N-1] */
 template<int N, int I>
 class _bz_meta_vectorDot {
 public:
-    static const int loopFlag = (I < N-1) ? 1 : 0;
-
     template<typename T_expr1, typename T_expr2>
-    static inline BZ_PROMOTE(_bz_typename T_expr1::T_numtype,
+    static BZ_CONSTEXPR inline BZ_PROMOTE(_bz_typename T_expr1::T_numtype,
         _bz_typename T_expr2::T_numtype)
     f(const T_expr1& a, const T_expr2& b)
     {
-        return a[I] * b[I]
-            + _bz_meta_vectorDot<loopFlag * N, loopFlag * (I+1)>::f(a,b);
-    }
-
-    template<typename T_expr1, typename T_expr2>
-    static inline BZ_PROMOTE(_bz_typename T_expr1::T_numtype,
-        _bz_typename T_expr2::T_numtype)
-    f_value_ref(T_expr1 a, const T_expr2& b)
-    {
-        return a[I] * b[I]
-            + _bz_meta_vectorDot<loopFlag * N, loopFlag * (I+1)>::f(a,b);
-    }
-
-    template<typename T_expr1, typename T_expr2>
-    static inline BZ_PROMOTE(_bz_typename T_expr1::T_numtype,
-        _bz_typename T_expr2::T_numtype)
-    f_ref_value(const T_expr1& a, T_expr2 b)
-    {
-        return a[I] * b[I]
-            + _bz_meta_vectorDot<loopFlag * N, loopFlag * (I+1)>::f(a,b);
+        BZ_PROMOTE(_bz_typename T_expr1::T_numtype,
+            _bz_typename T_expr2::T_numtype) x = a[N-1] * b[N-1];
+        for (int i=N-2; i >= I; --i)
+            x = a[i] * b[i] + x;
+        return x;
     }
-
-    template<typename T_expr1, typename P_numtype2>
-    static inline BZ_PROMOTE(_bz_typename T_expr1::T_numtype,
-        P_numtype2)
-    dotWithArgs(const T_expr1& a, P_numtype2 i1, P_numtype2 i2=0,
-        P_numtype2 i3=0, P_numtype2 i4=0, P_numtype2 i5=0, P_numtype2 i6=0,
-        P_numtype2 i7=0, P_numtype2 i8=0, P_numtype2 i9=0, P_numtype2 i10=0)
-    {
-        return a[I] * i1  
-            + _bz_meta_vectorDot<loopFlag * N, loopFlag * (I+1)>::dotWithArgs
-                 (a, i2, i3, i4, i5, i6, i7, i8, i9);
-    }
-};
-
-template<>
-class _bz_meta_vectorDot<0,0> {
-public:
-    template<typename T_expr1, typename T_expr2>
-    static inline _bz_meta_nullOperand f(const T_expr1&, const T_expr2&)
-    { return _bz_meta_nullOperand(); }
-
-    template<typename T_expr1, typename P_numtype2>
-    static inline _bz_meta_nullOperand 
-    dotWithArgs(const T_expr1& a, P_numtype2 i1, P_numtype2 i2=0,
-        P_numtype2 i3=0, P_numtype2 i4=0, P_numtype2 i5=0, P_numtype2 i6=0,
-        P_numtype2 i7=0, P_numtype2 i8=0, P_numtype2 i9=0, P_numtype2 i10=0)
-    {
-        return _bz_meta_nullOperand(); 
-    }
-
 };
 
-
+/** The same, computed in the type T_ret */
 template<int N, int I, typename T_ret>
 class _bz_meta_vectorDotRet {
 public:
-    static const int loopFlag = (I < N-1) ? 1 : 0;
-
     template<typename T_expr1, typename T_expr2>
-    static inline T_ret
+    static BZ_CONSTEXPR inline T_ret
     f(const T_expr1& a, const T_expr2& b)
     {
-      return static_cast<T_ret>(a[I]) * static_cast<T_ret>(b[I])
-	+ _bz_meta_vectorDotRet<loopFlag * N, loopFlag * (I+1), T_ret>::f(a,b);
-    }
-
-    template<typename T_expr1, typename T_expr2>
-    static inline T_ret
-    f_value_ref(T_expr1 a, const T_expr2& b)
-    {
-      return static_cast<T_ret>(a[I]) * static_cast<T_ret>(b[I])
-	+ _bz_meta_vectorDotRet<loopFlag * N, loopFlag * (I+1), T_ret>::f(a,b);
+        T_ret x = static_cast<T_ret>(a[N-1]) * static_cast<T_ret>(b[N-1]);
+        for (int i=N-2; i >= I; --i)
+            x = static_cast<T_ret>(a[i]) * static_cast<T_ret>(b[i]) + x;
+        return x;
     }
-
-    template<typename T_expr1, typename T_expr2>
-    static inline T_ret
-    f_ref_value(const T_expr1& a, T_expr2 b)
-    {
-      return static_cast<T_ret>(a[I]) * static_cast<T_ret>(b[I])
-	+ _bz_meta_vectorDotRet<loopFlag * N, loopFlag * (I+1), T_ret>::f(a,b);
-    }
-
-    template<typename T_expr1, typename P_numtype2>
-    static inline T_ret
-    dotWithArgs(const T_expr1& a, P_numtype2 i1, P_numtype2 i2=0,
-        P_numtype2 i3=0, P_numtype2 i4=0, P_numtype2 i5=0, P_numtype2 i6=0,
-        P_numtype2 i7=0, P_numtype2 i8=0, P_numtype2 i9=0, P_numtype2 i10=0)
-    {
-      return static_cast<T_ret>(a[I]) * static_cast<T_ret>(i1)  
-	+ _bz_meta_vectorDotRet<loopFlag * N, loopFlag * (I+1), T_ret>::dotWithArgs
-                 (a, i2, i3, i4, i5, i6, i7, i8, i9);
-    }
-};
-
-template<typename T_ret>
-class _bz_meta_vectorDotRet<0,0, T_ret> {
-public:
-    template<typename T_expr1, typename T_expr2>
-    static inline _bz_meta_nullOperand f(const T_expr1&, const T_expr2&)
-    { return _bz_meta_nullOperand(); }
-
-    template<typename T_expr1, typename P_numtype2>
-    static inline _bz_meta_nullOperand 
-    dotWithArgs(const T_expr1& a, P_numtype2 i1, P_numtype2 i2=0,
-        P_numtype2 i3=0, P_numtype2 i4=0, P_numtype2 i5=0, P_numtype2 i6=0,
-        P_numtype2 i7=0, P_numtype2 i8=0, P_numtype2 i9=0, P_numtype2 i10=0)
-    {
-        return _bz_meta_nullOperand(); 
-    }
-
 };
 
 BZ_NAMESPACE_END
@@ -38,52 +38,36 @@
 
 BZ_NAMESPACE(blitz)
 
+/** a[I] + ... + a[N-1], from the last element, like the dot product of
+    <blitz/meta/dot.h> */
 template<int N, int I>
 class _bz_meta_vectorSum {
 public:
-    static const int loopFlag = (I < N-1) ? 1 : 0;
-
     template<typename T_expr1>
-    static inline BZ_SUMTYPE(_bz_typename T_expr1::T_numtype)
+    static BZ_CONSTEXPR inline BZ_SUMTYPE(_bz_typename T_expr1::T_numtype)
     f(const T_expr1& a)
     {
-        return a[I] +
-            _bz_meta_vectorSum<loopFlag * N, loopFlag * (I+1)>::f(a);
+        BZ_SUMTYPE(_bz_typename T_expr1::T_numtype) x = a[N-1];
+        for (int i=N-2; i >= I; --i)
+            x = a[i] + x;
+        return x;
     }
 };
 
-template<>
-class _bz_meta_vectorSum<0,0> {
-public:
-    template<typename T_expr1>
-    static inline _bz_meta_nullOperand f(const T_expr1&)
-    { return _bz_meta_nullOperand(); }
-
-};
-
 template<int N, int I, typename T_ret>
 class _bz_meta_vectorSumRet {
 public:
-    static const int loopFlag = (I < N-1) ? 1 : 0;
-
     template<typename T_expr1>
-    static inline T_ret
+    static BZ_CONSTEXPR inline T_ret
     f(const T_expr1& a)
     {
-      return static_cast<T_ret>(a[I]) +
-	_bz_meta_vectorSumRet<loopFlag * N, loopFlag * (I+1), T_ret>::f(a);
+        T_ret x = static_cast<T_ret>(a[N-1]);
+        for (int i=N-2; i >= I; --i)
+            x = static_cast<T_ret>(a[i]) + x;
+        return x;
     }
 };
 
-template<typename T_ret>
-class _bz_meta_vectorSumRet<0,0, T_ret> {
-public:
-    template<typename T_expr1>
-    static inline _bz_meta_nullOperand f(const T_expr1&)
-    { return _bz_meta_nullOperand(); }
-
-};
-
 BZ_NAMESPACE_END
 
 #endif // BZ_META_SUM_H
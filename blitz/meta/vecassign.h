@@ -36,25 +36,24 @@
 
 BZ_NAMESPACE(blitz)
 
+/** Updates the elements I to N-1 of a vector with those of an
+    expression. The loops have constant bounds, which the compilers
+    unroll, without instantiating one class per element. */
 template<int N, int I> 
 class _bz_meta_vecAssign {
 public:
-    static const int loopFlag = (I < N-1) ? 1 : 0;
-
     template<typename T_data, typename T_expr, typename T_updater>
     static inline void fastAssign(T_data* data, T_expr expr, T_updater u)
     {
-      u.update(data[I], expr.fastRead(I));
-        _bz_meta_vecAssign<N * loopFlag, (I+1) * loopFlag>
-	  ::fastAssign(data,expr,u);
+        for (int i=I; i < N; ++i)
+            u.update(data[i], expr.fastRead(i));
     }
 
     template<typename T_vector, typename T_expr, typename T_updater>
     static inline void assign(T_vector& vec, T_expr expr, T_updater u)
     {
-        u.update(vec[I], expr[I]);
-        _bz_meta_vecAssign<N * loopFlag, (I+1) * loopFlag>
-           ::assign(vec,expr,u);
+        for (int i=I; i < N; ++i)
+            u.update(vec[i], expr[i]);
     }
 
     template<typename T_vector, typename T_numtype, typename T_updater>
@@ -63,35 +62,12 @@ public:
         T_numtype x4=0, T_numtype x5=0, T_numtype x6=0, T_numtype x7=0,
         T_numtype x8=0, T_numtype x9=0)
     {
-        u.update(vec[I], x0);
-        _bz_meta_vecAssign<N * loopFlag, (I+1) * loopFlag>
-            ::assignWithArgs(vec, u, x1, x2, x3, x4, x5, x6, x7, x8, x9);
+        const T_numtype x[10] = { x0, x1, x2, x3, x4, x5, x6, x7, x8, x9 };
+        for (int i=I; i < N; ++i)
+            u.update(vec[i], i-I < 10 ? x[i-I] : T_numtype(0));
     }
-        
 };
 
-template<>
-class _bz_meta_vecAssign<0,0> {
-public:
-    template<typename T_vector, typename T_expr, typename T_updater>
-    static inline void fastAssign(T_vector&, T_expr, T_updater)
-    { }
-
-    template<typename T_vector, typename T_expr, typename T_updater>
-    static inline void assign(T_vector&, T_expr, T_updater)
-    { }
-
-    template<typename T_vector, typename T_numtype, typename T_updater>
-    static inline void assignWithArgs(T_vector&, T_updater,
-        T_numtype, T_numtype =0, T_numtype =0, T_numtype =0,
-        T_numtype =0, T_numtype =0, T_numtype =0, T_numtype =0,
-        T_numtype =0, T_numtype =0)
-    {
-    }
-};
-
-
-
 BZ_NAMESPACE_END
 
 #endif // BZ_META_ASSIGN_H
@@ -46,29 +46,267 @@
  #include <time.h>
 #endif
 
+#ifdef BZ_HAVE_CLOCK_GETTIME
+ #include <time.h>
+#else
+ #include <sys/time.h>
+#endif
+
+#ifdef BZ_HAVE_LINUX_PERF_EVENT_H
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #include <string.h>
+#endif
+
+#ifdef _OPENMP
+ #include <omp.h>
+#endif
+
+#include <vector>
+
 BZ_NAMESPACE(blitz)
 
 #ifndef BZ_HAVE_LIBPAPI
 
+/** Identifies the calling thread. The perf counters count the thread
+    which opened them and can only be read by it, so they are kept by
+    the kernel thread id, which stays the same across parallel regions
+    even when the OpenMP thread numbers don't. */
+inline long _bz_threadId()
+{
+#if defined(BZ_HAVE_LINUX_PERF_EVENT_H)
+    return syscall(SYS_gettid);
+#elif defined(_OPENMP)
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+/** Hardware counters of one thread, read through Linux perf events.
+    The events are opened as a group the first time a Timer is started
+    in the thread and stay open, so start() and stop() each only cost one
+    read() of the group. Events the kernel or the processor doesn't
+    support (or all of them, if perf_event_paranoid forbids it) read
+    as 0. If the counters are opened again from another thread, the
+    events of the first thread are closed. */
+class _bz_ThreadCounters {
+public:
+    enum { cycles, instructions, cacheMisses, flops, numEvents };
+
+    _bz_ThreadCounters()
+    {
+        for (int i=0; i < numEvents; ++i)
+        {
+            fd_[i] = -1;
+            slot_[i] = -1;
+            begin_[i] = end_[i] = 0;
+        }
+        opened_ = false;
+        leader_ = -1;
+        thread_ = -1;
+    }
+
+    ~_bz_ThreadCounters()
+    { close(); }
+
+    /// Returns true if at least the cycle counter is running.
+    bool isCounting() const
+    { return leader_ >= 0; }
+
+    /// The thread which opened the counters.
+    long thread() const
+    { return thread_; }
+
+    void open(unsigned long long flopsEvent);
+    void close();
+
+    /// Reads the start values; the counters read 0 until stop().
+    void start()
+    {
+        read(begin_);
+        for (int i=0; i < numEvents; ++i)
+            end_[i] = begin_[i];
+    }
+
+    void stop()
+    { read(end_); }
+
+    long long value(int event) const
+    { return end_[event] - begin_[event]; }
+
+private:
+    void read(long long* values);
+
+    int fd_[numEvents];
+    int slot_[numEvents];
+    int leader_;
+    bool opened_;
+    long thread_;
+    long long begin_[numEvents], end_[numEvents];
+};
+
+inline void _bz_ThreadCounters::open(unsigned long long flopsEvent)
+{
+    const long thread = _bz_threadId();
+    if (opened_ && (thread_ == thread))
+        return;
+    close();
+    opened_ = true;
+    thread_ = thread;
+
+#ifdef BZ_HAVE_LINUX_PERF_EVENT_H
+    const unsigned int types[numEvents] = { PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_RAW };
+    const unsigned long long configs[numEvents] = { 
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, flopsEvent };
+
+    int numSlots = 0;
+    for (int i=0; i < numEvents; ++i)
+    {
+        if ((i == flops) && (flopsEvent == 0))
+            continue;
+
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[i];
+        attr.config = configs[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+
+        // pid 0, cpu -1: this thread, on whichever cpu it runs
+        fd_[i] = syscall(__NR_perf_event_open, &attr, 0, -1, leader_, 0);
+        if (fd_[i] < 0)
+        {
+            if (i == cycles)
+                return;
+            continue;
+        }
+        if (i == cycles)
+            leader_ = fd_[i];
+        slot_[i] = numSlots++;
+    }
+#endif
+}
+
+inline void _bz_ThreadCounters::close()
+{
+#ifdef BZ_HAVE_LINUX_PERF_EVENT_H
+    for (int i=numEvents-1; i >= 0; --i)
+        if (fd_[i] >= 0)
+            ::close(fd_[i]);
+#endif
+    for (int i=0; i < numEvents; ++i)
+        fd_[i] = slot_[i] = -1;
+    leader_ = -1;
+    opened_ = false;
+    thread_ = -1;
+}
+
+inline void _bz_ThreadCounters::read(long long* values)
+{
+    for (int i=0; i < numEvents; ++i)
+        values[i] = 0;
+#ifdef BZ_HAVE_LINUX_PERF_EVENT_H
+    if (leader_ < 0)
+        return;
+
+    // PERF_FORMAT_GROUP: the number of events, then their values
+    unsigned long long buffer[1 + numEvents];
+    if (::read(leader_, buffer, sizeof(buffer)) <= 0)
+        return;
+    for (int i=0; i < numEvents; ++i)
+        if ((slot_[i] >= 0) && ((unsigned long long)slot_[i] < buffer[0]))
+            values[i] = buffer[1 + slot_[i]];
+#endif
+}
+
+/** Timer for benchmarking.
+
+    elapsed() returns the wall-clock time in seconds between start()
+    and stop(), read from clock_gettime(CLOCK_MONOTONIC) (or
+    gettimeofday() where that is missing), so that multithreaded
+    evaluation is timed correctly. cpuTime() returns the CPU time used
+    by the process in the same interval.
+
+    On Linux the hardware counters are read with perf_event_open:
+    cycles(), instr(), cacheMisses() (last-level cache misses) and
+    flops(). There is no generic event for floating-point operations,
+    so flops() counts the processor-specific raw event set with
+    setFlopsEvent(), and is 0 if none is set. If the counters are not
+    available (other systems, or perf_event_paranoid is too
+    restrictive) they read 0, except cycles(), which falls back to the
+    time stamp counter on x86; hasCounters() tells which is the case.
+
+    When compiled with OpenMP, start() and stop() read the counters
+    in every thread of a parallel region. The counter functions then
+    return the sums over the threads, and the versions taking a thread
+    number return the values of each thread. Each thread of stop()
+    reads the counters it opened in start(); if stop() gets a team of
+    another size (with dynamic teams, for example), the counters of the
+    threads missing from it read 0. */
 class Timer {
 
 public:
     Timer() 
     { 
         state_ = uninitialized;
+        numThreads_ = 0;
     }
 
     void start()
     { 
+#ifdef _OPENMP
+        if (omp_in_parallel())
+            startCounters(0, 1);
+        else {
+            resizeCounters(omp_get_max_threads());
+#pragma omp parallel
+            {
+#pragma omp master
+                numThreads_ = omp_get_num_threads();
+                startCounters(omp_get_thread_num(), 0);
+            }
+        }
+#else
+        startCounters(0, 1);
+#endif
         state_ = running;
-        t1_ = systemTime();
+        c1_ = cpuClock();
+        ticks1_ = timeStamp();
+        t1_ = wallClock();
     }
 
     void stop()
     {
-        t2_ = systemTime();
+        t2_ = wallClock();
+        ticks2_ = timeStamp();
+        c2_ = cpuClock();
         BZPRECONDITION(state_ == running);
         state_ = stopped;
+#ifdef _OPENMP
+        if (omp_in_parallel())
+            counters_[0].stop();
+        else {
+            int teamSize = numThreads_;
+#pragma omp parallel num_threads(numThreads_)
+            {
+#pragma omp master
+                teamSize = omp_get_num_threads();
+                stopCounters();
+            }
+            BZPRECHECK(teamSize == numThreads_,
+                "Timer stopped with " << teamSize << " threads, but "
+                << "started with " << numThreads_)
+        }
+#else
+        counters_[0].stop();
+#endif
     }
     
 /* Compaq cxx compiler in ansi mode cannot print out long double type! */
@@ -80,19 +318,133 @@ public:
 #endif
     {
         BZPRECONDITION(state_ == stopped);
-        return (t2_ - t1_)/1e6;
+        return t2_ - t1_;
     }
 
-  long long instr() const { return 0; };
-  long long flops() const { return 0; };
+    /** Return the CPU time in seconds used by all the threads of the
+        process. */
+    double cpuTime() const
+    {
+        BZPRECONDITION(state_ == stopped);
+        return (c2_ - c1_)/1e6;
+    }
 
-  static const string& indep_var() { return ivar_; };
+    /// Number of threads whose counters were read.
+    int numThreads() const
+    { return numThreads_; }
+
+    /// True if the hardware counters are available.
+    bool hasCounters() const
+    { return !counters_.empty() && counters_[0].isCounting(); }
+
+    long long cycles() const
+    { 
+        if (!hasCounters())
+            return ticks2_ - ticks1_;
+        return sum(_bz_ThreadCounters::cycles); 
+    }
+
+    long long instr() const
+    { return sum(_bz_ThreadCounters::instructions); }
+
+    long long cacheMisses() const
+    { return sum(_bz_ThreadCounters::cacheMisses); }
+
+    long long flops() const
+    { return sum(_bz_ThreadCounters::flops); }
+
+    long long cycles(int thread) const
+    { return counters_[thread].value(_bz_ThreadCounters::cycles); }
+
+    long long instr(int thread) const
+    { return counters_[thread].value(_bz_ThreadCounters::instructions); }
+
+    long long cacheMisses(int thread) const
+    { return counters_[thread].value(_bz_ThreadCounters::cacheMisses); }
+
+    long long flops(int thread) const
+    { return counters_[thread].value(_bz_ThreadCounters::flops); }
+
+    /** Sets the raw perf event (PERF_TYPE_RAW config, see the
+        processor manuals) counted by flops() for timers started
+        afterwards in threads that have not opened their counters
+        yet. */
+    static void setFlopsEvent(unsigned long long config)
+    { flopsEvent_ = config; }
+
+    static const string& indep_var() { return ivar_; };
 
 private:
     Timer(Timer&) { }
     void operator=(Timer&) { }
 
-    long int systemTime()
+    void resizeCounters(int numThreads)
+    {
+        // the counters own their file descriptors, so they aren't
+        // copied when the vector grows
+        if (int(counters_.size()) < numThreads)
+        {
+            counters_.clear();
+            counters_.resize(numThreads);
+        }
+    }
+
+    /// Starts the counters of one thread. If \a numThreads is
+    /// nonzero, the Timer is used from that many threads.
+    void startCounters(int thread, int numThreads)
+    {
+        if (numThreads)
+        {
+            resizeCounters(numThreads);
+            numThreads_ = numThreads;
+        }
+        counters_[thread].open(flopsEvent_);
+        counters_[thread].start();
+    }
+
+    /// Stops the counters opened by the calling thread.
+    void stopCounters()
+    {
+        const long thread = _bz_threadId();
+        for (int i=0; i < numThreads_; ++i)
+            if (counters_[i].thread() == thread)
+                counters_[i].stop();
+    }
+
+    long long sum(int event) const
+    {
+        BZPRECONDITION(state_ == stopped);
+        long long n = 0;
+        for (int i=0; i < numThreads_; ++i)
+            n += counters_[i].value(event);
+        return n;
+    }
+
+    static double wallClock()
+    {
+#ifdef BZ_HAVE_CLOCK_GETTIME
+        struct timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec + 1e-9*t.tv_nsec;
+#else
+        struct timeval t;
+        gettimeofday(&t, 0);
+        return t.tv_sec + 1e-6*t.tv_usec;
+#endif
+    }
+
+    static long long timeStamp()
+    {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        unsigned int lo, hi;
+        __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+        return ((unsigned long long)hi << 32) | lo;
+#else
+        return 0;
+#endif
+    }
+
+    long int cpuClock()
     {
 #ifdef BZ_HAVE_RUSAGE
         getrusage(RUSAGE_SELF, &resourceUsage_);
@@ -109,12 +461,17 @@ private:
     enum { uninitialized, running, stopped } state_;
 
   static const string ivar_;
+  static unsigned long long flopsEvent_;
 
 #ifdef BZ_HAVE_RUSAGE
     struct rusage resourceUsage_;
 #endif
 
-    long int t1_, t2_;
+    double t1_, t2_;
+    long int c1_, c2_;
+    long long ticks1_, ticks2_;
+    int numThreads_;
+    std::vector<_bz_ThreadCounters> counters_;
 };
 
 #else
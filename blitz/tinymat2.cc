@@ -32,34 +32,59 @@
 #define BZ_TINYMAT2_CC
 
 #include <blitz/tmevaluate.h>
+#include <blitz/tmproduct.h>
 #include <blitz/tinymat2io.cc>
 #include <blitz/array/domain.h>
 
 BZ_NAMESPACE(blitz)
 
 template<typename P_numtype, int N_rows, int N_columns>
-inline TinyMatrix<P_numtype, N_rows, N_columns>::TinyMatrix(T_numtype initValue) 
+BZ_CONSTEXPR inline
+TinyMatrix<P_numtype, N_rows, N_columns>::TinyMatrix(T_numtype initValue) 
+  BZ_CONSTEXPR_INIT(data_)
 {
   for (sizeType i=0; i < numElements(); ++i)
     data_[i] = initValue;
 }
 
 template<typename P_numtype, int N_rows, int N_columns>
-inline TinyMatrix<P_numtype, N_rows, N_columns>::TinyMatrix(const T_matrix& x) 
+BZ_CONSTEXPR inline
+TinyMatrix<P_numtype, N_rows, N_columns>::TinyMatrix(const T_matrix& x) 
+  BZ_CONSTEXPR_INIT(data_)
 {
   for (sizeType i=0; i < numElements(); ++i)
     data_[i] = x.data_[i];
 }
 
+template<typename P_numtype, int N_rows, int N_columns>
+BZ_CONSTEXPR inline TinyMatrix<P_numtype, N_rows, N_columns>&
+TinyMatrix<P_numtype, N_rows, N_columns>::operator=(const T_matrix& x)
+{
+  for (sizeType i=0; i < numElements(); ++i)
+    data_[i] = x.data_[i];
+  return *this;
+}
+
 template<typename P_numtype, int N_rows, int N_columns>
 template<typename P_numtype2>
-inline
+BZ_CONSTEXPR inline
 TinyMatrix<P_numtype, N_rows, N_columns>::TinyMatrix(const TinyMatrix<P_numtype2, N_rows, N_columns>& x)
+  BZ_CONSTEXPR_INIT(data_)
 {
   for (sizeType i=0; i < numElements(); ++i)
     data_[i] = static_cast<P_numtype>(x.data_[i]);
 }
 
+template<typename P_numtype, int N_rows, int N_columns>
+BZ_CONSTEXPR inline
+TinyMatrix<P_numtype, N_rows, N_columns>::TinyMatrix(
+  const T_numtype (&x)[N_rows*N_columns])
+  BZ_CONSTEXPR_INIT(data_)
+{
+  for (sizeType i=0; i < numElements(); ++i)
+    data_[i] = x[i];
+}
+
 /*
  * Assignment-type operators
  */
@@ -61,6 +61,10 @@ class FastTM2CopyIterator;
 template<typename P_expr>
 class _bz_ArrayExpr;
 
+template<typename T_numtype1, typename T_numtype2, typename T_numtype3,
+         int N, int K, int M, int N_sign>
+class _bz_tinyMatrixProduct;
+
 template<int N0>
 class IndexPlaceholder;
 
@@ -89,17 +93,20 @@ public:
 
     TinyMatrix() { }
 
-  inline TinyMatrix(const T_matrix&);
+  BZ_CONSTEXPR inline TinyMatrix(const T_matrix&);
 
   template <typename T_numtype2>
-  inline TinyMatrix(const TinyMatrix<T_numtype2, N_rows, N_columns>& x);
+  BZ_CONSTEXPR inline TinyMatrix(const TinyMatrix<T_numtype2, N_rows, N_columns>& x);
   
-  inline TinyMatrix(T_numtype initValue);
+  BZ_CONSTEXPR inline TinyMatrix(T_numtype initValue);
+
+  /** Creates a TinyMatrix from the elements of x, stored by rows. */
+  BZ_CONSTEXPR inline TinyMatrix(const T_numtype (&x)[N_rows*N_columns]);
   
   static TinyVector<int, 2>    base() 
   { return 0; }
 
-  static int                               base(int rank) 
+  static BZ_CONSTEXPR int                  base(int rank) 
   { return 0; }
 
     iterator                          begin() 
@@ -117,10 +124,10 @@ public:
   static int                               columns() 
   { return N_columns; }
 
-    const T_numtype* restrict         data() const
+    BZ_CONSTEXPR const T_numtype* restrict data() const
     { return data_; }
 
-    T_numtype* restrict               data() 
+    BZ_CONSTEXPR T_numtype* restrict  data() 
     { return data_; }
     
     const T_numtype* restrict         dataFirst() const
@@ -158,12 +165,12 @@ public:
   static TinyVector<int,2>            lbound() 
   { return 0; }
 
-  static int                               length(int rank) 
+  static BZ_CONSTEXPR int                  length(int rank) 
   { BZPRECONDITION(rank<2); return rank==0 ? N_rows : N_columns; }
   static TinyVector<int, 2>    length() 
   { return TinyVector<int,2>(N_rows, N_columns); }
 
-  static sizeType                               numElements() 
+  static BZ_CONSTEXPR sizeType                  numElements() 
   { return N_rows*N_columns; }
 
   static int                               ordering(int rank) 
@@ -203,7 +210,7 @@ public:
     // Debugging routines
     //////////////////////////////////////////////
 
-    bool isInRange(const T_index& index) const {
+    BZ_CONSTEXPR bool isInRange(const T_index& index) const {
         for (int i=0; i < rank_; ++i)
 	  if (index[i] < base(i) || (index[i] - base(i)) >= length(i))
                 return false;
@@ -211,19 +218,19 @@ public:
         return true;
     }
 
-    bool isInRange(int i0, int i1) const {
+    BZ_CONSTEXPR bool isInRange(int i0, int i1) const {
       return i0 >= base(0) && (i0 - base(0)) < length(0)
 	&& i1 >= base(1) && (i1 - base(1)) < length(1);
     }
 
-    bool assertInRange(const T_index& BZ_DEBUG_PARAM(index)) const {
+    BZ_CONSTEXPR bool assertInRange(const T_index& BZ_DEBUG_PARAM(index)) const {
         BZPRECHECK(isInRange(index), "TinyMatrix index out of range: " << index
             << endl << "Lower bounds: " << base() << endl
 		   <<         "Length:       " << length() << endl);
         return true;
     }
 
-    bool assertInRange(int BZ_DEBUG_PARAM(i0), int BZ_DEBUG_PARAM(i1)) const {
+    BZ_CONSTEXPR bool assertInRange(int BZ_DEBUG_PARAM(i0), int BZ_DEBUG_PARAM(i1)) const {
         BZPRECHECK(isInRange(i0,i1), "TinyMatrix index out of range: (" 
             << i0 << ", " << i1 << ")"
             << endl << "Lower bounds: " << base() << endl
@@ -239,25 +246,25 @@ public:
     T_matrix& noConst() const
     { return const_cast<T_matrix&>(*this); }
 
-  const T_numtype& restrict operator()(unsigned i, unsigned j) const
+  BZ_CONSTEXPR const T_numtype& restrict operator()(unsigned i, unsigned j) const
     {
       assertInRange(i,j);
       return data_[i*N_columns + j];
     }
 
-  T_numtype& restrict operator()(unsigned i, unsigned j)
+  BZ_CONSTEXPR T_numtype& restrict operator()(unsigned i, unsigned j)
     {
       assertInRange(i,j);
       return data_[i*N_columns + j];
     }
 
-  const T_numtype& restrict operator()(T_index i) const
+  BZ_CONSTEXPR const T_numtype& restrict operator()(T_index i) const
     {
       assertInRange(i);
       return data_[i[0]*N_columns + i[1]];
     }
 
-  T_numtype& restrict operator()(T_index i)
+  BZ_CONSTEXPR T_numtype& restrict operator()(T_index i)
     {
       assertInRange(i);
       return data_[i[0]*N_columns + i[1]];
@@ -270,7 +277,7 @@ public:
 
   /** Fastread must return reference so the iterator can turn it into an
       iterator for the contained in case we have a multicomponent. */
-  const T_numtype& fastRead(diffType i) const
+  BZ_CONSTEXPR const T_numtype& fastRead(diffType i) const
   { return data_[i]; }
   
   /** Since data_ is simd aligned by construction, we just have
@@ -300,9 +307,23 @@ public:
     T_numtype* restrict getInitializationIterator()
     { return dataFirst(); }
 
+    BZ_CONSTEXPR inline T_matrix& operator=(const T_matrix&);
+
     template<typename T_expr>
     T_matrix& operator=(const ETBase<T_expr>&);
 
+    // matrix products, see <blitz/tmproduct.h>
+    template<typename T_numtype1, typename T_numtype2, typename T_numtype3,
+             int K, int N_sign>
+    BZ_CONSTEXPR T_matrix& operator=(const _bz_tinyMatrixProduct<T_numtype1, T_numtype2,
+        T_numtype3, N_rows, K, N_columns, N_sign>&);
+    template<typename T_numtype1, typename T_numtype2, int K>
+    BZ_CONSTEXPR T_matrix& operator+=(const _bz_tinyMatrixProduct<T_numtype1, T_numtype2,
+        void, N_rows, K, N_columns, 1>&);
+    template<typename T_numtype1, typename T_numtype2, int K>
+    BZ_CONSTEXPR T_matrix& operator-=(const _bz_tinyMatrixProduct<T_numtype1, T_numtype2,
+        void, N_rows, K, N_columns, 1>&);
+
     template<typename T> T_matrix& operator+=(const T&);
     template<typename T> T_matrix& operator-=(const T&);
     template<typename T> T_matrix& operator*=(const T&);
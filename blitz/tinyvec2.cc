@@ -43,23 +43,29 @@ BZ_NAMESPACE(blitz)
  */
 
 template<typename P_numtype, int N_length>
-_bz_forceinline
-TinyVector<P_numtype, N_length>::TinyVector(const T_numtype initValue) {
+_bz_forceinline BZ_CONSTEXPR
+TinyVector<P_numtype, N_length>::TinyVector(const T_numtype initValue)
+    BZ_CONSTEXPR_INIT(data_)
+{
     for (int i=0; i < N_length; ++i)
         data_[i] = initValue;
 }
 
 template<typename P_numtype, int N_length>
-_bz_forceinline 
-TinyVector<P_numtype, N_length>::TinyVector(const TinyVector<T_numtype, N_length>& x) {
+_bz_forceinline BZ_CONSTEXPR
+TinyVector<P_numtype, N_length>::TinyVector(const TinyVector<T_numtype, N_length>& x)
+    BZ_CONSTEXPR_INIT(data_)
+{
     for (int i=0; i < N_length; ++i)
         data_[i] = x.data_[i];
 }
 
 template<typename P_numtype, int N_length>
 template<typename P_numtype2>
-_bz_forceinline 
-TinyVector<P_numtype, N_length>::TinyVector(const TinyVector<P_numtype2, N_length>& x) {
+_bz_forceinline BZ_CONSTEXPR
+TinyVector<P_numtype, N_length>::TinyVector(const TinyVector<P_numtype2, N_length>& x)
+    BZ_CONSTEXPR_INIT(data_)
+{
     for (int i=0; i < N_length; ++i)
         data_[i] = static_cast<P_numtype>(x[i]);
 }
@@ -90,12 +90,11 @@ public:
         rank_ = 1;
 
     TinyVector()  { }
-    ~TinyVector() { }
 
-  TinyVector(const TinyVector<T_numtype,N_length>& x);
+  BZ_CONSTEXPR TinyVector(const TinyVector<T_numtype,N_length>& x);
 
     template <typename T_numtype2>
-    TinyVector(const TinyVector<T_numtype2,N_length>& x);
+    BZ_CONSTEXPR TinyVector(const TinyVector<T_numtype2,N_length>& x);
 
   /** This constructor creates a TinyVector from another ETBase
       object. It needs to be explicit to avoid all kinds of
@@ -113,28 +112,34 @@ public:
     inline TinyVector(const _bz_ArrayExpr<T_expr>& expr) {
       *this = expr; }
 
-    inline TinyVector(const T_numtype initValue);
+    BZ_CONSTEXPR inline TinyVector(const T_numtype initValue);
 
-    inline TinyVector(const T_numtype x[]) {
-        memcpy(data_,x,N_length*sizeof(T_numtype));
+    BZ_CONSTEXPR inline TinyVector(const T_numtype x[])
+        BZ_CONSTEXPR_INIT(data_)
+    {
+        for (int i=0; i < N_length; ++i)
+            data_[i] = x[i];
     }
 
   
-    TinyVector(T_numtype x0, T_numtype x1)
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
     }
 
-    TinyVector(T_numtype x0, T_numtype x1, T_numtype x2)
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1, T_numtype x2)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
         data_[2] = x2;
     }
 
-    TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
         T_numtype x3)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
@@ -142,8 +147,9 @@ public:
         data_[3] = x3;
     }
 
-    TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
         T_numtype x3, T_numtype x4)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
@@ -152,8 +158,9 @@ public:
         data_[4] = x4;
     }
 
-    TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
         T_numtype x3, T_numtype x4, T_numtype x5)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
@@ -163,8 +170,9 @@ public:
         data_[5] = x5;
     }
 
-    TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
         T_numtype x3, T_numtype x4, T_numtype x5, T_numtype x6)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
@@ -175,9 +183,10 @@ public:
         data_[6] = x6;
     }
 
-    TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
         T_numtype x3, T_numtype x4, T_numtype x5, T_numtype x6,
         T_numtype x7)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
@@ -189,9 +198,10 @@ public:
         data_[7] = x7;
     }
 
-    TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
         T_numtype x3, T_numtype x4, T_numtype x5, T_numtype x6,
         T_numtype x7, T_numtype x8)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
@@ -204,9 +214,10 @@ public:
         data_[8] = x8;
     }
 
-    TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
         T_numtype x3, T_numtype x4, T_numtype x5, T_numtype x6,
         T_numtype x7, T_numtype x8, T_numtype x9)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
@@ -220,9 +231,10 @@ public:
         data_[9] = x9;
     }
 
-    TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
+    BZ_CONSTEXPR TinyVector(T_numtype x0, T_numtype x1, T_numtype x2,
         T_numtype x3, T_numtype x4, T_numtype x5, T_numtype x6,
         T_numtype x7, T_numtype x8, T_numtype x9, T_numtype x10)
+        BZ_CONSTEXPR_INIT(data_)
     {
         data_[0] = x0;
         data_[1] = x1;
@@ -255,10 +267,10 @@ public:
     iterator       end()       { return data_ + N_length; }
     const_iterator end() const { return data_ + N_length; }
 
-    T_numtype * restrict data()
+    BZ_CONSTEXPR T_numtype * restrict data()
     { return data_; }
 
-    const T_numtype * restrict data() const
+    BZ_CONSTEXPR const T_numtype * restrict data() const
     { return data_; }
 
     T_numtype * restrict dataFirst()
@@ -277,7 +289,7 @@ public:
 
   static int                               length(int rank) 
   { BZPRECONDITION(rank==0); return N_length; }
-  static int    length() 
+  static BZ_CONSTEXPR int    length() 
   { return N_length; }
 
   static int                               extent(int rank)
@@ -292,7 +304,7 @@ public:
   static  int                               rank()
     { return rank_; }
 
-    static sizeType                               numElements() 
+    static BZ_CONSTEXPR sizeType                  numElements() 
   { return length(); }
 
     static diffType    stride() 
@@ -320,7 +332,7 @@ public:
     T_vector& noConst() const
     { return const_cast<T_vector&>(*this); }
 
-  static bool lengthCheck(unsigned i) 
+  static BZ_CONSTEXPR bool lengthCheck(unsigned i) 
     {
         BZPRECHECK(i < N_length, 
             "TinyVector<" << BZ_DEBUG_TEMPLATE_AS_STRING_LITERAL(T_numtype) 
@@ -328,13 +340,13 @@ public:
         return true;
     }
 
-    const T_numtype& operator()(unsigned i) const
+    BZ_CONSTEXPR const T_numtype& operator()(unsigned i) const
     {
         BZPRECONDITION(lengthCheck(i));
         return data_[i];
     }
 
-    T_numtype& restrict operator()(unsigned i)
+    BZ_CONSTEXPR T_numtype& restrict operator()(unsigned i)
     { 
         BZPRECONDITION(lengthCheck(i));
         return data_[i];
@@ -350,13 +362,13 @@ public:
     _bz_ArrayExpr<ArrayIndexMapping<typename asExpr<T_vector>::T_expr, N0> >
     operator()(IndexPlaceholder<N0>) const;
 
-    const T_numtype& operator[](unsigned i) const
+    BZ_CONSTEXPR const T_numtype& operator[](unsigned i) const
     {
         BZPRECONDITION(lengthCheck(i));
         return data_[i];
     }
 
-    T_numtype& restrict operator[](unsigned i)
+    BZ_CONSTEXPR T_numtype& restrict operator[](unsigned i)
     {
         BZPRECONDITION(lengthCheck(i));
         return data_[i];
@@ -364,7 +376,7 @@ public:
 
   // must return reference so the iterator can turn it into an
   // iterator for the contained in case we have a multicomponent.
-  const T_numtype& fastRead(diffType i) const
+  BZ_CONSTEXPR const T_numtype& fastRead(diffType i) const
     { return data_[i]; }
 
   /** Since data_ is simd aligned by construction, we just have
@@ -0,0 +1,249 @@
+// -*- C++ -*-
+/***************************************************************************
+ * blitz/tmproduct.h      Matrix products of TinyMatrix
+ *
+ * $Id$
+ *
+ * Copyright (C) 1997-2011 Todd Veldhuizen <tveldhui@acm.org>
+ *
+ * This file is a part of Blitz.
+ *
+ * Blitz is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Blitz is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Blitz.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Suggestions:          blitz-devel@lists.sourceforge.net
+ * Bugs:                 blitz-support@lists.sourceforge.net
+ *
+ * For more information, please see the Blitz++ Home Page:
+ *    https://sourceforge.net/projects/blitz/
+ *
+ ***************************************************************************/
+
+#ifndef BZ_TMPRODUCT_H
+#define BZ_TMPRODUCT_H
+
+#ifndef BZ_TINYMAT_H
+ #error <blitz/tmproduct.h> must be included via <blitz/tinymat2.h>
+#endif
+
+BZ_NAMESPACE(blitz)
+
+/*
+ * product(A, B) of an N x K and a K x M TinyMatrix is an expression
+ * evaluated when it is assigned to a TinyMatrix, or converted to one:
+ *
+ *   D = product(A, B);
+ *   D += product(A, B);
+ *   D = product(A, B) + C;      // fused, C is the initial value
+ *   D = C - product(A, B);
+ *
+ * The fused forms start the sums of the product with the elements of C,
+ * and need no temporary matrix.
+ *
+ * product(A, v) of a TinyMatrix and a TinyVector is a TinyVector.
+ */
+
+/** The kernel of the products of an N x K and a K x M matrix, stored
+    by rows. All the loops have constant bounds: the compiler unrolls
+    them and vectorizes the sums of neighbouring elements of a row. */
+template<typename T_numtype, int N, int K, int M>
+struct _bz_tinyMatrixProductKernel {
+    /** Sets c to N_sign * a * b, plus init when N_init is 1, or plus
+        the old value of c when N_init is 2. */
+    template<int N_sign, int N_init, typename T1, typename T2, typename T3>
+    static BZ_CONSTEXPR void apply(T_numtype* restrict c, const T1* restrict a,
+        const T2* restrict b, const T3* restrict init)
+    {
+        for (int i=0; i < N; ++i)
+            for (int j=0; j < M; ++j)
+            {
+                T_numtype x = T_numtype(a[i*K]) * b[j];
+                for (int k=1; k < K; ++k)
+                    x += T_numtype(a[i*K + k]) * b[k*M + j];
+                if (N_sign < 0)
+                    x = -x;
+                if (N_init == 1)
+                    x += init[i*M + j];
+                else if (N_init == 2)
+                    x += c[i*M + j];
+                c[i*M + j] = x;
+            }
+    }
+};
+
+// the element type of C in C + A * B: that of A * B when there is no C
+template<typename T_numtype3, typename T_product>
+struct _bz_tinyMatrixAdded {
+    typedef T_numtype3 T_added;
+};
+
+template<typename T_product>
+struct _bz_tinyMatrixAdded<void, T_product> {
+    typedef T_product T_added;
+};
+
+/** The expression product(A, B), or C + N_sign * product(A, B) when
+    T_numtype3 is not void. */
+template<typename T_numtype1, typename T_numtype2, typename T_numtype3,
+         int N, int K, int M, int N_sign>
+class _bz_tinyMatrixProduct {
+public:
+    typedef BZ_PROMOTE(T_numtype1, T_numtype2) T_product;
+    typedef typename _bz_tinyMatrixAdded<T_numtype3, T_product>::T_added
+        T_added;
+    typedef BZ_PROMOTE(T_product, T_added) T_numtype;
+
+    BZ_CONSTEXPR _bz_tinyMatrixProduct(const TinyMatrix<T_numtype1,N,K>& a,
+        const TinyMatrix<T_numtype2,K,M>& b,
+        const TinyMatrix<T_added,N,M>* c = 0)
+        : a_(a), b_(b), c_(c)
+    { }
+
+    /** Sets d to the value of the expression, plus N_update times the
+        old value of d for a nonzero N_update. */
+    template<int N_update, typename T>
+    BZ_CONSTEXPR void evaluate(TinyMatrix<T,N,M>& d) const
+    {
+        const void* p = d.data();
+        if (p == a_.data() || p == b_.data())
+        {
+            // d is an operand: compute a copy
+            TinyMatrix<T,N,M> e(d);
+            evaluate<N_update>(e);
+            d = e;
+            return;
+        }
+
+        typedef _bz_tinyMatrixProductKernel<T,N,K,M> T_kernel;
+        if (N_update)
+            T_kernel::template apply<N_update * N_sign, 2>(d.data(),
+                a_.data(), b_.data(), d.data());
+        else if (c_ && p == c_->data())
+            T_kernel::template apply<N_sign, 2>(d.data(), a_.data(),
+                b_.data(), d.data());
+        else if (c_)
+            T_kernel::template apply<N_sign, 1>(d.data(), a_.data(),
+                b_.data(), c_->data());
+        else
+            T_kernel::template apply<N_sign, 0>(d.data(), a_.data(),
+                b_.data(), d.data());
+    }
+
+    BZ_CONSTEXPR operator TinyMatrix<T_numtype,N,M>() const
+    {
+        TinyMatrix<T_numtype,N,M> d BZ_CONSTEXPR_VALUE(T_numtype(0));
+        evaluate<0>(d);
+        return d;
+    }
+
+    BZ_CONSTEXPR const TinyMatrix<T_numtype1,N,K>& a() const
+    { return a_; }
+
+    BZ_CONSTEXPR const TinyMatrix<T_numtype2,K,M>& b() const
+    { return b_; }
+
+private:
+    const TinyMatrix<T_numtype1,N,K>& a_;
+    const TinyMatrix<T_numtype2,K,M>& b_;
+    const TinyMatrix<T_added,N,M>* c_;
+};
+
+template<typename T_numtype1, typename T_numtype2, int N, int K, int M>
+BZ_CONSTEXPR inline _bz_tinyMatrixProduct<T_numtype1,T_numtype2,void,N,K,M,1>
+product(const TinyMatrix<T_numtype1,N,K>& a,
+    const TinyMatrix<T_numtype2,K,M>& b)
+{
+    return _bz_tinyMatrixProduct<T_numtype1,T_numtype2,void,N,K,M,1>(a, b);
+}
+
+// A * B + C, C + A * B and C - A * B
+template<typename T_numtype1, typename T_numtype2, typename T_numtype3,
+         int N, int K, int M>
+BZ_CONSTEXPR inline _bz_tinyMatrixProduct<T_numtype1,T_numtype2,T_numtype3,N,K,M,1>
+operator+(const _bz_tinyMatrixProduct<T_numtype1,T_numtype2,void,N,K,M,1>& p,
+    const TinyMatrix<T_numtype3,N,M>& c)
+{
+    return _bz_tinyMatrixProduct<T_numtype1,T_numtype2,T_numtype3,N,K,M,1>(
+        p.a(), p.b(), &c);
+}
+
+template<typename T_numtype1, typename T_numtype2, typename T_numtype3,
+         int N, int K, int M>
+BZ_CONSTEXPR inline _bz_tinyMatrixProduct<T_numtype1,T_numtype2,T_numtype3,N,K,M,1>
+operator+(const TinyMatrix<T_numtype3,N,M>& c,
+    const _bz_tinyMatrixProduct<T_numtype1,T_numtype2,void,N,K,M,1>& p)
+{
+    return _bz_tinyMatrixProduct<T_numtype1,T_numtype2,T_numtype3,N,K,M,1>(
+        p.a(), p.b(), &c);
+}
+
+template<typename T_numtype1, typename T_numtype2, typename T_numtype3,
+         int N, int K, int M>
+BZ_CONSTEXPR inline _bz_tinyMatrixProduct<T_numtype1,T_numtype2,T_numtype3,N,K,M,-1>
+operator-(const TinyMatrix<T_numtype3,N,M>& c,
+    const _bz_tinyMatrixProduct<T_numtype1,T_numtype2,void,N,K,M,1>& p)
+{
+    return _bz_tinyMatrixProduct<T_numtype1,T_numtype2,T_numtype3,N,K,M,-1>(
+        p.a(), p.b(), &c);
+}
+
+template<typename P_numtype, int N_rows, int N_columns>
+template<typename T_numtype1, typename T_numtype2, typename T_numtype3,
+         int K, int N_sign>
+BZ_CONSTEXPR inline TinyMatrix<P_numtype, N_rows, N_columns>&
+TinyMatrix<P_numtype, N_rows, N_columns>::operator=(
+    const _bz_tinyMatrixProduct<T_numtype1,T_numtype2,T_numtype3,N_rows,K,
+        N_columns,N_sign>& expr)
+{
+    expr.template evaluate<0>(*this);
+    return *this;
+}
+
+template<typename P_numtype, int N_rows, int N_columns>
+template<typename T_numtype1, typename T_numtype2, int K>
+BZ_CONSTEXPR inline TinyMatrix<P_numtype, N_rows, N_columns>&
+TinyMatrix<P_numtype, N_rows, N_columns>::operator+=(
+    const _bz_tinyMatrixProduct<T_numtype1,T_numtype2,void,N_rows,K,
+        N_columns,1>& expr)
+{
+    expr.template evaluate<1>(*this);
+    return *this;
+}
+
+template<typename P_numtype, int N_rows, int N_columns>
+template<typename T_numtype1, typename T_numtype2, int K>
+BZ_CONSTEXPR inline TinyMatrix<P_numtype, N_rows, N_columns>&
+TinyMatrix<P_numtype, N_rows, N_columns>::operator-=(
+    const _bz_tinyMatrixProduct<T_numtype1,T_numtype2,void,N_rows,K,
+        N_columns,1>& expr)
+{
+    expr.template evaluate<-1>(*this);
+    return *this;
+}
+
+// matrix-vector product, with the vector as a one-column matrix
+template<typename T_numtype1, typename T_numtype2, int N, int K>
+BZ_CONSTEXPR inline TinyVector<BZ_PROMOTE(T_numtype1, T_numtype2), N>
+product(const TinyMatrix<T_numtype1,N,K>& a,
+    const TinyVector<T_numtype2,K>& x)
+{
+    typedef BZ_PROMOTE(T_numtype1, T_numtype2) T_numtype;
+    TinyVector<T_numtype,N> y BZ_CONSTEXPR_VALUE(T_numtype(0));
+    _bz_tinyMatrixProductKernel<T_numtype,N,K,1>::template apply<1, 0>(
+        y.data(), a.data(), x.data(), y.data());
+    return y;
+}
+
+BZ_NAMESPACE_END
+
+#endif // BZ_TMPRODUCT_H
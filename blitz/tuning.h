@@ -65,6 +65,102 @@
 #define BZ_MAX_BITS_FOR_BINARY_UNROLL 8
 #define BZ_VECTORIZED_LOOP_WIDTH 32
 
+// Scatter updates through index lists (blitz/array/scatter.h) are
+// done in parallel with OpenMP when there are at least this many
+// points. Private per-thread buffers are used when the number of
+// array elements they cover times the number of threads is at most
+// BZ_SCATTER_PRIVATIZE_RATIO times the number of points.
+#ifndef BZ_SCATTER_THREADING_THRESHOLD
+ #define BZ_SCATTER_THREADING_THRESHOLD 32768
+#endif
+#ifndef BZ_SCATTER_PRIVATIZE_RATIO
+ #define BZ_SCATTER_PRIVATIZE_RATIO 2
+#endif
+
+// When BZ_PARALLEL_STENCILS is defined and compiling with OpenMP,
+// applyStencil splits interior domains of at least this many points
+// between threads.
+#ifndef BZ_STENCIL_THREADING_THRESHOLD
+ #define BZ_STENCIL_THREADING_THRESHOLD 16384
+#endif
+
+// convolve() and correlate() (blitz/array/convolve.h) use FFTs when
+// the direct sum needs more than BZ_CONVOLVE_FFT_RATIO times as many
+// multiply-adds as the FFTs need butterfly operations, and split the
+// direct sum between OpenMP threads when it needs at least
+// BZ_CONVOLVE_THREADING_THRESHOLD multiply-adds.
+#ifndef BZ_CONVOLVE_FFT_RATIO
+ #define BZ_CONVOLVE_FFT_RATIO 4
+#endif
+#ifndef BZ_CONVOLVE_THREADING_THRESHOLD
+ #define BZ_CONVOLVE_THREADING_THRESHOLD 65536
+#endif
+
+// An array assigned a permutation of another one (e.g. a transpose) is
+// copied in square tiles of BZ_PERMUTE_TILE elements along the ranks
+// of smallest stride of both, the tiles being split between OpenMP
+// threads for arrays of at least BZ_PERMUTE_THREADING_THRESHOLD
+// elements.
+#ifndef BZ_PERMUTE_TILE
+ #define BZ_PERMUTE_TILE 32
+#endif
+#ifndef BZ_PERMUTE_THREADING_THRESHOLD
+ #define BZ_PERMUTE_THREADING_THRESHOLD 65536
+#endif
+
+// Number of neighbouring lines transformed together by the FFTs of
+// blitz/array/fft.h.
+#ifndef BZ_FFT_BATCH_SIZE
+ #define BZ_FFT_BATCH_SIZE 8
+#endif
+
+// The vector updates and inner products of the Krylov solvers
+// (blitz/array/krylov.h) are split between OpenMP threads for vectors
+// of at least this many elements.
+#ifndef BZ_KRYLOV_THREADING_THRESHOLD
+ #define BZ_KRYLOV_THREADING_THRESHOLD 32768
+#endif
+
+// Size in bytes of the run of one component of an AoSoAArray
+// (blitz/array/soa.h): a cache line, so that the components of an
+// element are in as many cache lines as it has components.
+#ifndef BZ_AOSOA_BLOCK_BYTES
+ #define BZ_AOSOA_BLOCK_BYTES 64
+#endif
+
+// Largest size in bytes of the tiles of a TiledArray
+// (blitz/array/tiled.h): a page, so that a tile costs one TLB entry.
+#ifndef BZ_TILE_BYTES
+ #define BZ_TILE_BYTES 4096
+#endif
+
+// Number of objects the batched kernels of blitz/array/batched.h work
+// on at a time: enough lanes for the widest vectors of doubles. The
+// factorizations and solves, whose loops are longer, do better with
+// fewer lanes, BZ_BATCH_SOLVE_WIDTH, and those which pivot solve
+// matrices of more than BZ_BATCH_SOLVE_MAX_SIZE rows one at a time.
+// The kernels split arrays of at least BZ_BATCH_THREADING_THRESHOLD
+// objects between OpenMP threads.
+#ifndef BZ_BATCH_WIDTH
+ #define BZ_BATCH_WIDTH 8
+#endif
+#ifndef BZ_BATCH_SOLVE_WIDTH
+ #define BZ_BATCH_SOLVE_WIDTH 4
+#endif
+#ifndef BZ_BATCH_SOLVE_MAX_SIZE
+ #define BZ_BATCH_SOLVE_MAX_SIZE 4
+#endif
+#ifndef BZ_BATCH_THREADING_THRESHOLD
+ #define BZ_BATCH_THREADING_THRESHOLD 4096
+#endif
+
+// The PatchCollections of blitz/array/patches.h exchange ghost cells,
+// and with BZ_THREADSAFE are assigned expressions, in parallel with
+// OpenMP when at least this many elements are copied or assigned.
+#ifndef BZ_PATCH_THREADING_THRESHOLD
+ #define BZ_PATCH_THREADING_THRESHOLD 32768
+#endif
+
 
 #ifndef BZ_DISABLE_NEW_ET
  #define BZ_NEW_EXPRESSION_TEMPLATES
@@ -46,7 +46,7 @@ BZ_NAMESPACE(blitz)
  */
 
 template<typename T_numtype>
-TinyVector<T_numtype,3> cross(const TinyVector<T_numtype,3>& x, 
+BZ_CONSTEXPR TinyVector<T_numtype,3> cross(const TinyVector<T_numtype,3>& x, 
     const TinyVector<T_numtype,3>& y)
 {
     return TinyVector<T_numtype,3>(x[1]*y[2] - y[1]*x[2],
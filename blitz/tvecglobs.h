@@ -43,7 +43,7 @@
 BZ_NAMESPACE(blitz)
 
 template<typename T_numtype1, typename T_numtype2, int N_length>
-inline BZ_PROMOTE(T_numtype1, T_numtype2)
+BZ_CONSTEXPR inline BZ_PROMOTE(T_numtype1, T_numtype2)
 dot(const TinyVector<T_numtype1, N_length>& a, 
     const TinyVector<T_numtype2, N_length>& b)
 {
@@ -51,14 +51,14 @@ dot(const TinyVector<T_numtype1, N_length>& a,
 }
 
 template<typename T_numtype1, int N_length>
-inline BZ_SUMTYPE(T_numtype1)
+BZ_CONSTEXPR inline BZ_SUMTYPE(T_numtype1)
 product(const TinyVector<T_numtype1, N_length>& a)
 {
     return _bz_meta_vectorProduct<N_length, 0>::f(a);
 }
 
 template<typename T_numtype, int N_length>
-inline BZ_SUMTYPE(T_numtype)
+BZ_CONSTEXPR inline BZ_SUMTYPE(T_numtype)
 sum(const TinyVector<T_numtype, N_length>& a)
 {
     return _bz_meta_vectorSum<N_length, 0>::f(a);
@@ -71,7 +71,7 @@ class _bz_returntype {
 public:
 
   template<typename T_numtype1, typename T_numtype2, int N_length>
-static inline T_ret
+static BZ_CONSTEXPR inline T_ret
 dot(const TinyVector<T_numtype1, N_length>& a, 
     const TinyVector<T_numtype2, N_length>& b)
 {
@@ -79,14 +79,14 @@ dot(const TinyVector<T_numtype1, N_length>& a,
 };
 
 template<typename T_numtype1, int N_length>
-static inline T_ret
+static BZ_CONSTEXPR inline T_ret
 product(const TinyVector<T_numtype1, N_length>& a)
 {
     return _bz_meta_vectorProductRet<N_length, 0, T_ret>::f(a);
 };
 
 template<typename T_numtype, int N_length>
-static inline T_ret
+static BZ_CONSTEXPR inline T_ret
 sum(const TinyVector<T_numtype, N_length>& a)
 {
     return _bz_meta_vectorSumRet<N_length, 0, T_ret>::f(a);
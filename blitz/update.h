@@ -79,6 +79,34 @@ BZ_DECL_UPDATER(_bz_bitor_update, |=, "|=");
 BZ_DECL_UPDATER(_bz_shiftl_update, <<=, "<<=");
 BZ_DECL_UPDATER(_bz_shiftr_update, >>=, ">>=");
 
+/** Updaters which keep the smaller or larger of the old and new
+    values, used for min/max accumulation in scatter operations. */
+template<typename T_dest, typename T_source>
+class _bz_min_update : public _bz_updater_base {
+  public:
+  template<typename T1, typename T2> struct updateCast {
+    typedef _bz_min_update<T1, T2> T_updater;
+  };
+
+  static inline void update(T_dest& restrict x, T_source y)
+    { if (y < x) x = y; }
+  static void prettyPrint(BZ_STD_SCOPE(string) &str)
+    { str += "min="; }
+};
+
+template<typename T_dest, typename T_source>
+class _bz_max_update : public _bz_updater_base {
+  public:
+  template<typename T1, typename T2> struct updateCast {
+    typedef _bz_max_update<T1, T2> T_updater;
+  };
+
+  static inline void update(T_dest& restrict x, T_source y)
+    { if (x < y) x = y; }
+  static void prettyPrint(BZ_STD_SCOPE(string) &str)
+    { str += "max="; }
+};
+
 BZ_NAMESPACE_END
 
 #endif // BZ_UPDATE_H
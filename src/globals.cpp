@@ -27,8 +27,10 @@ char _blitz_id[] = BZ_PACKAGE_STRING;
 #include <papiStdEventDefs.h>
 const int Timer::Events[] =  {PAPI_TOT_CYC, PAPI_TOT_INS, PAPI_FP_INS};
 const string Timer::ivar_="c";
+// no flopsEvent_: the PAPI Timer always counts PAPI_FP_INS
 #else
 const string Timer::ivar_="s";
+unsigned long long Timer::flopsEvent_=0;
 #endif
 
 BZ_NAMESPACE_END
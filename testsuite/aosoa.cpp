@@ -0,0 +1,98 @@
+// Check AoSoAArray against the interleaved Array of the same values:
+// the blocked layout, conversions, element access and expressions.
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <blitz/array/soa.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+typedef TinyVector<double,3> T_vec;
+
+int main()
+{
+    // rows of 11 elements, in 3 blocks of 4 lanes
+    const int n = 5, m = 11;
+    Array<T_vec,2> A(Range(1,n), Range(0,m-1));
+    A[0] = i + j;
+    A[1] = i * j;
+    A[2] = 1.0 / (i + j + 1);
+
+    typedef AoSoAArray<T_vec,2,4> T_aosoa;
+    T_aosoa V(A);
+    BZTEST(all(V.lbound() == A.lbound()) && all(V.extent() == A.extent()));
+    BZTEST(V.numElements() == n*m && V.numBlocks() == n*3);
+
+    // the runs of the components of an element are width apart
+    const T_aosoa& cV = V;
+    BZTEST(all(cV(2,5) == A(2,5)));
+    BZTEST(&V.element(1, shape(2,5)) == &V.element(0, shape(2,5)) + 4);
+    BZTEST(V.data()[0] == A(1,0)[0] && V.data()[4] == A(1,0)[1]);
+    BZTEST(V.data()[12] == A(1,4)[0]);
+
+    // component views, with the blocks as a rank
+    Array<double,3> V1 = V[1];
+    BZTEST(all(V1.extent() == shape(n, 3, 4)) && V1.stride(2) == 1);
+    BZTEST(V1(1, 2, 1) == A(2, 9)[1]);
+
+    // element access through a proxy
+    V(2,5) = T_vec(7, 8, 9);
+    BZTEST(V[1](1, 1, 1) == 8);
+    V(2,5)[2] = 10;
+    BZTEST(V.element(2, shape(2,5)) == 10);
+    V(2,5) = A(2,5);
+    T_vec v = V(2,5);
+    BZTEST(all(v == A(2,5)));
+
+    // expressions, against the same ones on A
+    T_aosoa W(V.lbound(), V.extent()), X(V.lbound(), V.extent());
+    Array<T_vec,2> B(A.lbound(), A.extent()), C(A.lbound(), A.extent());
+
+    W = 2.0;
+    B = 2.0;
+    X = V + 0.5 * W - V / 4;
+    C = A + 0.5 * B - A / 4;
+    X.copyTo(B);
+    BZTEST(all(B[0] == C[0]) && all(B[1] == C[1]) && all(B[2] == C[2]));
+
+    X = -V * W + T_vec(1, 2, 3);
+    X.copyTo(B);
+    for (int c=0; c < 3; ++c)
+        BZTEST(all(B[c] == -A[c] * 2.0 + (c + 1)));
+
+    X += V;
+    X *= 2;
+    X -= T_vec(1, 1, 1);
+    X /= W;
+    X.copyTo(B);
+    for (int c=0; c < 3; ++c)
+        BZTEST(all(B[c] == ((-A[c] * 2.0 + (c + 1) + A[c]) * 2 - 1) / 2));
+
+    // the updates leave the padding lane of each row zero, not 0/0
+    for (int c=0; c < 3; ++c)
+        BZTEST(all(X[c](Range::all(), 2, 3) == 0));
+
+    // copies are views, copy() is not
+    T_aosoa Y(X), Z = X.copy();
+    Y(1,0) = T_vec(0.);
+    BZTEST(X(1,0)[0] == 0 && Z(1,0)[0] != 0);
+
+    // the sum leaves out the padding lanes
+    V = T_vec(1, 2, 3);
+    BZTEST(all(sum(V) == T_vec(n*m, 2*n*m, 3*n*m)));
+
+    // the default width, and other ranks and types
+    AoSoAArray<T_vec,3> D(3, 4, 20);
+    BZTEST(D.width == 64 / int(sizeof(double)));
+    D = T_vec(1, 0, 0);
+    D = D + D;
+    BZTEST(all(sum(D) == T_vec(2*3*4*20, 0, 0)));
+
+    AoSoAArray<complex<float>,1> Q(10);
+    Q = complex<float>(1, -1);
+    Q = Q + Q;
+    complex<float> q = Q(9);
+    BZTEST(q == complex<float>(2, -2));
+
+    return 0;
+}
@@ -0,0 +1,362 @@
+// Check the batched kernels of arrays of TinyVectors and TinyMatrices
+// against the same operations done one object at a time.
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <blitz/array/batched.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+typedef TinyVector<double,3> T_vec3;
+typedef TinyMatrix<double,3,3> T_mat3;
+typedef TinyMatrix<double,4,4> T_mat4;
+
+// a matrix with small integer entries, different for each n
+template<int N>
+TinyMatrix<double,N,N> sample(int n)
+{
+    TinyMatrix<double,N,N> m;
+    for (int i=0; i < N; ++i)
+        for (int j=0; j < N; ++j)
+            m(i,j) = (n * (i + 3) + j * j + 7 * (i == j)) % 11 - 5;
+    return m;
+}
+
+template<int N>
+TinyMatrix<double,N,N> multiply(const TinyMatrix<double,N,N>& a,
+    const TinyMatrix<double,N,N>& b)
+{
+    TinyMatrix<double,N,N> c;
+    for (int i=0; i < N; ++i)
+        for (int j=0; j < N; ++j)
+        {
+            c(i,j) = 0;
+            for (int k=0; k < N; ++k)
+                c(i,j) += a(i,k) * b(k,j);
+        }
+    return c;
+}
+
+// the determinant by expansion along the first row
+double det(const T_mat3& a)
+{
+    return a(0,0) * (a(1,1) * a(2,2) - a(1,2) * a(2,1))
+        - a(0,1) * (a(1,0) * a(2,2) - a(1,2) * a(2,0))
+        + a(0,2) * (a(1,0) * a(2,1) - a(1,1) * a(2,0));
+}
+
+double det(const T_mat4& a)
+{
+    double d = 0;
+    for (int c=0; c < 4; ++c)
+    {
+        T_mat3 m;
+        for (int i=1; i < 4; ++i)
+            for (int j=0, k=0; j < 4; ++j)
+                if (j != c)
+                    m(i-1, k++) = a(i,j);
+        d += (c % 2 ? -1 : 1) * a(0,c) * det(m);
+    }
+    return d;
+}
+
+template<int N>
+TinyVector<double,N> multiply(const TinyMatrix<double,N,N>& a,
+    const TinyVector<double,N>& x)
+{
+    TinyVector<double,N> y;
+    for (int i=0; i < N; ++i)
+    {
+        y(i) = 0;
+        for (int k=0; k < N; ++k)
+            y(i) += a(i,k) * x(k);
+    }
+    return y;
+}
+
+template<int N>
+bool isClose(const TinyVector<double,N>& a, const TinyVector<double,N>& b)
+{
+    for (int i=0; i < N; ++i)
+        if (fabs(a(i) - b(i)) > 1e-9 * (1 + fabs(b(i))))
+            return false;
+    return true;
+}
+
+template<int N>
+bool isIdentity(const TinyMatrix<double,N,N>& a)
+{
+    for (int i=0; i < N; ++i)
+        for (int j=0; j < N; ++j)
+            if (fabs(a(i,j) - (i == j)) > 1e-10)
+                return false;
+    return true;
+}
+
+int main()
+{
+    // rows of 13 objects: one batch and a tail
+    const int n = 3, m = 13;
+
+    Array<T_vec3,2> u(n, m), v(n, m), w(n, m);
+    u[0] = i + j;
+    u[1] = i * j - 2;
+    u[2] = 3 - j;
+    v[0] = j * j;
+    v[1] = 1;
+    v[2] = i - j;
+
+    batchCross(w, u, v);
+    Array<double,2> d(n, m);
+    batchDot(d, u, v);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            BZTEST(all(w(a,b) == cross(u(a,b), v(a,b))));
+            BZTEST(d(a,b) == dot(u(a,b), v(a,b)));
+        }
+    // the result may be an operand
+    Array<T_vec3,2> z = v.copy();
+    batchCross(z, u, z);
+    BZTEST(all(z[0] == w[0]) && all(z[1] == w[1]) && all(z[2] == w[2]));
+
+    // 3x3 matrices: products, determinant and inverse
+    Array<T_mat3,2> A(n, m), B(n, m), C(n, m);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            A(a,b) = sample<3>(a * m + b);
+            B(a,b) = sample<3>(a + 5 * b + 1);
+        }
+
+    batchProduct(C, A, B);
+    batchProduct(w, A, u);
+    batchDeterminant(d, A);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            BZTEST(all(C(a,b) == multiply(A(a,b), B(a,b))));
+            for (int r=0; r < 3; ++r)
+                BZTEST(w(a,b)(r) == A(a,b)(r,0) * u(a,b)(0)
+                    + A(a,b)(r,1) * u(a,b)(1) + A(a,b)(r,2) * u(a,b)(2));
+            BZTEST(d(a,b) == det(A(a,b)));
+        }
+
+    batchInverse(C, A);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+            if (d(a,b) != 0)
+                BZTEST(isIdentity(multiply(A(a,b), C(a,b))));
+
+    // in place, and through strided and transposed views
+    C = A;
+    batchInverse(C, C);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+            if (d(a,b) != 0)
+                BZTEST(isIdentity(multiply(A(a,b), C(a,b))));
+
+    C = B;
+    batchProduct(C, A, C);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+            BZTEST(all(C(a,b) == multiply(A(a,b), B(a,b))));
+
+    Array<T_mat3,2> At = A.transpose(1, 0), Bs = B(Range::all(),
+        Range(m-1, 0, -1));
+    Array<T_mat3,2> Ct(m, n, ColumnMajorArray<2>());
+    Array<T_mat3,2> Bst = Bs.transpose(1, 0);
+    batchProduct(Ct, At, Bst);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+            BZTEST(all(Ct(b,a) == multiply(A(a,b), B(a,m-1-b))));
+
+    // 4x4 and 2x2
+    Array<T_mat4,1> E(m), F(m);
+    Array<double,1> e(m);
+    for (int b=0; b < m; ++b)
+        E(b) = sample<4>(b + 2);
+    batchDeterminant(e, E);
+    batchInverse(F, E);
+    for (int b=0; b < m; ++b)
+    {
+        BZTEST(e(b) == det(E(b)));
+        if (e(b) != 0)
+            BZTEST(isIdentity(multiply(E(b), F(b))));
+    }
+
+    Array<TinyMatrix<float,2,2>,1> G(5), H(5);
+    Array<float,1> g(5);
+    G = TinyMatrix<float,2,2>(0.f);
+    for (int b=0; b < 5; ++b)
+    {
+        G(b)(0,0) = b + 1;
+        G(b)(0,1) = 2;
+        G(b)(1,1) = 4;
+    }
+    batchDeterminant(g, G);
+    batchInverse(H, G);
+    for (int b=0; b < 5; ++b)
+    {
+        BZTEST(g(b) == 4 * (b + 1));
+        BZTEST(H(b)(0,0) == 1.f / (b + 1) && H(b)(1,1) == 0.25f);
+        BZTEST(H(b)(1,0) == 0 && H(b)(0,1) == -2.f / (4 * (b + 1)));
+    }
+
+    // linear systems of 5 equations, solved directly and from their LU
+    // factorizations, and inverted
+    typedef TinyMatrix<double,5,5> T_mat5;
+    typedef TinyVector<double,5> T_vec5;
+    Array<T_mat5,2> P(n, m), LU(n, m), Q(n, m);
+    Array<T_vec5,2> x(n, m), y(n, m), rhs(n, m);
+    Array<TinyVector<int,5>,2> pivot(n, m);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            P(a,b) = sample<5>(3 * a + b + 4);
+            for (int k=0; k < 5; ++k)
+                rhs(a,b)(k) = a - 2 * k + b % 3;
+        }
+
+    batchSolve(x, P, rhs);
+    batchLU(LU, pivot, P);
+    batchLUSolve(y, LU, pivot, rhs);
+    batchInverse(Q, P);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            BZTEST(isClose(multiply(P(a,b), x(a,b)), rhs(a,b)));
+            BZTEST(isClose(y(a,b), x(a,b)));
+            BZTEST(isIdentity(multiply(P(a,b), Q(a,b))));
+
+            // P A = L U, with multipliers of modulus at most 1
+            T_mat5 l(0.), u(0.);
+            for (int r=0; r < 5; ++r)
+                for (int c=0; c < 5; ++c)
+                {
+                    if (c < r)
+                    {
+                        l(r,c) = LU(a,b)(r,c);
+                        BZTEST(fabs(l(r,c)) <= 1);
+                    }
+                    else
+                        u(r,c) = LU(a,b)(r,c);
+                }
+            for (int r=0; r < 5; ++r)
+                l(r,r) = 1;
+            T_mat5 lu = multiply(l, u);
+            for (int r=0; r < 5; ++r)
+                for (int c=0; c < 5; ++c)
+                    BZTEST(fabs(lu(r,c) - P(a,b)(pivot(a,b)(r),c)) < 1e-10);
+        }
+
+    // in place: the right-hand side overwritten by the solution
+    y = rhs;
+    batchLUSolve(y, LU, pivot, y);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+            BZTEST(isClose(y(a,b), x(a,b)));
+    y = rhs;
+    batchSolve(y, P, y);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+            BZTEST(isClose(y(a,b), x(a,b)));
+
+    // systems of 4 equations, which are solved in lanes rather than one
+    // at a time
+    Array<TinyMatrix<double,4,4>,2> P4(n, m), LU4(n, m);
+    Array<TinyVector<double,4>,2> x4(n, m), y4(n, m), rhs4(n, m);
+    Array<TinyVector<int,4>,2> pivot4(n, m);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            P4(a,b) = sample<4>(2 * a + 3 * b + 1);
+            for (int k=0; k < 4; ++k)
+                rhs4(a,b)(k) = 2 * a - k + b % 5;
+        }
+    batchSolve(x4, P4, rhs4);
+    batchLU(LU4, pivot4, P4);
+    batchLUSolve(y4, LU4, pivot4, rhs4);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            BZTEST(isClose(multiply(P4(a,b), x4(a,b)), rhs4(a,b)));
+            BZTEST(isClose(y4(a,b), x4(a,b)));
+        }
+
+    // symmetric positive definite matrices: P^T P + 5 I
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            T_mat5 t;
+            for (int r=0; r < 5; ++r)
+                for (int c=0; c < 5; ++c)
+                    t(r,c) = P(a,b)(c,r);
+            Q(a,b) = multiply(t, P(a,b));
+            for (int r=0; r < 5; ++r)
+                Q(a,b)(r,r) += 5;
+        }
+    batchCholesky(LU, Q);
+    batchCholeskySolve(x, LU, rhs);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            T_mat5 t;
+            for (int r=0; r < 5; ++r)
+                for (int c=0; c < 5; ++c)
+                {
+                    t(r,c) = LU(a,b)(c,r);
+                    if (c > r)
+                        BZTEST(LU(a,b)(r,c) == 0);
+                }
+            T_mat5 q = multiply(LU(a,b), t);
+            for (int r=0; r < 5; ++r)
+                for (int c=0; c < 5; ++c)
+                    BZTEST(fabs(q(r,c) - Q(a,b)(r,c))
+                        < 1e-10 * (1 + fabs(Q(a,b)(r,c))));
+            BZTEST(isClose(multiply(Q(a,b), x(a,b)), rhs(a,b)));
+        }
+
+    // eigenvalues and eigenvectors of symmetric 3x3 matrices, one of
+    // them with a double eigenvalue
+    Array<T_vec3,2> lambda(n, m);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            T_mat3 s = sample<3>(a * m + b + 3);
+            for (int r=0; r < 3; ++r)
+                for (int c=0; c < 3; ++c)
+                    A(a,b)(r,c) = s(r,c) + s(c,r);
+        }
+    A(2,5) = 2, 1, 1,
+             1, 2, 1,
+             1, 1, 2;
+    batchEigenSymmetric(lambda, C, A);
+    for (int a=0; a < n; ++a)
+        for (int b=0; b < m; ++b)
+        {
+            BZTEST(lambda(a,b)(0) <= lambda(a,b)(1)
+                && lambda(a,b)(1) <= lambda(a,b)(2));
+            for (int k=0; k < 3; ++k)
+            {
+                T_vec3 v;
+                for (int r=0; r < 3; ++r)
+                    v(r) = C(a,b)(r,k);
+                TinyVector<double,3> av = multiply(A(a,b), v),
+                    lv = lambda(a,b)(k) * v;
+                BZTEST(isClose(av, lv));
+                for (int l=0; l < 3; ++l)
+                {
+                    double p = 0;
+                    for (int r=0; r < 3; ++r)
+                        p += C(a,b)(r,k) * C(a,b)(r,l);
+                    BZTEST(fabs(p - (k == l)) < 1e-10);
+                }
+            }
+        }
+    BZTEST(fabs(lambda(2,5)(0) - 1) < 1e-12
+        && fabs(lambda(2,5)(1) - 1) < 1e-12
+        && fabs(lambda(2,5)(2) - 4) < 1e-12);
+
+    return 0;
+}
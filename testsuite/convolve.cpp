@@ -0,0 +1,103 @@
+// Check convolve() and correlate() against the sums, in all modes and
+// with both the direct and the FFT method.
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <blitz/array/convolve.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+// the full convolution, summed term by term
+Array<double,2> fullSum(const Array<double,2>& B, const Array<double,2>& C)
+{
+    Array<double,2> A(B.lbound() + C.lbound(), B.extent() + C.extent() - 1);
+    A = 0;
+    for (int i=B.lbound(0); i <= B.ubound(0); ++i)
+    for (int j=B.lbound(1); j <= B.ubound(1); ++j)
+        for (int k=C.lbound(0); k <= C.ubound(0); ++k)
+        for (int l=C.lbound(1); l <= C.ubound(1); ++l)
+            A(i+k,j+l) += B(i,j) * C(k,l);
+    return A;
+}
+
+// the part of A on domain d, with the bounds of d
+Array<double,2> part(const Array<double,2>& A, const RectDomain<2>& d)
+{
+    Array<double,2> P = A(d);
+    P.reindexSelf(d.lbound());
+    return P;
+}
+
+template<typename T, int N>
+bool near(const Array<T,N>& A, const Array<T,N>& B)
+{
+    return all(A.lbound() == B.lbound()) && all(A.extent() == B.extent())
+        && (max(abs(A - B)) < 1e-10 * (1 + max(abs(B))));
+}
+
+int main()
+{
+    // The example of the manual
+    Array<float,1> B1(Range(-2,+2)), C1(Range(10,15));
+    B1 = 1, 0, 2, 5, 3;
+    C1 = 10, 2, 4, 1, 7, 2;
+    Array<float,1> A1 = convolve(B1,C1);
+    BZTEST(A1.lbound(0) == 8 && A1.ubound(0) == 17);
+    Array<float,1> R1(Range(8,17));
+    R1 = 10, 2, 24, 55, 55, 30, 31, 42, 31, 6;
+    BZTEST(all(A1 == R1));
+    BZTEST(all(abs(convolve(B1,C1,convolveFull,convolveFFT) - R1) < 1e-4));
+
+    // Integers use the direct sum
+    Array<int,1> I1(Range(-2,+2)), J1(Range(10,15));
+    I1 = 1, 0, 2, 5, 3;
+    J1 = 10, 2, 4, 1, 7, 2;
+    BZTEST(all(convolve(I1,J1,convolveFull,convolveFFT) == R1));
+
+    // 2D, with a prime and an even extent (Bluestein and mixed radix)
+    Array<double,2> B(Range(-3,33), Range(2,29)), C(Range(-2,3), Range(-1,1));
+    B = sin(i * 0.3 + j * j * 0.1);
+    C = i - j * 2 + 0.5;
+    Array<double,2> full = fullSum(B, C);
+
+    for (int method=convolveDirect; method <= convolveFFT; ++method)
+    {
+        ConvolutionMethod m = ConvolutionMethod(method);
+        BZTEST(near(convolve(B, C, convolveFull, m), full));
+
+        Array<double,2> same = convolve(B, C, convolveSame, m);
+        BZTEST(near(same, part(full, B.domain())));
+
+        Array<double,2> valid = convolve(B, C, convolveValid, m);
+        RectDomain<2> v(B.lbound() + C.ubound(), B.ubound() + C.lbound());
+        BZTEST(near(valid, part(full, v)));
+
+        // the correlation is the convolution with the reversed kernel
+        Array<double,2> D = C.copy();
+        D.reverseSelf(firstDim);
+        D.reverseSelf(secondDim);
+        D.reindexSelf(-C.ubound());
+        BZTEST(near(correlate(B, C, convolveFull, m), fullSum(B, D)));
+        BZTEST(near(correlate(B, C, convolveSame, m),
+                    part(fullSum(B, D), B.domain())));
+    }
+
+    // A kernel larger than B has no valid part
+    BZTEST(convolve(C, B, convolveValid).numElements() == 0);
+
+    // Overlap-add of a long signal, complex correlation
+    const int n = 5000;
+    Array<complex<double>,1> S(n), F(Range(-20,20));
+    S = zip(cos(i * 0.01), sin(i * 0.03), complex<double>());
+    F = zip(1.0 / (1 + i * i), i * 0.01, complex<double>());
+    BZTEST(near(convolve(S, F, convolveSame, convolveFFT),
+                convolve(S, F, convolveSame, convolveDirect)));
+    Array<complex<double>,1> X = correlate(S, F, convolveValid, convolveFFT);
+    BZTEST(X.lbound(0) == 20 && X.ubound(0) == n - 21);
+    complex<double> x = 0;
+    for (int k=-20; k <= 20; ++k)
+        x += S(100 + k) * conj(F(k));
+    BZTEST(abs(X(100) - x) < 1e-10);
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Check that the expression profile counts calls, elements and
+// traversal paths once per expression type.
+#define BZ_EXPR_PROFILING
+
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <sstream>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+const ExprProfileEntry* entry(const string& description)
+{
+    const ExprProfileEntry* e = ExprProfile::find(description);
+    if (!e)
+        cerr << "No profile of " << description << endl;
+    return e;
+}
+
+int main()
+{
+    ExprProfile::setDumpAtExit(false);
+
+    const int n = 100;
+    Array<double,1> A(n), B(n), C(n);
+    Array<double,2> D(10,n);
+
+    // index traversal
+    B = i;
+    C = 2 * i;
+
+    // unit stride, three calls of the same expression
+    for (int k=0; k < 3; ++k)
+        A = B + C;
+
+    // common stride
+    Range even(0, n-2, 2);
+    A(even) = B(even) * C(even);
+
+    // collapsed loops of a 2D array
+    D = 1.5;
+
+    const double s = sum(A);
+    BZTEST(s > 0);
+
+    const ExprProfileEntry* e = entry("A=(B+C)");
+    BZTEST(e != 0);
+    BZTEST(e->calls == 3);
+    BZTEST(e->elements == 3 * n);
+    BZTEST(e->pathCalls[unitStrideTraversal] == 3);
+    BZTEST(e->pathCalls[indexTraversal] == 0);
+    BZTEST(e->seconds >= 0);
+
+    e = entry("A=(B*C)");
+    BZTEST(e != 0);
+    BZTEST(e->calls == 1);
+    BZTEST(e->elements == n/2);
+    BZTEST(e->pathCalls[commonStrideTraversal] == 1);
+
+    e = entry("A=s");
+    BZTEST(e != 0);
+    BZTEST(e->elements == 10 * n);
+    BZTEST(e->pathCalls[unitStrideTraversal] == 1);
+
+    e = entry("sum(A)");
+    BZTEST(e != 0);
+    BZTEST(e->calls == 1);
+    BZTEST(e->elements == n);
+    BZTEST(e->pathCalls[indexTraversal] == 1);
+
+    // both index expressions, each with its own entry
+    int indexed = 0;
+    for (size_t k=0; k < ExprProfile::entries().size(); ++k)
+        if (ExprProfile::entries()[k]->pathCalls[indexTraversal] == 1
+            && ExprProfile::entries()[k]->elements == n)
+            ++indexed;
+    BZTEST(indexed == 3);
+
+    ostringstream os;
+    ExprProfile::dump(os);
+    BZTEST(os.str().find("unit-stride: A=(B+C)") != string::npos);
+
+    ExprProfile::reset();
+    BZTEST(entry("A=(B+C)")->calls == 0);
+    A = B + C;
+    BZTEST(entry("A=(B+C)")->calls == 1);
+
+    // the same expression on arrays of another type shares the entry
+    Array<float,1> F(n), G(n), H(n);
+    G = 1;
+    H = 2;
+    F = G + H;
+    BZTEST(entry("A=(B+C)")->calls == 2);
+    int same = 0;
+    for (size_t k=0; k < ExprProfile::entries().size(); ++k)
+        if (ExprProfile::entries()[k]->description == "A=(B+C)")
+            ++same;
+    BZTEST(same == 1);
+
+    return 0;
+}
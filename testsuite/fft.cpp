@@ -0,0 +1,114 @@
+// Check the FFTs against the sums of their definition, for lengths
+// transformed by the mixed-radix and by Bluestein's algorithm, along
+// all ranks of views, and the real transforms against the complex ones.
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <blitz/array/fft.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+typedef complex<double> cd;
+
+// the transform of A along rank r, summed term by term
+Array<cd,3> dft(const Array<cd,3>& A, int r, double sign = -1)
+{
+    Array<cd,3> X(A.extent());
+    X = 0;
+    const double pi = 3.14159265358979323846;
+    const int n = A.extent(r);
+    for (int i=0; i < A.extent(0); ++i)
+    for (int j=0; j < A.extent(1); ++j)
+    for (int k=0; k < A.extent(2); ++k)
+    {
+        TinyVector<int,3> p(i,j,k);
+        const int out = p(r);
+        for (int m=0; m < n; ++m)
+        {
+            p(r) = m;
+            const double a = sign * 2 * pi * double(out) * m / n;
+            X(i,j,k) += A(TinyVector<int,3>(p + A.lbound())) * cd(cos(a), sin(a));
+        }
+    }
+    return X;
+}
+
+// compares A and B regardless of their lbounds
+template<int N>
+bool near(Array<cd,N> A, Array<cd,N> B)
+{
+    A.reindexSelf(TinyVector<int,N>(0));
+    B.reindexSelf(TinyVector<int,N>(0));
+    return all(A.extent() == B.extent())
+        && (max(abs(A - B)) < 1e-10 * (1 + max(abs(B))));
+}
+
+int main()
+{
+    // 1D, lengths of all the radices and primes
+    for (int n=1; n <= 40; ++n)
+    {
+        Array<cd,3> A(n,1,1);
+        A = zip(cos(i * 0.7 + 1), sin(i * i * 0.1), cd());
+        Array<cd,3> X = fft(A);
+        BZTEST(near(X, dft(A, 0)));
+        BZTEST(near(ifft(X), A));
+    }
+
+    // 3D with a prime, a mixed-radix and a power-of-two extent
+    Array<cd,3> A(Range(1,7), Range(-2,9), Range(0,15));
+    A = zip(cos(i * 0.3 + j * 0.5), sin(k * k * 0.1 - i), cd());
+    Array<cd,3> X = fft(A);
+    BZTEST(all(X.lbound() == 0));
+    BZTEST(near(X, dft(dft(dft(A, 0), 1), 2)));
+
+    // in place along one rank, and back
+    Array<cd,3> B = A.copy();
+    fftInPlace(B, 1);
+    BZTEST(near(B, dft(A, 1)));
+    fftInPlace(B, 1, fftInverse);
+    BZTEST(near(B, A));
+
+    // strided and reversed views, and a rank ordering other than C's
+    Array<cd,3> C(Range(0,14), Range(0,11), Range(0,9),
+                  ColumnMajorArray<3>());
+    C = zip(sin(i * 0.2 + k), cos(j * j * 0.3), cd());
+    Array<cd,3> V = C(Range(0,14,2), Range::all(), Range(9,0,-1));
+    Array<cd,3> W = V.copy();
+    BZTEST(near(fft(V), dft(dft(dft(W, 0), 1), 2)));
+    fftInPlace(V);
+    BZTEST(near(V, fft(W)));
+    fftInPlace(V, fftInverse);
+    BZTEST(near(V, W));
+    BZTEST(all(C(Range(1,13,2), Range::all(), Range::all()) ==
+               zip(sin((2*i + 1) * 0.2 + k), cos(j * j * 0.3), cd())));
+
+    // the real transforms, of even and odd lengths
+    for (int n=1; n <= 13; ++n)
+    {
+        Array<double,2> R(5, n);
+        R = sin(i * 1.3 + j * j * 0.4) + j;
+        Array<cd,2> Y = rfft(R);
+        BZTEST(Y.extent(1) == n/2 + 1);
+        Array<cd,2> Rc(5, n);
+        Rc = zip(R, 0., cd());
+        Array<cd,2> Z = fft(Rc);
+        BZTEST(near(Y, Array<cd,2>(Z(Range::all(), Range(0, n/2)))));
+        BZTEST(max(abs(irfft(Y, n) - R)) < 1e-10 * (1 + max(abs(R))));
+    }
+
+    // plans are cached by length, and by shape and stride
+    BZTEST(&FFTPlan<double>::get(30) == &FFTPlan<double>::get(30));
+    typedef ArrayFFTPlan<double,3> T_plan3;
+    const T_plan3& plan3 = T_plan3::get(A.extent(), A.stride());
+    BZTEST(&plan3 == &T_plan3::get(A.extent(), A.stride()));
+    BZTEST(&RealFFTPlan<float>::get(12) == &RealFFTPlan<float>::get(12));
+
+    // single precision
+    Array<complex<float>,1> F(100);
+    F = zip(cos(i * 0.1f), 0.f, complex<float>());
+    Array<complex<float>,1> G = ifft(fft(F));
+    BZTEST(max(abs(G - F)) < 1e-5);
+
+    return 0;
+}
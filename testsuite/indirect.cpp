@@ -0,0 +1,96 @@
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <list>
+#include <vector>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+typedef TinyVector<int,2> coord;
+
+int main()
+{
+    Array<int,2> A(4,4), B(4,4);
+    B = 10*i + j;
+
+    list<coord> I;
+    I.push_back(coord(2,2));
+    I.push_back(coord(1,1));
+    I.push_back(coord(3,0));
+
+    // List of positions
+    A = 0;
+    A[I] = B;
+    BZTEST(A(1,1) == 11);
+    BZTEST(A(2,2) == 22);
+    BZTEST(A(3,0) == 30);
+    BZTEST(sum(A) == 63);
+
+    // Expressions and index placeholders are evaluated at the position
+    A = 0;
+    A[I] = B + 100;
+    BZTEST(sum(A) == 363);
+    A = 0;
+    A[I] = i*j;
+    BZTEST(sum(A) == 5);
+
+    // Operand with a different layout than the destination
+    Array<int,2> Bt(4, 4, ColumnMajorArray<2>());
+    Bt = B;
+    A = 0;
+    A[I] = Bt;
+    BZTEST(sum(A) == 63);
+
+    // Rank-1 indirection with a container of int
+    Array<int,1> C(5), D(5);
+    C = 0;
+    D = 1, 2, 3, 4, 5;
+    vector<int> J;
+    J.push_back(2);
+    J.push_back(4);
+    J.push_back(1);
+    C[J] = D;
+    BZTEST(C(0) == 0 && C(1) == 2 && C(2) == 3 && C(3) == 0 && C(4) == 5);
+
+    // Compiled index sets, with repeated positions
+    Array<int,2> E(Range(1,4), Range(-1,2));
+    E = 10*i + j;
+    vector<coord> K;
+    K.push_back(coord(4,2));
+    K.push_back(coord(1,-1));
+    K.push_back(coord(4,2));
+    K.push_back(coord(2,0));
+
+    CompiledIndexSet<2> sorted(K, E);
+    BZTEST(sorted.size() == 4);
+    BZTEST(sorted.isSorted());
+    BZTEST(!sorted.isUnique());
+    BZTEST(all(sorted.point(0) == coord(1,-1)));
+    BZTEST(sorted.position(0) == 1);
+    for (sizeType n=1; n < sorted.size(); ++n)
+        BZTEST(sorted.offset(n) >= sorted.offset(n-1));
+
+    CompiledIndexSet<2> unsorted(K, E, false);
+    BZTEST(all(unsorted.point(0) == coord(4,2)));
+    BZTEST(unsorted.position(2) == 2);
+
+    Array<int,2> F(Range(1,4), Range(-1,2)), G(Range(1,4), Range(-1,2));
+    F = 0;
+    G = 0;
+    F[sorted] = E * 2;
+    G[unsorted] = E * 2;
+    BZTEST(F(4,2) == 84);
+    BZTEST(F(1,-1) == 18);
+    BZTEST(F(2,0) == 40);
+    BZTEST(sum(F) == 142);
+    BZTEST(all(F == G));
+
+    // The compiled set can be reused with other arrays of the same layout
+    BZTEST(sorted.isCompatible(G));
+    G = 0;
+    G[sorted] = F + 1;
+    BZTEST(G(4,2) == 85);
+    BZTEST(sum(G) == 145);
+
+    return 0;
+}
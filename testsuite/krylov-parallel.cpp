@@ -0,0 +1,79 @@
+// Check the Krylov solvers with their passes split between OpenMP
+// threads: the inner products must add up the same as in one thread, so
+// that the solvers stop on the right tolerance.
+#define BZ_KRYLOV_THREADING_THRESHOLD 1
+
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <blitz/array/krylov.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+// the 1D Laplacian with zero boundaries, plus shift times identity
+struct Laplacian {
+    double shift;
+
+    Laplacian(double s) : shift(s) { }
+
+    void operator()(const Array<double,1>& x, Array<double,1>& y) const
+    {
+        const int l = x.lbound(0), u = x.ubound(0);
+        for (int i=l; i <= u; ++i)
+            y(i) = (2 + shift) * x(i) - (i > l ? x(i-1) : 0.)
+                - (i < u ? x(i+1) : 0.);
+    }
+};
+
+// |A x - b| / |b|
+double relativeResidual(const Array<double,1>& x, const Array<double,1>& b)
+{
+    Array<double,1> r(b.shape());
+    r.reindexSelf(b.lbound());
+    Laplacian(0.01)(x, r);
+    r -= b;
+    return sqrt(sum(r * r) / sum(b * b));
+}
+
+template<typename T_solver>
+void check(T_solver& solver, const Array<double,1>& b)
+{
+    const double tolerance = 1e-8;
+    solver.setTolerance(tolerance);
+    solver.setMaxIterations(2000);
+
+    Array<double,1> x(b.shape());
+    x.reindexSelf(b.lbound());
+    x = 0;
+    KrylovResult result = solver.solve(Laplacian(0.01), x, b);
+    BZTEST(result.converged);
+    // the reported residual is relative to the true norm of b
+    BZTEST(result.residual <= tolerance * sqrt(sum(b * b)));
+    BZTEST(relativeResidual(x, b) < 2 * tolerance);
+}
+
+int main()
+{
+#ifdef _OPENMP
+    omp_set_num_threads(4);
+#endif
+
+    // odd sizes, so that the threads get unequal parts
+    const int n = 257;
+    Array<double,1> b(Range(1,n));
+    b = sin(i * 0.1) + 0.5;
+
+    ConjugateGradient<double,1> cg;
+    check(cg, b);
+
+    BiCGStab<double,1> bicg;
+    check(bicg, b);
+
+    GMRES<double,1> gmres(20);
+    check(gmres, b);
+
+    return 0;
+}
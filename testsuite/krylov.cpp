@@ -0,0 +1,144 @@
+// Check the Krylov solvers on matrix-free, dense and stencil operators,
+// with real and complex, contiguous and strided vectors.
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <blitz/array/stencilops.h>
+#include <blitz/array/stencils.h>
+#include <blitz/array/cgsolve.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+// the 1D Laplacian with zero boundaries, plus shift times identity
+struct Laplacian {
+    double shift;
+
+    Laplacian(double s) : shift(s) { }
+
+    void operator()(const Array<double,1>& x, Array<double,1>& y) const
+    {
+        const int l = x.lbound(0), u = x.ubound(0);
+        for (int i=l; i <= u; ++i)
+            y(i) = (2 + shift) * x(i) - (i > l ? x(i-1) : 0.)
+                - (i < u ? x(i+1) : 0.);
+    }
+};
+
+template<typename T>
+double residual(const Array<T,2>& A, const Array<T,1>& x,
+                const Array<T,1>& b)
+{
+    Array<T,1> r(b.shape());
+    DenseOperator<T> op(A);
+    op(x, r);
+    r -= b;
+    return sqrt(sum(abs(r) * abs(r)));
+}
+
+int calls;
+
+bool count(int, double, void*)
+{
+    ++calls;
+    return calls < 5;
+}
+
+BZ_DECLARE_STENCIL2(minusLaplacian, A, B)
+    A = -Laplacian3D_stencilop(B);
+BZ_END_STENCIL
+
+struct NoBCs {
+    void applyBCs(Array<double,3>&) const { }
+};
+
+int main()
+{
+    // CG, on an operator functor
+    const int n = 200;
+    Array<double,1> x(Range(1,n)), b(Range(1,n)), y(Range(1,n));
+    b = sin(i * 0.1);
+    x = 0;
+    ConjugateGradient<double,1> cg;
+    cg.setTolerance(1e-10);
+    KrylovResult result = cg.solve(Laplacian(0.01), x, b);
+    BZTEST(result.converged);
+    BZTEST(result.iterations <= n);
+    Laplacian(0.01)(x, y);
+    BZTEST(max(abs(y - b)) < 1e-8);
+
+    // the work arrays are reused, and a strided x is copied in and out
+    Array<double,2> X2(n, 2);
+    X2 = 0;
+    Array<double,1> xs = X2(Range::all(), 1);
+    xs.reindexSelf(1);
+    KrylovResult again = cg.solve(Laplacian(0.01), xs, b);
+    BZTEST(again.iterations == result.iterations);
+    BZTEST(max(abs(xs - x)) < 1e-12);
+    BZTEST(all(X2(Range::all(), 0) == 0));
+
+    // a callback stopping the solver
+    calls = 0;
+    x = 0;
+    cg.setCallback(count);
+    result = cg.solve(Laplacian(0.01), x, b);
+    BZTEST(calls == 5);
+    BZTEST(!result.converged && result.iterations == 4);
+    cg.setCallback(0);
+
+    // nonsymmetric dense systems
+    const int m = 60;
+    Array<double,2> A(m, m);
+    A = 1.0 / (1 + abs(i - j)) + (i == j) * 4 + 0.3 * (j == i + 1);
+    Array<double,1> u(m), v(m);
+    v = cos(i * 0.4);
+
+    u = 0;
+    BiCGStab<double,1> bicg;
+    result = bicg.solve(DenseOperator<double>(A), u, v);
+    BZTEST(result.converged);
+    BZTEST(residual(A, u, v) < 1e-7 * sqrt(sum(v * v)));
+
+    u = 0;
+    GMRES<double,1> gmres(10);
+    result = gmres.solve(DenseOperator<double>(A), u, v);
+    BZTEST(result.converged);
+    BZTEST(residual(A, u, v) < 1e-7 * sqrt(sum(v * v)));
+
+    // restarts do not lose the solution
+    u = 0;
+    gmres.setRestart(2);
+    gmres.setMaxIterations(500);
+    result = gmres.solve(DenseOperator<double>(A), u, v);
+    BZTEST(result.converged);
+    BZTEST(residual(A, u, v) < 1e-7 * sqrt(sum(v * v)));
+
+    // complex
+    typedef complex<double> cd;
+    Array<cd,2> C(m, m);
+    C = zip(A, 0.2 * sin(i + 2.0 * j), cd());
+    Array<cd,1> w(m), z(m);
+    z = zip(cos(i * 0.3), sin(i * 0.2), cd());
+    w = 0;
+    GMRES<cd,1> zgmres(15);
+    BZTEST(zgmres.solve(DenseOperator<cd>(C), w, z).converged);
+    BZTEST(residual(C, w, z) < 1e-7);
+    w = 0;
+    BiCGStab<cd,1> zbicg;
+    BZTEST(zbicg.solve(DenseOperator<cd>(C), w, z).converged);
+    BZTEST(residual(C, w, z) < 1e-7);
+
+    // Poisson's equation -Laplacian(P) = 1 with P = 0 on the boundary
+    Array<double,3> P(16, 16, 16), rhs(16, 16, 16), R(16, 16, 16);
+    P = 0;
+    rhs = 1;
+    int iterations = conjugateGradientSolver(minusLaplacian(), P, rhs, 1e-16,
+                                             NoBCs());
+    BZTEST(iterations > 0 && iterations < 1000);
+    R = 0;
+    applyStencil(minusLaplacian(), R, P);
+    Range I(1, 14), J = Range::all();
+    BZTEST(max(abs(R(I,I,I) - 1)) < 1e-7);
+    BZTEST(all(P(0, J, J) == 0));
+
+    return 0;
+}
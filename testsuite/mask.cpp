@@ -0,0 +1,97 @@
+#include "testsuite.h"
+#include <blitz/array.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+int main()
+{
+    Array<int,2> M(Range(1,4), Range(0,5));
+    M = 0;
+    M(1,1) = 1;
+    M(1,2) = 1;
+    M(1,5) = 1;
+    M(3,0) = 1;
+    M(3,1) = 1;
+    M(3,2) = 1;
+    M(4,5) = 1;
+
+    CompiledMask<2> m(M);
+    BZTEST(m.runRank() == 1);
+    BZTEST(m.numRuns() == 4);
+    BZTEST(m.numActive() == 7);
+    BZTEST(all(m.runStart(2) == TinyVector<int,2>(3,0)));
+    BZTEST(m.runLength(2) == 3);
+
+    // Masked assignment gives the same result as where()
+    Array<double,2> A(Range(1,4), Range(0,5)), B(Range(1,4), Range(0,5)),
+        C(Range(1,4), Range(0,5));
+    B = 10*i + j;
+    A = -1;
+    C = -1;
+    A[m] = B * 2 + 1;
+    C = where(M != 0, B * 2 + 1, C);
+    BZTEST(all(A == C));
+
+    A[m] += B;
+    C = where(M != 0, C + B, C);
+    BZTEST(all(A == C));
+
+    // Index placeholders and a scalar
+    A = 0;
+    A[m] = i * j;
+    BZTEST(sum(A) == 1 + 2 + 5 + 0 + 3 + 6 + 20);
+    A[m] = 3;
+    BZTEST(sum(A) == 21);
+
+    // Operand with another storage order uses the strided loop
+    Array<double,2> D(Range(1,4), Range(0,5), ColumnMajorArray<2>());
+    D = B;
+    A = 0;
+    A[m] = D;
+    BZTEST(sum(A) == 11 + 12 + 15 + 30 + 31 + 32 + 45);
+
+    // Mask built from an expression, runs along the fastest rank of a
+    // column-major mask
+    CompiledMask<2> m2(B > 43);
+    BZTEST(m2.numActive() == 2);
+    Array<int,2> N(Range(1,4), Range(0,5), ColumnMajorArray<2>());
+    N = where(j == 5, 1, 0);
+    CompiledMask<2> m3(N);
+    BZTEST(m3.runRank() == 0);
+    BZTEST(m3.numRuns() == 1);
+    BZTEST(m3.runLength(0) == 4);
+    A = 0;
+    A[m3] = B;
+    BZTEST(sum(A) == 15 + 25 + 35 + 45);
+
+    // Runs long enough to be evaluated in vectorized chunks, starting
+    // at various columns
+    const int n = 100;
+    Array<double,2> G(3,n), H(3,n), K(3,n);
+    Array<bool,2> L(3,n);
+    L = (j >= 3 * i + 1) && (j < n - i);
+    H = i * n + j;
+    CompiledMask<2> m5(L);
+    BZTEST(m5.numRuns() == 3);
+    G = 0;
+    K = 0;
+    G[m5] = H * 2 + 1;
+    K = where(L, H * 2 + 1, K);
+    BZTEST(all(G == K));
+    G[m5] -= H;
+    K = where(L, K - H, K);
+    BZTEST(all(G == K));
+
+    // Empty mask
+    Array<bool,2> E(3,3);
+    E = false;
+    CompiledMask<2> m4(E);
+    BZTEST(m4.numRuns() == 0);
+    Array<int,2> F(3,3);
+    F = 7;
+    F[m4] = 0;
+    BZTEST(all(F == 7));
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Check PatchCollection: views, expressions and ghost cell exchange.
+#include "testsuite.h"
+
+#include <blitz/array.h>
+#include <blitz/array/patches.h>
+
+BZ_USING_NAMESPACE(blitz)
+
+// fills the interiors of the patches from G, and their ghost cells
+// with -1; then checks that after exchangeGhosts() the ghost cells in
+// the interior of another patch hold the elements of G
+template<int N>
+bool checkExchange(PatchCollection<double,N>& U, const Array<double,N>& G)
+{
+    for (int p=0; p < U.numPatches(); ++p)
+    {
+        U.patch(p) = -1;
+        // subarrays of G keep its base
+        U.interior(p) = G(U.interiorDomain(p)).reindex(U.origin(p));
+    }
+    U.exchangeGhosts();
+
+    sizeType ghosts = 0;
+    for (int p=0; p < U.numPatches(); ++p)
+    {
+        const Array<double,N> P = U.patch(p);
+        for (typename Array<double,N>::const_iterator iter = P.begin();
+             iter != P.end(); ++iter)
+        {
+            const TinyVector<int,N> i = iter.position();
+            int owner = -1;
+            for (int q=0; q < U.numPatches(); ++q)
+                if (all(i >= U.origin(q)) && all(i < U.origin(q) + U.extent()))
+                    owner = q;
+            if (owner == p)
+                continue;
+            if (owner < 0)
+            {
+                if (*iter != -1)
+                    return false;
+            }
+            else
+            {
+                if (*iter != G(i))
+                    return false;
+                ++ghosts;
+            }
+        }
+    }
+    return ghosts == U.numGhostElements();
+}
+
+int main()
+{
+    firstIndex i;
+    secondIndex j;
+    thirdIndex k;
+
+    // a 3 x 2 grid of 4 x 5 patches, with one missing
+    PatchCollection<double,2> U(shape(4,5), 2);
+    for (int a=0; a < 3; ++a)
+        for (int b=0; b < 2; ++b)
+            if ((a != 1) || (b != 1))
+                U.addPatch(shape(4 * a, 5 * b));
+    BZTEST(U.numPatches() == 5 && U.capacity() >= 5 && U.ghost() == 2);
+
+    // views of the patches
+    Array<double,2> P = U.patch(3);
+    BZTEST(all(P.lbound() == U.origin(3) - 2));
+    BZTEST(all(P.extent() == shape(8,9)));
+    Array<double,2> I = U.interior(3);
+    BZTEST(all(I.lbound() == shape(8,0)) && all(I.ubound() == shape(11,4)));
+    I = i + 10 * j;
+    BZTEST(P(9,2) == 29 && U.patch(3)(11,4) == 51);
+    Array<double,3> B = U.interiors();
+    BZTEST(all(B.extent() == shape(5,4,5)) && B(3,1,2) == 29);
+    BZTEST(U.patches()(3,-1,0) == P(7,0));
+
+    // the patches start on a SIMD vector
+    const int width = simdTypes<double>::vecWidth;
+    for (int p=0; p < U.numPatches(); ++p)
+        BZTEST((U.patch(p).data() - U.patch(0).data()) % width == 0);
+
+    // ghost cell exchange, against a global array
+    Array<double,2> G(Range(-2,13), Range(-2,11));
+    G = 100 * i + j;
+    BZTEST(checkExchange(U, G));
+    // ghost cells 2 wide, both ways: two pairs of neighbours along each
+    // rank, and two pairs by a corner, around the missing patch
+    BZTEST(U.numGhostElements() == sizeType(2 * (2 * 2 * 5 + 2 * 2 * 4)
+                                            + 2 * 2 * 2 * 2));
+
+    // expressions over all the interiors
+    PatchCollection<double,2> V = U.copy();
+    BZTEST(V.numPatches() == 5 && all(V.origin(4) == U.origin(4)));
+    BZTEST(V.interior(2).data() != U.interior(2).data());
+    BZTEST(all(V.patch(2) == U.patch(2)));
+    V = 2 * U + 1;
+    for (int p=0; p < U.numPatches(); ++p)
+        BZTEST(all(V.interior(p) == 2 * U.interior(p) + 1));
+    // the ghost cells are left alone
+    BZTEST(V.patch(0)(-2,-2) == -1);
+    V += U;
+    V -= 1;
+    V *= 2;
+    V /= U + 1;
+    V = V + sqrt(U * U);
+    Array<double,3> R(B.shape());
+    R = 6 * B / (B + 1) + abs(B);
+    BZTEST(all(abs(V.interiors() - R) < 1e-12));
+    V = 3;
+    BZTEST(all(V.interiors() == 3) && sum(V) == 3 * 5 * 20);
+    V = U;
+    BZTEST(all(V.interiors() == U.interiors()));
+    // Arrays of the shape of interiors() in expressions
+    Array<double,3> C(B.shape());
+    C = i;
+    V = U + C;
+    BZTEST(V.interior(3)(9,2) == 3 + U.interior(3)(9,2));
+
+    // patches added later move the storage, and are planned again
+    PatchCollection<double,3> W(shape(6,6,6), 1);
+    W.reserve(2);
+    W.addPatch(shape(0,0,0));
+    W.addPatch(shape(6,0,0));
+    BZTEST(W.capacity() == 2);
+    Array<double,3> H(Range(-1,18), Range(-1,12), Range(-1,12));
+    H = i * 10000 + j * 100 + k;
+    W.interior(1) = H(W.interiorDomain(1)).reindex(W.origin(1));
+    W.addPatch(shape(0,6,0));
+    W.addPatch(shape(6,6,6));
+    W.addPatch(shape(12,0,0));
+    BZTEST(W.capacity() >= 5);
+    BZTEST(all(W.interior(1) == H(W.interiorDomain(1)).reindex(W.origin(1))));
+    BZTEST(checkExchange(W, H));
+    W.addPatch(shape(12,6,6));
+    BZTEST(checkExchange(W, H));
+
+    return 0;
+}
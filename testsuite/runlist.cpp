@@ -0,0 +1,113 @@
+#include "testsuite.h"
+#include <blitz/array.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+typedef TinyVector<int,2> coord;
+
+int main()
+{
+    // Runs added out of order are sorted and merged
+    RunListDomain<2> a;
+    a.addRun(coord(2,4), 3);
+    a.addPoint(coord(1,0));
+    a.addRun(coord(2,0), 2);
+    a.addRun(coord(2,2), 3);
+    a.addPoint(coord(1,2));
+    a.normalize();
+    BZTEST(a.numRuns() == 3);
+    BZTEST(a.numElements() == 9);
+    BZTEST(all(a.runStart(2) == coord(2,0)));
+    BZTEST(a.runLength(2) == 7);
+    BZTEST(a.contains(coord(2,6)));
+    BZTEST(a.contains(coord(1,2)));
+    BZTEST(!a.contains(coord(1,1)));
+    BZTEST(!a.contains(coord(2,7)));
+    BZTEST(!a.contains(coord(0,3)));
+    BZTEST(all(a.boundingBox().lbound() == coord(1,0)));
+    BZTEST(all(a.boundingBox().ubound() == coord(2,6)));
+
+    // Rectangular domains and set operations
+    RunListDomain<2> b(RectDomain<2>(coord(1,1), coord(3,3)));
+    BZTEST(b.numRuns() == 3);
+    BZTEST(b.numElements() == 9);
+
+    BZTEST(a.isNormalized() && b.isNormalized());
+    RunListDomain<2> c = a & b;
+    BZTEST(c.numElements() == 4);
+    BZTEST(c.contains(coord(1,2)));
+    BZTEST(c.contains(coord(2,3)));
+    BZTEST(!c.contains(coord(1,0)));
+    BZTEST(c.isNormalized());
+
+    // Runs which are not normalized can not be intersected
+    RunListDomain<2> u;
+    u.addRun(coord(2,4), 3);
+    u.addRun(coord(2,0), 5);
+    BZTEST(!u.isNormalized());
+    beginCheckAssert();
+    u & b;
+    endCheckAssert();
+    u.normalize();
+    BZTEST(u.isNormalized());
+    BZTEST(u.numRuns() == 1 && u.numElements() == 7);
+
+    RunListDomain<2> d = a | b;
+    BZTEST(d.numElements() == 9 + 9 - 4);
+    BZTEST(d.numRuns() == 3);
+
+    RunListDomain<2> e;
+    e.addPoint(coord(2,2));
+    e = dilate(e, 1);
+    BZTEST(e.numRuns() == 3);
+    BZTEST(e.numElements() == 9);
+    BZTEST(e.contains(coord(1,1)) && e.contains(coord(3,3)));
+    e = dilate(e, coord(0,2));
+    BZTEST(e.numElements() == 21);
+
+    // Dilated domains can be clipped to an array
+    Array<double,2> A(4,7), B(4,7), C(4,7);
+    RunListDomain<2> f = dilate(a, 1) & RunListDomain<2>(A.domain());
+    BZTEST(all(f.boundingBox().lbound() == coord(0,0)));
+    BZTEST(all(f.boundingBox().ubound() == coord(3,6)));
+
+    // Assignment over a domain equals assignment over the positions
+    B = 10*i + j;
+    A = 0;
+    C = 0;
+    A[d] = B * 2;
+    for (int m=0; m < 4; ++m)
+        for (int n=0; n < 7; ++n)
+            if (d.contains(coord(m,n)))
+                C(m,n) = B(m,n) * 2;
+    BZTEST(all(A == C));
+
+    A[d] += i;
+    BZTEST(A(3,3) == 2 * 33 + 3);
+    BZTEST(A(0,0) == 0);
+
+    // Runs along a rank other than the fastest one
+    Array<int,2> D(4,5, ColumnMajorArray<2>());
+    D = 0;
+    RunListDomain<2> g(RectDomain<2>(coord(1,1), coord(2,3)), 0);
+    BZTEST(g.runRank() == 0);
+    BZTEST(g.numRuns() == 3);
+    D[g] = 1;
+    BZTEST(sum(D) == 6);
+    RunListDomain<2> gd(D);
+    BZTEST(gd.runRank() == 0);
+    BZTEST(gd.numRuns() == 3 && gd.numElements() == 6);
+
+    // Rank 3
+    Array<int,3> E(3,3,3);
+    E = 0;
+    RunListDomain<3> h;
+    h.addPoint(TinyVector<int,3>(1,1,1));
+    h = dilate(h, 1);
+    BZTEST(h.numElements() == 27);
+    E[h] = 1;
+    BZTEST(sum(E) == 27);
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <vector>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+typedef TinyVector<int,2> coord;
+
+int main()
+{
+    // Repeated positions accumulate through IndirectArray
+    Array<int,1> hist(4);
+    vector<int> bins;
+    bins.push_back(1);
+    bins.push_back(3);
+    bins.push_back(1);
+    bins.push_back(1);
+    hist = 0;
+    hist[bins] += 1;
+    BZTEST(hist(0) == 0 && hist(1) == 3 && hist(2) == 0 && hist(3) == 1);
+    hist[bins] -= 1;
+    BZTEST(all(hist == 0));
+
+    Array<double,2> A(3,3), B(3,3);
+    B = 10*i + j;
+    vector<coord> I;
+    I.push_back(coord(1,2));
+    I.push_back(coord(0,0));
+    I.push_back(coord(1,2));
+    A = 1;
+    A[I] += B;
+    BZTEST(A(1,2) == 25);
+    BZTEST(A(0,0) == 1);
+    BZTEST(sum(A) == 33);
+    A[I] *= 2;
+    BZTEST(A(1,2) == 100);
+
+    // Scatter with one value per position
+    Array<double,1> v(3);
+    v = 5, -2, 7;
+    A = 0;
+    scatterAdd(A, I, v);
+    BZTEST(A(1,2) == 12);
+    BZTEST(A(0,0) == -2);
+    A = 0;
+    scatterMin(A, I, v);
+    BZTEST(A(1,2) == 0 && A(0,0) == -2);
+    scatterMax(A, I, v);
+    BZTEST(A(1,2) == 7 && A(0,0) == -2);
+
+    // Values are matched to positions in the original order even if
+    // the compiled set is sorted, and a scalar is used for all points
+    Array<double,2> C(Range(1,3), Range(1,3));
+    CompiledIndexSet<2> sorted;
+    I[1] = coord(3,3);
+    sorted.compile(I, C);
+    BZTEST(sorted.minOffset() == sorted.offset(0));
+    BZTEST(sorted.maxOffset() == sorted.offset(2));
+    C = 0;
+    scatterAdd(C, sorted, v);
+    BZTEST(C(1,2) == 12 && C(3,3) == -2);
+    scatterAdd(C, sorted, 1);
+    BZTEST(C(1,2) == 14 && C(3,3) == -1);
+
+    // Large scatters, which are done in parallel with OpenMP
+    const int n = 100000;
+    Array<int,1> positions(n), values(n);
+    positions = (i * 7919) % 64;
+    values = i % 13 - 6;
+
+    vector<int> dense(positions.begin(), positions.end());
+    Array<long,1> D(64), Dref(64);
+    Array<int,1> M(64), Mref(64);
+    Dref = 0;
+    Mref = 1000;
+    for (int k=0; k < n; ++k)
+    {
+        Dref(dense[k]) += values(k);
+        Mref(dense[k]) = min(Mref(dense[k]), values(k));
+    }
+    D = 0;
+    scatterAdd(D, dense, values);
+    BZTEST(all(D == Dref));
+    M = 1000;
+    scatterMin(M, dense, values);
+    BZTEST(all(M == Mref));
+
+    positions = (i * 7919) % 50000;
+    vector<int> sparse(positions.begin(), positions.end());
+    Array<double,1> S(50000), Sref(50000);
+    Array<int,1> X(50000), Xref(50000);
+    Sref = 0;
+    Xref = -1000;
+    for (int k=0; k < n; ++k)
+    {
+        Sref(sparse[k]) += values(k);
+        Xref(sparse[k]) = max(Xref(sparse[k]), values(k));
+    }
+    S = 0;
+    scatterAdd(S, sparse, values);
+    BZTEST(all(S == Sref));
+    X = -1000;
+    scatterMax(X, sparse, values);
+    BZTEST(all(X == Xref));
+
+    CompiledIndexSet<1> sparseSet(sparse, X);
+    X = -1000;
+    scatterMax(X, sparseSet, values);
+    BZTEST(all(X == Xref));
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Check SoAArray against the interleaved Array of the same values:
+// conversions, element access and component-wise expressions.
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <blitz/array/soa.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+typedef TinyVector<double,3> T_vec;
+
+int main()
+{
+    const int n = 9;
+    Array<T_vec,3> A(Range(1,n), Range(1,n), Range(1,n));
+    A[0] = i + j;
+    A[1] = j * k;
+    A[2] = 1.0 / (i + k);
+
+    // conversions keep the domain; components have unit stride
+    SoAArray<T_vec,3> V(A);
+    BZTEST(all(V.lbound() == 1) && all(V.extent() == n));
+    BZTEST(V.numElements() == n*n*n);
+    for (int c=0; c < 3; ++c)
+    {
+        BZTEST(V[c].isStorageContiguous() && V[c].stride(2) == 1);
+        BZTEST(all(V[c] == A[c]));
+    }
+
+    // element access, through a proxy unless V is const
+    const SoAArray<T_vec,3>& cV = V;
+    BZTEST(all(cV(2,3,4) == A(2,3,4)));
+    V(2,3,4) = T_vec(7, 8, 9);
+    BZTEST(V[1](2,3,4) == 8);
+    V(2,3,4)[2] = 10;
+    BZTEST(V[2](2,3,4) == 10);
+    V(2,3,4) = A(2,3,4);
+    T_vec v = V(2,3,4);
+    BZTEST(all(v == A(2,3,4)));
+
+    // expressions, against the same ones on A
+    SoAArray<T_vec,3> W(V.lbound(), V.extent()), X(V.lbound(), V.extent());
+    Array<T_vec,3> B(A.lbound(), A.extent()), C(A.lbound(), A.extent());
+    Array<double,3> rho(A.lbound(), A.extent());
+    rho = 1 + i * 0.5;
+
+    W = 2.0;
+    B = 2.0;
+    X = V + 0.5 * W - V / 4;
+    C = A + 0.5 * B - A / 4;
+    X.copyTo(B);
+    BZTEST(all(B[0] == C[0]) && all(B[1] == C[1]) && all(B[2] == C[2]));
+
+    X = -V * W + T_vec(1, 2, 3);
+    for (int c=0; c < 3; ++c)
+        BZTEST(all(X[c] == -A[c] * 2.0 + (c + 1)));
+
+    // an array of scalars is used for every component
+    X = V / rho + rho;
+    for (int c=0; c < 3; ++c)
+        BZTEST(all(X[c] == A[c] / rho + rho));
+
+    X += V;
+    X *= 2;
+    X -= T_vec(1, 1, 1);
+    for (int c=0; c < 3; ++c)
+        BZTEST(all(X[c] == (A[c] / rho + rho + A[c]) * 2 - 1));
+
+    // copies are views, copy() is not
+    SoAArray<T_vec,3> Y(X), Z = X.copy();
+    Y(1,1,1) = T_vec(0.);
+    BZTEST(X[0](1,1,1) == 0 && Z[0](1,1,1) != 0);
+
+    // reductions and other multicomponent types
+    SoAArray<T_vec,1> S(4);
+    S = T_vec(1, 2, 3);
+    BZTEST(all(sum(S) == T_vec(4, 8, 12)));
+
+    SoAArray<complex<float>,2> Q(3, 4);
+    Q = complex<float>(1, -1);
+    Q[1] *= 2;
+    Q = Q + Q;
+    complex<float> q = Q(2,3);
+    BZTEST(q == complex<float>(2, -4));
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Check StaticArray, alone and in expressions with Arrays.
+#include "testsuite.h"
+
+#include <blitz/array.h>
+#include <blitz/array/static.h>
+
+BZ_USING_NAMESPACE(blitz)
+
+typedef StaticArray<double, StaticShape<4,5,6> > T_block;
+typedef StaticArray<double, StaticShape<8,8>, -2> T_ghosted;
+
+template<typename T>
+bool equal(const T& S, const Array<double,T::rank_>& A)
+{
+    BZTEST(all(A.lbound() == S.lbound()) && all(A.ubound() == S.ubound()));
+    for (int i=0; i < int(S.numElements()); ++i)
+        if (S.data()[i] != A.data()[i])
+            return false;
+    return true;
+}
+
+int main()
+{
+    // the shape is constant, only the elements are stored
+    BZTEST(sizeof(T_block) == 4 * 5 * 6 * sizeof(double));
+    BZTEST(T_block::rank_ == 3 && T_block::numElements() == 120);
+    BZTEST(T_block::stride(0) == 30 && T_block::stride(1) == 6
+        && T_block::stride(2) == 1);
+    BZTEST(T_ghosted::lbound(1) == -2 && T_ghosted::ubound(1) == 5);
+
+    firstIndex i;
+    secondIndex j;
+    thirdIndex k;
+
+    Array<double,3> A(4,5,6), B(4,5,6), C(4,5,6);
+    A = i * 100 + j * 10 + k;
+    B = 1 + k;
+
+    // elements in row-major order
+    T_block S, T;
+    S = A;
+    BZTEST(S(3,4,5) == 345 && S(2,0,1) == 201);
+    BZTEST(S.data()[1] == 1 && S.data()[6] == 10);
+    BZTEST(equal(S, A));
+
+    // StaticArray expressions, and update operators
+    T = B;
+    S = 2 * T + S * 0.5;
+    C = 2 * B + A * 0.5;
+    BZTEST(equal(S, C));
+    S += T;
+    C += B;
+    BZTEST(equal(S, C));
+    S -= 1;
+    S *= T;
+    S /= 2;
+    C = (C - 1) * B / 2;
+    BZTEST(equal(S, C));
+
+    // StaticArrays as operands assigned to an Array
+    Array<double,3> D(4,5,6);
+    D = S + sqrt(T) + A;
+    C = C + sqrt(B) + A;
+    BZTEST(all(D == C));
+    BZTEST(sum(T) == sum(B) && max(S + sqrt(T) + A) == max(D));
+
+    // index placeholders, strided and transposed Arrays
+    S = i * 100 + j * 10 + k;
+    BZTEST(equal(S, A));
+    Array<double,3> E(8,10,12);
+    E = 0;
+    E(Range(0,6,2), Range(0,8,2), Range(0,10,2)) = A;
+    S = E(Range(0,6,2), Range(0,8,2), Range(0,10,2)) + 1;
+    BZTEST(equal(S, Array<double,3>(A + 1)));
+    Array<double,3> F(6,5,4);
+    F = k * 100 + j * 10 + i;
+    S = F.transpose(2,1,0);
+    BZTEST(equal(S, A));
+
+    // a StaticArray with ghost cells, and its views
+    T_ghosted G(0.);
+    Array<double,2> H(Range(-2,5), Range(-2,5));
+    H = i + 2 * j;
+    G = H;
+    BZTEST(G(-2,-2) == -6 && G(5,3) == 11 && G(0,1) == 2);
+    // subarrays keep the base of the array, as for Array
+    Array<double,2> interior = G(RectDomain<2>(shape(0,0), shape(3,3)));
+    BZTEST(interior(1,1) == 9 && interior.lbound(0) == -2);
+    interior = 0;
+    BZTEST(G(0,0) == 0 && G(-1,0) == -1);
+    Array<double,2> V = G.view();
+    BZTEST(V.lbound(0) == -2 && V(5,5) == 15);
+
+    // a StaticArray made from an expression
+    const T_ghosted K(H * 2);
+    BZTEST(K(4,4) == 24);
+
+    return 0;
+}
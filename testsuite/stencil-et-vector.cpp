@@ -0,0 +1,64 @@
+// Check that stencil ETs on long unit-stride lines, starting at
+// various alignments, give the same result as the equivalent array
+// expressions.
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <blitz/array/stencil-et.h>
+#include <blitz/array/stencilops.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+int main()
+{
+    const int n = 75;
+
+    Array<double,3> A3(4,5,n), B3(4,5,n), C3(4,5,n);
+    B3 = i + j * 0.5 + k * k * 0.25;
+    A3 = 0;
+    C3 = 0;
+    Range I(1,2), J(1,3), K(1,n-2);
+    A3(I,J,K) = Laplacian3D(B3);
+    C3(I,J,K) = B3(I-1,J,K) + B3(I+1,J,K) + B3(I,J-1,K) + B3(I,J+1,K)
+        + B3(I,J,K-1) + B3(I,J,K+1) - 6 * B3(I,J,K);
+    BZTEST(all(A3 == C3));
+
+    // Stencils mixed with other operands, and applied to an
+    // expression. The stencil operand is a view starting at various
+    // columns, so the destination lines start at various alignments.
+    Array<double,2> A2(6,n), B2(6,n), C2(6,n);
+    B2 = i * 3 + j * j * 0.5;
+    for (int first = 1; first < 6; ++first)
+    {
+        Range I2(1,4), J2(first,n-2);
+        Array<double,2> S = B2(Range::all(), Range(first-1,n-1));
+        C2 = 0;
+        C2(I2,J2) = B2(I2-1,J2) + B2(I2+1,J2) + B2(I2,J2-1) + B2(I2,J2+1)
+            - 4 * B2(I2,J2);
+
+        A2 = 0;
+        A2(I2,J2) = Laplacian2D(S);
+        BZTEST(all(A2 == C2));
+
+        A2 = 0;
+        A2(I2,J2) = Laplacian2D(S) * 0.5 + B2(I2,J2);
+        BZTEST(all(A2(I2,J2) == C2(I2,J2) * 0.5 + B2(I2,J2)));
+
+        A2 = 0;
+        A2(I2,J2) = Laplacian2D(S * 2.0);
+        BZTEST(all(A2 == C2 * 2.0));
+    }
+
+    // Multicomponent result
+    Array<TinyVector<double,2>,2> G(6,n);
+    Range I2(1,4), J2(1,n-2);
+    G = TinyVector<double,2>(0.0);
+    G(I2,J2) = grad2D(B2);
+    C2 = 0;
+    C2(I2,J2) = B2(I2,J2+1) - B2(I2,J2-1);
+    BZTEST(all(G[1] == C2));
+    C2(I2,J2) = B2(I2+1,J2) - B2(I2-1,J2);
+    BZTEST(all(G[0] == C2));
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Check that applyStencil gives the same result as the equivalent
+// array expression.  When compiled with OpenMP the interior domain is
+// split between threads.
+#define BZ_PARALLEL_STENCILS
+#define BZ_STENCIL_THREADING_THRESHOLD 1
+
+#include "testsuite.h"
+#include <blitz/array.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+BZ_DECLARE_STENCIL2(smooth1, A, B)
+    A = B(-1) + 2 * B(0) + B(1);
+BZ_END_STENCIL
+
+BZ_DECLARE_STENCIL2(smooth2, A, B)
+    A = Laplacian2D_stencilop(B) + B(0,0);
+BZ_END_STENCIL
+
+BZ_DECLARE_STENCIL2(smooth3, A, B)
+    A = Laplacian3D_stencilop(B) + B(0,0,0);
+BZ_END_STENCIL
+
+int main()
+{
+    Array<double,1> A1(Range(-3,60)), B1(Range(-3,60)), C1(Range(-3,60));
+    B1 = sqr(i);
+    A1 = 0;
+    C1 = 0;
+    applyStencil(smooth1(), A1, B1);
+    Range I1(-2,59);
+    C1(I1) = B1(I1-1) + 2 * B1(I1) + B1(I1+1);
+    BZTEST(all(A1 == C1));
+
+    Array<double,2> A2(37,29), B2(37,29), C2(37,29);
+    B2 = i * 0.5 + j * j;
+    A2 = 0;
+    C2 = 0;
+    applyStencil(smooth2(), A2, B2);
+    Range I2(1,35), J2(1,27);
+    C2(I2,J2) = B2(I2-1,J2) + B2(I2+1,J2) + B2(I2,J2-1) + B2(I2,J2+1)
+        - 3 * B2(I2,J2);
+    BZTEST(all(A2 == C2));
+
+    // Fewer planes than threads: the split is over lines, not planes
+    Array<double,3> A3(3,21,17), B3(3,21,17), C3(3,21,17);
+    B3 = i + j * 2 + k * k;
+    A3 = 0;
+    C3 = 0;
+    applyStencil(smooth3(), A3, B3);
+    Range I3(1,1), J3(1,19), K3(1,15);
+    C3(I3,J3,K3) = B3(I3-1,J3,K3) + B3(I3+1,J3,K3) + B3(I3,J3-1,K3)
+        + B3(I3,J3+1,K3) + B3(I3,J3,K3-1) + B3(I3,J3,K3+1)
+        - 5 * B3(I3,J3,K3);
+    BZTEST(all(A3 == C3));
+
+    return 0;
+}
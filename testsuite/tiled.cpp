@@ -0,0 +1,87 @@
+// Check TiledArray against Array: the tiles and their Morton order,
+// conversions, element access, expressions and transposes.
+#include "testsuite.h"
+#include <blitz/array.h>
+#include <blitz/array/tiled.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+int main()
+{
+    // 4x4 tiles, the last ones partly outside the array
+    Array<double,2> A(Range(1,10), Range(-2,11));
+    A = 100 * i + j;
+    TiledArray<double,2> T(A, 4);
+    BZTEST(T.edge() == 4);
+    BZTEST(all(T.tileExtent() == shape(3, 4)));
+    BZTEST(all(T.lbound() == A.lbound()) && all(T.extent() == A.extent()));
+    BZTEST(T.numElements() == A.numElements());
+
+    // element access
+    BZTEST(T(3, 5) == A(3, 5));
+    T(3, 5) = -1;
+    BZTEST(T(3, 5) == -1);
+    T(3, 5) = A(3, 5);
+
+    // a tile is stored contiguously; tiles (0,1) and (1,0) follow (0,0)
+    // along the Morton curve, and tile (1,1) comes next
+    BZTEST(&T(1, 2) == &T(1, -2) + 16);
+    BZTEST(&T(5, -2) == &T(1, -2) + 32);
+    BZTEST(&T(5, 2) == &T(1, -2) + 48);
+    BZTEST(&T(1, -1) == &T(1, -2) + 1 && &T(2, -2) == &T(1, -2) + 4);
+
+    Array<double,2> t = T.tile(shape(2, 3));
+    BZTEST(all(t.lbound() == shape(8, 12)) && all(t.extent() == shape(2, 2)));
+    BZTEST(t(9, 13) == A(10, 11));
+
+    // back to an array
+    Array<double,2> B(A.lbound(), A.extent());
+    B = 0;
+    T.copyTo(B);
+    BZTEST(all(B == A));
+    BZTEST(sum(T) == sum(A));
+
+    // expressions
+    TiledArray<double,2> U(A.lbound(), A.extent(), 4);
+    U = 2 * T + 1;
+    U -= T / 2;
+    U *= -T;
+    U.copyTo(B);
+    BZTEST(all(B == (2 * A + 1 - A / 2) * -A));
+
+    // copies are views, copy() is not
+    TiledArray<double,2> V(U), W = U.copy();
+    V(1, 0) = 7;
+    BZTEST(U(1, 0) == 7 && W(1, 0) != 7);
+
+    // transposes
+    Array<double,3> C(9, 13, 6);
+    C = i + 20 * j + 400 * k;
+    TiledArray<double,3> X(C, 4);
+    TiledArray<double,3> Y = X.transpose(2, 0, 1);
+    BZTEST(all(Y.extent() == shape(6, 9, 13)));
+    BZTEST(Y(5, 8, 12) == C(8, 12, 5));
+
+    TiledArray<double,3> Z(shape(6, 9, 13), 4);
+    Z = Y * 2;
+    Array<double,3> D(6, 9, 13), E(6, 9, 13);
+    Z.copyTo(D);
+    E = C(j, k, i) * 2;
+    BZTEST(all(D == E));
+    Y.copyTo(D);
+    BZTEST(all(D == C.transpose(2, 0, 1)));
+    Z += X.transpose(2, 0, 1).copy();
+    Z.copyTo(D);
+    BZTEST(all(D == 3 * E / 2));
+
+    // the default tiles fit in BZ_TILE_BYTES
+    TiledArray<double,3> F(20, 20, 20);
+    BZTEST(F.edge() == 8);
+    F = 1;
+    BZTEST(sum(F) == 8000);
+    TiledArray<float,2> G(100, 3);
+    BZTEST(G.edge() == 32);
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Check the TinyVector and TinyMatrix functions which are evaluated at
+// compile time when constexpr is available, and at run time otherwise.
+#include "testsuite.h"
+
+#include <blitz/array.h>
+#include <blitz/tinymat2.h>
+#include <blitz/tinymat2.cc>
+
+BZ_USING_NAMESPACE(blitz)
+
+typedef TinyVector<double,3> T_vec3;
+typedef TinyMatrix<double,3,3> T_mat3;
+
+// a rotation by a quarter turn about z, and the normal of a plane
+BZ_CONSTEXPR double rotationElements[9] = { 0, -1, 0,
+                                            1,  0, 0,
+                                            0,  0, 1 };
+
+BZ_CONSTEXPR T_vec3 normal()
+{
+    return cross(T_vec3(1, 0, 0), T_vec3(0, 1, 0));
+}
+
+BZ_CONSTEXPR T_vec3 rotated(const T_vec3& x)
+{
+    return product(T_mat3(rotationElements), x);
+}
+
+// 3 times the weights of the 5-point centered difference of a first
+// derivative, which are exact in binary
+BZ_CONSTEXPR TinyVector<double,5> stencil()
+{
+    TinyVector<double,5> w(1, -8, 0, 8, -1);
+    for (int i=0; i < 5; ++i)
+        w[i] /= 4;
+    return w;
+}
+
+BZ_CONSTEXPR T_mat3 rotatedTwice()
+{
+    T_mat3 r(rotationElements), s BZ_CONSTEXPR_VALUE(0.);
+    s = product(r, r);
+    s += product(r, T_mat3(0.));
+    return s;
+}
+
+#ifdef BZ_HAVE_CONSTEXPR
+ #define CHECK(x) static_assert(x, #x); BZTEST(x)
+#else
+ #define CHECK(x) BZTEST(x)
+#endif
+
+int main()
+{
+    BZ_CONSTEXPR T_vec3 n = normal();
+    CHECK(n[0] == 0 && n[1] == 0 && n[2] == 1);
+
+    BZ_CONSTEXPR T_vec3 x = rotated(T_vec3(1, 2, 3));
+    CHECK(x(0) == -2 && x(1) == 1 && x(2) == 3);
+
+    BZ_CONSTEXPR TinyVector<double,5> w = stencil();
+    CHECK(sum(w) == 0);
+    CHECK(dot(w, TinyVector<double,5>(-2, -1, 0, 1, 2)) == 3);
+
+    BZ_CONSTEXPR TinyVector<int,4> k(2, 3, 4, 5);
+    CHECK(product(k) == 120 && sum(k) == 14 && dot(k, k) == 54);
+    CHECK(_bz_returntype<double>::sum(TinyVector<int,2>(1, 2)) == 3);
+
+    BZ_CONSTEXPR T_mat3 r2 = rotatedTwice();
+    CHECK(r2(0,0) == -1 && r2(1,1) == -1 && r2(2,2) == 1 && r2(0,1) == 0);
+
+    BZ_CONSTEXPR TinyVector<float,3> c(TinyVector<int,3>(1, 2, 3));
+    CHECK(c[2] == 3.f);
+
+    // the reductions add the elements from the last, as before
+    TinyVector<double,4> a(1e16, 1, -1e16, 1);
+    BZTEST(sum(a) == 1e16 + (1 + (-1e16 + 1)));
+    BZTEST(product(TinyVector<double,3>(1e200, 1e200, 1e-200))
+        == 1e200 * (1e200 * 1e-200));
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Check the matrix products of TinyMatrix against products computed
+// element by element.
+#include "testsuite.h"
+
+#include <blitz/array.h>
+#include <blitz/tinymat2.h>
+#include <blitz/tinymat2.cc>
+
+BZ_USING_NAMESPACE(blitz)
+
+template<typename T, int N, int M>
+void fill(TinyMatrix<T,N,M>& a, int seed)
+{
+    for (int i=0; i < N; ++i)
+        for (int j=0; j < M; ++j)
+            a(i,j) = T((seed * (i + 1) + 3 * j * j + i * j) % 17 - 8);
+}
+
+template<typename T, typename T1, typename T2, int N, int K, int M>
+TinyMatrix<T,N,M> reference(const TinyMatrix<T1,N,K>& a,
+    const TinyMatrix<T2,K,M>& b)
+{
+    TinyMatrix<T,N,M> c;
+    for (int i=0; i < N; ++i)
+        for (int j=0; j < M; ++j)
+        {
+            c(i,j) = 0;
+            for (int k=0; k < K; ++k)
+                c(i,j) += a(i,k) * b(k,j);
+        }
+    return c;
+}
+
+template<typename T, int N, int M>
+bool equal(const TinyMatrix<T,N,M>& a, const TinyMatrix<T,N,M>& b)
+{
+    for (int i=0; i < N; ++i)
+        for (int j=0; j < M; ++j)
+            if (a(i,j) != b(i,j))
+                return false;
+    return true;
+}
+
+// the products of N x K and K x M matrices, alone and fused
+template<typename T, int N, int K, int M>
+void check(int seed)
+{
+    TinyMatrix<T,N,K> A;
+    TinyMatrix<T,K,M> B;
+    TinyMatrix<T,N,M> C, D, E;
+    fill(A, seed);
+    fill(B, seed + 1);
+    fill(C, seed + 2);
+    E = reference<T>(A, B);
+
+    D = product(A, B);
+    BZTEST(equal(D, E));
+
+    TinyMatrix<T,N,M> F(product(A, B));
+    BZTEST(equal(F, E));
+
+    D = product(A, B) + C;
+    F = E + C;
+    BZTEST(equal(D, F));
+    D = C + product(A, B);
+    BZTEST(equal(D, F));
+
+    D = C;
+    D += product(A, B);
+    BZTEST(equal(D, F));
+
+    D = C - product(A, B);
+    F = C - E;
+    BZTEST(equal(D, F));
+    D = C;
+    D -= product(A, B);
+    BZTEST(equal(D, F));
+
+    // the result may be the added matrix
+    D = C;
+    D = product(A, B) + D;
+    F = E + C;
+    BZTEST(equal(D, F));
+}
+
+int main()
+{
+    check<int,2,3,4>(1);
+    check<double,3,3,3>(2);
+    check<float,4,4,4>(3);
+    check<double,4,4,4>(4);
+    // rows computed in blocks, with a last smaller block
+    check<double,8,8,8>(5);
+    check<double,7,5,9>(6);
+    check<float,5,2,16>(7);
+    check<int,3,6,40>(8);
+
+    // the result may be an operand
+    TinyMatrix<double,4,4> A, B, C;
+    fill(A, 9);
+    fill(B, 10);
+    C = reference<double>(A, B);
+    TinyMatrix<double,4,4> D = A;
+    D = product(D, B);
+    BZTEST(equal(D, C));
+    D = B;
+    D = product(A, D);
+    BZTEST(equal(D, C));
+    D = A;
+    D += product(D, D);
+    C = A + reference<double>(A, A);
+    BZTEST(equal(D, C));
+
+    // mixed types are promoted
+    TinyMatrix<int,2,2> I;
+    I = 1, 2,
+        3, 4;
+    TinyMatrix<double,2,2> H;
+    H = 0.5, 0,
+        0, 0.25;
+    TinyMatrix<double,2,2> P = product(I, H);
+    BZTEST(P(0,0) == 0.5 && P(0,1) == 0.5 && P(1,0) == 1.5 && P(1,1) == 1);
+
+    // matrix-vector products
+    TinyMatrix<double,3,4> M;
+    fill(M, 11);
+    TinyVector<double,4> x(1, -2, 3, 0.5);
+    TinyVector<double,3> y = product(M, x);
+    for (int i=0; i < 3; ++i)
+        BZTEST(y(i) == M(i,0) * x(0) + M(i,1) * x(1) + M(i,2) * x(2)
+            + M(i,3) * x(3));
+
+    return 0;
+}
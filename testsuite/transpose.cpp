@@ -52,6 +52,42 @@ int main()
         2, 5, 8;
     BZTEST(count(D==E) == 9);
 
+    // assignments of transposes are copied in tiles; sizes which are
+    // not multiples of the tiles and blocks
+    Array<double,2> F(Range(1,37), Range(-3,41)), G(45, 37);
+    F = tensor::i * 100 + tensor::j;
+    G = F.transpose(secondDim, firstDim);
+    bool same = true;
+    for (int i=0; i < 45; ++i)
+      for (int j=0; j < 37; ++j)
+        same = same && (G(i,j) == F(j+1, i-3));
+    BZTEST(same);
+    G += F.transpose(secondDim, firstDim);
+    BZTEST(G(44,36) == 2 * F(37,41));
+
+    // index-permuted arrays, from Fortran to C storage and conversions
+    Array<float,3> H(Range(0,8), Range(0,69), Range(0,32),
+                     FortranArray<3>());
+    H = tensor::i + 10 * tensor::j + 1000 * tensor::k;
+    Array<double,3> K(33, 9, 70);
+    K = H(tensor::j, tensor::k, tensor::i);
+    same = true;
+    for (int i=0; i < 33; ++i)
+      for (int j=0; j < 9; ++j)
+        for (int k=0; k < 70; ++k)
+          same = same && (K(i,j,k) == H(j, k, i));
+    BZTEST(same);
+
+    // descending ranks
+    Array<int,2> L(20, 30, GeneralArrayStorage<2>(shape(0,1),
+                                                  shape(false,true)));
+    L = tensor::i - tensor::j;
+    Array<int,2> M(20, 30);
+    M = L;
+    BZTEST(all(M == tensor::i - tensor::j));
+    M = L.reverse(secondDim);
+    BZTEST(all(M == tensor::i - (29 - tensor::j)));
+
     return 0;
 }
 
@@ -0,0 +1,86 @@
+// Check the traversal counters of unit-stride, strided and index
+// traversals, and how the unit-stride loops are split.
+#define BZ_TRAVERSAL_COUNTERS
+
+#include "testsuite.h"
+#include <blitz/array.h>
+
+BZ_USING_NAMESPACE(blitz)
+BZ_USING_NAMESPACE(blitz::tensor)
+
+int main()
+{
+    TraversalCounters& c = TraversalCounters::get();
+
+    const int n = 1000;
+    Array<double,1> A(n), B(n), C(n);
+    B = i;
+    BZTEST(c.calls[indexTraversal] == 1);
+    BZTEST(c.elements[indexTraversal] == n);
+
+    c.reset();
+    C = 2.0;
+    A = B + C;
+    BZTEST(c.calls[unitStrideTraversal] == 2);
+    BZTEST(c.elements[unitStrideTraversal] == 2 * n);
+    BZTEST(c.unitStrideLoops[alignedChunkedLoop] +
+           c.unitStrideLoops[unalignedChunkedLoop] == 2);
+    BZTEST(c.unitStrideElements[alignedChunkedLoop] +
+           c.unitStrideElements[unalignedChunkedLoop] == 2 * n);
+
+    // every element is either peeled, in a chunk or in the remainder
+    c.reset();
+    Range I(3, n-1);
+    A(I) = B(I) + C(I);
+    const unsigned long long m = n - 3;
+    BZTEST(c.peeledLoops <= 1);
+    BZTEST(c.peeledElements + c.remainderElements < m);
+    BZTEST((m - c.peeledElements - c.remainderElements)
+           % BZ_VECTORIZED_LOOP_WIDTH == 0);
+
+    // short loops, 7 = 4 + 2 + 1 elements
+    c.reset();
+    Range S(0, 6);
+    A(S) = B(S) * 2;
+    BZTEST(c.unitStrideLoops[binaryUnrolledLoop] == 1);
+    BZTEST(c.unitStrideElements[binaryUnrolledLoop] == 7);
+    BZTEST(c.binaryAssignScalarElements == 1);
+
+    // strided and common-stride
+    c.reset();
+    Range even(0, n-2, 2);
+    A(even) = B(even);
+    A(Range(0, 99)) = B(Range(0, 198, 2));
+    BZTEST(c.calls[commonStrideTraversal] == 1);
+    BZTEST(c.elements[commonStrideTraversal] == n/2);
+    BZTEST(c.calls[stridedTraversal] == 1);
+    BZTEST(c.elements[stridedTraversal] == 100);
+
+    // a contiguous 3D array collapses into one loop, a view of it only
+    // partly
+    c.reset();
+    Array<float,3> D(4,5,6);
+    D = 1;
+    BZTEST(c.collapsedLoops[2] == 1);
+    D(Range::all(), Range(0,3), Range::all()) = 2;
+    BZTEST(c.collapsedLoops[1] == 1);
+    BZTEST(c.calls[unitStrideTraversal] == 2);
+    BZTEST(c.elements[unitStrideTraversal] == 4*5*6 + 4*4*6);
+
+    // transposes and permutations of an array
+    c.reset();
+    Array<float,2> E(30, 40), F(40, 30);
+    E = 1;
+    F = E.transpose(1, 0);
+    F = E(j, i);
+    BZTEST(c.calls[permutedCopy] == 2);
+    BZTEST(c.elements[permutedCopy] == 2 * 30 * 40);
+
+    // reductions
+    c.reset();
+    BZTEST(sum(B) == n * (n - 1) / 2);
+    BZTEST(c.calls[indexTraversal] == 1);
+    BZTEST(c.elements[indexTraversal] == n);
+
+    return 0;
+}